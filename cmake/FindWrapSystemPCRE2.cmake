@@ -7,10 +7,12 @@ if(TARGET WrapSystemPCRE2::WrapSystemPCRE2)
 endif()
 set(WrapSystemPCRE2_REQUIRED_VARS __pcre2_found)
 
-find_package(PCRE2 ${${CMAKE_FIND_PACKAGE_NAME}_FIND_VERSION} COMPONENTS 16BIT QUIET)
+# QRegularExpression needs both the 16-bit and the 8-bit library
+find_package(PCRE2 ${${CMAKE_FIND_PACKAGE_NAME}_FIND_VERSION} COMPONENTS 16BIT 8BIT QUIET)
 
 set(__pcre2_target_name "PCRE2::16BIT")
-if(PCRE2_FOUND AND TARGET "${__pcre2_target_name}")
+set(__pcre2_8bit_target_name "PCRE2::8BIT")
+if(PCRE2_FOUND AND TARGET "${__pcre2_target_name}" AND TARGET "${__pcre2_8bit_target_name}")
   # Hunter case.
   set(__pcre2_found TRUE)
   if(PCRE2_VERSION)
@@ -23,6 +25,7 @@ if(NOT __pcre2_found)
 
   find_package(PkgConfig QUIET)
   pkg_check_modules(PC_PCRE2 QUIET "libpcre2-16")
+  pkg_check_modules(PC_PCRE2_8BIT QUIET "libpcre2-8")
 
   find_path(PCRE2_INCLUDE_DIRS
             NAMES pcre2.h
@@ -33,14 +36,22 @@ if(NOT __pcre2_found)
   find_library(PCRE2_LIBRARY_DEBUG
               NAMES pcre2-16d pcre2-16
               HINTS ${PC_PCRE2_LIBDIR})
+  find_library(PCRE2_8BIT_LIBRARY_RELEASE
+              NAMES pcre2-8
+              HINTS ${PC_PCRE2_8BIT_LIBDIR})
+  find_library(PCRE2_8BIT_LIBRARY_DEBUG
+              NAMES pcre2-8d pcre2-8
+              HINTS ${PC_PCRE2_8BIT_LIBDIR})
   include(SelectLibraryConfigurations)
   select_library_configurations(PCRE2)
+  select_library_configurations(PCRE2_8BIT)
 
   if(PC_PCRE2_VERSION)
       set(WrapSystemPCRE2_VERSION "${PC_PCRE2_VERSION}")
   endif()
 
-  if (PCRE2_LIBRARIES AND PCRE2_INCLUDE_DIRS)
+  if (PCRE2_LIBRARIES AND PCRE2_8BIT_LIBRARIES AND PCRE2_INCLUDE_DIRS)
+      list(APPEND PCRE2_LIBRARIES ${PCRE2_8BIT_LIBRARIES})
       set(__pcre2_found TRUE)
   endif()
 endif()
@@ -52,11 +63,13 @@ find_package_handle_standard_args(WrapSystemPCRE2
 if(WrapSystemPCRE2_FOUND)
     add_library(WrapSystemPCRE2::WrapSystemPCRE2 INTERFACE IMPORTED)
     if(TARGET "${__pcre2_target_name}")
-        target_link_libraries(WrapSystemPCRE2::WrapSystemPCRE2 INTERFACE "${__pcre2_target_name}")
+        target_link_libraries(WrapSystemPCRE2::WrapSystemPCRE2 INTERFACE
+            "${__pcre2_target_name}" "${__pcre2_8bit_target_name}")
     else()
         target_link_libraries(WrapSystemPCRE2::WrapSystemPCRE2 INTERFACE ${PCRE2_LIBRARIES})
         target_include_directories(WrapSystemPCRE2::WrapSystemPCRE2 INTERFACE ${PCRE2_INCLUDE_DIRS})
     endif()
 endif()
 unset(__pcre2_target_name)
+unset(__pcre2_8bit_target_name)
 unset(__pcre2_found)
@@ -172,6 +172,52 @@ int main(void)
 }"
 )
 
+# epoll
+qt_config_compile_test(epoll
+    LABEL "epoll and timerfd"
+    CODE
+"#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+int main(void)
+{
+    /* BEGIN TEST: */
+struct epoll_event ev;
+struct itimerspec spec = {};
+int epfd = epoll_create1(EPOLL_CLOEXEC);
+int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+ev.events = EPOLLIN;
+ev.data.fd = tfd;
+epoll_ctl(epfd, EPOLL_CTL_ADD, tfd, &ev);
+timerfd_settime(tfd, 0, &spec, nullptr);
+epoll_wait(epfd, &ev, 1, 0);
+    /* END TEST: */
+    return 0;
+}
+")
+
+# io_uring
+qt_config_compile_test(io_uring
+    LABEL "io_uring"
+    CODE
+"#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+int main(void)
+{
+    /* BEGIN TEST: */
+struct io_uring_params params = {};
+struct io_uring_getevents_arg arg = {};
+int fd = syscall(__NR_io_uring_setup, 8, &params);
+params.features |= IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+        &arg, sizeof(arg));
+    /* END TEST: */
+    return 0;
+}
+")
+
 # eventfd
 qt_config_compile_test(eventfd
     LABEL "eventfd"
@@ -505,6 +551,14 @@ qt_feature("eventfd" PRIVATE
     LABEL "eventfd"
     CONDITION NOT WASM AND TEST_eventfd
 )
+qt_feature("epoll" PRIVATE
+    LABEL "epoll event dispatcher"
+    CONDITION LINUX AND QT_FEATURE_eventfd AND TEST_epoll
+)
+qt_feature("io-uring" PRIVATE
+    LABEL "io_uring event dispatcher"
+    CONDITION LINUX AND QT_FEATURE_eventfd AND TEST_io_uring
+)
 qt_feature("futimens" PRIVATE
     LABEL "futimens()"
     CONDITION NOT WIN32 AND TEST_futimens
@@ -928,6 +982,8 @@ qt_configure_add_summary_entry(ARGS "backtrace")
 qt_configure_add_summary_entry(ARGS "doubleconversion")
 qt_configure_add_summary_entry(ARGS "system-doubleconversion")
 qt_configure_add_summary_entry(ARGS "forkfd_pidfd" CONDITION LINUX)
+qt_configure_add_summary_entry(ARGS "epoll" CONDITION LINUX)
+qt_configure_add_summary_entry(ARGS "io-uring" CONDITION LINUX)
 qt_configure_add_summary_entry(ARGS "glib")
 qt_configure_add_summary_entry(ARGS "icu")
 qt_configure_add_summary_entry(ARGS "system-libb2")
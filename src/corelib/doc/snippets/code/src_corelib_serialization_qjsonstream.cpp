@@ -0,0 +1,52 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR BSD-3-Clause
+
+using namespace Qt::StringLiterals;
+
+//! [0]
+    QJsonStreamReader reader(&file);
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QJsonStreamReader::Name:
+            handleName(reader.text());
+            break;
+        case QJsonStreamReader::String:
+        case QJsonStreamReader::Number:
+        case QJsonStreamReader::Bool:
+        case QJsonStreamReader::Null:
+            handleValue(reader.value());
+            break;
+        default:
+            break;
+        }
+    }
+    if (reader.hasError())
+        qWarning() << reader.errorString() << "at offset" << reader.currentOffset();
+//! [0]
+
+//! [1]
+    // [ { "id": 1, ... }, { "id": 2, ... }, ... ]
+    QJsonStreamReader reader(&file);
+    if (reader.readNext() == QJsonStreamReader::StartArray) {
+        while (reader.readNextValue())
+            handleRecord(reader.readValue().toObject());
+    }
+//! [1]
+
+//! [2]
+    QJsonStreamWriter writer(&file);
+    writer.startObject();
+
+    writer.append("label"_L1);
+    writer.append("journald"_L1);
+
+    writer.append("autoDetect"_L1);
+    writer.append(false);
+
+    writer.append("output"_L1);
+    writer.startArray();
+    writer.append("privateFeature"_L1);
+    writer.endArray();
+
+    writer.endObject();
+//! [2]
@@ -339,4 +339,16 @@ if (m.hasMatch()) {
 //! [36]
 }
 
+{
+//! [37]
+QRegularExpression re(R"(status=(\d+))");
+QByteArray line = "GET /index.html status=404 size=1024";
+QRegularExpressionMatch match = re.matchView(QUtf8StringView(line));
+if (match.hasMatch()) {
+    qsizetype start = match.capturedStart(1); // 23, a byte offset into line
+    QString status = match.captured(1);       // "404"
+}
+//! [37]
+}
+
 }
@@ -3,6 +3,7 @@
 
 #include <QCoreApplication>
 #include <QLoggingCategory>
+#include <QtCore/qstructuredlogging.h>
 
 //![1]
 // in a header
@@ -145,6 +146,15 @@ oldCategoryFilter = QLoggingCategory::installFilter(myCategoryFilter);
 //![17]
     }
 
+    {
+//![30]
+    QLoggingCategory category("driver.usb");
+    const int id = 42;
+    const QString name = QStringLiteral("usb-storage");
+    qCStructuredDebug(category, "device %1 bound to driver %2", id, name);
+//![30]
+    }
+
     return 0;
 }
 
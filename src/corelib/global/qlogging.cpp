@@ -115,6 +115,12 @@ static QT_PREPEND_NAMESPACE(qint64) qt_gettid()
     return qintptr(QThread::currentThreadId());
 }
 #endif
+
+#if QT_CONFIG(thread) && defined(Q_COMPILER_THREAD_LOCAL)
+#  include "qwaitcondition.h"
+#  include <atomic>
+#  define QLOGGING_HAVE_ASYNC_OUTPUT
+#endif
 #endif // !QT_BOOTSTRAPPED
 
 #include <cstdlib>
@@ -1200,12 +1206,19 @@ struct QMessagePattern
 
     bool fromEnvironment;
     static QBasicMutex mutex;
+#ifdef QLOGGING_HAVE_BACKTRACE
+    // whether the current pattern has a %{backtrace}, readable without the mutex
+    static QBasicAtomicInteger<bool> hasBacktrace;
+#endif
 };
 #ifdef QLOGGING_HAVE_BACKTRACE
 Q_DECLARE_TYPEINFO(QMessagePattern::BacktraceParams, Q_RELOCATABLE_TYPE);
 #endif
 
 Q_CONSTINIT QBasicMutex QMessagePattern::mutex;
+#ifdef QLOGGING_HAVE_BACKTRACE
+Q_CONSTINIT QBasicAtomicInteger<bool> QMessagePattern::hasBacktrace = Q_BASIC_ATOMIC_INITIALIZER(false);
+#endif
 
 QMessagePattern::QMessagePattern()
 {
@@ -1368,6 +1381,9 @@ void QMessagePattern::setPattern(const QString &pattern)
 
     literals.reset(new std::unique_ptr<const char[]>[literalsVar.size() + 1]);
     std::move(literalsVar.begin(), literalsVar.end(), &literals[0]);
+#ifdef QLOGGING_HAVE_BACKTRACE
+    hasBacktrace.storeRelaxed(!backtraceArgs.isEmpty());
+#endif
 }
 
 #if defined(QLOGGING_HAVE_BACKTRACE) && !defined(QT_BOOTSTRAPPED)
@@ -1537,6 +1553,50 @@ static QString formatBacktraceForLogMessage(const QMessagePattern::BacktracePara
 
 Q_GLOBAL_STATIC(QMessagePattern, qMessagePattern)
 
+#ifndef QT_BOOTSTRAPPED
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+namespace {
+// Where and when a message was logged, for messages formatted later by the
+// asynchronous output's writer thread.
+struct MessageOrigin
+{
+    qint64 threadId;
+    QThread *thread;
+    qint64 age;         // milliseconds since the message was logged
+};
+} // unnamed namespace
+
+Q_CONSTINIT static thread_local const MessageOrigin *deferredMessageOrigin = nullptr;
+#endif
+
+static qint64 messageThreadId()
+{
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    if (deferredMessageOrigin)
+        return deferredMessageOrigin->threadId;
+#endif
+    return qt_gettid();
+}
+
+static QThread *messageThread()
+{
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    if (deferredMessageOrigin)
+        return deferredMessageOrigin->thread;
+#endif
+    return QThread::currentThread();
+}
+
+static qint64 messageAge()
+{
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    if (deferredMessageOrigin)
+        return deferredMessageOrigin->age;
+#endif
+    return 0;
+}
+#endif // !QT_BOOTSTRAPPED
+
 /*!
     \relates <QtLogging>
     \since 5.4
@@ -1623,10 +1683,10 @@ QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, con
             message.append(QCoreApplication::applicationName());
         } else if (token == threadidTokenC) {
             // print the TID as decimal
-            message.append(QString::number(qt_gettid()));
+            message.append(QString::number(messageThreadId()));
         } else if (token == qthreadptrTokenC) {
             message.append("0x"_L1);
-            message.append(QString::number(qlonglong(QThread::currentThread()->currentThread()), 16));
+            message.append(QString::number(qlonglong(messageThread()), 16));
 #ifdef QLOGGING_HAVE_BACKTRACE
         } else if (token == backtraceTokenC) {
             QMessagePattern::BacktraceParams backtraceParams = pattern->backtraceArgs.at(backtraceArgsIdx);
@@ -1637,18 +1697,18 @@ QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, con
             QString timeFormat = pattern->timeArgs.at(timeArgsIdx);
             timeArgsIdx++;
             if (timeFormat == "process"_L1) {
-                quint64 ms = pattern->timer.elapsed();
+                quint64 ms = qMax<qint64>(pattern->timer.elapsed() - messageAge(), 0);
                 message.append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
             } else if (timeFormat == "boot"_L1) {
                 // just print the milliseconds since the elapsed timer reference
                 // like the Linux kernel does
-                qint64 ms = QDeadlineTimer::current().deadline();
+                qint64 ms = QDeadlineTimer::current().deadline() - messageAge();
                 message.append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
 #if QT_CONFIG(datestring)
             } else if (timeFormat.isEmpty()) {
-                    message.append(QDateTime::currentDateTime().toString(Qt::ISODate));
+                    message.append(QDateTime::currentDateTime().addMSecs(-messageAge()).toString(Qt::ISODate));
             } else {
-                message.append(QDateTime::currentDateTime().toString(timeFormat));
+                message.append(QDateTime::currentDateTime().addMSecs(-messageAge()).toString(timeFormat));
 #endif // QT_CONFIG(datestring)
             }
 #endif // !QT_BOOTSTRAPPED
@@ -1994,6 +2054,432 @@ static bool grabMessageHandler() { return true; }
 static void ungrabMessageHandler() { }
 #endif // (Q_COMPILER_THREAD_LOCAL)
 
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+namespace {
+/*
+    Hands messages for the default message handler over to a writer thread, so
+    that the logging thread only pays for copying the message into a buffer.
+
+    Each logging thread owns a single-producer/single-consumer ring buffer that
+    only it appends to and only the writer thread consumes from, so no lock is
+    taken on the logging path, except for registering a thread's buffer the
+    first time it logs. The writer formats the messages of all threads in the
+    order they were logged, reporting the thread and time they were logged at
+    (see MessageOrigin).
+*/
+class QAsyncMessageOutput
+{
+public:
+    using OverflowPolicy = QLoggingCategory::OverflowPolicy;
+
+    QAsyncMessageOutput();
+    ~QAsyncMessageOutput();
+
+    bool isEnabled() const { return enabled.loadRelaxed(); }
+    void setEnabled(bool enable, OverflowPolicy policy);
+
+    bool enqueue(QtMsgType type, const QMessageLogContext &context, const QString &message);
+    void flush();
+
+private:
+    struct Record
+    {
+        enum : quint8 { HasFile = 1, HasFunction = 2, HasCategory = 4 };
+
+        QString message;
+        QByteArray strings;         // file, function and category, each '\0'-terminated
+        qint64 timestamp = 0;       // QDeadlineTimer::current(), in nanoseconds
+        int line = 0;
+        QtMsgType type = QtDebugMsg;
+        quint8 flags = 0;
+    };
+
+    struct ThreadBuffer
+    {
+        static constexpr quint32 Capacity = 512;    // must be a power of two
+
+        alignas(64) QAtomicInteger<quint32> head;   // advanced by the writer thread
+        alignas(64) QAtomicInteger<quint32> tail;   // advanced by the logging thread
+        QAtomicInteger<quint32> dropped;
+        alignas(64) QAtomicInteger<quint32> written;
+        QAtomicInteger<bool> retired;
+        qint64 threadId = 0;
+        QThread *thread = nullptr;
+        Record records[Capacity];
+    };
+
+    struct ThreadBufferHolder
+    {
+        std::shared_ptr<ThreadBuffer> buffer;
+        ~ThreadBufferHolder()
+        {
+            // the writer thread releases the buffer once it is drained
+            if (buffer)
+                buffer->retired.storeRelease(true);
+            currentThreadBuffer = nullptr;
+            threadBufferReleased = true;
+        }
+    };
+
+    class Writer : public QThread
+    {
+    public:
+        explicit Writer(QAsyncMessageOutput *output) : output(output) {}
+    protected:
+        void run() override { output->run(); }
+    private:
+        QAsyncMessageOutput *output;
+    };
+
+    ThreadBuffer *threadBuffer();
+    void wakeWriter();
+    bool hasPending();
+    bool drain();
+    void output(const ThreadBuffer &buffer, QtMsgType type, const QMessageLogContext &context,
+                const QString &message, qint64 timestamp, qint64 now);
+    void run();
+
+    static thread_local ThreadBufferHolder threadBufferHolder;
+    static thread_local ThreadBuffer *currentThreadBuffer;
+    static thread_local bool threadBufferReleased;
+    static thread_local bool isWriterThread;
+
+    QAtomicInteger<bool> enabled;
+    QAtomicInt policy;
+    QAtomicInteger<bool> stopping;
+    QAtomicInteger<bool> writerSleeping;
+
+    QMutex mutex;                   // protects buffers and writer
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::unique_ptr<Writer> writer;
+
+    QMutex wakeMutex;
+    QWaitCondition wakeUp;          // the writer waits for messages
+    QWaitCondition drained;         // flush() and full buffers wait for the writer
+
+    struct Pending
+    {
+        ThreadBuffer *buffer;
+        Record record;
+    };
+    std::vector<Pending> batch;     // only used by the writer thread
+};
+
+thread_local QAsyncMessageOutput::ThreadBufferHolder QAsyncMessageOutput::threadBufferHolder;
+Q_CONSTINIT thread_local QAsyncMessageOutput::ThreadBuffer *QAsyncMessageOutput::currentThreadBuffer = nullptr;
+Q_CONSTINIT thread_local bool QAsyncMessageOutput::threadBufferReleased = false;
+Q_CONSTINIT thread_local bool QAsyncMessageOutput::isWriterThread = false;
+
+QAsyncMessageOutput::QAsyncMessageOutput()
+{
+    // make sure QT_MESSAGE_PATTERN has been parsed, and that the pattern
+    // outlives this object
+    qMessagePattern();
+
+    const QByteArray mode = qgetenv("QT_LOGGING_ASYNC");
+    if (mode == "1" || mode == "block")
+        setEnabled(true, OverflowPolicy::Block);
+    else if (mode == "drop")
+        setEnabled(true, OverflowPolicy::Drop);
+    else if (mode == "count")
+        setEnabled(true, OverflowPolicy::DropAndCount);
+}
+
+QAsyncMessageOutput::~QAsyncMessageOutput()
+{
+    enabled.storeRelaxed(false);
+    {
+        QMutexLocker locker(&wakeMutex);
+        stopping.storeRelaxed(true);
+        wakeUp.wakeOne();
+    }
+    // the writer drains all buffers before exiting
+    Writer *thread;
+    {
+        QMutexLocker locker(&mutex);
+        thread = writer.get();
+    }
+    if (thread)
+        thread->wait();
+}
+
+void QAsyncMessageOutput::setEnabled(bool enable, OverflowPolicy overflowPolicy)
+{
+    policy.storeRelaxed(int(overflowPolicy));
+    if (enabled.fetchAndStoreRelaxed(enable) && !enable)
+        flush();
+}
+
+QAsyncMessageOutput::ThreadBuffer *QAsyncMessageOutput::threadBuffer()
+{
+    if (Q_LIKELY(currentThreadBuffer))
+        return currentThreadBuffer;
+    if (threadBufferReleased)
+        return nullptr;
+
+    auto buffer = std::make_shared<ThreadBuffer>();
+    buffer->threadId = qt_gettid();
+    buffer->thread = QThread::currentThread();
+
+    QMutexLocker locker(&mutex);
+    if (stopping.loadRelaxed())
+        return nullptr;
+    if (!writer) {
+        writer = std::make_unique<Writer>(this);
+        writer->setObjectName(u"QAsyncMessageOutput"_s);
+        writer->start();
+    }
+    buffers.push_back(buffer);
+    currentThreadBuffer = buffer.get();
+    threadBufferHolder.buffer = std::move(buffer);
+    return currentThreadBuffer;
+}
+
+bool QAsyncMessageOutput::enqueue(QtMsgType type, const QMessageLogContext &context,
+                                  const QString &message)
+{
+#ifdef QLOGGING_HAVE_BACKTRACE
+    // the backtrace must be taken by the logging thread
+    if (QMessagePattern::hasBacktrace.loadRelaxed())
+        return false;
+#endif
+
+    ThreadBuffer *buffer = threadBuffer();
+    if (!buffer) {
+        // this thread is exiting: print what it logged so far ahead of
+        // the message, which the caller prints synchronously
+        flush();
+        return false;
+    }
+
+    const quint32 tail = buffer->tail.loadRelaxed();
+    while (tail - buffer->head.loadAcquire() == ThreadBuffer::Capacity) {
+        switch (OverflowPolicy(policy.loadRelaxed())) {
+        case OverflowPolicy::Block: {
+            // the writer advances head before it signals drained under
+            // wakeMutex, so checking head again under the lock cannot miss it
+            QMutexLocker locker(&wakeMutex);
+            if (stopping.loadRelaxed())
+                return false;
+            if (tail - buffer->head.loadAcquire() == ThreadBuffer::Capacity) {
+                wakeUp.wakeOne();
+                drained.wait(&wakeMutex);
+            }
+            continue;
+        }
+        case OverflowPolicy::DropAndCount:
+            buffer->dropped.fetchAndAddRelaxed(1);
+            Q_FALLTHROUGH();
+        case OverflowPolicy::Drop:
+            return true;
+        }
+    }
+
+    Record &record = buffer->records[tail % ThreadBuffer::Capacity];
+    record.message = message;
+    record.strings.clear();
+    record.flags = 0;
+    auto addString = [&record](const char *string, quint8 flag) {
+        if (string) {
+            record.strings.append(string, qstrlen(string) + 1);
+            record.flags |= flag;
+        }
+    };
+    addString(context.file, Record::HasFile);
+    addString(context.function, Record::HasFunction);
+    addString(context.category, Record::HasCategory);
+    record.timestamp = QDeadlineTimer::current().deadlineNSecs();
+    record.line = context.line;
+    record.type = type;
+    buffer->tail.storeRelease(tail + 1);
+
+    // pairs with the fence in run(): either the writer sees the new record
+    // before going to sleep, or we see that it is sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerSleeping.loadRelaxed())
+        wakeWriter();
+    return true;
+}
+
+void QAsyncMessageOutput::wakeWriter()
+{
+    QMutexLocker locker(&wakeMutex);
+    wakeUp.wakeOne();
+}
+
+bool QAsyncMessageOutput::hasPending()
+{
+    QMutexLocker locker(&mutex);
+    return std::any_of(buffers.cbegin(), buffers.cend(), [](const auto &buffer) {
+        return buffer->head.loadRelaxed() != buffer->tail.loadAcquire();
+    });
+}
+
+void QAsyncMessageOutput::flush()
+{
+    if (isWriterThread)
+        return;
+
+    std::vector<std::pair<std::shared_ptr<ThreadBuffer>, quint32>> pending;
+    {
+        QMutexLocker locker(&mutex);
+        if (!writer)
+            return;
+        for (const auto &buffer : buffers) {
+            const quint32 tail = buffer->tail.loadAcquire();
+            if (buffer->written.loadAcquire() != tail)
+                pending.emplace_back(buffer, tail);
+        }
+    }
+
+    auto isWritten = [](const auto &entry) {
+        return qint32(entry.second - entry.first->written.loadAcquire()) <= 0;
+    };
+    QMutexLocker locker(&wakeMutex);
+    while (!std::all_of(pending.cbegin(), pending.cend(), isWritten)) {
+        wakeUp.wakeOne();
+        drained.wait(&wakeMutex);
+    }
+}
+
+void QAsyncMessageOutput::output(const ThreadBuffer &buffer, QtMsgType type,
+                                 const QMessageLogContext &context, const QString &message,
+                                 qint64 timestamp, qint64 now)
+{
+    const MessageOrigin origin = { buffer.threadId, buffer.thread, (now - timestamp) / (1000 * 1000) };
+    deferredMessageOrigin = &origin;
+    msgHandlerGrabbed = true;
+    qDefaultMessageHandler(type, context, message);
+    msgHandlerGrabbed = false;
+    deferredMessageOrigin = nullptr;
+}
+
+bool QAsyncMessageOutput::drain()
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> current;
+    {
+        QMutexLocker locker(&mutex);
+        current = buffers;
+    }
+
+    for (const auto &buffer : current) {
+        quint32 head = buffer->head.loadRelaxed();
+        const quint32 tail = buffer->tail.loadAcquire();
+        for ( ; head != tail; ++head)
+            batch.push_back({ buffer.get(), std::move(buffer->records[head % ThreadBuffer::Capacity]) });
+        buffer->head.storeRelease(head);
+    }
+
+    // interleave the messages of all threads in the order they were logged;
+    // each thread's own messages are already in order
+    std::stable_sort(batch.begin(), batch.end(), [](const Pending &lhs, const Pending &rhs) {
+        return lhs.record.timestamp < rhs.record.timestamp;
+    });
+
+    const qint64 now = QDeadlineTimer::current().deadlineNSecs();
+    for (const Pending &pending : batch) {
+        const Record &record = pending.record;
+        const char *strings = record.strings.constData();
+        auto nextString = [&strings, &record](quint8 flag) -> const char * {
+            if (!(record.flags & flag))
+                return nullptr;
+            const char *string = strings;
+            strings += qstrlen(string) + 1;
+            return string;
+        };
+        const char *file = nextString(Record::HasFile);
+        const char *function = nextString(Record::HasFunction);
+        const char *category = nextString(Record::HasCategory);
+        const QMessageLogContext context(file, record.line, function, category);
+        output(*pending.buffer, record.type, context, record.message, record.timestamp, now);
+        pending.buffer->written.fetchAndAddRelease(1);
+    }
+    const bool wroteMessages = !batch.empty();
+    batch.clear();
+
+    for (const auto &buffer : current) {
+        if (const quint32 dropped = buffer->dropped.fetchAndStoreRelaxed(0)) {
+            const QMessageLogContext context(nullptr, 0, nullptr, "qt.core.logging");
+            const QString message = QString::fromLatin1("%1 messages were dropped from the "
+                                                        "asynchronous log output").arg(dropped);
+            output(*buffer, QtWarningMsg, context, message, now, now);
+        }
+    }
+
+    // release the buffers of threads that have exited
+    QMutexLocker locker(&mutex);
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const auto &buffer) {
+        return buffer->retired.loadAcquire()
+                && buffer->head.loadRelaxed() == buffer->tail.loadAcquire();
+    }), buffers.end());
+    return wroteMessages;
+}
+
+void QAsyncMessageOutput::run()
+{
+    isWriterThread = true;
+    for (;;) {
+        const bool wroteMessages = drain();
+
+        QMutexLocker locker(&wakeMutex);
+        drained.wakeAll();
+        if (wroteMessages)
+            continue;
+        if (stopping.loadRelaxed())
+            break;
+
+        writerSleeping.storeRelaxed(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!hasPending())
+            wakeUp.wait(&wakeMutex);
+        writerSleeping.storeRelaxed(false);
+    }
+}
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(QAsyncMessageOutput, asyncMessageOutput)
+
+static bool enqueueAsyncMessage(QtMsgType type, const QMessageLogContext &context,
+                                const QString &message)
+{
+    QAsyncMessageOutput *output = asyncMessageOutput();
+    return output && output->isEnabled() && output->enqueue(type, context, message);
+}
+#endif // QLOGGING_HAVE_ASYNC_OUTPUT
+
+namespace QtPrivate {
+
+void setAsynchronousMessageOutput(bool enable, QLoggingCategory::OverflowPolicy policy)
+{
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    if (QAsyncMessageOutput *output = asyncMessageOutput())
+        output->setEnabled(enable, policy);
+#else
+    Q_UNUSED(enable);
+    Q_UNUSED(policy);
+#endif
+}
+
+bool hasAsynchronousMessageOutput()
+{
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    QAsyncMessageOutput *output = asyncMessageOutput();
+    return output && output->isEnabled();
+#else
+    return false;
+#endif
+}
+
+void flushAsynchronousMessageOutput()
+{
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    if (asyncMessageOutput.exists())
+        asyncMessageOutput->flush();
+#endif
+}
+
+} // namespace QtPrivate
+
 static void qt_message_print(QtMsgType msgType, const QMessageLogContext &context, const QString &message)
 {
 #ifndef QT_BOOTSTRAPPED
@@ -2008,11 +2494,19 @@ static void qt_message_print(QtMsgType msgType, const QMessageLogContext &contex
     }
 #endif
 
+    // everything logged before a fatal message is printed ahead of it
+    if (msgType == QtFatalMsg)
+        flushAsynchronousMessageOutput();
+
     // prevent recursion in case the message handler generates messages
     // itself, e.g. by using Qt API
     if (grabMessageHandler()) {
         const auto ungrab = qScopeGuard([]{ ungrabMessageHandler(); });
         auto msgHandler = messageHandler.loadAcquire();
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+        if (!msgHandler && msgType != QtFatalMsg && enqueueAsyncMessage(msgType, context, message))
+            return;
+#endif
         (msgHandler ? msgHandler : qDefaultMessageHandler)(msgType, context, message);
     } else {
         fprintf(stderr, "%s\n", message.toLocal8Bit().constData());
@@ -2033,6 +2527,9 @@ static void qt_message_print(const QString &message)
 
 static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const QString &message)
 {
+    // a warning made fatal by QT_FATAL_WARNINGS may still be queued
+    flushAsynchronousMessageOutput();
+
 #if defined(Q_CC_MSVC_ONLY) && defined(QT_DEBUG) && defined(_DEBUG) && defined(_CRT_ERROR)
     wchar_t contextFileL[256];
     // we probably should let the compiler do this for us, by declaring QMessageLogContext::file to
@@ -2223,6 +2720,8 @@ void qErrnoWarning(int code, const char *msg, ...)
 
 QtMessageHandler qInstallMessageHandler(QtMessageHandler h)
 {
+    // messages logged so far go to the handler that was installed at the time
+    flushAsynchronousMessageOutput();
     const auto old = messageHandler.fetchAndStoreOrdered(h);
     if (old)
         return old;
@@ -2232,6 +2731,8 @@ QtMessageHandler qInstallMessageHandler(QtMessageHandler h)
 
 void qSetMessagePattern(const QString &pattern)
 {
+    // messages logged so far are formatted with the old pattern
+    flushAsynchronousMessageOutput();
     const auto locker = qt_scoped_lock(QMessagePattern::mutex);
 
     if (!qMessagePattern()->fromEnvironment)
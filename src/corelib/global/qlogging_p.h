@@ -16,6 +16,7 @@
 //
 
 #include <QtCore/private/qglobal_p.h>
+#include <QtCore/qloggingcategory.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -23,6 +24,10 @@ namespace QtPrivate {
 
 Q_CORE_EXPORT bool shouldLogToStderr();
 
+void setAsynchronousMessageOutput(bool enable, QLoggingCategory::OverflowPolicy policy);
+bool hasAsynchronousMessageOutput();
+void flushAsynchronousMessageOutput();
+
 }
 
 QT_END_NAMESPACE
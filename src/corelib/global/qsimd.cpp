@@ -44,10 +44,14 @@
 
 // copied from <asm/hwcap.h> (ARM):
 #define HWCAP2_AES   (1 << 0)
+#define HWCAP2_SHA1  (1 << 2)
+#define HWCAP2_SHA2  (1 << 3)
 #define HWCAP2_CRC32 (1 << 4)
 
 // copied from <asm/hwcap.h> (Aarch64)
 #define HWCAP_AES               (1 << 3)
+#define HWCAP_SHA1              (1 << 5)
+#define HWCAP_SHA2              (1 << 6)
 #define HWCAP_CRC32             (1 << 7)
 
 // copied from <linux/auxvec.h>
@@ -75,13 +79,17 @@ uint arraysize(T (&)[N])
  neon
  crc32
  aes
+ sha1
+ sha2
  */
 static const char features_string[] =
         "\0"
         " neon\0"
         " crc32\0"
-        " aes\0";
-static const int features_indices[] = { 0, 1, 7, 14 };
+        " aes\0"
+        " sha1\0"
+        " sha2\0";
+static const int features_indices[] = { 0, 1, 7, 14, 19, 25 };
 #elif defined(Q_PROCESSOR_MIPS)
 /* Data:
  dsp
@@ -123,6 +131,10 @@ static inline quint64 detectProcessorFeatures()
             features |= CpuFeatureCRC32;
         if (auxvHwCap & HWCAP_AES)
             features |= CpuFeatureAES;
+        if (auxvHwCap & HWCAP_SHA1)
+            features |= CpuFeatureSHA1;
+        if (auxvHwCap & HWCAP_SHA2)
+            features |= CpuFeatureSHA2;
 #  else
         // For ARM32:
         if (auxvHwCap & HWCAP_NEON)
@@ -132,6 +144,10 @@ static inline quint64 detectProcessorFeatures()
             features |= CpuFeatureCRC32;
         if (auxvHwCap & HWCAP2_AES)
             features |= CpuFeatureAES;
+        if (auxvHwCap & HWCAP2_SHA1)
+            features |= CpuFeatureSHA1;
+        if (auxvHwCap & HWCAP2_SHA2)
+            features |= CpuFeatureSHA2;
 #  endif
         return features;
     }
@@ -143,6 +159,10 @@ static inline quint64 detectProcessorFeatures()
         features |= feature ? CpuFeatureNEON : 0;
     if (sysctlbyname("hw.optional.armv8_crc32", &feature, &len, nullptr, 0) == 0)
         features |= feature ? CpuFeatureCRC32 : 0;
+    if (sysctlbyname("hw.optional.arm.FEAT_SHA1", &feature, &len, nullptr, 0) == 0)
+        features |= feature ? CpuFeatureSHA1 : 0;
+    if (sysctlbyname("hw.optional.arm.FEAT_SHA256", &feature, &len, nullptr, 0) == 0)
+        features |= feature ? CpuFeatureSHA2 : 0;
     // There is currently no optional value for crypto/AES.
 #if defined(__ARM_FEATURE_CRYPTO)
     features |= CpuFeatureAES;
@@ -152,8 +172,9 @@ static inline quint64 detectProcessorFeatures()
     features |= CpuFeatureNEON;
     if (IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE) != 0)
         features |= CpuFeatureCRC32;
+    // the v8 crypto instructions are AES, SHA-1 and SHA-256
     if (IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE) != 0)
-        features |= CpuFeatureAES;
+        features |= CpuFeatureAES | CpuFeatureSHA1 | CpuFeatureSHA2;
     return features;
 #endif
 #if defined(__ARM_NEON__) || defined(__ARM_NEON)
@@ -165,6 +186,9 @@ static inline quint64 detectProcessorFeatures()
 #if defined(__ARM_FEATURE_CRYPTO)
     features |= CpuFeatureAES;
 #endif
+#if defined(__ARM_FEATURE_SHA2)
+    features |= CpuFeatureSHA1 | CpuFeatureSHA2;
+#endif
 
     return features;
 }
@@ -569,7 +593,7 @@ uint64_t QT_MANGLE_NAMESPACE(qDetectCpuFeatures)()
 #if defined(Q_OS_LINUX) && defined(Q_PROCESSOR_ARM_64)
     // Yocto hard-codes CRC32+AES on. Since they are unlikely to be used
     // automatically by compilers, we can just add runtime check.
-    minFeatureTest &= ~(CpuFeatureAES|CpuFeatureCRC32);
+    minFeatureTest &= ~(CpuFeatureAES|CpuFeatureCRC32|CpuFeatureSHA1|CpuFeatureSHA2);
 #endif
 #if defined(Q_PROCESSOR_X86_64) && defined(cpu_feature_shstk)
     // Controlflow Enforcement Technology (CET) is an OS-assisted
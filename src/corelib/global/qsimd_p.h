@@ -313,6 +313,8 @@ enum CPUFeatures {
     CpuFeatureCRC32         = 4,
     CpuFeatureAES           = 8,
     CpuFeatureARM_CRYPTO    = CpuFeatureAES,
+    CpuFeatureSHA1          = 16,
+    CpuFeatureSHA2          = 32,
 #elif defined(Q_PROCESSOR_MIPS)
     CpuFeatureDSP           = 2,
     CpuFeatureDSPR2         = 4,
@@ -329,6 +331,9 @@ static const uint64_t qCompilerCpuFeatures = 0
 #if defined __ARM_FEATURE_CRYPTO
         | CpuFeatureAES
 #endif
+#if defined __ARM_FEATURE_SHA2
+        | CpuFeatureSHA1 | CpuFeatureSHA2
+#endif
 #if defined __mips_dsp
         | CpuFeatureDSP
 #endif
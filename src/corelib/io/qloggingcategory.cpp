@@ -3,6 +3,7 @@
 
 #include "qloggingcategory.h"
 #include "qloggingregistry_p.h"
+#include <QtCore/private/qlogging_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -149,6 +150,31 @@ Q_GLOBAL_STATIC(QLoggingCategory, qtDefaultCategory, qtDefaultCategoryName)
     custom filter via \l installFilter(). All filter rules are ignored in this
     case.
 
+    \section1 Asynchronous Output
+
+    By default, the thread that logs a message also formats it and writes it
+    to \c stderr or the system log. With \l setAsynchronousOutputEnabled(),
+    or by setting the \c QT_LOGGING_ASYNC environment variable to \c block,
+    \c drop or \c count, the default message handler instead hands each
+    message to a background thread, and the logging thread returns without
+    waiting for the output. The message pattern still reports the thread that
+    logged a message and the time it was logged at.
+
+    Messages are only passed on asynchronously while no custom message handler
+    is installed with qInstallMessageHandler(), and fatal messages are always
+    printed by the thread that logs them, after all pending messages.
+
+    \section1 Structured Output
+
+    The qCStructuredDebug(), qCStructuredInfo(), qCStructuredWarning() and
+    qCStructuredCritical() macros take a string literal format and typed
+    arguments instead of a stream. When \l setStructuredOutputFile() or the
+    \c QT_LOGGING_STRUCTURED_FILE environment variable names a file, they
+    write the category, the call site and the raw arguments to it in a compact
+    binary format, without formatting any text. The \c qtlogdump tool renders
+    such a file as text offline. Otherwise, their messages are formatted and
+    passed to the message handler like any other message.
+
     \section1 Printing the Category
 
     Use the \c %{category} placeholder to print the category in the default
@@ -385,6 +411,68 @@ void QLoggingCategory::setFilterRules(const QString &rules)
     QLoggingRegistry::instance()->setApiRules(rules);
 }
 
+/*!
+    \enum QLoggingCategory::OverflowPolicy
+    \since 6.7
+
+    This enum describes what happens to a message that is logged while the
+    asynchronous output of the logging thread is full.
+
+    \value Block           The logging thread waits until the message can be queued.
+    \value Drop            The message is discarded.
+    \value DropAndCount    The message is discarded, and a warning reporting the
+                           number of discarded messages is printed once there is
+                           room again.
+
+    \sa setAsynchronousOutputEnabled()
+*/
+
+/*!
+    \since 6.7
+
+    Enables the asynchronous output of the default message handler if \a enable
+    is \c true, and disables it otherwise. \a policy determines what happens
+    to messages logged by a thread whose queued messages have not been written
+    yet.
+
+    Disabling the asynchronous output writes all queued messages before
+    returning. The initial setting is taken from the \c QT_LOGGING_ASYNC
+    environment variable, which can be set to \c block, \c drop or \c count.
+
+    \sa isAsynchronousOutputEnabled(), flushAsynchronousOutput(),
+        {Asynchronous Output}
+*/
+void QLoggingCategory::setAsynchronousOutputEnabled(bool enable, OverflowPolicy policy)
+{
+    QtPrivate::setAsynchronousMessageOutput(enable, policy);
+}
+
+/*!
+    \since 6.7
+
+    Returns \c true if messages for the default message handler are written
+    by a background thread.
+
+    \sa setAsynchronousOutputEnabled()
+*/
+bool QLoggingCategory::isAsynchronousOutputEnabled()
+{
+    return QtPrivate::hasAsynchronousMessageOutput();
+}
+
+/*!
+    \since 6.7
+
+    Waits until all messages that were logged before this call and queued for
+    asynchronous output have been written.
+
+    \sa setAsynchronousOutputEnabled()
+*/
+void QLoggingCategory::flushAsynchronousOutput()
+{
+    QtPrivate::flushAsynchronousMessageOutput();
+}
+
 /*!
     \macro qCDebug(category)
     \relates QLoggingCategory
@@ -37,6 +37,18 @@ public:
 
     static void setFilterRules(const QString &rules);
 
+    enum class OverflowPolicy {
+        Block,
+        Drop,
+        DropAndCount
+    };
+    static void setAsynchronousOutputEnabled(bool enable,
+                                             OverflowPolicy policy = OverflowPolicy::Block);
+    static bool isAsynchronousOutputEnabled();
+    static void flushAsynchronousOutput();
+
+    static bool setStructuredOutputFile(const QString &fileName);
+
 private:
     void init(const char *category, QtMsgType severityLevel);
 
@@ -76,6 +76,20 @@ QT_BEGIN_NAMESPACE
 
     \internal
 */
+/*!
+    \fn virtual qintptr QNonContiguousByteDevice::fileHandle(qint64 *offset) const
+
+    Returns the native handle of the file the data at the read pointer
+    comes from, and stores the position of the read pointer in that file
+    in \a offset. The data can then be passed on by the operating system
+    without being read through readPointer(); advanceReadPointer() must
+    still be called for it.
+
+    Returns -1 if the data is not backed by a file, or no longer can be
+    sent this way because readPointer() has been used.
+
+    \internal
+*/
 /*!
     \fn void QNonContiguousByteDevice::readyRead()
 
@@ -247,7 +261,7 @@ QNonContiguousByteDeviceIoDeviceImpl::QNonContiguousByteDeviceIoDeviceImpl(QIODe
     : QNonContiguousByteDevice(),
     currentReadBuffer(nullptr), currentReadBufferSize(16*1024),
     currentReadBufferAmount(0), currentReadBufferPosition(0), totalAdvancements(0),
-    eof(false)
+    eof(false), readPointerUsed(false)
 {
     device = d;
     initialPosition = d->pos();
@@ -267,6 +281,7 @@ const char *QNonContiguousByteDeviceIoDeviceImpl::readPointer(qint64 maximumLeng
         return nullptr;
     }
 
+    readPointerUsed = true;
     if (currentReadBuffer == nullptr)
         currentReadBuffer = new QByteArray(currentReadBufferSize, '\0'); // lazy alloc
 
@@ -311,6 +326,15 @@ bool QNonContiguousByteDeviceIoDeviceImpl::advanceReadPointer(qint64 amount)
     // advancing over that what has actually been read before
     if (currentReadBufferPosition > currentReadBufferAmount) {
         qint64 i = currentReadBufferPosition - currentReadBufferAmount;
+        if (!device->isSequential()) {
+            // e.g. data that was sent with fileHandle(), skip it without reading it
+            const qint64 newPosition = device->pos() + i;
+            if (newPosition > device->size() || !device->seek(newPosition)) {
+                emit readProgress(totalAdvancements - i, size());
+                return false;
+            }
+            i = 0;
+        }
         while (i > 0) {
             if (device->getChar(nullptr) == false) {
                 emit readProgress(totalAdvancements - i, size());
@@ -367,6 +391,22 @@ qint64 QNonContiguousByteDeviceIoDeviceImpl::pos() const
     return device->pos();
 }
 
+qintptr QNonContiguousByteDeviceIoDeviceImpl::fileHandle(qint64 *offset) const
+{
+    // once data has been read into currentReadBuffer, the file position is
+    // no longer where the read pointer is
+    if (readPointerUsed || device->isSequential())
+        return -1;
+
+    // data still in the write buffer is not in the file yet
+    const QFileDevice *file = qobject_cast<const QFileDevice *>(device);
+    if (!file || file->handle() == -1 || file->bytesToWrite() > 0)
+        return -1;
+
+    *offset = device->pos();
+    return file->handle();
+}
+
 QByteDeviceWrappingIoDevice::QByteDeviceWrappingIoDevice(QNonContiguousByteDevice *bd) : QIODevice((QObject*)nullptr)
 {
     byteDevice = bd;
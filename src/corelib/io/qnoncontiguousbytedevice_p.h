@@ -35,6 +35,7 @@ public:
     virtual qint64 pos() const { return -1; }
     virtual bool reset() = 0;
     virtual qint64 size() const = 0;
+    virtual qintptr fileHandle(qint64 *offset) const { Q_UNUSED(offset); return -1; }
 
     virtual ~QNonContiguousByteDevice();
 
@@ -110,6 +111,7 @@ public:
     bool reset() override;
     qint64 size() const override;
     qint64 pos() const override;
+    qintptr fileHandle(qint64 *offset) const override;
 
 protected:
     QIODevice *device;
@@ -119,6 +121,7 @@ protected:
     qint64 currentReadBufferPosition;
     qint64 totalAdvancements;
     bool eof;
+    bool readPointerUsed;
     qint64 initialPosition;
 };
 
@@ -0,0 +1,531 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qstructuredlogging_p.h"
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qsysinfo.h>
+#include <QtCore/qthread.h>
+
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt::StringLiterals;
+
+/*
+    Binary format of the structured log output
+
+    The file starts with the 6 bytes "QTSLOG", a version byte (currently 1),
+    a flags byte (bit 0 is set if doubles and UTF-16 strings are stored
+    big-endian) and the time the file was opened, in milliseconds since the
+    epoch. All integers are stored as base-128 varints, least significant
+    group first; strings are a varint size followed by the bytes.
+
+    It is followed by records, each starting with a kind byte:
+
+    - 1, a category: id, name.
+    - 2, a call site: id, message type (one byte), format string, argument
+      types, file, function, line. The argument types are the codes listed
+      in qstructuredlogging.h, one per argument.
+    - 3, a message: call site id, category id, nanoseconds since the file was
+      opened, thread id, size of the arguments, and the arguments encoded
+      according to the argument types of the call site.
+
+    Category and call site records are written before the first message that
+    refers to them.
+*/
+
+namespace {
+enum RecordKind : char {
+    CategoryRecord = 1,
+    SiteRecord = 2,
+    MessageRecord = 3
+};
+
+constexpr char logMagic[] = "QTSLOG";
+constexpr qsizetype logMagicSize = sizeof(logMagic) - 1;
+constexpr char logVersion = 1;
+
+class QStructuredLogWriter
+{
+public:
+    QStructuredLogWriter()
+    {
+        const QString fileName = qEnvironmentVariable("QT_LOGGING_STRUCTURED_FILE");
+        if (!fileName.isEmpty())
+            open(fileName);
+    }
+
+    ~QStructuredLogWriter()
+    {
+        QMutexLocker locker(&mutex);
+        close();
+    }
+
+    bool isActive() const { return active.loadRelaxed(); }
+
+    bool setFileName(const QString &fileName)
+    {
+        QMutexLocker locker(&mutex);
+        close();
+        return fileName.isEmpty() || open(fileName);
+    }
+
+    void write(QtPrivate::QStructuredLogSite &site, const QLoggingCategory &category,
+               const char *format, const char *argumentTypes,
+               const QtPrivate::QStructuredLogBuffer &arguments);
+
+private:
+    bool open(const QString &fileName);
+    void close();
+    quint64 categoryId(const char *name, QtPrivate::QStructuredLogBuffer &record);
+
+    static void appendString(QtPrivate::QStructuredLogBuffer &record, QByteArrayView string)
+    {
+        QtPrivate::appendStructuredLogVarint(record, quint64(string.size()));
+        record.append(string.data(), string.size());
+    }
+
+    QAtomicInteger<bool> active;
+
+    // the rest is protected by the mutex
+    QMutex mutex;
+    QFile file;
+    QElapsedTimer timer;
+    int siteCount = 0;
+    std::vector<bool> definedSites;
+    struct Category
+    {
+        quint64 id;
+        QByteArray name;
+    };
+    QHash<const char *, Category> categories;
+};
+
+bool QStructuredLogWriter::open(const QString &fileName)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    timer.start();
+    definedSites.clear();
+    categories.clear();
+
+    QtPrivate::QStructuredLogBuffer header;
+    header.append(logMagic, logMagicSize);
+    header.append(logVersion);
+    header.append(char(QSysInfo::ByteOrder == QSysInfo::BigEndian ? 1 : 0));
+    QtPrivate::appendStructuredLogVarint(header, quint64(QDateTime::currentMSecsSinceEpoch()));
+    file.write(header.constData(), header.size());
+
+    active.storeRelaxed(true);
+    return true;
+}
+
+void QStructuredLogWriter::close()
+{
+    active.storeRelaxed(false);
+    if (file.isOpen())
+        file.close();
+}
+
+quint64 QStructuredLogWriter::categoryId(const char *name, QtPrivate::QStructuredLogBuffer &record)
+{
+    // categories are usually named by string literals; compare the contents
+    // anyway, in case a destroyed category's name was reused
+    auto it = categories.find(name);
+    if (it != categories.end() && it->name == name)
+        return it->id;
+
+    const Category category = { quint64(categories.size() + 1), QByteArray(name) };
+    categories.insert(name, category);
+    record.append(CategoryRecord);
+    QtPrivate::appendStructuredLogVarint(record, category.id);
+    appendString(record, category.name);
+    return category.id;
+}
+
+void QStructuredLogWriter::write(QtPrivate::QStructuredLogSite &site,
+                                 const QLoggingCategory &category, const char *format,
+                                 const char *argumentTypes,
+                                 const QtPrivate::QStructuredLogBuffer &arguments)
+{
+    QtPrivate::QStructuredLogBuffer record;
+
+    QMutexLocker locker(&mutex);
+    if (!file.isOpen())
+        return;
+
+    if (!site.id)
+        site.id = ++siteCount;
+    const size_t siteId = size_t(site.id);
+    if (definedSites.size() <= siteId)
+        definedSites.resize(siteId + 1);
+    if (!definedSites[siteId]) {
+        definedSites[siteId] = true;
+        record.append(SiteRecord);
+        QtPrivate::appendStructuredLogVarint(record, siteId);
+        record.append(char(site.type));
+        appendString(record, format);
+        appendString(record, argumentTypes);
+        appendString(record, site.file);
+        appendString(record, site.function);
+        QtPrivate::appendStructuredLogVarint(record, quint64(site.line));
+    }
+
+    const quint64 categoryIdentifier = categoryId(category.categoryName(), record);
+
+    record.append(MessageRecord);
+    QtPrivate::appendStructuredLogVarint(record, siteId);
+    QtPrivate::appendStructuredLogVarint(record, categoryIdentifier);
+    QtPrivate::appendStructuredLogVarint(record, quint64(timer.nsecsElapsed()));
+    QtPrivate::appendStructuredLogVarint(record, quint64(quintptr(QThread::currentThreadId())));
+    QtPrivate::appendStructuredLogVarint(record, quint64(arguments.size()));
+    record.append(arguments.constData(), arguments.size());
+
+    file.write(record.constData(), record.size());
+}
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(QStructuredLogWriter, structuredLogWriter)
+
+namespace QtPrivate {
+
+bool isStructuredLogOutputActive()
+{
+    QStructuredLogWriter *writer = structuredLogWriter();
+    return writer && writer->isActive();
+}
+
+void writeStructuredLog(QStructuredLogSite &site, const QLoggingCategory &category,
+                        const char *format, const char *argumentTypes,
+                        const QStructuredLogBuffer &arguments)
+{
+    if (QStructuredLogWriter *writer = structuredLogWriter())
+        writer->write(site, category, format, argumentTypes, arguments);
+}
+
+void writeStructuredLogAsText(const QStructuredLogSite &site, const QLoggingCategory &category,
+                              const char *format, const QString *arguments, qsizetype count)
+{
+    const QMessageLogContext context(site.file, site.line, site.function,
+                                     category.categoryName());
+    qt_message_output(site.type, context,
+                      formatStructuredLogMessage(QString::fromUtf8(format), arguments, count));
+}
+
+QString formatStructuredLogMessage(QStringView format, const QString *arguments, qsizetype count)
+{
+    auto isDigit = [](QChar c) { return c.unicode() >= u'0' && c.unicode() <= u'9'; };
+
+    QString result;
+    result.reserve(format.size());
+    qsizetype i = 0;
+    while (i < format.size()) {
+        const QChar c = format.at(i);
+        if (c == u'%' && i + 1 < format.size() && isDigit(format.at(i + 1))) {
+            // %1 to %99, like QString::arg()
+            qsizetype end = i + 1;
+            qsizetype n = 0;
+            while (end < format.size() && end < i + 3 && isDigit(format.at(end)))
+                n = n * 10 + format.at(end++).unicode() - u'0';
+            if (n >= 1 && n <= count) {
+                result += arguments[n - 1];
+                i = end;
+                continue;
+            }
+        }
+        result += c;
+        ++i;
+    }
+    return result;
+}
+
+} // namespace QtPrivate
+
+/*!
+    \since 6.7
+
+    Writes the messages of the qCStructuredDebug(), qCStructuredInfo(),
+    qCStructuredWarning() and qCStructuredCritical() macros to the file
+    \a fileName in a compact binary format, instead of formatting them as text
+    and passing them to the message handler. Returns \c true if the file could
+    be opened.
+
+    An empty \a fileName closes the file, and the messages are formatted as
+    text again. The initial file is taken from the
+    \c QT_LOGGING_STRUCTURED_FILE environment variable.
+
+    The \c qtlogdump tool renders the file as text.
+
+    \sa {Structured Output}
+*/
+bool QLoggingCategory::setStructuredOutputFile(const QString &fileName)
+{
+    QStructuredLogWriter *writer = structuredLogWriter();
+    return writer && writer->setFileName(fileName);
+}
+
+/*!
+    \macro qCStructuredDebug(category, format, ...)
+    \relates QLoggingCategory
+    \threadsafe
+    \since 6.7
+
+    Logs a debug message with the \a format and the arguments that follow it
+    in the logging category \a category, if the category is enabled for debug
+    messages. \a format must be a string literal, and refers to the arguments
+    with \c %1, \c %2 and so on, like QString::arg().
+
+    The arguments can be integers, enumerations, floating-point numbers,
+    \c bool, pointers, C strings, QString, QStringView, QLatin1StringView,
+    QUtf8StringView, QByteArray and QByteArrayView. They are only evaluated if
+    the category is enabled.
+
+    By default, the message is formatted and passed to the message handler
+    like a qCDebug() message. With structured output enabled through
+    QLoggingCategory::setStructuredOutputFile(), the category, the call site,
+    the format and the raw arguments are written to a binary file instead, and
+    the message is only formatted when the file is rendered.
+
+    Example:
+
+    \snippet qloggingcategory/main.cpp 30
+
+    \sa qCDebug(), QLoggingCategory::setStructuredOutputFile()
+*/
+
+/*!
+    \macro qCStructuredInfo(category, format, ...)
+    \relates QLoggingCategory
+    \threadsafe
+    \since 6.7
+
+    Logs an informational message with the \a format and the arguments that
+    follow it in the logging category \a category, if the category is enabled
+    for informational messages.
+
+    \sa qCStructuredDebug(), qCInfo()
+*/
+
+/*!
+    \macro qCStructuredWarning(category, format, ...)
+    \relates QLoggingCategory
+    \threadsafe
+    \since 6.7
+
+    Logs a warning with the \a format and the arguments that follow it in the
+    logging category \a category, if the category is enabled for warnings.
+
+    \sa qCStructuredDebug(), qCWarning()
+*/
+
+/*!
+    \macro qCStructuredCritical(category, format, ...)
+    \relates QLoggingCategory
+    \threadsafe
+    \since 6.7
+
+    Logs a critical message with the \a format and the arguments that follow
+    it in the logging category \a category, if the category is enabled for
+    critical messages.
+
+    \sa qCStructuredDebug(), qCCritical()
+*/
+
+QStructuredLogReader::QStructuredLogReader(const QByteArray &data)
+    : data(data)
+{
+    if (data.size() < logMagicSize + 2 || !data.startsWith(logMagic)
+            || data.at(logMagicSize) != logVersion)
+        return;
+
+    const bool bigEndian = data.at(logMagicSize + 1) & 1;
+    swapBytes = bigEndian != (QSysInfo::ByteOrder == QSysInfo::BigEndian);
+    offset = logMagicSize + 2;
+
+    quint64 msecs;
+    if (!readVarint(&msecs))
+        return;
+    startMSecs = qint64(msecs);
+    valid = true;
+}
+
+bool QStructuredLogReader::readVarint(quint64 *value)
+{
+    quint64 result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (offset >= data.size())
+            return false;
+        const uchar byte = uchar(data.at(offset++));
+        result |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool QStructuredLogReader::readBytes(QByteArrayView *bytes)
+{
+    quint64 size;
+    if (!readVarint(&size) || size > quint64(data.size() - offset))
+        return false;
+    *bytes = QByteArrayView(data.constData() + offset, qsizetype(size));
+    offset += qsizetype(size);
+    return true;
+}
+
+bool QStructuredLogReader::readArgument(char type, QString *string)
+{
+    quint64 value;
+    QByteArrayView bytes;
+    switch (type) {
+    case 'b':
+        if (offset >= data.size())
+            return false;
+        *string = data.at(offset++) ? u"true"_s : u"false"_s;
+        return true;
+    case 'i':
+        if (!readVarint(&value))
+            return false;
+        *string = QString::number(qint64(value >> 1) ^ -qint64(value & 1));
+        return true;
+    case 'u':
+        if (!readVarint(&value))
+            return false;
+        *string = QString::number(value);
+        return true;
+    case 'p':
+        if (!readVarint(&value))
+            return false;
+        *string = "0x"_L1 + QString::number(value, 16);
+        return true;
+    case 'd': {
+        if (data.size() - offset < qsizetype(sizeof(double)))
+            return false;
+        quint64 bits;
+        memcpy(&bits, data.constData() + offset, sizeof(bits));
+        offset += sizeof(bits);
+        if (swapBytes)
+            bits = qbswap(bits);
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        *string = QString::number(d);
+        return true;
+    }
+    case 's':
+        if (!readBytes(&bytes))
+            return false;
+        *string = QString::fromUtf8(bytes);
+        return true;
+    case 'l':
+        if (!readBytes(&bytes))
+            return false;
+        *string = QString::fromLatin1(bytes);
+        return true;
+    case 'S': {
+        if (!readVarint(&value) || value > quint64(data.size() - offset) / 2)
+            return false;
+        const qsizetype size = qsizetype(value);
+        QString result(size, Qt::Uninitialized);
+        memcpy(result.data(), data.constData() + offset, size * sizeof(char16_t));
+        offset += size * sizeof(char16_t);
+        if (swapBytes) {
+            for (QChar &c : result)
+                c = QChar(qbswap(quint16(c.unicode())));
+        }
+        *string = std::move(result);
+        return true;
+    }
+    }
+    return false;
+}
+
+/*!
+    \internal
+
+    Reads the next message into \a message. Returns \c false at the end of the
+    data, or if the data is corrupt, in which case hasError() returns \c true.
+*/
+bool QStructuredLogReader::readNext(Message *message)
+{
+    if (!valid || error)
+        return false;
+
+    auto fail = [this]() {
+        error = true;
+        return false;
+    };
+
+    while (offset < data.size()) {
+        switch (data.at(offset++)) {
+        case CategoryRecord: {
+            quint64 id;
+            QByteArrayView name;
+            if (!readVarint(&id) || !readBytes(&name))
+                return fail();
+            categories.insert(id, name.toByteArray());
+            break;
+        }
+        case SiteRecord: {
+            quint64 id, line;
+            QByteArrayView format, argumentTypes, file, function;
+            if (!readVarint(&id) || offset >= data.size())
+                return fail();
+            const auto type = QtMsgType(data.at(offset++));
+            if (!readBytes(&format) || !readBytes(&argumentTypes) || !readBytes(&file)
+                    || !readBytes(&function) || !readVarint(&line)) {
+                return fail();
+            }
+            sites.insert(id, Site{ type, QString::fromUtf8(format), argumentTypes.toByteArray(),
+                                   file.toByteArray(), function.toByteArray(), int(line) });
+            break;
+        }
+        case MessageRecord: {
+            quint64 siteId, categoryId, timestamp, threadId, size;
+            if (!readVarint(&siteId) || !readVarint(&categoryId) || !readVarint(&timestamp)
+                    || !readVarint(&threadId) || !readVarint(&size)
+                    || size > quint64(data.size() - offset)) {
+                return fail();
+            }
+            const auto site = sites.constFind(siteId);
+            const auto category = categories.constFind(categoryId);
+            if (site == sites.cend() || category == categories.cend())
+                return fail();
+
+            const qsizetype end = offset + qsizetype(size);
+            QVarLengthArray<QString, 8> arguments(site->argumentTypes.size());
+            for (qsizetype i = 0; i < arguments.size(); ++i) {
+                if (!readArgument(site->argumentTypes.at(i), &arguments[i]) || offset > end)
+                    return fail();
+            }
+            if (offset != end)
+                return fail();
+
+            message->type = site->type;
+            message->category = *category;
+            message->file = site->file;
+            message->function = site->function;
+            message->line = site->line;
+            message->threadId = threadId;
+            message->timestamp = qint64(timestamp);
+            message->message = QtPrivate::formatStructuredLogMessage(site->format,
+                                                                     arguments.constData(),
+                                                                     arguments.size());
+            return true;
+        }
+        default:
+            return fail();
+        }
+    }
+    return false;
+}
+
+QT_END_NAMESPACE
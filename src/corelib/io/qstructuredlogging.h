@@ -0,0 +1,169 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSTRUCTUREDLOGGING_H
+#define QSTRUCTUREDLOGGING_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qttypetraits.h>
+#include <QtCore/qutf8stringview.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <cstring>
+#include <type_traits>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+// One per qCStructured* call site, constant-initialized.
+struct QStructuredLogSite
+{
+    QtMsgType type;
+    const char *file;
+    int line;
+    const char *function;
+    int id;             // assigned by the binary output on first use
+};
+
+using QStructuredLogBuffer = QVarLengthArray<char, 256>;
+
+Q_CORE_EXPORT bool isStructuredLogOutputActive();
+Q_CORE_EXPORT void writeStructuredLog(QStructuredLogSite &site, const QLoggingCategory &category,
+                                      const char *format, const char *argumentTypes,
+                                      const QStructuredLogBuffer &arguments);
+Q_CORE_EXPORT void writeStructuredLogAsText(const QStructuredLogSite &site,
+                                            const QLoggingCategory &category, const char *format,
+                                            const QString *arguments, qsizetype count);
+
+inline void appendStructuredLogVarint(QStructuredLogBuffer &buffer, quint64 value)
+{
+    while (value >= 0x80) {
+        buffer.append(char(value | 0x80));
+        value >>= 7;
+    }
+    buffer.append(char(value));
+}
+
+// Type codes of the arguments, as recorded in the binary output:
+//   b: bool, i: signed integer, u: unsigned integer, d: double, p: pointer,
+//   s: UTF-8 string, l: Latin-1 string, S: UTF-16 string
+template <typename T>
+constexpr char structuredLogArgumentType()
+{
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool>)
+        return 'b';
+    else if constexpr (std::is_enum_v<U>)
+        return std::is_signed_v<std::underlying_type_t<U>> ? 'i' : 'u';
+    else if constexpr (std::is_integral_v<U>)
+        return std::is_signed_v<U> ? 'i' : 'u';
+    else if constexpr (std::is_floating_point_v<U>)
+        return 'd';
+    else if constexpr (std::is_same_v<U, const char *> || std::is_same_v<U, char *>
+                       || std::is_same_v<U, QByteArray> || std::is_same_v<U, QByteArrayView>
+                       || std::is_same_v<U, QUtf8StringView>)
+        return 's';
+    else if constexpr (std::is_same_v<U, QLatin1StringView>)
+        return 'l';
+    else if constexpr (std::is_same_v<U, QString> || std::is_same_v<U, QStringView>)
+        return 'S';
+    else if constexpr (std::is_pointer_v<U>)
+        return 'p';
+    else
+        static_assert(type_dependent_false<T>::value,
+                      "This type cannot be logged with the qCStructured macros");
+}
+
+template <typename T>
+void encodeStructuredLogArgument(QStructuredLogBuffer &buffer, const T &value)
+{
+    constexpr char type = structuredLogArgumentType<T>();
+    if constexpr (type == 'b') {
+        buffer.append(char(value));
+    } else if constexpr (type == 'i') {
+        const qint64 v = qint64(value);
+        appendStructuredLogVarint(buffer, (quint64(v) << 1) ^ quint64(v >> 63));
+    } else if constexpr (type == 'u') {
+        appendStructuredLogVarint(buffer, quint64(value));
+    } else if constexpr (type == 'd') {
+        const double v = double(value);
+        buffer.append(reinterpret_cast<const char *>(&v), sizeof(v));
+    } else if constexpr (type == 'p') {
+        appendStructuredLogVarint(buffer, quintptr(value));
+    } else if constexpr (type == 's' || type == 'l') {
+        QByteArrayView view;
+        if constexpr (std::is_pointer_v<std::decay_t<T>>) {
+            const char *string = value;
+            view = string ? QByteArrayView(string, qsizetype(std::strlen(string))) : view;
+        } else {
+            view = QByteArrayView(value.data(), value.size());
+        }
+        appendStructuredLogVarint(buffer, quint64(view.size()));
+        buffer.append(view.data(), view.size());
+    } else if constexpr (type == 'S') {
+        const QStringView view(value);
+        appendStructuredLogVarint(buffer, quint64(view.size()));
+        buffer.append(reinterpret_cast<const char *>(view.utf16()), view.size() * sizeof(char16_t));
+    }
+}
+
+template <typename T>
+QString structuredLogArgumentToString(const T &value)
+{
+    constexpr char type = structuredLogArgumentType<T>();
+    if constexpr (type == 'b')
+        return value ? QStringLiteral("true") : QStringLiteral("false");
+    else if constexpr (type == 'i')
+        return QString::number(qint64(value));
+    else if constexpr (type == 'u')
+        return QString::number(quint64(value));
+    else if constexpr (type == 'd')
+        return QString::number(double(value));
+    else if constexpr (type == 'p')
+        return QLatin1StringView("0x") + QString::number(quintptr(value), 16);
+    else if constexpr (type == 's' && std::is_pointer_v<std::decay_t<T>>)
+        return QString::fromUtf8(static_cast<const char *>(value));
+    else if constexpr (type == 's')
+        return QString::fromUtf8(value.data(), value.size());
+    else if constexpr (type == 'l')
+        return QString(value);
+    else if constexpr (type == 'S')
+        return QStringView(value).toString();
+}
+
+template <size_t N, typename... Args>
+void logStructured(QStructuredLogSite &site, const QLoggingCategory &category,
+                   const char (&format)[N], const Args &...args)
+{
+    static constexpr char argumentTypes[] = { structuredLogArgumentType<Args>()..., '\0' };
+    if (isStructuredLogOutputActive()) {
+        QStructuredLogBuffer arguments;
+        (encodeStructuredLogArgument(arguments, args), ...);
+        writeStructuredLog(site, category, format, argumentTypes, arguments);
+    } else {
+        const QString strings[] = { structuredLogArgumentToString(args)..., QString() };
+        writeStructuredLogAsText(site, category, format, strings, qsizetype(sizeof...(Args)));
+    }
+}
+
+} // namespace QtPrivate
+
+#define QT_STRUCTURED_LOGGER_COMMON(categoryFunction, level, ...) \
+    for (QLoggingCategoryMacroHolder<level> qt_category(categoryFunction()); qt_category; qt_category.control = false) \
+        for (static QtPrivate::QStructuredLogSite qt_site = \
+                { level, __FILE__, __LINE__, QT_MESSAGELOG_FUNC, 0 }; \
+             qt_category; qt_category.control = false) \
+            QtPrivate::logStructured(qt_site, *qt_category.category, __VA_ARGS__)
+
+#define qCStructuredDebug(category, ...) QT_STRUCTURED_LOGGER_COMMON(category, QtDebugMsg, __VA_ARGS__)
+#define qCStructuredInfo(category, ...) QT_STRUCTURED_LOGGER_COMMON(category, QtInfoMsg, __VA_ARGS__)
+#define qCStructuredWarning(category, ...) QT_STRUCTURED_LOGGER_COMMON(category, QtWarningMsg, __VA_ARGS__)
+#define qCStructuredCritical(category, ...) QT_STRUCTURED_LOGGER_COMMON(category, QtCriticalMsg, __VA_ARGS__)
+
+QT_END_NAMESPACE
+
+#endif // QSTRUCTUREDLOGGING_H
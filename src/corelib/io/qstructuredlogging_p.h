@@ -0,0 +1,82 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSTRUCTUREDLOGGING_P_H
+#define QSTRUCTUREDLOGGING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qstructuredlogging.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+Q_CORE_EXPORT QString formatStructuredLogMessage(QStringView format, const QString *arguments,
+                                                 qsizetype count);
+}
+
+// Decodes the binary output written for the qCStructured* macros.
+class Q_CORE_EXPORT QStructuredLogReader
+{
+public:
+    struct Message
+    {
+        QtMsgType type = QtDebugMsg;
+        QByteArray category;
+        QByteArray file;
+        QByteArray function;
+        int line = 0;
+        quint64 threadId = 0;
+        qint64 timestamp = 0;       // nanoseconds since startTime()
+        QString message;
+    };
+
+    explicit QStructuredLogReader(const QByteArray &data);
+
+    bool isValid() const { return valid; }
+    bool hasError() const { return error; }
+    QDateTime startTime() const { return QDateTime::fromMSecsSinceEpoch(startMSecs); }
+
+    bool readNext(Message *message);
+
+private:
+    struct Site
+    {
+        QtMsgType type;
+        QString format;
+        QByteArray argumentTypes;
+        QByteArray file;
+        QByteArray function;
+        int line;
+    };
+
+    bool readVarint(quint64 *value);
+    bool readBytes(QByteArrayView *bytes);
+    bool readArgument(char type, QString *string);
+
+    QByteArray data;
+    qsizetype offset = 0;
+    qint64 startMSecs = 0;
+    bool swapBytes = false;
+    bool valid = false;
+    bool error = false;
+    QHash<quint64, QByteArray> categories;
+    QHash<quint64, Site> sites;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSTRUCTUREDLOGGING_P_H
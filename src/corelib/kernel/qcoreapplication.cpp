@@ -486,6 +486,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         const auto locker = qt_scoped_lock(thisThreadData->postEventList.mutex);
+        thisThreadData->mergePendingPostEventIntake();
         for (const QPostEvent &pe : std::as_const(thisThreadData->postEventList)) {
             if (pe.event) {
                 --pe.receiver->d_func()->postedEvents;
@@ -1580,6 +1581,7 @@ QCoreApplicationPrivate::QPostEventListLocker QCoreApplicationPrivate::lockThrea
     if (!object) {
         locker.threadData = QThreadData::current();
         locker.locker = qt_unique_lock(locker.threadData->postEventList.mutex);
+        locker.threadData->mergePendingPostEventIntake();
         return locker;
     }
 
@@ -1602,6 +1604,8 @@ QCoreApplicationPrivate::QPostEventListLocker QCoreApplicationPrivate::lockThrea
     }
 
     Q_ASSERT(locker.threadData);
+    // keep the order of events posted through the intake before this call
+    locker.threadData->mergePendingPostEventIntake();
     return locker;
 }
 
@@ -1643,6 +1647,44 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    // Queued calls are never compressed, so if they come from another thread
+    // they can skip the receiving thread's lock and go through the intake.
+    if (event->type() == QEvent::MetaCall) {
+        // synchronizes with the storeRelease in QObject::moveToThread
+        QThreadData *data = receiver->d_func()->threadData.loadAcquire();
+        const quint32 moveGeneration = data ? data->postEventList.moveGeneration.loadAcquire() : 0;
+        // moveToThread() publishes the new thread data before it bumps the
+        // generation, so this sees any move that the snapshot missed
+        if (data && data->threadId.loadRelaxed() != QThread::currentThreadId()
+            && receiver->d_func()->threadData.loadAcquire() == data) {
+            std::unique_ptr<QEvent> eventDeleter(event);
+            auto *node = new QPostEventList::IntakeNode{ QPostEvent(receiver, event, priority),
+                                                         nullptr };
+            Q_UNUSED(eventDeleter.release());
+            Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
+            event->m_posted = true;
+            ++receiver->d_func()->postedEvents;
+            // once the event is in the intake, the receiver may be deleted and
+            // its thread may finish: keep the thread data alive until we are done
+            // and don't touch the receiver anymore
+            data->ref();
+            data->postEventList.pushIntake(node);
+
+            // If an object was moved out of this thread in the meantime,
+            // moveToThread() may have merged the intake before our push. Merge
+            // it again, this forwards the event if the receiver was the one.
+            if (Q_UNLIKELY(data->postEventList.moveGeneration.loadAcquire() != moveGeneration)) {
+                const auto locker = qt_scoped_lock(data->postEventList.mutex);
+                data->mergePostEventIntake();
+            }
+
+            if (QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire())
+                dispatcher->wakeUp();
+            data->deref();
+            return;
+        }
+    }
+
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     if (!locker.threadData) {
         // posting during destruction? just delete the event to prevent a leak
@@ -1798,6 +1840,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     auto locker = qt_unique_lock(data->postEventList.mutex);
+    data->mergePendingPostEventIntake();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -2017,6 +2060,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     const auto locker = qt_scoped_lock(data->postEventList.mutex);
+    data->mergePendingPostEventIntake();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
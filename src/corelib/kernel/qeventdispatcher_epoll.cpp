@@ -0,0 +1,500 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qplatformdefs.h"
+
+#include "qcoreapplication.h"
+#include "qsocketnotifier.h"
+#include "qthread.h"
+
+#include "qeventdispatcher_epoll_p.h"
+#include <private/qthread_p.h>
+#include <private/qcoreapplication_p.h>
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <sys/timerfd.h>
+
+QT_BEGIN_NAMESPACE
+
+// upper bound for the number of events fetched by a single epoll_wait() call;
+// anything beyond this is simply reported by the next call (epoll is level-triggered)
+static constexpr qsizetype MaxReadyEvents = 4096;
+
+// epoll events are handed to QSocketNotifierSetUNIX::markPending() as poll() events
+static_assert(EPOLLIN == POLLIN && EPOLLOUT == POLLOUT && EPOLLPRI == POLLPRI
+              && EPOLLERR == POLLERR && EPOLLHUP == POLLHUP);
+
+static const char *socketType(QSocketNotifier::Type type)
+{
+    switch (type) {
+    case QSocketNotifier::Read:
+        return "Read";
+    case QSocketNotifier::Write:
+        return "Write";
+    case QSocketNotifier::Exception:
+        return "Exception";
+    }
+
+    Q_UNREACHABLE();
+}
+
+static quint32 epollEvents(const QSocketNotifierSetUNIX &sn_set)
+{
+    quint32 result = 0;
+
+    if (sn_set.notifiers[QSocketNotifier::Read])
+        result |= EPOLLIN;
+
+    if (sn_set.notifiers[QSocketNotifier::Write])
+        result |= EPOLLOUT;
+
+    if (sn_set.notifiers[QSocketNotifier::Exception])
+        result |= EPOLLPRI;
+
+    return result;
+}
+
+QEventDispatcherEpollPrivate::QEventDispatcherEpollPrivate()
+{
+    if (Q_UNLIKELY(threadPipe.init() == false))
+        qFatal("QEventDispatcherEpollPrivate(): Cannot continue without a thread pipe");
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1) {
+        qErrnoWarning("QEventDispatcherEpoll: epoll_create1 failed");
+        return;
+    }
+
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd == -1) {
+        qErrnoWarning("QEventDispatcherEpoll: timerfd_create failed");
+        return;
+    }
+
+    for (int fd : { threadPipe.fds[0], timerFd }) {
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+            qErrnoWarning("QEventDispatcherEpoll: cannot watch internal descriptor %d", fd);
+            qt_safe_close(timerFd);
+            timerFd = -1;
+            return;
+        }
+    }
+}
+
+QEventDispatcherEpollPrivate::~QEventDispatcherEpollPrivate()
+{
+    // cleanup timers
+    timerList.clearTimers();
+
+    if (timerFd >= 0)
+        qt_safe_close(timerFd);
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+}
+
+void QEventDispatcherEpollPrivate::updateWatch(int fd, const QSocketNotifierSetUNIX &sn_set,
+                                               bool isNew)
+{
+    if (sn_set.isEmpty()) {
+        // EBADF is expected here if the descriptor was closed before its notifier was
+        // disabled; the kernel has already dropped it from the interest list then.
+        if (!alwaysReadyFds.remove(fd))
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        return;
+    }
+
+    if (alwaysReadyFds.contains(fd))
+        return;
+
+    epoll_event ev = {};
+    ev.events = epollEvents(sn_set);
+    ev.data.fd = fd;
+
+    int ret = epoll_ctl(epollFd, isNew ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev);
+
+    // The descriptor may have been closed and reopened behind our back (the
+    // interest list forgets about it) or we may have missed an unregistration.
+    if (ret == -1 && errno == ENOENT && !isNew)
+        ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    else if (ret == -1 && errno == EEXIST && isNew)
+        ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+
+    if (ret == -1) {
+        if (errno == EPERM) {
+            // regular files and directories can't be watched, but poll() reports
+            // them as always readable and writable, so emulate that
+            alwaysReadyFds.insert(fd);
+            return;
+        }
+        qErrnoWarning("QEventDispatcherEpoll: cannot watch socket %d", fd);
+    }
+}
+
+bool QEventDispatcherEpollPrivate::armTimer(const timespec &timeout)
+{
+    itimerspec spec = {};
+    spec.it_value = timeout;
+    if (timerfd_settime(timerFd, 0, &spec, nullptr) == -1) {
+        qErrnoWarning("QEventDispatcherEpoll: timerfd_settime failed");
+        return false;
+    }
+    return true;
+}
+
+/*
+    Waits for the thread pipe, the timer descriptor and all registered socket
+    notifiers. The cost of a wakeup is proportional to the number of ready
+    descriptors, not to the number of registered ones. Returns the number of
+    events that were handled, or -1 on error.
+*/
+int QEventDispatcherEpollPrivate::waitForEvents(const timespec *timeout)
+{
+    int msecs = -1;
+    if (!alwaysReadyFds.isEmpty()) {
+        msecs = 0;
+    } else if (timeout) {
+        if (timeout->tv_sec == 0 && timeout->tv_nsec == 0)
+            msecs = 0;
+        else if (!armTimer(*timeout))
+            msecs = qMax<int>(1, timeout->tv_sec * 1000 + timeout->tv_nsec / (1000 * 1000));
+    }
+
+    readyEvents.resize(qBound(readyEvents.capacity(), socketNotifiers.size() + 2,
+                              MaxReadyEvents));
+
+    int ready;
+    do {
+        ready = epoll_wait(epollFd, readyEvents.data(), int(readyEvents.size()), msecs);
+    } while (ready == -1 && errno == EINTR);
+
+    if (ready == -1)
+        return -1;
+
+    // epoll reports every descriptor at most once per wait
+    const bool checkDuplicates = !pendingNotifiers.isEmpty();
+
+    int nevents = 0;
+    for (int i = 0; i < ready; ++i) {
+        const epoll_event &ev = readyEvents.at(i);
+        const int fd = ev.data.fd;
+
+        if (fd == threadPipe.fds[0]) {
+            pollfd pfd = threadPipe.prepare();
+            pfd.revents = POLLIN;
+            nevents += threadPipe.check(pfd);
+        } else if (fd == timerFd) {
+            // the timers themselves are activated by the caller
+            quint64 expirations;
+            Q_UNUSED(qt_safe_read(timerFd, &expirations, sizeof(expirations)));
+        } else {
+            auto it = socketNotifiers.constFind(fd);
+            if (it == socketNotifiers.cend()) {
+                // stale registration, e.g. a dup()ed descriptor that was closed while
+                // its notifier was still enabled: stop epoll from reporting it forever
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+                continue;
+            }
+            it.value().markPending(short(ev.events), pendingNotifiers, checkDuplicates);
+        }
+    }
+
+    for (int fd : std::as_const(alwaysReadyFds)) {
+        auto it = socketNotifiers.constFind(fd);
+        if (it != socketNotifiers.cend())
+            it.value().markPending(POLLIN | POLLOUT, pendingNotifiers, checkDuplicates);
+    }
+
+    return nevents + activateSocketNotifiers();
+}
+
+/*
+    Used when socket notifiers are excluded from processing: only the thread
+    pipe is polled, so that ready sockets don't keep waking us up.
+*/
+int QEventDispatcherEpollPrivate::waitForThreadPipe(const timespec *timeout)
+{
+    pollfd pfd = threadPipe.prepare();
+    switch (qt_safe_poll(&pfd, 1, timeout)) {
+    case -1:
+        return -1;
+    case 0:
+        return 0;
+    default:
+        return threadPipe.check(pfd);
+    }
+}
+
+int QEventDispatcherEpollPrivate::activateSocketNotifiers()
+{
+    if (pendingNotifiers.isEmpty())
+        return 0;
+
+    int n_activated = 0;
+    QEvent event(QEvent::SockAct);
+
+    while (!pendingNotifiers.isEmpty()) {
+        QSocketNotifier *notifier = pendingNotifiers.takeFirst();
+        QCoreApplication::sendEvent(notifier, &event);
+        ++n_activated;
+    }
+
+    return n_activated;
+}
+
+/*!
+    \internal
+    \class QEventDispatcherEpoll
+
+    An event dispatcher for Linux that keeps its socket notifiers registered
+    in an epoll instance, so that registering and unregistering them is
+    incremental and a wakeup costs O(ready descriptors) instead of O(registered
+    descriptors). Timers are still managed by QTimerInfoList, with a timerfd
+    providing the sub-millisecond wakeup; cross-thread wakeups go through the
+    eventfd of QThreadPipe.
+
+    It is selected instead of QEventDispatcherUNIX by setting the
+    \c QT_EVENT_DISPATCHER_EPOLL environment variable to a positive value.
+*/
+
+/*!
+    \internal
+
+    Returns a new epoll based event dispatcher, or \nullptr if the kernel
+    resources it needs could not be allocated.
+*/
+QEventDispatcherEpoll *QEventDispatcherEpoll::create(QObject *parent)
+{
+    auto dispatcher = new QEventDispatcherEpoll(parent);
+    if (!dispatcher->d_func()->isValid()) {
+        delete dispatcher;
+        return nullptr;
+    }
+    return dispatcher;
+}
+
+QEventDispatcherEpoll::QEventDispatcherEpoll(QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherEpollPrivate, parent)
+{ }
+
+QEventDispatcherEpoll::~QEventDispatcherEpoll()
+{ }
+
+/*!
+    \internal
+*/
+void QEventDispatcherEpoll::registerTimer(int timerId, qint64 interval, Qt::TimerType timerType, QObject *obj)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1 || interval < 0 || !obj) {
+        qWarning("QEventDispatcherEpoll::registerTimer: invalid arguments");
+        return;
+    } else if (obj->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::registerTimer: timers cannot be started from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    d->timerList.registerTimer(timerId, std::chrono::milliseconds{ interval }, timerType, obj);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimer(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: invalid argument");
+        return false;
+    } else if (thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimer: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimer(timerId);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherEpoll::unregisterTimers(QObject *object)
+{
+#ifndef QT_NO_DEBUG
+    if (!object) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: invalid argument");
+        return false;
+    } else if (object->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherEpoll::unregisterTimers: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.unregisterTimers(object);
+}
+
+QList<QEventDispatcherEpoll::TimerInfo>
+QEventDispatcherEpoll::registeredTimers(QObject *object) const
+{
+    if (!object) {
+        qWarning("QEventDispatcherEpoll:registeredTimers: invalid argument");
+        return QList<TimerInfo>();
+    }
+
+    Q_D(const QEventDispatcherEpoll);
+    return d->timerList.registeredTimers(object);
+}
+
+void QEventDispatcherEpoll::registerSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be enabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    auto it = d->socketNotifiers.find(sockfd);
+    const bool isNew = (it == d->socketNotifiers.end());
+    if (isNew)
+        it = d->socketNotifiers.insert(sockfd, QSocketNotifierSetUNIX());
+
+    QSocketNotifierSetUNIX &sn_set = it.value();
+
+    if (sn_set.notifiers[type] && sn_set.notifiers[type] != notifier)
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+
+    sn_set.notifiers[type] = notifier;
+    d->updateWatch(sockfd, sn_set, isNew);
+}
+
+void QEventDispatcherEpoll::unregisterSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifier (fd %d) cannot be disabled from another thread.\n"
+                "(Notifier's thread is %s(%p), event dispatcher's thread is %s(%p), current thread is %s(%p))",
+                sockfd,
+                notifier->thread() ? notifier->thread()->metaObject()->className() : "QThread", notifier->thread(),
+                thread() ? thread()->metaObject()->className() : "QThread", thread(),
+                QThread::currentThread() ? QThread::currentThread()->metaObject()->className() : "QThread", QThread::currentThread());
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+
+    d->pendingNotifiers.removeOne(notifier);
+
+    auto i = d->socketNotifiers.find(sockfd);
+    if (i == d->socketNotifiers.end())
+        return;
+
+    QSocketNotifierSetUNIX &sn_set = i.value();
+
+    if (sn_set.notifiers[type] == nullptr)
+        return;
+
+    if (sn_set.notifiers[type] != notifier) {
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+        return;
+    }
+
+    sn_set.notifiers[type] = nullptr;
+    d->updateWatch(sockfd, sn_set, false);
+
+    if (sn_set.isEmpty())
+        d->socketNotifiers.erase(i);
+}
+
+bool QEventDispatcherEpoll::processEvents(QEventLoop::ProcessEventsFlags flags)
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.storeRelaxed(0);
+
+    // we are awake, broadcast it
+    emit awake();
+
+    auto threadData = d->threadData.loadRelaxed();
+    QCoreApplicationPrivate::sendPostedEvents(nullptr, 0, threadData);
+
+    const bool include_timers = (flags & QEventLoop::X11ExcludeTimers) == 0;
+    const bool include_notifiers = (flags & QEventLoop::ExcludeSocketNotifiers) == 0;
+    const bool wait_for_events = (flags & QEventLoop::WaitForMoreEvents) != 0;
+
+    const bool canWait = (threadData->canWaitLocked()
+                          && !d->interrupt.loadRelaxed()
+                          && wait_for_events);
+
+    if (canWait)
+        emit aboutToBlock();
+
+    if (d->interrupt.loadRelaxed())
+        return false;
+
+    timespec *tm = nullptr;
+    timespec wait_tm = { 0, 0 };
+
+    if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
+        tm = &wait_tm;
+
+    int nevents = include_notifiers ? d->waitForEvents(tm) : d->waitForThreadPipe(tm);
+    if (nevents == -1) {
+        qErrnoWarning(include_notifiers ? "epoll_wait" : "qt_safe_poll");
+        if (QT_CONFIG(poll_exit_on_error))
+            abort();
+        nevents = 0;
+    }
+
+    if (include_timers)
+        nevents += d->timerList.activateTimers();
+
+    // return true if we handled events, false otherwise
+    return (nevents > 0);
+}
+
+int QEventDispatcherEpoll::remainingTime(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherEpoll::remainingTime: invalid argument");
+        return -1;
+    }
+#endif
+
+    Q_D(QEventDispatcherEpoll);
+    return d->timerList.timerRemainingTime(timerId);
+}
+
+void QEventDispatcherEpoll::wakeUp()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->threadPipe.wakeUp();
+}
+
+void QEventDispatcherEpoll::interrupt()
+{
+    Q_D(QEventDispatcherEpoll);
+    d->interrupt.storeRelaxed(1);
+    wakeUp();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qeventdispatcher_epoll_p.cpp"
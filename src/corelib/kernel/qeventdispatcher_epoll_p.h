@@ -0,0 +1,96 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QEVENTDISPATCHER_EPOLL_P_H
+#define QEVENTDISPATCHER_EPOLL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtCore/qabstracteventdispatcher.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qlist.h"
+#include "QtCore/qset.h"
+#include "QtCore/qvarlengtharray.h"
+#include "private/qabstracteventdispatcher_p.h"
+#include "private/qeventdispatcher_unix_p.h"
+#include "private/qtimerinfo_unix_p.h"
+
+#include <sys/epoll.h>
+
+QT_REQUIRE_CONFIG(epoll);
+
+QT_BEGIN_NAMESPACE
+
+class QEventDispatcherEpollPrivate;
+
+class Q_CORE_EXPORT QEventDispatcherEpoll : public QAbstractEventDispatcher
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QEventDispatcherEpoll)
+
+public:
+    static QEventDispatcherEpoll *create(QObject *parent = nullptr);
+    ~QEventDispatcherEpoll();
+
+    bool processEvents(QEventLoop::ProcessEventsFlags flags) override;
+
+    void registerSocketNotifier(QSocketNotifier *notifier) final;
+    void unregisterSocketNotifier(QSocketNotifier *notifier) final;
+
+    void registerTimer(int timerId, qint64 interval, Qt::TimerType timerType, QObject *object) final;
+    bool unregisterTimer(int timerId) final;
+    bool unregisterTimers(QObject *object) final;
+    QList<TimerInfo> registeredTimers(QObject *object) const final;
+
+    int remainingTime(int timerId) final;
+
+    void wakeUp() override;
+    void interrupt() final;
+
+private:
+    explicit QEventDispatcherEpoll(QObject *parent = nullptr);
+};
+
+class Q_CORE_EXPORT QEventDispatcherEpollPrivate : public QAbstractEventDispatcherPrivate
+{
+    Q_DECLARE_PUBLIC(QEventDispatcherEpoll)
+
+public:
+    QEventDispatcherEpollPrivate();
+    ~QEventDispatcherEpollPrivate();
+
+    bool isValid() const { return epollFd >= 0 && timerFd >= 0; }
+
+    void updateWatch(int fd, const QSocketNotifierSetUNIX &sn_set, bool isNew);
+    bool armTimer(const timespec &timeout);
+    int waitForEvents(const timespec *timeout);
+    int waitForThreadPipe(const timespec *timeout);
+
+    int activateSocketNotifiers();
+
+    QThreadPipe threadPipe;
+    int epollFd = -1;
+    int timerFd = -1;
+
+    QHash<int, QSocketNotifierSetUNIX> socketNotifiers;
+    // descriptors epoll refuses to watch (e.g. regular files); poll() reports them as always ready
+    QSet<int> alwaysReadyFds;
+    QList<QSocketNotifier *> pendingNotifiers;
+    QVarLengthArray<epoll_event, 64> readyEvents;
+
+    QTimerInfoList timerList;
+    QAtomicInt interrupt; // bool
+};
+
+QT_END_NAMESPACE
+
+#endif // QEVENTDISPATCHER_EPOLL_P_H
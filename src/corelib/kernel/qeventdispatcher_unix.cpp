@@ -187,6 +187,34 @@ void QEventDispatcherUNIXPrivate::setSocketNotifierPending(QSocketNotifier *noti
     pendingNotifiers << notifier;
 }
 
+/*
+    Appends the notifiers of this set that the poll() events \a revents make
+    ready to \a pending. Dispatchers that report every descriptor at most once
+    per wait only need the O(n) duplicate check if a nested event loop runs
+    while notifiers are still pending, so that check is left to the caller.
+*/
+void QSocketNotifierSetUNIX::markPending(short revents, QList<QSocketNotifier *> &pending,
+                                         bool checkDuplicates) const
+{
+    static const struct {
+        QSocketNotifier::Type type;
+        short flags;
+    } types[] = {
+        { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
+        { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
+        { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
+    };
+
+    for (const auto &t : types) {
+        QSocketNotifier *notifier = notifiers[t.type];
+        if (!notifier || !(revents & t.flags))
+            continue;
+        if (checkDuplicates && pending.contains(notifier))
+            continue;
+        pending << notifier;
+    }
+}
+
 int QEventDispatcherUNIXPrivate::activateTimers()
 {
     return timerList.activateTimers();
@@ -34,6 +34,9 @@ struct Q_CORE_EXPORT QSocketNotifierSetUNIX final
     inline bool isEmpty() const noexcept;
     inline short events() const noexcept;
 
+    void markPending(short revents, QList<QSocketNotifier *> &pending,
+                     bool checkDuplicates) const;
+
     QSocketNotifier *notifiers[3];
 };
 
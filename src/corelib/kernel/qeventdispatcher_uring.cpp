@@ -0,0 +1,662 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qplatformdefs.h"
+
+#include "qcoreapplication.h"
+#include "qsocketnotifier.h"
+#include "qthread.h"
+
+#include "qeventdispatcher_uring_p.h"
+#include <private/qthread_p.h>
+#include <private/qcoreapplication_p.h>
+#include <private/qcore_unix_p.h>
+
+#include <QtCore/qvarlengtharray.h>
+
+#include <errno.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+QT_BEGIN_NAMESPACE
+
+static constexpr unsigned RingEntries = 256;
+
+// user_data values of requests that are not socket polls; those always
+// carry a non-zero serial number in the upper 32 bits
+static constexpr quint64 IgnoredUserData = 0;
+static constexpr quint64 ThreadPipeUserData = 1;
+
+static inline unsigned loadAcquire(const unsigned *p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void storeRelease(unsigned *p, unsigned value)
+{
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+static const char *socketType(QSocketNotifier::Type type)
+{
+    switch (type) {
+    case QSocketNotifier::Read:
+        return "Read";
+    case QSocketNotifier::Write:
+        return "Write";
+    case QSocketNotifier::Exception:
+        return "Exception";
+    }
+
+    Q_UNREACHABLE();
+}
+
+static void preparePoll(io_uring_sqe *sqe, int fd, quint32 events, quint64 userData)
+{
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    events = (events << 16) | (events >> 16);
+#endif
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = events;
+    sqe->user_data = userData;
+}
+
+QEventDispatcherIoUringPrivate::QEventDispatcherIoUringPrivate()
+{
+    if (Q_UNLIKELY(threadPipe.init() == false))
+        qFatal("QEventDispatcherIoUringPrivate(): Cannot continue without a thread pipe");
+
+    setupRing();
+}
+
+QEventDispatcherIoUringPrivate::~QEventDispatcherIoUringPrivate()
+{
+    // cleanup timers
+    timerList.clearTimers();
+
+    if (sqes)
+        munmap(sqes, sqesSize);
+    if (cqRing && cqRing != sqRing)
+        munmap(cqRing, cqRingSize);
+    if (sqRing)
+        munmap(sqRing, sqRingSize);
+    if (ringFd >= 0)
+        qt_safe_close(ringFd);
+}
+
+/*
+    Creates the submission and completion rings and maps them into our address
+    space. Returns false if io_uring is unavailable (old kernel, seccomp filter,
+    disabled by sysctl) or lacks the features we rely on, in which case the
+    caller falls back to another event dispatcher.
+*/
+bool QEventDispatcherIoUringPrivate::setupRing()
+{
+    io_uring_params params = {};
+    ringFd = int(syscall(__NR_io_uring_setup, RingEntries, &params));
+    if (ringFd == -1)
+        return false;
+
+    // NODROP keeps completions that don't fit into the ring instead of losing
+    // them, EXT_ARG lets io_uring_enter() take a timeout without extra requests
+    constexpr quint32 requiredFeatures = IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ((params.features & requiredFeatures) != requiredFeatures)
+        return false;
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap)
+        sqRingSize = cqRingSize = qMax(sqRingSize, cqRingSize);
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        sqRing = nullptr;
+        return false;
+    }
+
+    if (singleMmap) {
+        cqRing = sqRing;
+    } else {
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            cqRing = nullptr;
+            return false;
+        }
+    }
+
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqesPtr = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ringFd, IORING_OFF_SQES);
+    if (sqesPtr == MAP_FAILED)
+        return false;
+    sqes = static_cast<io_uring_sqe *>(sqesPtr);
+
+    char *sq = static_cast<char *>(sqRing);
+    sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqEntries = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_entries);
+    sqLocalTail = *sqTail;
+
+    char *cq = static_cast<char *>(cqRing);
+    cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    return true;
+}
+
+/*
+    Returns the next free submission queue entry, cleared. Entries are only
+    handed to the kernel by the next enter(), so that everything queued during
+    one loop iteration goes out in a single system call. If the ring is full,
+    what was queued so far is submitted right away.
+*/
+io_uring_sqe *QEventDispatcherIoUringPrivate::nextSqe()
+{
+    if (sqLocalTail - loadAcquire(sqHead) >= sqEntries) {
+        enter(0, nullptr);
+        if (sqLocalTail - loadAcquire(sqHead) >= sqEntries) {
+            qWarning("QEventDispatcherIoUring: submission queue overflow");
+            return nullptr;
+        }
+    }
+
+    const unsigned index = sqLocalTail & sqMask;
+    io_uring_sqe *sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    ++sqLocalTail;
+    ++toSubmit;
+    return sqe;
+}
+
+/*
+    Submits all queued requests and, if \a minComplete is non-zero, waits until
+    that many completions are available or \a timeout expires. Returns 0 on
+    success (including timeouts) and -1 on error.
+*/
+int QEventDispatcherIoUringPrivate::enter(unsigned minComplete, const timespec *timeout)
+{
+    if (toSubmit == 0 && minComplete == 0)
+        return 0;
+
+    storeRelease(sqTail, sqLocalTail);
+
+    __kernel_timespec ts = {};
+    io_uring_getevents_arg arg = {};
+    arg.sigmask_sz = _NSIG / 8;
+    if (timeout) {
+        ts.tv_sec = timeout->tv_sec;
+        ts.tv_nsec = timeout->tv_nsec;
+        arg.ts = quintptr(&ts);
+    }
+
+    const unsigned flags = IORING_ENTER_EXT_ARG | (minComplete ? IORING_ENTER_GETEVENTS : 0);
+
+    int ret;
+    do {
+        ret = int(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags,
+                          &arg, sizeof(arg)));
+    } while (ret == -1 && errno == EINTR);
+
+    if (ret >= 0) {
+        toSubmit -= qMin(unsigned(ret), toSubmit);
+        return 0;
+    }
+
+    // ETIME: the timeout expired before minComplete completions arrived;
+    // EBUSY/EAGAIN: the completion queue is backed up, reaping will fix that
+    if (errno == ETIME || errno == EBUSY || errno == EAGAIN)
+        return 0;
+    return -1;
+}
+
+void QEventDispatcherIoUringPrivate::queuePoll(int fd, Watch &watch)
+{
+    Q_ASSERT(watch.userData == 0);
+
+    io_uring_sqe *sqe = nextSqe();
+    if (!sqe)
+        return;
+
+    if (++serial == 0)
+        serial = 1;
+    watch.userData = (quint64(serial) << 32) | quint32(fd);
+    preparePoll(sqe, fd, quint32(watch.notifiers.events()), watch.userData);
+}
+
+void QEventDispatcherIoUringPrivate::queuePollRemove(Watch &watch)
+{
+    if (watch.userData == 0)
+        return;
+
+    // whatever the old request completes with from now on is stale
+    const quint64 target = watch.userData;
+    watch.userData = 0;
+
+    io_uring_sqe *sqe = nextSqe();
+    if (!sqe)
+        return;
+
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = target;
+    sqe->user_data = IgnoredUserData;
+}
+
+/*
+    Called when the notifiers registered for \a fd change. The poll request in
+    flight (if any) watches the wrong set of events now, so cancel it and queue
+    a new one for the next submission.
+*/
+void QEventDispatcherIoUringPrivate::queueWatchUpdate(int fd)
+{
+    auto it = socketNotifiers.find(fd);
+    if (it == socketNotifiers.end())
+        return;
+
+    queuePollRemove(it.value());
+    if (it.value().notifiers.isEmpty()) {
+        socketNotifiers.erase(it);
+        // the poll request holds a reference to the file: submit the removal
+        // now, or a close() following the unregistration won't take effect
+        // before the next loop iteration
+        enter(0, nullptr);
+    } else {
+        pollQueue.append(fd);
+    }
+}
+
+void QEventDispatcherIoUringPrivate::submitPendingPolls()
+{
+    for (int fd : std::as_const(pollQueue)) {
+        auto it = socketNotifiers.find(fd);
+        if (it == socketNotifiers.end() || it.value().userData != 0)
+            continue;   // gone or already queued
+        queuePoll(fd, it.value());
+    }
+    pollQueue.clear();
+}
+
+void QEventDispatcherIoUringPrivate::markPendingSocketNotifiers(int fd,
+                                                                const QSocketNotifierSetUNIX &sn_set,
+                                                                int res)
+{
+    if (res < 0) {
+        // the request failed as a whole, typically with EBADF
+        for (int type = QSocketNotifier::Read; type <= QSocketNotifier::Exception; ++type) {
+            QSocketNotifier *notifier = sn_set.notifiers[type];
+            if (!notifier)
+                continue;
+            qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
+                     fd, socketType(QSocketNotifier::Type(type)));
+            notifier->setEnabled(false);
+        }
+        return;
+    }
+
+    // io_uring reports every descriptor at most once per wait
+    const bool checkDuplicates = !pendingNotifiers.isEmpty();
+    sn_set.markPending(short(res), pendingNotifiers, checkDuplicates);
+}
+
+/*
+    Processes all completions that are available. Completions of socket polls
+    are only collected here; they are handled by processSocketCompletions().
+*/
+int QEventDispatcherIoUringPrivate::reapCompletions()
+{
+    int nevents = 0;
+    unsigned head = *cqHead;
+    const unsigned tail = loadAcquire(cqTail);
+
+    // copy the completions out first: marking a notifier may disable it,
+    // which can submit requests and must not see a half-consumed ring
+    QVarLengthArray<io_uring_cqe, 64> completions;
+    for (; head != tail; ++head)
+        completions.append(cqes[head & cqMask]);
+    storeRelease(cqHead, head);
+
+    for (const io_uring_cqe &cqe : std::as_const(completions)) {
+        if (cqe.user_data == IgnoredUserData)
+            continue;
+
+        if (cqe.user_data == ThreadPipeUserData) {
+            threadPipeArmed = false;
+            pollfd pfd = threadPipe.prepare();
+            pfd.revents = cqe.res > 0 ? short(cqe.res) : 0;
+            nevents += threadPipe.check(pfd);
+            continue;
+        }
+
+        socketCompletions.append(cqe);
+    }
+
+    return nevents;
+}
+
+/*
+    Marks the socket notifiers of descriptors that became ready pending. Not
+    called while socket notifiers are excluded from processing, so their
+    completions stay queued until a pass that includes them. Poll requests are
+    only resubmitted once the notifiers had a chance to consume the data.
+*/
+void QEventDispatcherIoUringPrivate::processSocketCompletions()
+{
+    const QList<io_uring_cqe> completions = std::exchange(socketCompletions, {});
+    for (const io_uring_cqe &cqe : completions) {
+        const int fd = int(quint32(cqe.user_data));
+        auto it = socketNotifiers.find(fd);
+        if (it == socketNotifiers.end() || it.value().userData != cqe.user_data)
+            continue;   // cancelled or superseded
+
+        it.value().userData = 0;
+        if (cqe.res == -ECANCELED) {
+            // cancelled by the kernel rather than by us, just try again
+            pollQueue.append(fd);
+            continue;
+        }
+
+        readyFds.append(fd);
+        const QSocketNotifierSetUNIX sn_set = it.value().notifiers;
+        markPendingSocketNotifiers(fd, sn_set, cqe.res);
+    }
+}
+
+int QEventDispatcherIoUringPrivate::activateSocketNotifiers()
+{
+    int n_activated = 0;
+
+    if (!pendingNotifiers.isEmpty()) {
+        QEvent event(QEvent::SockAct);
+
+        while (!pendingNotifiers.isEmpty()) {
+            QSocketNotifier *notifier = pendingNotifiers.takeFirst();
+            QCoreApplication::sendEvent(notifier, &event);
+            ++n_activated;
+        }
+    }
+
+    // the notifiers got their chance to consume what was ready: watch again
+    pollQueue.append(readyFds);
+    readyFds.clear();
+
+    return n_activated;
+}
+
+/*!
+    \internal
+    \class QEventDispatcherIoUring
+
+    An event dispatcher for Linux built on io_uring. All requests queued during
+    a loop iteration (new and re-armed socket polls, cancellations and the
+    thread pipe poll) are submitted with the same io_uring_enter() call that
+    waits for completions, with the timeout derived from QTimerInfoList, so an
+    iteration costs a single system call in the common case.
+
+    Socket polls are one-shot: a poll is only re-armed after the notifiers of
+    its descriptor have been activated, which gives the same level-triggered
+    semantics as QEventDispatcherUNIX.
+
+    It is selected by setting the \c QT_EVENT_DISPATCHER_IO_URING environment
+    variable to a positive value. If the kernel doesn't support io_uring, or
+    lacks the features needed, the default event dispatcher is used instead.
+*/
+
+/*!
+    \internal
+
+    Returns a new io_uring based event dispatcher, or \nullptr if the kernel
+    doesn't support it.
+*/
+QEventDispatcherIoUring *QEventDispatcherIoUring::create(QObject *parent)
+{
+    auto dispatcher = new QEventDispatcherIoUring(parent);
+    if (!dispatcher->d_func()->isValid()) {
+        delete dispatcher;
+        return nullptr;
+    }
+    return dispatcher;
+}
+
+QEventDispatcherIoUring::QEventDispatcherIoUring(QObject *parent)
+    : QAbstractEventDispatcher(*new QEventDispatcherIoUringPrivate, parent)
+{ }
+
+QEventDispatcherIoUring::~QEventDispatcherIoUring()
+{ }
+
+/*!
+    \internal
+*/
+void QEventDispatcherIoUring::registerTimer(int timerId, qint64 interval, Qt::TimerType timerType, QObject *obj)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1 || interval < 0 || !obj) {
+        qWarning("QEventDispatcherIoUring::registerTimer: invalid arguments");
+        return;
+    } else if (obj->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherIoUring::registerTimer: timers cannot be started from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherIoUring);
+    d->timerList.registerTimer(timerId, std::chrono::milliseconds{ interval }, timerType, obj);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherIoUring::unregisterTimer(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherIoUring::unregisterTimer: invalid argument");
+        return false;
+    } else if (thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherIoUring::unregisterTimer: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherIoUring);
+    return d->timerList.unregisterTimer(timerId);
+}
+
+/*!
+    \internal
+*/
+bool QEventDispatcherIoUring::unregisterTimers(QObject *object)
+{
+#ifndef QT_NO_DEBUG
+    if (!object) {
+        qWarning("QEventDispatcherIoUring::unregisterTimers: invalid argument");
+        return false;
+    } else if (object->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QEventDispatcherIoUring::unregisterTimers: timers cannot be stopped from another thread");
+        return false;
+    }
+#endif
+
+    Q_D(QEventDispatcherIoUring);
+    return d->timerList.unregisterTimers(object);
+}
+
+QList<QEventDispatcherIoUring::TimerInfo>
+QEventDispatcherIoUring::registeredTimers(QObject *object) const
+{
+    if (!object) {
+        qWarning("QEventDispatcherIoUring:registeredTimers: invalid argument");
+        return QList<TimerInfo>();
+    }
+
+    Q_D(const QEventDispatcherIoUring);
+    return d->timerList.registeredTimers(object);
+}
+
+void QEventDispatcherIoUring::registerSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifiers cannot be enabled from another thread");
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherIoUring);
+    QSocketNotifierSetUNIX &sn_set = d->socketNotifiers[sockfd].notifiers;
+
+    if (sn_set.notifiers[type] && sn_set.notifiers[type] != notifier)
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+
+    sn_set.notifiers[type] = notifier;
+    d->queueWatchUpdate(sockfd);
+}
+
+void QEventDispatcherIoUring::unregisterSocketNotifier(QSocketNotifier *notifier)
+{
+    Q_ASSERT(notifier);
+    int sockfd = notifier->socket();
+    QSocketNotifier::Type type = notifier->type();
+#ifndef QT_NO_DEBUG
+    if (notifier->thread() != thread() || thread() != QThread::currentThread()) {
+        qWarning("QSocketNotifier: socket notifier (fd %d) cannot be disabled from another thread.\n"
+                "(Notifier's thread is %s(%p), event dispatcher's thread is %s(%p), current thread is %s(%p))",
+                sockfd,
+                notifier->thread() ? notifier->thread()->metaObject()->className() : "QThread", notifier->thread(),
+                thread() ? thread()->metaObject()->className() : "QThread", thread(),
+                QThread::currentThread() ? QThread::currentThread()->metaObject()->className() : "QThread", QThread::currentThread());
+        return;
+    }
+#endif
+
+    Q_D(QEventDispatcherIoUring);
+
+    d->pendingNotifiers.removeOne(notifier);
+
+    auto i = d->socketNotifiers.find(sockfd);
+    if (i == d->socketNotifiers.end())
+        return;
+
+    QSocketNotifierSetUNIX &sn_set = i.value().notifiers;
+
+    if (sn_set.notifiers[type] == nullptr)
+        return;
+
+    if (sn_set.notifiers[type] != notifier) {
+        qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
+                 Q_FUNC_INFO, sockfd, socketType(type));
+        return;
+    }
+
+    sn_set.notifiers[type] = nullptr;
+    d->queueWatchUpdate(sockfd);
+}
+
+bool QEventDispatcherIoUring::processEvents(QEventLoop::ProcessEventsFlags flags)
+{
+    Q_D(QEventDispatcherIoUring);
+    d->interrupt.storeRelaxed(0);
+
+    // we are awake, broadcast it
+    emit awake();
+
+    auto threadData = d->threadData.loadRelaxed();
+    QCoreApplicationPrivate::sendPostedEvents(nullptr, 0, threadData);
+
+    const bool include_timers = (flags & QEventLoop::X11ExcludeTimers) == 0;
+    const bool include_notifiers = (flags & QEventLoop::ExcludeSocketNotifiers) == 0;
+    const bool wait_for_events = (flags & QEventLoop::WaitForMoreEvents) != 0;
+
+    const bool canWait = (threadData->canWaitLocked()
+                          && !d->interrupt.loadRelaxed()
+                          && wait_for_events
+                          && (!include_notifiers || (d->pendingNotifiers.isEmpty()
+                                                     && d->socketCompletions.isEmpty())));
+
+    if (canWait)
+        emit aboutToBlock();
+
+    if (d->interrupt.loadRelaxed())
+        return false;
+
+    timespec *tm = nullptr;
+    timespec wait_tm = { 0, 0 };
+
+    if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
+        tm = &wait_tm;
+
+    if (include_notifiers)
+        d->submitPendingPolls();
+
+    if (!d->threadPipeArmed) {
+        if (io_uring_sqe *sqe = d->nextSqe()) {
+            preparePoll(sqe, d->threadPipe.fds[0], POLLIN, ThreadPipeUserData);
+            d->threadPipeArmed = true;
+        }
+    }
+
+    const bool block = !tm || tm->tv_sec != 0 || tm->tv_nsec != 0;
+    int nevents = 0;
+
+    if (d->enter(block ? 1 : 0, tm) == -1) {
+        qErrnoWarning("io_uring_enter");
+        if (QT_CONFIG(poll_exit_on_error))
+            abort();
+    }
+
+    nevents += d->reapCompletions();
+    if (include_notifiers) {
+        d->processSocketCompletions();
+        nevents += d->activateSocketNotifiers();
+    }
+
+    if (include_timers)
+        nevents += d->timerList.activateTimers();
+
+    // return true if we handled events, false otherwise
+    return (nevents > 0);
+}
+
+int QEventDispatcherIoUring::remainingTime(int timerId)
+{
+#ifndef QT_NO_DEBUG
+    if (timerId < 1) {
+        qWarning("QEventDispatcherIoUring::remainingTime: invalid argument");
+        return -1;
+    }
+#endif
+
+    Q_D(QEventDispatcherIoUring);
+    return d->timerList.timerRemainingTime(timerId);
+}
+
+void QEventDispatcherIoUring::wakeUp()
+{
+    Q_D(QEventDispatcherIoUring);
+    d->threadPipe.wakeUp();
+}
+
+void QEventDispatcherIoUring::interrupt()
+{
+    Q_D(QEventDispatcherIoUring);
+    d->interrupt.storeRelaxed(1);
+    wakeUp();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qeventdispatcher_uring_p.cpp"
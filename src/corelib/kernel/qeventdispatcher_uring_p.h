@@ -0,0 +1,128 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QEVENTDISPATCHER_URING_P_H
+#define QEVENTDISPATCHER_URING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtCore/qabstracteventdispatcher.h"
+#include "QtCore/qhash.h"
+#include "QtCore/qlist.h"
+#include "private/qabstracteventdispatcher_p.h"
+#include "private/qeventdispatcher_unix_p.h"
+#include "private/qtimerinfo_unix_p.h"
+
+#include <linux/io_uring.h>
+
+QT_REQUIRE_CONFIG(io_uring);
+
+QT_BEGIN_NAMESPACE
+
+class QEventDispatcherIoUringPrivate;
+
+class Q_CORE_EXPORT QEventDispatcherIoUring : public QAbstractEventDispatcher
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QEventDispatcherIoUring)
+
+public:
+    static QEventDispatcherIoUring *create(QObject *parent = nullptr);
+    ~QEventDispatcherIoUring();
+
+    bool processEvents(QEventLoop::ProcessEventsFlags flags) override;
+
+    void registerSocketNotifier(QSocketNotifier *notifier) final;
+    void unregisterSocketNotifier(QSocketNotifier *notifier) final;
+
+    void registerTimer(int timerId, qint64 interval, Qt::TimerType timerType, QObject *object) final;
+    bool unregisterTimer(int timerId) final;
+    bool unregisterTimers(QObject *object) final;
+    QList<TimerInfo> registeredTimers(QObject *object) const final;
+
+    int remainingTime(int timerId) final;
+
+    void wakeUp() override;
+    void interrupt() final;
+
+private:
+    explicit QEventDispatcherIoUring(QObject *parent = nullptr);
+};
+
+class Q_CORE_EXPORT QEventDispatcherIoUringPrivate : public QAbstractEventDispatcherPrivate
+{
+    Q_DECLARE_PUBLIC(QEventDispatcherIoUring)
+
+public:
+    QEventDispatcherIoUringPrivate();
+    ~QEventDispatcherIoUringPrivate();
+
+    // set up last, so only non-null if the rings were set up completely
+    bool isValid() const { return cqes != nullptr; }
+
+    struct Watch
+    {
+        QSocketNotifierSetUNIX notifiers;
+        quint64 userData = 0;   // of the poll request in flight, 0 if there is none
+    };
+
+    bool setupRing();
+    io_uring_sqe *nextSqe();
+    int enter(unsigned minComplete, const timespec *timeout);
+    int reapCompletions();
+    void processSocketCompletions();
+
+    void queuePoll(int fd, Watch &watch);
+    void queuePollRemove(Watch &watch);
+    void queueWatchUpdate(int fd);
+    void submitPendingPolls();
+
+    void markPendingSocketNotifiers(int fd, const QSocketNotifierSetUNIX &sn_set, int res);
+    int activateSocketNotifiers();
+
+    QThreadPipe threadPipe;
+    bool threadPipeArmed = false;
+
+    // the rings shared with the kernel
+    int ringFd = -1;
+    void *sqRing = nullptr;
+    void *cqRing = nullptr;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe *sqes = nullptr;
+    size_t sqesSize = 0;
+    unsigned *sqHead = nullptr;
+    unsigned *sqTail = nullptr;
+    unsigned *sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned sqLocalTail = 0;
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    io_uring_cqe *cqes = nullptr;
+    unsigned cqMask = 0;
+    unsigned toSubmit = 0;
+
+    quint32 serial = 0;
+    QHash<int, Watch> socketNotifiers;
+    QList<int> pollQueue;   // descriptors whose poll request needs to be (re)submitted
+    QList<int> readyFds;    // descriptors that completed but whose notifiers weren't activated yet
+    QList<io_uring_cqe> socketCompletions;  // socket polls that completed but weren't processed yet
+    QList<QSocketNotifier *> pendingNotifiers;
+
+    QTimerInfoList timerList;
+    QAtomicInt interrupt; // bool
+};
+
+QT_END_NAMESPACE
+
+#endif // QEVENTDISPATCHER_URING_P_H
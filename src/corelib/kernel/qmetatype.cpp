@@ -9,6 +9,7 @@
 #include "qobjectdefs.h"
 #include "qdatetime.h"
 #include "qbytearray.h"
+#include "qmutex.h"
 #include "qreadwritelock.h"
 #include "qhash.h"
 #include "qmap.h"
@@ -57,8 +58,10 @@
 #endif
 
 #include <bitset>
+#include <memory>
 #include <new>
 #include <cstring>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
@@ -82,27 +85,136 @@ struct QMetaTypeDeleter
     }
 };
 
+/*
+    The registry of custom types, by id and by name.
+
+    Lookups don't lock: they are done on hot paths (QVariant conversions,
+    queued connections, demarshalling) from many threads at once, and even a
+    read lock makes all of those threads write to the same cache line. So
+    both tables are built such that they can be read while they are being
+    modified: entries are published with release stores, and nothing that a
+    reader may be looking at is freed before the registry itself. Writers
+    are serialized by the mutex.
+*/
 struct QMetaTypeCustomRegistry
 {
+    using Interface = QtPrivate::QMetaTypeInterface;
+
+    // The interfaces by id, in segments of 64, 128, 256... entries that are
+    // allocated when first needed and never move.
+    static constexpr int FirstSegmentBits = 6;
+    static constexpr int SegmentCount = 32 - FirstSegmentBits;
+    QAtomicPointer<QAtomicPointer<const Interface>> segments[SegmentCount];
+
+    // The interfaces by name, including the typedefs, in an open-addressing
+    // hash table of Alias pointers. Aliases are never removed: unregistering
+    // a type resets the interface of its aliases.
+    struct Alias
+    {
+        QByteArray name;
+        size_t hash;
+        QAtomicPointer<const Interface> iface;
+    };
+    struct AliasTable
+    {
+        explicit AliasTable(size_t capacity)
+            : mask(capacity - 1), entries(new QAtomicPointer<Alias>[capacity])
+        {}
+        size_t mask;
+        std::unique_ptr<QAtomicPointer<Alias>[]> entries;
+    };
+    QAtomicPointer<AliasTable> aliasTable;
+
+    QMutex mutex;
+    // all the aliases and tables, including the ones readers may still use
+    std::vector<std::unique_ptr<Alias>> aliases;
+    std::vector<std::unique_ptr<AliasTable>> aliasTables;
+    // number of types in the id table, and index of the first empty
+    // (unregistered) one, if any
+    int typeCount = 0;
+    int firstEmpty = 0;
 
-#if QT_VERSION < QT_VERSION_CHECK(7, 0, 0) && !defined(QT_BOOTSTRAPPED)
     QMetaTypeCustomRegistry()
     {
+#if QT_VERSION < QT_VERSION_CHECK(7, 0, 0) && !defined(QT_BOOTSTRAPPED)
         /* qfloat16 was neither a builtin, nor unconditionally registered
           in QtCore in Qt <= 6.2.
           Inserting it as an alias ensures that a QMetaType::id call
           will get the correct built-in type-id (the interface pointers
           might still not match, but we already deal with that case.
         */
-        aliases.insert("qfloat16", QtPrivate::qMetaTypeInterfaceForType<qfloat16>());
-    }
+        aliasFor("qfloat16")->iface.storeRelaxed(QtPrivate::qMetaTypeInterfaceForType<qfloat16>());
 #endif
+    }
 
-    QReadWriteLock lock;
-    QList<const QtPrivate::QMetaTypeInterface *> registry;
-    QHash<QByteArray, const QtPrivate::QMetaTypeInterface *> aliases;
-    // index of first empty (unregistered) type in registry, if any.
-    int firstEmpty = 0;
+    ~QMetaTypeCustomRegistry()
+    {
+        for (auto &segment : segments)
+            delete[] segment.loadRelaxed();
+    }
+
+    static std::pair<int, int> segmentFor(int index)
+    {
+        const quint32 n = quint32(index) + (1U << FirstSegmentBits);
+        const int bits = 31 - qCountLeadingZeroBits(n);
+        return { bits - FirstSegmentBits, int(n - (1U << bits)) };
+    }
+
+    // must be called with the mutex locked
+    QAtomicPointer<const Interface> &typeSlot(int index)
+    {
+        const auto [segment, offset] = segmentFor(index);
+        QAtomicPointer<const Interface> *entries = segments[segment].loadRelaxed();
+        if (!entries) {
+            entries = new QAtomicPointer<const Interface>[size_t(1) << (segment + FirstSegmentBits)];
+            segments[segment].storeRelease(entries);
+        }
+        return entries[offset];
+    }
+
+    static const Alias *findAlias(const AliasTable *table, QByteArrayView name, size_t hash)
+    {
+        // there always is an empty entry
+        for (size_t i = hash & table->mask; ; i = (i + 1) & table->mask) {
+            const Alias *alias = table->entries[i].loadAcquire();
+            if (!alias || (alias->hash == hash && alias->name == name))
+                return alias;
+        }
+    }
+
+    // must be called with the mutex locked
+    Alias *aliasFor(const QByteArray &name)
+    {
+        const size_t hash = qHash(QByteArrayView(name));
+        AliasTable *table = aliasTable.loadRelaxed();
+        if (table) {
+            if (const Alias *alias = findAlias(table, name, hash))
+                return const_cast<Alias *>(alias);
+        }
+
+        // keep the table at most half full
+        if (!table || 2 * (aliases.size() + 1) > table->mask + 1) {
+            auto grown = std::make_unique<AliasTable>(table ? 2 * (table->mask + 1) : 64);
+            for (const auto &alias : aliases)
+                insertAlias(grown.get(), alias.get());
+            table = grown.get();
+            aliasTables.push_back(std::move(grown));
+            aliasTable.storeRelease(table);
+        }
+
+        Alias *alias = new Alias{ name, hash, {} };
+        aliases.emplace_back(alias);
+        insertAlias(table, alias);
+        return alias;
+    }
+
+    static void insertAlias(AliasTable *table, Alias *alias)
+    {
+        size_t i = alias->hash & table->mask;
+        while (table->entries[i].loadRelaxed())
+            i = (i + 1) & table->mask;
+        table->entries[i].storeRelease(alias);
+    }
 
     int registerCustomType(const QtPrivate::QMetaTypeInterface *cti)
     {
@@ -110,7 +222,7 @@ struct QMetaTypeCustomRegistry
         // (not read-only)
         auto ti = const_cast<QtPrivate::QMetaTypeInterface *>(cti);
         {
-            QWriteLocker l(&lock);
+            QMutexLocker l(&mutex);
             if (int id = ti->typeId.loadRelaxed())
                 return id;
             QByteArray name =
@@ -118,23 +230,20 @@ struct QMetaTypeCustomRegistry
                     QMetaObject::normalizedType
 #endif
                     (ti->name);
-            if (auto ti2 = aliases.value(name)) {
+            Alias *alias = aliasFor(name);
+            if (auto ti2 = alias->iface.loadRelaxed()) {
                 const auto id = ti2->typeId.loadRelaxed();
                 ti->typeId.storeRelaxed(id);
                 return id;
             }
-            aliases[name] = ti;
-            int size = registry.size();
-            while (firstEmpty < size && registry[firstEmpty])
+            while (firstEmpty < typeCount && typeSlot(firstEmpty).loadRelaxed())
                 ++firstEmpty;
-            if (firstEmpty < size) {
-                registry[firstEmpty] = ti;
-                ++firstEmpty;
-            } else {
-                registry.append(ti);
-                firstEmpty = registry.size();
-            }
+            typeSlot(firstEmpty).storeRelease(ti);
+            if (firstEmpty == typeCount)
+                ++typeCount;
+            ++firstEmpty;
             ti->typeId.storeRelaxed(firstEmpty + QMetaType::User);
+            alias->iface.storeRelease(ti);
         }
         if (ti->legacyRegisterOp)
             ti->legacyRegisterOp();
@@ -146,28 +255,47 @@ struct QMetaTypeCustomRegistry
         if (!id)
             return;
         Q_ASSERT(id > QMetaType::User);
-        QWriteLocker l(&lock);
+        QMutexLocker l(&mutex);
         int idx = id - QMetaType::User - 1;
-        auto &ti = registry[idx];
+        auto &slot = typeSlot(idx);
+        const Interface *ti = slot.loadRelaxed();
 
         // We must unregister all names.
-        auto it = aliases.begin();
-        while (it != aliases.end()) {
-            if (it.value() == ti)
-                it = aliases.erase(it);
-            else
-                ++it;
+        for (const auto &alias : aliases) {
+            if (alias->iface.loadRelaxed() == ti)
+                alias->iface.storeRelease(nullptr);
         }
 
-        ti = nullptr;
+        slot.storeRelease(nullptr);
 
         firstEmpty = std::min(firstEmpty, idx);
     }
 
-    const QtPrivate::QMetaTypeInterface *getCustomType(int id)
+    void registerTypedef(const QByteArray &name, const Interface *iface)
     {
-        QReadLocker l(&lock);
-        return registry.value(id - QMetaType::User - 1);
+        QMutexLocker l(&mutex);
+        Alias *alias = aliasFor(name);
+        if (!alias->iface.loadRelaxed())
+            alias->iface.storeRelease(iface);
+    }
+
+    const QtPrivate::QMetaTypeInterface *getCustomType(int id) const
+    {
+        const int idx = id - QMetaType::User - 1;
+        if (idx < 0)
+            return nullptr;
+        const auto [segment, offset] = segmentFor(idx);
+        const QAtomicPointer<const Interface> *entries = segments[segment].loadAcquire();
+        return entries ? entries[offset].loadAcquire() : nullptr;
+    }
+
+    const QtPrivate::QMetaTypeInterface *getCustomType(QByteArrayView name) const
+    {
+        const AliasTable *table = aliasTable.loadAcquire();
+        if (!table)
+            return nullptr;
+        const Alias *alias = findAlias(table, name, qHash(name));
+        return alias ? alias->iface.loadAcquire() : nullptr;
     }
 };
 
@@ -185,15 +313,15 @@ const char *QtMetaTypePrivate::typedefNameForType(const QtPrivate::QMetaTypeInte
     QMetaTypeCustomRegistry *r = &*customTypeRegistry;
 
     QByteArrayView officialName(type_d->name);
-    QReadLocker l(&r->lock);
-    auto it = r->aliases.constBegin();
-    auto end = r->aliases.constEnd();
+    QMutexLocker l(&r->mutex);
+    auto it = r->aliases.cbegin();
+    auto end = r->aliases.cend();
     for ( ; it != end; ++it) {
-        if (it.value() != type_d)
+        if ((*it)->iface.loadRelaxed() != type_d)
             continue;
-        if (it.key() == officialName)
+        if ((*it)->name == officialName)
             continue;               // skip the official name
-        name = it.key().constData();
+        name = (*it)->name.constData();
         ++it;
         break;
     }
@@ -201,8 +329,8 @@ const char *QtMetaTypePrivate::typedefNameForType(const QtPrivate::QMetaTypeInte
 #ifndef QT_NO_DEBUG
     QByteArrayList otherNames;
     for ( ; it != end; ++it) {
-        if (it.value() == type_d && it.key() != officialName)
-            otherNames << it.key();
+        if ((*it)->iface.loadRelaxed() == type_d && (*it)->name != officialName)
+            otherNames << (*it)->name;
     }
     l.unlock();
     if (!otherNames.isEmpty())
@@ -2690,19 +2818,14 @@ static inline int qMetaTypeStaticType(const char *typeName, int length)
 
 /*
     Similar to QMetaType::type(), but only looks in the custom set of
-    types, and doesn't lock the mutex.
-
+    types. This doesn't lock.
 */
-static int qMetaTypeCustomType_unlocked(const char *typeName, int length)
+static int qMetaTypeCustomType(const char *typeName, int length)
 {
     if (customTypeRegistry.exists()) {
         auto reg = &*customTypeRegistry;
-#if QT_CONFIG(thread)
-        Q_ASSERT(!reg->lock.tryLockForWrite());
-#endif
-        if (auto ti = reg->aliases.value(QByteArray::fromRawData(typeName, length), nullptr)) {
+        if (auto ti = reg->getCustomType(QByteArrayView(typeName, length)))
             return ti->typeId.loadRelaxed();
-        }
     }
     return QMetaType::UnknownType;
 }
@@ -2719,13 +2842,8 @@ void QMetaType::registerNormalizedTypedef(const NS(QByteArray) & normalizedTypeN
 {
     if (!metaType.isValid())
         return;
-    if (auto reg = customTypeRegistry()) {
-        QWriteLocker lock(&reg->lock);
-        auto &al = reg->aliases[normalizedTypeName];
-        if (al)
-            return;
-        al = metaType.d_ptr;
-    }
+    if (auto reg = customTypeRegistry())
+        reg->registerTypedef(normalizedTypeName, metaType.d_ptr);
 }
 
 
@@ -2760,16 +2878,15 @@ static inline int qMetaTypeTypeImpl(const char *typeName, int length)
         return QMetaType::UnknownType;
     int type = qMetaTypeStaticType(typeName, length);
     if (type == QMetaType::UnknownType) {
-        QReadLocker locker(&customTypeRegistry()->lock);
-        type = qMetaTypeCustomType_unlocked(typeName, length);
+        type = qMetaTypeCustomType(typeName, length);
 #ifndef QT_NO_QOBJECT
         if ((type == QMetaType::UnknownType) && tryNormalizedType) {
             const NS(QByteArray) normalizedTypeName = QMetaObject::normalizedType(typeName);
             type = qMetaTypeStaticType(normalizedTypeName.constData(),
                                        normalizedTypeName.size());
             if (type == QMetaType::UnknownType) {
-                type = qMetaTypeCustomType_unlocked(normalizedTypeName.constData(),
-                                                    normalizedTypeName.size());
+                type = qMetaTypeCustomType(normalizedTypeName.constData(),
+                                           normalizedTypeName.size());
             }
         }
 #endif
@@ -308,6 +308,11 @@ inline void QObjectPrivate::addConnection(int signal, Connection *c)
     cd->resizeSignalVector(signal + 1);
 
     ConnectionList &connectionList = cd->connectionsForSignal(signal);
+    // set the flag before the connection id is incremented: the (ordered)
+    // increment publishes it to doActivate(), which loads the id with acquire
+    // semantics before it reads the flag
+    if (!c->isDirectCall(threadData.loadRelaxed()))
+        connectionList.needsDispatch.storeRelaxed(true);
     if (connectionList.last.loadRelaxed()) {
         Q_ASSERT(connectionList.last.loadRelaxed()->receiver.loadRelaxed());
         connectionList.last.loadRelaxed()->nextConnectionList.storeRelaxed(c);
@@ -332,6 +337,8 @@ void QObjectPrivate::ConnectionData::removeConnection(QObjectPrivate::Connection
 {
     Q_ASSERT(c->receiver.loadRelaxed());
     ConnectionList &connections = signalVector.loadRelaxed()->at(c->signal_index);
+    const QThreadData *senderThreadData = QObjectPrivate::get(c->sender)->threadData.loadRelaxed();
+    const bool wasDirectCall = c->isDirectCall(senderThreadData);
     c->receiver.storeRelaxed(nullptr);
     QThreadData *td = c->receiverThreadData.loadRelaxed();
     if (td)
@@ -370,6 +377,9 @@ void QObjectPrivate::ConnectionData::removeConnection(QObjectPrivate::Connection
         c->prevConnectionList->nextConnectionList.storeRelaxed(n);
     c->prevConnectionList = nullptr;
 
+    if (!wasDirectCall && connections.needsDispatch.loadRelaxed())
+        updateNeedsDispatch(c->signal_index, senderThreadData);
+
     Q_ASSERT(c != static_cast<Connection *>(orphaned.load(std::memory_order_relaxed)));
     // add c to orphanedConnections
     TaggedSignalVector o = nullptr;
@@ -394,6 +404,18 @@ void QObjectPrivate::ConnectionData::removeConnection(QObjectPrivate::Connection
 
 }
 
+void QObjectPrivate::ConnectionData::updateNeedsDispatch(int signal,
+                                                         const QThreadData *senderThreadData)
+{
+    ConnectionList &connections = signalVector.loadRelaxed()->at(signal);
+    bool needsDispatch = false;
+    for (Connection *c = connections.first.loadRelaxed(); c && !needsDispatch;
+         c = c->nextConnectionList.loadRelaxed()) {
+        needsDispatch = !c->isDirectCall(senderThreadData);
+    }
+    connections.needsDispatch.storeRelaxed(needsDispatch);
+}
+
 void QObjectPrivate::ConnectionData::cleanOrphanedConnectionsImpl(QObject *sender, LockPolicy lockPolicy)
 {
     QBasicMutex *senderMutex = signalSlotLock(sender);
@@ -1716,6 +1738,9 @@ void QObject::moveToThread(QThread *targetThread)
     // keep currentData alive (since we've got it locked)
     currentData->ref();
 
+    // events posted through the intake need to be moved as well
+    currentData->mergePendingPostEventIntake();
+
     // move the object
     auto threadPrivate =  targetThread
         ? static_cast<QThreadPrivate *>(QThreadPrivate::get(targetThread))
@@ -1728,8 +1753,16 @@ void QObject::moveToThread(QThread *targetThread)
     }
     d_func()->setThreadData_helper(currentData, targetData, bindingStatus);
 
+    // publish the new thread data to postEvent() calls that may have pushed
+    // to our intake in the meantime and forward their events
+    currentData->postEventList.moveGeneration.fetchAndAddRelease(1);
+    currentData->mergePostEventIntake();
+
     locker.unlock();
 
+    // the signalSlotLock()s are taken before the postEventList mutexes
+    d_func()->updateNeedsDispatch_helper(signalSlotLock(this));
+
     // now currentData can commit suicide if it wants to
     currentData->deref();
 }
@@ -1813,6 +1846,58 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
     }
 }
 
+/*!
+    \internal
+    Re-evaluates which connections from and to this object and its children
+    are direct calls, after setThreadData_helper() moved them to another
+    thread. Each ConnectionList is updated under the lock of its sender;
+    \a heldMutex is the signalSlotLock() of the object being moved, which
+    the caller has locked.
+
+    activate() checks the receiver's thread data of every connection even
+    when the flags claim direct calls only, so the flags may lag behind the
+    move until this function has run.
+*/
+void QObjectPrivate::updateNeedsDispatch_helper(QBasicMutex *heldMutex)
+{
+    Q_Q(QObject);
+    QVarLengthArray<Connection *, 8> senders;
+    {
+        QBasicMutex *mutex = signalSlotLock(q);
+        const bool needToUnlock = QOrderedMutexLocker::relock(heldMutex, mutex);
+        if (ConnectionData *cd = connections.loadRelaxed()) {
+            if (cd->signalVector.loadRelaxed()) {
+                const QThreadData *data = threadData.loadRelaxed();
+                for (int signal = -1; signal < cd->signalVectorCount(); ++signal)
+                    cd->updateNeedsDispatch(signal, data);
+            }
+            for (Connection *c = cd->senders; c; c = c->next) {
+                c->ref();
+                senders.append(c);
+            }
+        }
+        if (needToUnlock)
+            mutex->unlock();
+    }
+
+    for (Connection *c : std::as_const(senders)) {
+        QBasicMutex *senderMutex = signalSlotLock(c->sender);
+        const bool needToUnlock = QOrderedMutexLocker::relock(heldMutex, senderMutex);
+        // the sender disconnects all of its connections before it goes away
+        if (c->receiver.loadRelaxed()) {
+            QObjectPrivate *sp = QObjectPrivate::get(c->sender);
+            sp->connections.loadRelaxed()->updateNeedsDispatch(c->signal_index,
+                                                               sp->threadData.loadRelaxed());
+        }
+        if (needToUnlock)
+            senderMutex->unlock();
+        c->deref();
+    }
+
+    for (QObject *child : std::as_const(children))
+        child->d_func()->updateNeedsDispatch_helper(heldMutex);
+}
+
 //
 // The timer flag hasTimer is set when startTimer is called.
 // It is not reset when killing the timer because more than
@@ -3941,11 +4026,21 @@ void doActivate(QObject *sender, int signal_index, void **argv)
         list = &signalVector->at(-1);
 
     Qt::HANDLE currentThreadId = QThread::currentThreadId();
-    bool inSenderThread = currentThreadId == QObjectPrivate::get(sender)->threadData.loadRelaxed()->threadId.loadRelaxed();
+    const QThreadData *senderThreadData = sp->threadData.loadRelaxed();
+    bool inSenderThread = currentThreadId == senderThreadData->threadId.loadRelaxed();
 
     // We need to check against the highest connection id to ensure that signals added
     // during the signal emission are not emitted in this emission.
-    uint highestConnectionId = connections->currentConnectionId.loadRelaxed();
+    // addConnection() sets needsDispatch before it increments the id, so the flags
+    // read below cover every connection up to this one.
+    uint highestConnectionId = connections->currentConnectionId.loadAcquire();
+
+    // If all connections are direct calls into the sender's thread, and we are in that
+    // thread, we can skip the thread checks. The receiver's thread can change while we
+    // are emitting, and the first connection of a list may be newer than the flags, so
+    // the receiver's thread and the connection type are still verified per connection.
+    const bool directCallsOnly = inSenderThread && !list->needsDispatch.loadRelaxed()
+            && !signalVector->at(-1).needsDispatch.loadRelaxed();
     do {
         QObjectPrivate::Connection *c = list->first.loadRelaxed();
         if (!c)
@@ -3956,57 +4051,62 @@ void doActivate(QObject *sender, int signal_index, void **argv)
             if (!receiver)
                 continue;
 
-            QThreadData *td = c->receiverThreadData.loadRelaxed();
-            if (!td)
-                continue;
+            bool receiverInSameThread = true;
+            if (!directCallsOnly || c->receiverThreadData.loadRelaxed() != senderThreadData
+                    || (c->connectionType != Qt::AutoConnection
+                        && c->connectionType != Qt::DirectConnection)
+                    || c->isSingleShot) {
+                QThreadData *td = c->receiverThreadData.loadRelaxed();
+                if (!td)
+                    continue;
 
-            bool receiverInSameThread;
-            if (inSenderThread) {
-                receiverInSameThread = currentThreadId == td->threadId.loadRelaxed();
-            } else {
-                // need to lock before reading the threadId, because moveToThread() could interfere
-                QMutexLocker lock(signalSlotLock(receiver));
-                receiverInSameThread = currentThreadId == td->threadId.loadRelaxed();
-            }
+                if (inSenderThread) {
+                    receiverInSameThread = currentThreadId == td->threadId.loadRelaxed();
+                } else {
+                    // need to lock before reading the threadId, because moveToThread() could interfere
+                    QMutexLocker lock(signalSlotLock(receiver));
+                    receiverInSameThread = currentThreadId == td->threadId.loadRelaxed();
+                }
 
 
-            // determine if this connection should be sent immediately or
-            // put into the event queue
-            if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
-                || (c->connectionType == Qt::QueuedConnection)) {
-                queued_activate(sender, signal_index, c, argv);
-                continue;
+                // determine if this connection should be sent immediately or
+                // put into the event queue
+                if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
+                    || (c->connectionType == Qt::QueuedConnection)) {
+                    queued_activate(sender, signal_index, c, argv);
+                    continue;
 #if QT_CONFIG(thread)
-            } else if (c->connectionType == Qt::BlockingQueuedConnection) {
-                if (receiverInSameThread) {
-                    qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
-                    "Sender is %s(%p), receiver is %s(%p)",
-                    sender->metaObject()->className(), sender,
-                    receiver->metaObject()->className(), receiver);
+                } else if (c->connectionType == Qt::BlockingQueuedConnection) {
+                    if (receiverInSameThread) {
+                        qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
+                        "Sender is %s(%p), receiver is %s(%p)",
+                        sender->metaObject()->className(), sender,
+                        receiver->metaObject()->className(), receiver);
+                    }
+
+                    if (c->isSingleShot && !QObjectPrivate::removeConnection(c))
+                        continue;
+
+                    QSemaphore semaphore;
+                    {
+                        QMutexLocker locker(signalSlotLock(receiver));
+                        if (!c->isSingleShot && !c->receiver.loadAcquire())
+                            continue;
+                        QMetaCallEvent *ev = c->isSlotObject ?
+                            new QMetaCallEvent(c->slotObj, sender, signal_index, argv, &semaphore) :
+                            new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction,
+                                               sender, signal_index, argv, &semaphore);
+                        QCoreApplication::postEvent(receiver, ev);
+                    }
+                    semaphore.acquire();
+                    continue;
+#endif
                 }
 
                 if (c->isSingleShot && !QObjectPrivate::removeConnection(c))
                     continue;
-
-                QSemaphore semaphore;
-                {
-                    QMutexLocker locker(signalSlotLock(receiver));
-                    if (!c->isSingleShot && !c->receiver.loadAcquire())
-                        continue;
-                    QMetaCallEvent *ev = c->isSlotObject ?
-                        new QMetaCallEvent(c->slotObj, sender, signal_index, argv, &semaphore) :
-                        new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction,
-                                           sender, signal_index, argv, &semaphore);
-                    QCoreApplication::postEvent(receiver, ev);
-                }
-                semaphore.acquire();
-                continue;
-#endif
             }
 
-            if (c->isSingleShot && !QObjectPrivate::removeConnection(c))
-                continue;
-
             QObjectPrivate::Sender senderData(receiverInSameThread ? receiver : nullptr, sender, signal_index);
 
             if (c->isSlotObject) {
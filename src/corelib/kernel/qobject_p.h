@@ -20,6 +20,7 @@
 #include "QtCore/qcoreevent.h"
 #include <QtCore/qfunctionaltools_impl.h>
 #include "QtCore/qlist.h"
+#include "QtCore/qmutex.h"
 #include "QtCore/qobject.h"
 #include "QtCore/qpointer.h"
 #include "QtCore/qvariant.h"
@@ -140,6 +141,7 @@ public:
     void setParent_helper(QObject *);
     void moveToThread_helper();
     void setThreadData_helper(QThreadData *currentData, QThreadData *targetData, QBindingStatus *status);
+    void updateNeedsDispatch_helper(QBasicMutex *heldMutex);
 
     bool isSender(const QObject *receiver, const char *signal) const;
     QObjectList receiverList(const char *signal) const;
@@ -30,6 +30,9 @@ struct QObjectPrivate::ConnectionList
 {
     QAtomicPointer<Connection> first;
     QAtomicPointer<Connection> last;
+    // set if a connection in the list is not a direct call into the sender's thread,
+    // so that activate() has to check the type and thread of every connection
+    QAtomicInteger<bool> needsDispatch;
 };
 static_assert(std::is_trivially_destructible_v<QObjectPrivate::ConnectionList>);
 Q_DECLARE_TYPEINFO(QObjectPrivate::ConnectionList, Q_RELOCATABLE_TYPE);
@@ -100,6 +103,13 @@ struct QObjectPrivate::Connection : public ConnectionOrSignalVector
         Q_ASSERT(!isSlotObject);
         return method_offset + method_relative;
     }
+    // true if an emission from the sender's thread always invokes the slot directly
+    bool isDirectCall(const QThreadData *senderThreadData) const
+    {
+        return !isSingleShot
+                && (connectionType == Qt::AutoConnection || connectionType == Qt::DirectConnection)
+                && receiverThreadData.loadRelaxed() == senderThreadData;
+    }
     void ref() { ref_.ref(); }
     void freeSlotObject()
     {
@@ -174,6 +184,10 @@ struct QObjectPrivate::ConnectionData
     }
     void cleanOrphanedConnectionsImpl(QObject *sender, LockPolicy lockPolicy);
 
+    // must be called on the senders connection data
+    // assumes the senders lock is held
+    void updateNeedsDispatch(int signal, const QThreadData *senderThreadData);
+
     ConnectionList &connectionsForSignal(int signal)
     {
         return signalVector.loadRelaxed()->at(signal);
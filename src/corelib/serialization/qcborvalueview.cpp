@@ -0,0 +1,924 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qcborvalueview.h"
+
+#include <qendian.h>
+#include <qfile.h>
+#include <qfloat16.h>
+#include <qhash.h>
+#include <qjsonvalue.h>
+#include <qlist.h>
+#include <qmutex.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QCborDocumentView
+    \inmodule QtCore
+    \ingroup cbor
+    \ingroup qtserialization
+    \ingroup shared
+    \reentrant
+    \since 6.7
+
+    \brief The QCborDocumentView class provides read-only access to a CBOR
+    document without decoding it.
+
+    QCborValue::fromCbor() decodes a whole CBOR stream up front, copying every
+    string into its own storage. For large documents of which only a few values
+    are used, such as configuration data or asset catalogs, most of that work
+    is wasted. QCborDocumentView instead keeps the encoded data and decodes
+    values only when they are accessed through QCborValueView:
+
+    \list
+      \li The elements of an array or map are located the first time that
+          container is accessed, and that index is kept for later accesses.
+      \li Strings and byte arrays are returned as views into the encoded data,
+          using utf8StringView() and byteArrayView(), without being copied.
+      \li fromFile() maps the file into memory, so that only the pages that
+          are accessed are read, and they are shared between all the processes
+          that map the same file.
+    \endlist
+
+    As a consequence, the cost of opening a document does not depend on its
+    size, and only the parts of it that are used are ever read.
+
+    The document is not validated when it is opened. Values that are
+    malformed or truncated are reported as QCborValue::Invalid when accessed,
+    and malformed arrays and maps appear empty. The whole document, or any
+    part of it, can be validated by converting it with
+    QCborValueView::toCborValue().
+
+    QCborDocumentView is implicitly shared and can be used from several
+    threads at the same time.
+
+    \sa QCborValueView, QCborValue::fromCbor()
+*/
+
+/*!
+    \class QCborValueView
+    \inmodule QtCore
+    \ingroup cbor
+    \ingroup qtserialization
+    \reentrant
+    \since 6.7
+
+    \brief The QCborValueView class is a read-only view of a value in a
+    QCborDocumentView.
+
+    QCborValueView provides the same accessors as QCborValue for the value it
+    refers to, but decodes it from the encoded data of the document on
+    demand. It is small and cheap to copy. The elements of arrays and maps are
+    accessed with at(), keyAt(), valueAt() and value(), which return views
+    too.
+
+    A QCborValueView is only valid for as long as the QCborDocumentView it
+    was obtained from, or a copy of it, exists.
+
+    Unlike QCborValue, QCborValueView does not interpret tags: a tagged value
+    is always of type QCborValue::Tag, and tag() and taggedValue() return its
+    tag and contents. QCborValue's extended types, such as
+    QCborValue::DateTime, are returned by toCborValue().
+
+    \sa QCborDocumentView, QCborValue
+*/
+
+namespace {
+enum MajorType : quint8 {
+    UnsignedIntegerType = 0,
+    NegativeIntegerType,
+    ByteStringType,
+    TextStringType,
+    ArrayType,
+    MapType,
+    TagType,
+    SimpleTypesType
+};
+
+enum : quint8 {
+    SimpleTypeInNextByte = 24,
+    HalfPrecisionFloat = 25,
+    SinglePrecisionFloat = 26,
+    DoublePrecisionFloat = 27,
+    IndefiniteLength = 31,
+    BreakByte = 0xff
+};
+
+// The initial byte of an element and its argument
+struct Header
+{
+    qsizetype size = 0;     // zero if malformed
+    MajorType majorType = UnsignedIntegerType;
+    quint8 additionalInfo = 0;
+    quint64 value = 0;
+
+    bool isValid() const { return size != 0; }
+    bool isIndefiniteLength() const { return additionalInfo == IndefiniteLength; }
+};
+} // unnamed namespace
+
+static constexpr int MaximumRecursionDepth = 1024;
+
+static Header readHeader(const uchar *ptr, const uchar *end) noexcept
+{
+    Header h;
+    if (ptr >= end)
+        return h;
+
+    h.majorType = MajorType(*ptr >> 5);
+    h.additionalInfo = *ptr & 0x1f;
+    if (h.additionalInfo < 24) {
+        h.value = h.additionalInfo;
+        h.size = 1;
+    } else if (h.additionalInfo == IndefiniteLength) {
+        // only strings and containers can have an indefinite length; the
+        // break byte that ends them is in the simple types
+        if (h.majorType != UnsignedIntegerType && h.majorType != NegativeIntegerType
+                && h.majorType != TagType)
+            h.size = 1;
+    } else if (h.additionalInfo <= DoublePrecisionFloat) {
+        const qsizetype bytes = qsizetype(1) << (h.additionalInfo - 24);
+        if (end - ptr - 1 < bytes)
+            return h;
+        switch (bytes) {
+        case 1:
+            h.value = ptr[1];
+            break;
+        case 2:
+            h.value = qFromBigEndian<quint16>(ptr + 1);
+            break;
+        case 4:
+            h.value = qFromBigEndian<quint32>(ptr + 1);
+            break;
+        case 8:
+            h.value = qFromBigEndian<quint64>(ptr + 1);
+            break;
+        }
+        h.size = 1 + bytes;
+    }
+    return h;
+}
+
+// Returns the position just past the element at ptr, or nullptr if it is
+// malformed or truncated.
+static const uchar *skipElement(const uchar *ptr, const uchar *end,
+                                int depth = MaximumRecursionDepth) noexcept
+{
+    const Header h = readHeader(ptr, end);
+    if (!h.isValid() || depth == 0)
+        return nullptr;
+    ptr += h.size;
+
+    switch (h.majorType) {
+    case UnsignedIntegerType:
+    case NegativeIntegerType:
+        return ptr;
+
+    case SimpleTypesType:
+        // a break byte outside of an indefinite-length string or container
+        return h.isIndefiniteLength() ? nullptr : ptr;
+
+    case ByteStringType:
+    case TextStringType:
+        if (!h.isIndefiniteLength())
+            return h.value <= quint64(end - ptr) ? ptr + h.value : nullptr;
+
+        // chunked string: definite-length strings of the same type, up to
+        // the break byte
+        while (ptr < end && *ptr != BreakByte) {
+            const Header chunk = readHeader(ptr, end);
+            if (!chunk.isValid() || chunk.majorType != h.majorType || chunk.isIndefiniteLength())
+                return nullptr;
+            ptr += chunk.size;
+            if (chunk.value > quint64(end - ptr))
+                return nullptr;
+            ptr += chunk.value;
+        }
+        return ptr < end ? ptr + 1 : nullptr;
+
+    case TagType:
+        return skipElement(ptr, end, depth - 1);
+
+    case ArrayType:
+    case MapType:
+        if (h.isIndefiniteLength()) {
+            quint64 count = 0;
+            for ( ; ptr < end && *ptr != BreakByte; ++count) {
+                ptr = skipElement(ptr, end, depth - 1);
+                if (!ptr)
+                    return nullptr;
+            }
+            if (ptr == end || (h.majorType == MapType && count % 2))
+                return nullptr;
+            return ptr + 1;
+        }
+
+        // each element is at least one byte, so a bogus count stops at the
+        // end of the data
+        for (quint64 count = 0; count < h.value; ++count) {
+            ptr = skipElement(ptr, end, depth - 1);
+            if (ptr && h.majorType == MapType)
+                ptr = skipElement(ptr, end, depth - 1);
+            if (!ptr)
+                return nullptr;
+        }
+        return ptr;
+    }
+    Q_UNREACHABLE_RETURN(nullptr);
+}
+
+class QCborDocumentViewPrivate : public QSharedData
+{
+public:
+    QByteArray data;                    // raw data over the mapping, for files
+    std::unique_ptr<QFile> file;        // keeps the mapping alive
+
+    // The offsets of the elements of each array and map that was accessed,
+    // by the offset of the container. The keys and values of maps alternate.
+    mutable QMutex mutex;
+    mutable QHash<qsizetype, QList<qsizetype>> containers;
+
+    const uchar *begin() const
+    { return reinterpret_cast<const uchar *>(data.constData()); }
+    const uchar *end() const
+    { return begin() + data.size(); }
+    Header header(qsizetype offset) const
+    { return readHeader(begin() + offset, end()); }
+
+    QList<qsizetype> elements(qsizetype offset) const;
+    QList<qsizetype> indexContainer(qsizetype offset) const;
+};
+
+QList<qsizetype> QCborDocumentViewPrivate::indexContainer(qsizetype offset) const
+{
+    const uchar *ptr = begin() + offset;
+    const Header h = readHeader(ptr, end());
+    Q_ASSERT(h.majorType == ArrayType || h.majorType == MapType);
+    ptr += h.size;
+
+    // each element is at least one byte long
+    const quint64 available = quint64(end() - ptr);
+    quint64 count = h.value;
+    if (h.majorType == MapType)
+        count = count > available ? available + 1 : 2 * count;
+    if (!h.isIndefiniteLength() && count > available)
+        return {};
+
+    QList<qsizetype> offsets;
+    if (!h.isIndefiniteLength())
+        offsets.reserve(qsizetype(count));
+    while (ptr < end()) {
+        if (h.isIndefiniteLength()) {
+            if (*ptr == BreakByte)
+                break;
+        } else if (quint64(offsets.size()) == count) {
+            break;
+        }
+
+        offsets.append(ptr - begin());
+        ptr = skipElement(ptr, end());
+        if (!ptr)
+            return {};
+    }
+
+    if (h.isIndefiniteLength() ? ptr == end() : quint64(offsets.size()) != count)
+        return {};      // missing break or truncated
+    if (h.majorType == MapType && offsets.size() % 2)
+        return {};
+    return offsets;
+}
+
+QList<qsizetype> QCborDocumentViewPrivate::elements(qsizetype offset) const
+{
+    {
+        QMutexLocker locker(&mutex);
+        const auto it = containers.constFind(offset);
+        if (it != containers.cend())
+            return *it;
+    }
+
+    // Index without holding the lock, so that other threads can keep using
+    // the containers that are already indexed. If two threads index the
+    // same container, they produce the same result.
+    QList<qsizetype> offsets = indexContainer(offset);
+    QMutexLocker locker(&mutex);
+    return *containers.insert(offset, std::move(offsets));
+}
+
+QT_DEFINE_QESDP_SPECIALIZATION_DTOR(QCborDocumentViewPrivate)
+
+static bool checkRoot(const QCborDocumentViewPrivate *d, QCborParserError *error)
+{
+    QCborError code = { QCborError::NoError };
+    const Header h = d->header(0);
+    if (d->data.isEmpty())
+        code = { QCborError::EndOfFile };
+    else if (h.isValid() && h.majorType == SimpleTypesType && h.isIndefiniteLength())
+        code = { QCborError::UnexpectedBreak };
+    else if (!h.isValid() && h.additionalInfo > DoublePrecisionFloat)
+        code = { QCborError::IllegalNumber };
+    else if (!h.isValid())
+        code = { QCborError::EndOfFile };
+
+    if (error) {
+        error->offset = 0;
+        error->error = code;
+    }
+    return code == QCborError::NoError;
+}
+
+/*!
+    Constructs a null QCborDocumentView.
+
+    \sa isNull()
+*/
+QCborDocumentView::QCborDocumentView() noexcept = default;
+
+/*!
+    Constructs a QCborDocumentView that shares the data of \a other.
+*/
+QCborDocumentView::QCborDocumentView(const QCborDocumentView &other) noexcept = default;
+
+/*!
+    \fn QCborDocumentView::QCborDocumentView(QCborDocumentView &&other)
+
+    Move-constructs a QCborDocumentView from \a other.
+*/
+
+/*!
+    Makes this QCborDocumentView share the data of \a other.
+*/
+QCborDocumentView &QCborDocumentView::operator=(const QCborDocumentView &other) noexcept = default;
+
+/*!
+    \fn QCborDocumentView &QCborDocumentView::operator=(QCborDocumentView &&other)
+
+    Move-assigns \a other to this QCborDocumentView.
+*/
+
+/*!
+    \fn void QCborDocumentView::swap(QCborDocumentView &other)
+
+    Swaps this document view with \a other. This operation is very fast and
+    never fails.
+*/
+
+/*!
+    Destroys this QCborDocumentView. The mapping of the file, if any, is
+    released when the last copy is destroyed.
+*/
+QCborDocumentView::~QCborDocumentView() = default;
+
+QCborDocumentView::QCborDocumentView(QCborDocumentViewPrivate *dd)
+    : d(dd)
+{
+}
+
+/*!
+    Returns a view of the CBOR document in \a data. The data is not copied: if
+    \a data was created with QByteArray::fromRawData(), the memory it refers
+    to must stay valid for as long as the view and its copies exist.
+
+    Only the first element of the data is checked. If it is malformed, or if
+    \a data is empty, this function returns a null QCborDocumentView and, if
+    \a error is not null, reports the problem in it. Any data after the first
+    element is ignored.
+
+    \sa fromFile(), QCborValue::fromCbor()
+*/
+QCborDocumentView QCborDocumentView::fromCbor(const QByteArray &data, QCborParserError *error)
+{
+    auto d = new QCborDocumentViewPrivate;
+    QCborDocumentView result(d);
+    d->data = data;
+    if (!checkRoot(d, error))
+        return QCborDocumentView();
+    return result;
+}
+
+/*!
+    Returns a view of the CBOR document in the file \a fileName. The file is
+    mapped into memory, so that only the parts of the document that are
+    accessed are read from it. If the file cannot be mapped, it is read
+    completely.
+
+    If the file cannot be opened, this function returns a null
+    QCborDocumentView and reports QCborError::InputOutputError in \a error, if
+    it is not null. Otherwise, it checks the document as fromCbor() does.
+
+    The file must not be modified while the view or any of its copies exist.
+
+    \sa fromCbor()
+*/
+QCborDocumentView QCborDocumentView::fromFile(const QString &fileName, QCborParserError *error)
+{
+    auto file = std::make_unique<QFile>(fileName);
+    if (!file->open(QIODevice::ReadOnly)) {
+        if (error) {
+            error->offset = 0;
+            error->error = { QCborError::InputOutputError };
+        }
+        return QCborDocumentView();
+    }
+
+    auto d = new QCborDocumentViewPrivate;
+    QCborDocumentView result(d);
+    const qint64 size = file->size();
+    uchar *mapping = size > 0 && size <= std::numeric_limits<qsizetype>::max()
+            ? file->map(0, size) : nullptr;
+    if (mapping) {
+        d->data = QByteArray::fromRawData(reinterpret_cast<const char *>(mapping), qsizetype(size));
+        d->file = std::move(file);
+    } else {
+        d->data = file->readAll();
+    }
+
+    if (!checkRoot(d, error))
+        return QCborDocumentView();
+    return result;
+}
+
+/*!
+    \fn bool QCborDocumentView::isNull() const
+
+    Returns \c true if this view does not refer to a document.
+*/
+
+/*!
+    Returns the encoded data of the document.
+*/
+QByteArrayView QCborDocumentView::data() const noexcept
+{
+    return d ? QByteArrayView(d->data) : QByteArrayView();
+}
+
+/*!
+    Returns a view of the top-level value of the document, or an invalid view
+    if this document view is null.
+*/
+QCborValueView QCborDocumentView::root() const noexcept
+{
+    return d ? QCborValueView(d.get(), 0) : QCborValueView();
+}
+
+/*!
+    \fn QCborValueView::QCborValueView()
+
+    Constructs an invalid view, which does not refer to any value.
+*/
+
+/*!
+    Returns the type of the value. Integers that do not fit in a qint64 are
+    reported as QCborValue::Double, as QCborValue::fromCbor() does, and
+    floating point numbers of any precision are reported as
+    QCborValue::Double.
+
+    Tagged values are of type QCborValue::Tag. Malformed values, and views
+    that do not refer to a value, are of type QCborValue::Invalid.
+*/
+QCborValue::Type QCborValueView::type() const noexcept
+{
+    if (!d)
+        return QCborValue::Invalid;
+    const Header h = d->header(offset);
+    if (!h.isValid())
+        return QCborValue::Invalid;
+
+    switch (h.majorType) {
+    case UnsignedIntegerType:
+    case NegativeIntegerType:
+        return qint64(h.value) < 0 ? QCborValue::Double : QCborValue::Integer;
+    case ByteStringType:
+        return QCborValue::ByteArray;
+    case TextStringType:
+        return QCborValue::String;
+    case ArrayType:
+        return QCborValue::Array;
+    case MapType:
+        return QCborValue::Map;
+    case TagType:
+        return QCborValue::Tag;
+    case SimpleTypesType:
+        switch (h.additionalInfo) {
+        case HalfPrecisionFloat:
+        case SinglePrecisionFloat:
+        case DoublePrecisionFloat:
+            return QCborValue::Double;
+        case IndefiniteLength:
+            return QCborValue::Invalid;
+        }
+        return QCborValue::Type(QCborValue::SimpleType | quint8(h.value));
+    }
+    Q_UNREACHABLE_RETURN(QCborValue::Invalid);
+}
+
+/*!
+    \fn bool QCborValueView::isInteger() const
+    \fn bool QCborValueView::isByteArray() const
+    \fn bool QCborValueView::isString() const
+    \fn bool QCborValueView::isArray() const
+    \fn bool QCborValueView::isMap() const
+    \fn bool QCborValueView::isTag() const
+    \fn bool QCborValueView::isFalse() const
+    \fn bool QCborValueView::isTrue() const
+    \fn bool QCborValueView::isBool() const
+    \fn bool QCborValueView::isNull() const
+    \fn bool QCborValueView::isUndefined() const
+    \fn bool QCborValueView::isDouble() const
+    \fn bool QCborValueView::isInvalid() const
+    \fn bool QCborValueView::isSimpleType() const
+
+    Returns \c true if the value is of the corresponding type, as in
+    QCborValue.
+
+    \sa type()
+*/
+
+/*!
+    Returns the integer value, or the floating point value truncated, if this
+    view is of type QCborValue::Integer or QCborValue::Double. Otherwise,
+    returns \a defaultValue.
+
+    \sa toDouble(), QCborValue::toInteger()
+*/
+qint64 QCborValueView::toInteger(qint64 defaultValue) const noexcept
+{
+    switch (type()) {
+    case QCborValue::Integer: {
+        const Header h = d->header(offset);
+        return h.majorType == UnsignedIntegerType ? qint64(h.value) : -1 - qint64(h.value);
+    }
+    case QCborValue::Double:
+        return qint64(toDouble());
+    default:
+        return defaultValue;
+    }
+}
+
+/*!
+    Returns the floating point value, or the integer value converted to
+    double, if this view is of type QCborValue::Double or QCborValue::Integer.
+    Otherwise, returns \a defaultValue.
+
+    \sa toInteger(), QCborValue::toDouble()
+*/
+double QCborValueView::toDouble(double defaultValue) const noexcept
+{
+    if (!d)
+        return defaultValue;
+    const Header h = d->header(offset);
+    if (!h.isValid())
+        return defaultValue;
+
+    switch (h.majorType) {
+    case UnsignedIntegerType:
+        return double(h.value);
+    case NegativeIntegerType:
+        return -1 - double(h.value);
+    case SimpleTypesType:
+        switch (h.additionalInfo) {
+        case HalfPrecisionFloat: {
+            const quint16 bits = quint16(h.value);
+            qfloat16 f;
+            memcpy(&f, &bits, sizeof(f));
+            return double(f);
+        }
+        case SinglePrecisionFloat: {
+            const quint32 bits = quint32(h.value);
+            float f;
+            memcpy(&f, &bits, sizeof(f));
+            return double(f);
+        }
+        case DoublePrecisionFloat: {
+            double f;
+            memcpy(&f, &h.value, sizeof(f));
+            return f;
+        }
+        }
+        break;
+    default:
+        break;
+    }
+    return defaultValue;
+}
+
+/*!
+    Returns the boolean value if this view is of type QCborValue::False or
+    QCborValue::True, and \a defaultValue otherwise.
+*/
+bool QCborValueView::toBool(bool defaultValue) const noexcept
+{
+    return isBool() ? isTrue() : defaultValue;
+}
+
+/*!
+    Returns the simple type of the value if it is one, and \a defaultValue
+    otherwise.
+
+    \sa isSimpleType()
+*/
+QCborSimpleType QCborValueView::toSimpleType(QCborSimpleType defaultValue) const noexcept
+{
+    const QCborValue::Type t = type();
+    return int(t) >> 8 == int(QCborValue::SimpleType) >> 8 ? QCborSimpleType(t & 0xff) : defaultValue;
+}
+
+// The contents of a definite-length string, or a null view
+static QByteArrayView stringContents(const QCborDocumentViewPrivate *d, qsizetype offset,
+                                     MajorType type) noexcept
+{
+    if (!d)
+        return {};
+    const Header h = d->header(offset);
+    if (!h.isValid() || h.majorType != type || h.isIndefiniteLength())
+        return {};
+    const uchar *ptr = d->begin() + offset + h.size;
+    if (h.value > quint64(d->end() - ptr))
+        return {};
+    return QByteArrayView(ptr, qsizetype(h.value));
+}
+
+// The concatenated contents of a string of either length, or a null byte
+// array if the string is malformed or of another type
+static QByteArray stringData(const QCborDocumentViewPrivate *d, qsizetype offset, MajorType type)
+{
+    if (!d)
+        return {};
+    const Header h = d->header(offset);
+    if (!h.isValid() || h.majorType != type)
+        return {};
+    if (!h.isIndefiniteLength()) {
+        const QByteArrayView contents = stringContents(d, offset, type);
+        return contents.isNull() ? QByteArray() : contents.toByteArray();
+    }
+
+    const uchar *ptr = d->begin() + offset;
+    if (!skipElement(ptr, d->end()))
+        return {};
+    QByteArray result(0, Qt::Uninitialized);    // not null
+    for (ptr += h.size; *ptr != BreakByte; ) {
+        const Header chunk = readHeader(ptr, d->end());
+        ptr += chunk.size;
+        result.append(reinterpret_cast<const char *>(ptr), qsizetype(chunk.value));
+        ptr += chunk.value;
+    }
+    return result;
+}
+
+/*!
+    Returns a view of the contents of this text string, without copying or
+    decoding it. Returns a null view if this is not a text string, or if it is
+    a chunked (indefinite-length) string, whose contents are not contiguous;
+    use toString() for those.
+
+    The contents are not validated as UTF-8.
+
+    \sa toString(), byteArrayView()
+*/
+QUtf8StringView QCborValueView::utf8StringView() const noexcept
+{
+    const QByteArrayView contents = stringContents(d, offset, TextStringType);
+    return contents.isNull() ? QUtf8StringView() : QUtf8StringView(contents.data(), contents.size());
+}
+
+/*!
+    Returns a view of the contents of this byte array, without copying it.
+    Returns a null view if this is not a byte array, or if it is chunked
+    (indefinite-length); use toByteArray() for those.
+
+    \sa toByteArray(), utf8StringView()
+*/
+QByteArrayView QCborValueView::byteArrayView() const noexcept
+{
+    return stringContents(d, offset, ByteStringType);
+}
+
+/*!
+    Returns the text string, decoded from UTF-8, if this view is of type
+    QCborValue::String, and \a defaultValue otherwise.
+
+    \sa utf8StringView()
+*/
+QString QCborValueView::toString(const QString &defaultValue) const
+{
+    if (const QByteArrayView contents = stringContents(d, offset, TextStringType); !contents.isNull())
+        return QString::fromUtf8(contents);
+    const QByteArray chunks = stringData(d, offset, TextStringType);
+    return chunks.isNull() ? defaultValue : QString::fromUtf8(chunks);
+}
+
+/*!
+    Returns a copy of the byte array if this view is of type
+    QCborValue::ByteArray, and \a defaultValue otherwise.
+
+    \sa byteArrayView()
+*/
+QByteArray QCborValueView::toByteArray(const QByteArray &defaultValue) const
+{
+    const QByteArray data = stringData(d, offset, ByteStringType);
+    return data.isNull() ? defaultValue : data;
+}
+
+/*!
+    Returns the tag of this value if it is of type QCborValue::Tag, and \a
+    defaultValue otherwise.
+
+    \sa taggedValue()
+*/
+QCborTag QCborValueView::tag(QCborTag defaultValue) const noexcept
+{
+    if (!d)
+        return defaultValue;
+    const Header h = d->header(offset);
+    return h.isValid() && h.majorType == TagType ? QCborTag(h.value) : defaultValue;
+}
+
+/*!
+    Returns a view of the value that is tagged, if this value is of type
+    QCborValue::Tag, and an invalid view otherwise.
+
+    \sa tag()
+*/
+QCborValueView QCborValueView::taggedValue() const noexcept
+{
+    if (!d)
+        return {};
+    const Header h = d->header(offset);
+    if (!h.isValid() || h.majorType != TagType)
+        return {};
+    return QCborValueView(d, offset + h.size);
+}
+
+/*!
+    Returns the number of elements in this array, or the number of pairs in
+    this map. Returns 0 for other types and for malformed containers.
+
+    The first call for a given container indexes it, which reads through all
+    of its elements, but not their contents.
+*/
+qsizetype QCborValueView::size() const
+{
+    switch (type()) {
+    case QCborValue::Array:
+        return d->elements(offset).size();
+    case QCborValue::Map:
+        return d->elements(offset).size() / 2;
+    default:
+        return 0;
+    }
+}
+
+/*!
+    Returns a view of the element at position \a i in this array. Returns an
+    invalid view if this is not an array or if \a i is out of range.
+
+    \sa size(), value()
+*/
+QCborValueView QCborValueView::at(qsizetype i) const
+{
+    if (!isArray())
+        return {};
+    const QList<qsizetype> elements = d->elements(offset);
+    if (i < 0 || i >= elements.size())
+        return {};
+    return QCborValueView(d, elements.at(i));
+}
+
+/*!
+    Returns a view of the key of the pair at position \a i in this map.
+    Returns an invalid view if this is not a map or if \a i is out of range.
+
+    \sa valueAt(), size()
+*/
+QCborValueView QCborValueView::keyAt(qsizetype i) const
+{
+    if (!isMap())
+        return {};
+    const QList<qsizetype> elements = d->elements(offset);
+    if (i < 0 || i >= elements.size() / 2)
+        return {};
+    return QCborValueView(d, elements.at(2 * i));
+}
+
+/*!
+    Returns a view of the value of the pair at position \a i in this map.
+    Returns an invalid view if this is not a map or if \a i is out of range.
+
+    \sa keyAt(), size()
+*/
+QCborValueView QCborValueView::valueAt(qsizetype i) const
+{
+    if (!isMap())
+        return {};
+    const QList<qsizetype> elements = d->elements(offset);
+    if (i < 0 || i >= elements.size() / 2)
+        return {};
+    return QCborValueView(d, elements.at(2 * i + 1));
+}
+
+/*!
+    \overload
+
+    If this is a map, returns a view of the value whose key is the integer \a
+    key. If this is an array, returns a view of the element at position \a
+    key. Otherwise, or if there is no such element, returns an invalid view.
+
+    Like QCborMap::value(), this searches the keys in order.
+*/
+QCborValueView QCborValueView::value(qint64 key) const
+{
+    if (isArray())
+        return at(key);
+    if (!isMap())
+        return {};
+
+    const QList<qsizetype> elements = d->elements(offset);
+    for (qsizetype i = 0; i < elements.size(); i += 2) {
+        const QCborValueView k(d, elements.at(i));
+        if (k.isInteger() && k.toInteger() == key)
+            return QCborValueView(d, elements.at(i + 1));
+    }
+    return {};
+}
+
+/*!
+    If this is a map, returns a view of the value whose key is the string \a
+    key. Otherwise, or if there is no such key, returns an invalid view.
+
+    The keys are compared in their encoded form, without being decoded. Like
+    QCborMap::value(), this searches the keys in order.
+
+    \sa operator[]()
+*/
+QCborValueView QCborValueView::value(QAnyStringView key) const
+{
+    if (!isMap())
+        return {};
+
+    const QList<qsizetype> elements = d->elements(offset);
+    for (qsizetype i = 0; i < elements.size(); i += 2) {
+        const QCborValueView k(d, elements.at(i));
+        if (const QUtf8StringView contents = k.utf8StringView(); !contents.isNull()) {
+            if (QAnyStringView::equal(contents, key))
+                return QCborValueView(d, elements.at(i + 1));
+        } else if (k.isString() && QAnyStringView::equal(k.toString(), key)) {
+            return QCborValueView(d, elements.at(i + 1));
+        }
+    }
+    return {};
+}
+
+/*!
+    \fn QCborValueView QCborValueView::operator[](qint64 key) const
+    \fn QCborValueView QCborValueView::operator[](QAnyStringView key) const
+
+    Same as value(\a key).
+*/
+
+/*!
+    Returns the encoded form of this value, including the contents of arrays,
+    maps and tags. Returns a null view if the value is malformed.
+*/
+QByteArrayView QCborValueView::encoded() const noexcept
+{
+    if (!d)
+        return {};
+    const uchar *begin = d->begin() + offset;
+    const uchar *end = skipElement(begin, d->end());
+    return end ? QByteArrayView(begin, end) : QByteArrayView();
+}
+
+/*!
+    Decodes this value, including the contents of arrays, maps and tags, with
+    QCborValue::fromCbor(). This validates the value completely, and returns
+    an invalid QCborValue if it is malformed.
+
+    \sa toJsonValue()
+*/
+QCborValue QCborValueView::toCborValue() const
+{
+    const QByteArrayView data = encoded();
+    if (data.isNull())
+        return QCborValue(QCborValue::Invalid);
+    QCborParserError error;
+    QCborValue value = QCborValue::fromCbor(QByteArray::fromRawData(data.data(), data.size()),
+                                            &error);
+    if (error.error != QCborError::NoError)
+        return QCborValue(QCborValue::Invalid);
+    return value;
+}
+
+/*!
+    Converts this value to QJsonValue, as toCborValue().toJsonValue() does.
+
+    \sa toCborValue(), QCborValue::toJsonValue()
+*/
+QJsonValue QCborValueView::toJsonValue() const
+{
+    return toCborValue().toJsonValue();
+}
+
+QT_END_NAMESPACE
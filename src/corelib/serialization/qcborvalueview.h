@@ -0,0 +1,121 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QCBORVALUEVIEW_H
+#define QCBORVALUEVIEW_H
+
+#include <QtCore/qanystringview.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qcborcommon.h>
+#include <QtCore/qcborvalue.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qutf8stringview.h>
+
+QT_REQUIRE_CONFIG(cborstreamreader);
+
+QT_BEGIN_NAMESPACE
+
+class QJsonValue;
+class QCborValueView;
+
+class QCborDocumentViewPrivate;
+QT_DECLARE_QESDP_SPECIALIZATION_DTOR_WITH_EXPORT(QCborDocumentViewPrivate, Q_CORE_EXPORT)
+
+class Q_CORE_EXPORT QCborDocumentView
+{
+public:
+    QCborDocumentView() noexcept;
+    QCborDocumentView(const QCborDocumentView &other) noexcept;
+    QCborDocumentView &operator=(const QCborDocumentView &other) noexcept;
+    QCborDocumentView(QCborDocumentView &&other) noexcept = default;
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QCborDocumentView)
+    ~QCborDocumentView();
+
+    void swap(QCborDocumentView &other) noexcept { d.swap(other.d); }
+
+    static QCborDocumentView fromCbor(const QByteArray &data, QCborParserError *error = nullptr);
+    static QCborDocumentView fromFile(const QString &fileName, QCborParserError *error = nullptr);
+
+    bool isNull() const noexcept { return !d; }
+    QByteArrayView data() const noexcept;
+    QCborValueView root() const noexcept;
+
+private:
+    friend class QCborValueView;
+    explicit QCborDocumentView(QCborDocumentViewPrivate *dd);
+
+    QExplicitlySharedDataPointer<QCborDocumentViewPrivate> d;
+};
+
+Q_DECLARE_SHARED(QCborDocumentView)
+
+class Q_CORE_EXPORT QCborValueView
+{
+public:
+    constexpr QCborValueView() noexcept = default;
+
+    QCborValue::Type type() const noexcept;
+    bool isInteger() const      { return type() == QCborValue::Integer; }
+    bool isByteArray() const    { return type() == QCborValue::ByteArray; }
+    bool isString() const       { return type() == QCborValue::String; }
+    bool isArray() const        { return type() == QCborValue::Array; }
+    bool isMap() const          { return type() == QCborValue::Map; }
+    bool isTag() const          { return type() == QCborValue::Tag; }
+    bool isFalse() const        { return type() == QCborValue::False; }
+    bool isTrue() const         { return type() == QCborValue::True; }
+    bool isBool() const         { return isFalse() || isTrue(); }
+    bool isNull() const         { return type() == QCborValue::Null; }
+    bool isUndefined() const    { return type() == QCborValue::Undefined; }
+    bool isDouble() const       { return type() == QCborValue::Double; }
+    bool isInvalid() const      { return type() == QCborValue::Invalid; }
+    bool isSimpleType() const   { return int(type()) >> 8 == int(QCborValue::SimpleType) >> 8; }
+
+    qint64 toInteger(qint64 defaultValue = 0) const noexcept;
+    double toDouble(double defaultValue = 0) const noexcept;
+    bool toBool(bool defaultValue = false) const noexcept;
+    QCborSimpleType toSimpleType(QCborSimpleType defaultValue = QCborSimpleType::Undefined) const noexcept;
+
+    QUtf8StringView utf8StringView() const noexcept;
+    QByteArrayView byteArrayView() const noexcept;
+    QString toString(const QString &defaultValue = {}) const;
+    QByteArray toByteArray(const QByteArray &defaultValue = {}) const;
+
+    QCborTag tag(QCborTag defaultValue = QCborTag(-1)) const noexcept;
+    QCborValueView taggedValue() const noexcept;
+
+    qsizetype size() const;
+    QCborValueView at(qsizetype i) const;
+    QCborValueView keyAt(qsizetype i) const;
+    QCborValueView valueAt(qsizetype i) const;
+    QCborValueView value(qint64 key) const;
+    QCborValueView value(QAnyStringView key) const;
+    QCborValueView operator[](qint64 key) const             { return value(key); }
+    QCborValueView operator[](QAnyStringView key) const     { return value(key); }
+#ifndef Q_QDOC
+    QCborValueView value(int key) const                     { return value(qint64(key)); }
+    QCborValueView operator[](int key) const                { return value(qint64(key)); }
+    QCborValueView value(const char *key) const             { return value(QAnyStringView(key)); }
+    QCborValueView operator[](const char *key) const        { return value(QAnyStringView(key)); }
+#endif
+
+    QByteArrayView encoded() const noexcept;
+    QCborValue toCborValue() const;
+    QJsonValue toJsonValue() const;
+
+private:
+    friend class QCborDocumentView;
+    QCborValueView(const QCborDocumentViewPrivate *d, qsizetype offset) noexcept
+        : d(d), offset(offset)
+    {}
+
+    const QCborDocumentViewPrivate *d = nullptr;
+    qsizetype offset = 0;
+};
+
+Q_DECLARE_TYPEINFO(QCborValueView, Q_PRIMITIVE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QCBORVALUEVIEW_H
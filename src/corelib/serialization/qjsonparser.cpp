@@ -11,6 +11,7 @@
 #include "private/qstringconverter_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 #include <private/qtools_p.h>
 
 //#define PARSER_DEBUG
@@ -31,6 +32,132 @@ QT_BEGIN_NAMESPACE
 
 using namespace QtMiscUtils;
 
+/*
+    Vectorized scanning of the input. Both functions return the first byte in
+    [json, end) that the byte-by-byte code of the parser needs to look at,
+    checking blocks of 16 bytes (SSE2, Neon) or 32 bytes (AVX2, selected at
+    runtime) at a time. Inside strings, that is a quotation mark, a backslash
+    or the start of a multi-byte UTF-8 sequence; between tokens, anything
+    that isn't whitespace.
+*/
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+#  define QT_JSONPARSER_RUNTIME_AVX2
+
+static QT_FUNCTION_TARGET(AVX2)
+const char *skipPlainString_avx2(const char *json, const char *end) noexcept
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    for ( ; end - json >= 32; json += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        const __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(data, quote),
+                                                                _mm256_cmpeq_epi8(data, backslash)),
+                                                data);
+        if (const uint mask = _mm256_movemask_epi8(special))
+            return json + qCountTrailingZeroBits(mask);
+    }
+    return json;
+}
+
+static QT_FUNCTION_TARGET(AVX2)
+const char *skipWhitespace_avx2(const char *json, const char *end) noexcept
+{
+    for ( ; end - json >= 32; json += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        const __m256i space = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(' ')),
+                                _mm256_cmpeq_epi8(data, _mm256_set1_epi8('\t'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8('\n')),
+                                _mm256_cmpeq_epi8(data, _mm256_set1_epi8('\r'))));
+        if (const uint mask = ~uint(_mm256_movemask_epi8(space)))
+            return json + qCountTrailingZeroBits(mask);
+    }
+    return json;
+}
+#endif
+
+static inline const char *skipPlainString(const char *json, const char *end) noexcept
+{
+#ifdef QT_JSONPARSER_RUNTIME_AVX2
+    if (qCpuHasFeature(AVX2)) {
+        json = skipPlainString_avx2(json, end);
+        if (end - json >= 32)
+            return json;
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                                          _mm_cmpeq_epi8(data, backslash)),
+                                             data);
+        if (const uint mask = _mm_movemask_epi8(special))
+            return json + qCountTrailingZeroBits(mask);
+    }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const uint8x16_t nonAscii = vdupq_n_u8(0x80);
+    for ( ; end - json >= 16; json += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uint8_t *>(json));
+        const uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(data, quote), vceqq_u8(data, backslash)),
+                                            vcgeq_u8(data, nonAscii));
+        // four bits per byte
+        const quint64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+        if (mask)
+            return json + qCountTrailingZeroBits(mask) / 4;
+    }
+#endif
+    for ( ; json < end; ++json) {
+        const uchar c = *json;
+        if (c == '"' || c == '\\' || c >= 0x80)
+            break;
+    }
+    return json;
+}
+
+static inline const char *skipWhitespace(const char *json, const char *end) noexcept
+{
+    const auto isSpace = [](char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    };
+#ifdef QT_JSONPARSER_RUNTIME_AVX2
+    if (qCpuHasFeature(AVX2)) {
+        json = skipWhitespace_avx2(json, end);
+        if (end - json >= 32)
+            return json;
+    }
+#endif
+#if defined(__SSE2__)
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i space = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(' ')),
+                                                        _mm_cmpeq_epi8(data, _mm_set1_epi8('\t'))),
+                                           _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8('\n')),
+                                                        _mm_cmpeq_epi8(data, _mm_set1_epi8('\r'))));
+        if (const uint mask = ~uint(_mm_movemask_epi8(space)) & 0xffff)
+            return json + qCountTrailingZeroBits(mask);
+    }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    for ( ; end - json >= 16; json += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uint8_t *>(json));
+        const uint8x16_t space = vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(' ')),
+                                                   vceqq_u8(data, vdupq_n_u8('\t'))),
+                                          vorrq_u8(vceqq_u8(data, vdupq_n_u8('\n')),
+                                                   vceqq_u8(data, vdupq_n_u8('\r'))));
+        // four bits per byte
+        const quint64 mask = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(space), 4)), 0);
+        if (mask)
+            return json + qCountTrailingZeroBits(mask) / 4;
+    }
+#endif
+    while (json < end && isSpace(*json))
+        ++json;
+    return json;
+}
+
 // error strings for the JSON parser
 #define JSONERR_OK          QT_TRANSLATE_NOOP("QJsonParseError", "no error occurred")
 #define JSONERR_UNTERM_OBJ  QT_TRANSLATE_NOOP("QJsonParseError", "unterminated object")
@@ -253,16 +380,10 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
-        ++json;
-    }
+    // compact JSON has no whitespace at all between tokens, and indented
+    // JSON has long runs of it
+    if (json < end && uchar(*json) <= Space)
+        json = skipWhitespace(json, end);
     return (json < end);
 }
 
@@ -857,6 +978,10 @@ bool Parser::parseString()
     bool isUtf8 = true;
     bool isAscii = true;
     while (json < end) {
+        json = skipPlainString(json, end);
+        if (json == end)
+            break;
+
         char32_t ch = 0;
         if (*json == '"')
             break;
@@ -899,6 +1024,13 @@ bool Parser::parseString()
 
     QString ucs4;
     while (json < end) {
+        const char *run = json;
+        json = skipPlainString(json, end);
+        if (json != run)
+            ucs4.append(QLatin1StringView(run, json));
+        if (json == end)
+            break;
+
         char32_t ch = 0;
         if (*json == '"')
             break;
@@ -928,4 +1060,35 @@ bool Parser::parseString()
     return true;
 }
 
+/*
+    Decodes the contents of a string, the text between the quotation marks,
+    for QJsonStreamReader.
+*/
+QJsonParseError::ParseError Parser::decodeString(const char *json, const char *end,
+                                                 QString *result)
+{
+    const QByteArrayView utf8(json, end);
+    if (!utf8.contains('\\')) {
+        if (!QUtf8::isValidUtf8(utf8).isValidUtf8)
+            return QJsonParseError::IllegalUTF8String;
+        *result = QString::fromUtf8(utf8);
+        return QJsonParseError::NoError;
+    }
+
+    result->clear();
+    result->reserve(utf8.size());
+    while (json < end) {
+        char32_t ch = 0;
+        if (*json == '\\') {
+            if (!scanEscapeSequence(json, end, &ch))
+                return QJsonParseError::IllegalEscapeSequence;
+        } else {
+            if (!scanUtf8Char(json, end, &ch))
+                return QJsonParseError::IllegalUTF8String;
+        }
+        result->append(QChar::fromUcs4(ch));
+    }
+    return QJsonParseError::NoError;
+}
+
 QT_END_NAMESPACE
@@ -30,6 +30,9 @@ public:
 
     QCborValue parse(QJsonParseError *error);
 
+    static QJsonParseError::ParseError decodeString(const char *json, const char *end,
+                                                    QString *result);
+
 private:
     inline void eatBOM();
     inline bool eatSpace();
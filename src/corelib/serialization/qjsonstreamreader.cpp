@@ -0,0 +1,936 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qjsonstreamreader.h"
+
+#include "qjsonparser_p.h"
+#include <private/qnumeric_p.h>
+#include <private/qtools_p.h>
+#include <qcoreapplication.h>
+#include <qiodevice.h>
+#include <qjsonarray.h>
+#include <qjsonobject.h>
+#include <qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt::StringLiterals;
+using namespace QtMiscUtils;
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \ingroup qtserialization
+    \reentrant
+    \since 6.7
+
+    \brief The QJsonStreamReader class is a pull parser for JSON, operating on
+    either a QByteArray or a QIODevice.
+
+    QJsonDocument::fromJson() parses the whole document into memory before
+    any of it can be used. QJsonStreamReader instead reports the document as
+    a stream of tokens, in the style of QXmlStreamReader and
+    QCborStreamReader, and only keeps the data of the current token. It can
+    therefore process documents of any size, such as large exports consisting
+    of one huge array, in constant memory.
+
+    The basic loop reads the tokens one after the other with readNext():
+
+    \snippet code/src_corelib_serialization_qjsonstream.cpp 0
+
+    Array and object elements usually are records that are small enough to be
+    handled with QJsonValue. readNextValue() advances to the next value in the
+    current container, and readValue() returns it, complete with its
+    contents:
+
+    \snippet code/src_corelib_serialization_qjsonstream.cpp 1
+
+    Unlike QJsonDocument, QJsonStreamReader accepts any value at the top
+    level, as RFC 8259 does. With setMultipleDocuments(), it also reads a
+    sequence of top-level values separated by whitespace, such as
+    newline-delimited JSON.
+
+    \section1 Incremental parsing
+
+    The data can be added in chunks with addData(), or read from a device as
+    needed. When the data ends in the middle of the document, readNext()
+    returns Invalid and error() is PrematureEndOfDocumentError. This error is
+    recoverable: once more data has been added with addData(), or is
+    available from the device, calling readNext() continues where the parser
+    stopped.
+
+    A number is only complete once the character following it has been seen,
+    or the input has ended, as more digits could follow. The input ends with
+    the data passed to the constructor, at the end of a file, or once a
+    sequential device has been closed. Data added with addData() can always
+    be continued, so when reading a sequence of top-level numbers that way,
+    each of them needs to be followed by whitespace, which newline-delimited
+    JSON does anyway.
+
+    \sa QJsonStreamWriter, QJsonDocument, QCborStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader just read.
+
+    \value NoToken          The reader has not yet read anything.
+    \value Invalid          An error has occurred, reported in error() and
+                            errorString().
+    \value StartArray       The reader reports the start of an array. The
+                            elements of the array follow, and then EndArray.
+    \value EndArray         The reader reports the end of an array.
+    \value StartObject      The reader reports the start of an object. The
+                            members of the object follow, each of them a Name
+                            followed by a value, and then EndObject.
+    \value EndObject        The reader reports the end of an object.
+    \value Name             The reader reports the name of an object member,
+                            in text().
+    \value String           The reader reports a string, in text().
+    \value Number           The reader reports a number; see toDouble(),
+                            toInteger() and isInteger().
+    \value Bool             The reader reports \c true or \c false; see
+                            toBool().
+    \value Null             The reader reports \c null.
+    \value EndDocument      The reader has reached the end of the input.
+*/
+
+/*!
+    \enum QJsonStreamReader::Error
+
+    This enum specifies the different error cases.
+
+    \value NoError          No error has occurred.
+    \value CustomError      A custom error has been raised with raiseError().
+    \value NotWellFormedError The parser internally raised an error due to
+                            the read JSON not being well-formed.
+    \value PrematureEndOfDocumentError The input ended before a well-formed
+                            JSON document was parsed completely. This error is
+                            recoverable, see \l{Incremental parsing}.
+*/
+
+static const int nestingLimit = 1024;
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum {
+        IdealIoBufferSize = 16384
+    };
+    enum ScanResult {
+        TokenRead,
+        NeedMoreData,
+        ScanError
+    };
+    enum ContainerState : quint8 {
+        ExpectFirst,
+        ExpectValue,
+        AfterValue
+    };
+    struct Container {
+        bool isObject;
+        ContainerState state;
+    };
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    qsizetype pos = 0;
+    qint64 bufferOffset = 0;
+    qint64 tokenOffset = 0;
+    qsizetype scannedStringSize = 0;
+    QVarLengthArray<Container, 16> containers;
+
+    QJsonStreamReader::TokenType type = QJsonStreamReader::NoToken;
+    QJsonStreamReader::Error error = QJsonStreamReader::NoError;
+    QString errorString;
+
+    QString text;
+    double doubleValue = 0;
+    qint64 integerValue = 0;
+    bool isInteger = false;
+    bool boolValue = false;
+
+    bool multipleDocuments = false;
+    bool bomChecked = false;
+    bool documentDone = false;
+    // the buffer holds all of the input, nothing will be added to it
+    bool dataComplete = false;
+
+    QJsonStreamReaderPrivate(const QByteArray &data)
+        : buffer(data), dataComplete(true)
+    {
+    }
+
+    QJsonStreamReaderPrivate(QIODevice *device)
+        : device(device)
+    {
+    }
+
+    void clear()
+    {
+        buffer.clear();
+        pos = 0;
+        bufferOffset = 0;
+        tokenOffset = 0;
+        scannedStringSize = 0;
+        containers.clear();
+        type = QJsonStreamReader::NoToken;
+        error = QJsonStreamReader::NoError;
+        errorString.clear();
+        text.clear();
+        bomChecked = false;
+        documentDone = false;
+        dataComplete = false;
+    }
+
+    void compact()
+    {
+        // drop the consumed data, but only once it's at least half of the
+        // buffer, so that this doesn't become quadratic
+        if (pos && pos >= buffer.size() - pos) {
+            buffer.remove(0, pos);
+            bufferOffset += pos;
+            pos = 0;
+        }
+    }
+
+    bool readMore();
+    bool atInputEnd() const;
+    void readNext();
+    ScanResult scan();
+    ScanResult scanValue(const char *json, const char *end);
+    ScanResult scanName(const char *json, const char *end);
+    ScanResult scanString(const char *&json, const char *end);
+    ScanResult scanLiteral(const char *json, const char *end, QLatin1StringView literal);
+    ScanResult scanNumber(const char *json, const char *end);
+    ScanResult endContainer(const char *json);
+    ScanResult setToken(QJsonStreamReader::TokenType token, const char *json);
+    ScanResult parseError(QJsonParseError::ParseError code, const char *json);
+    void valueDone();
+    void raiseError(QJsonStreamReader::Error code, const QString &message);
+};
+
+static const char *skipSpace(const char *json, const char *end)
+{
+    while (json < end && (*json == ' ' || *json == '\t' || *json == '\n' || *json == '\r'))
+        ++json;
+    return json;
+}
+
+bool QJsonStreamReaderPrivate::readMore()
+{
+    if (!device || !device->isReadable())
+        return false;
+
+    compact();
+    const qsizetype oldSize = buffer.size();
+    buffer.resize(oldSize + IdealIoBufferSize);
+    const qint64 n = device->read(buffer.data() + oldSize, IdealIoBufferSize);
+    buffer.resize(oldSize + qMax(n, qint64(0)));
+    return n > 0;
+}
+
+bool QJsonStreamReaderPrivate::atInputEnd() const
+{
+    if (!device)
+        return dataComplete;
+    // a sequential device may still receive more data, unless it was closed
+    return device->atEnd() && (!device->isSequential() || !device->isReadable());
+}
+
+void QJsonStreamReaderPrivate::raiseError(QJsonStreamReader::Error code, const QString &message)
+{
+    type = QJsonStreamReader::Invalid;
+    error = code;
+    errorString = message;
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::parseError(QJsonParseError::ParseError code, const char *json)
+{
+    QJsonParseError parseError;
+    parseError.error = code;
+    tokenOffset = bufferOffset + (json - buffer.constData());
+    raiseError(QJsonStreamReader::NotWellFormedError, parseError.errorString());
+    return ScanError;
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::setToken(QJsonStreamReader::TokenType token, const char *json)
+{
+    type = token;
+    pos = json - buffer.constData();
+    return TokenRead;
+}
+
+void QJsonStreamReaderPrivate::valueDone()
+{
+    if (containers.isEmpty())
+        documentDone = true;
+    else
+        containers.last().state = AfterValue;
+}
+
+void QJsonStreamReaderPrivate::readNext()
+{
+    if (error == QJsonStreamReader::PrematureEndOfDocumentError)
+        error = QJsonStreamReader::NoError;     // resume
+    else if (error != QJsonStreamReader::NoError)
+        return;
+    else if (type == QJsonStreamReader::EndDocument && !multipleDocuments)
+        return;
+
+    for (;;) {
+        switch (scan()) {
+        case TokenRead:
+        case ScanError:
+            return;
+        case NeedMoreData:
+            if (readMore())
+                continue;
+            break;
+        }
+
+        // only whitespace is left when between documents
+        if (containers.isEmpty() && pos == buffer.size() && (documentDone || multipleDocuments))
+            type = QJsonStreamReader::EndDocument;
+        else
+            raiseError(QJsonStreamReader::PrematureEndOfDocumentError,
+                       QCoreApplication::translate("QJsonStreamReader",
+                                                   "Premature end of document."));
+        return;
+    }
+}
+
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scan()
+{
+    const char *begin = buffer.constData();
+    const char *end = begin + buffer.size();
+    const char *json = begin + pos;
+
+    if (!bomChecked) {
+        // skip the UTF-8 byte order mark
+        static const char bom[] = "\xef\xbb\xbf";
+        const qsizetype n = qMin(end - json, qsizetype(3));
+        if (memcmp(json, bom, n) == 0) {
+            if (n < 3)
+                return NeedMoreData;
+            json += 3;
+        }
+        bomChecked = true;
+    }
+
+    // the whitespace is consumed even if the token that follows is incomplete
+    json = skipSpace(json, end);
+    pos = json - begin;
+    if (json == end)
+        return NeedMoreData;
+    tokenOffset = bufferOffset + pos;
+
+    if (containers.isEmpty()) {
+        if (documentDone) {
+            if (!multipleDocuments)
+                return parseError(QJsonParseError::GarbageAtEnd, json);
+            documentDone = false;
+        }
+        return scanValue(json, end);
+    }
+
+    const Container container = containers.last();
+    if (container.state == ExpectValue)
+        return scanValue(json, end);
+
+    const char endToken = container.isObject ? '}' : ']';
+    if (*json == endToken)
+        return endContainer(json + 1);
+
+    if (container.state == AfterValue) {
+        if (*json != ',') {
+            return parseError(container.isObject ? QJsonParseError::UnterminatedObject
+                                                 : QJsonParseError::MissingValueSeparator, json);
+        }
+        json = skipSpace(json + 1, end);
+        if (json == end)
+            return NeedMoreData;
+    }
+
+    if (!container.isObject)
+        return scanValue(json, end);
+    if (*json == '"')
+        return scanName(json, end);
+    return parseError(*json == endToken ? QJsonParseError::MissingObject
+                                        : QJsonParseError::UnterminatedObject, json);
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::scanValue(const char *json, const char *end)
+{
+    switch (*json) {
+    case '[':
+    case '{':
+        if (containers.size() >= nestingLimit)
+            return parseError(QJsonParseError::DeepNesting, json);
+        containers.append({ *json == '{', ExpectFirst });
+        return setToken(*json == '{' ? QJsonStreamReader::StartObject
+                                     : QJsonStreamReader::StartArray, json + 1);
+    case '"':
+        if (ScanResult r = scanString(json, end); r != TokenRead)
+            return r;
+        valueDone();
+        return setToken(QJsonStreamReader::String, json);
+    case 't':
+        return scanLiteral(json, end, "true"_L1);
+    case 'f':
+        return scanLiteral(json, end, "false"_L1);
+    case 'n':
+        return scanLiteral(json, end, "null"_L1);
+    case ',':
+        // Essentially missing value, but after a colon, not after a comma
+        // like the other MissingObject errors.
+        return parseError(QJsonParseError::IllegalValue, json);
+    case ']':
+    case '}':
+        return parseError(QJsonParseError::MissingObject, json);
+    default:
+        return scanNumber(json, end);
+    }
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::scanName(const char *json, const char *end)
+{
+    if (ScanResult r = scanString(json, end); r != TokenRead)
+        return r;
+    json = skipSpace(json, end);
+    if (json == end)
+        return NeedMoreData;
+    if (*json != ':')
+        return parseError(QJsonParseError::MissingNameSeparator, json);
+    containers.last().state = ExpectValue;
+    return setToken(QJsonStreamReader::Name, json + 1);
+}
+
+// on success, advances json past the closing quotation mark
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::scanString(const char *&json, const char *end)
+{
+    Q_ASSERT(*json == '"');
+    const char *start = json + 1;
+
+    // don't search the part of a long string that arrived in earlier chunks again
+    const char *stop = start + scannedStringSize;
+    for (;;) {
+        stop = static_cast<const char *>(memchr(stop, '"', end - stop));
+        if (!stop) {
+            scannedStringSize = end - start;
+            return NeedMoreData;
+        }
+
+        // the quotation mark is escaped if preceded by an odd number of backslashes
+        const char *backslash = stop;
+        while (backslash > start && backslash[-1] == '\\')
+            --backslash;
+        if ((stop - backslash) % 2 == 0)
+            break;
+        ++stop;
+    }
+    scannedStringSize = 0;
+
+    const QJsonParseError::ParseError code = QJsonPrivate::Parser::decodeString(start, stop, &text);
+    if (code != QJsonParseError::NoError)
+        return parseError(code, start);
+    json = stop + 1;
+    return TokenRead;
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::scanLiteral(const char *json, const char *end, QLatin1StringView literal)
+{
+    const qsizetype available = qMin(end - json, literal.size());
+    if (memcmp(json, literal.data(), available) != 0)
+        return parseError(QJsonParseError::IllegalValue, json);
+    if (available < literal.size())
+        return NeedMoreData;
+
+    if (literal.front() == 'n') {
+        valueDone();
+        return setToken(QJsonStreamReader::Null, json + literal.size());
+    }
+    boolValue = literal.front() == 't';
+    valueDone();
+    return setToken(QJsonStreamReader::Bool, json + literal.size());
+}
+
+/*
+    The same grammar and conversions as QJsonPrivate::Parser::parseNumber().
+*/
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::scanNumber(const char *json, const char *end)
+{
+    const char *start = json;
+    bool isInt = true;
+
+    if (json < end && *json == '-')
+        ++json;
+
+    if (json < end && *json == '0') {
+        ++json;
+    } else {
+        while (json < end && isAsciiDigit(*json))
+            ++json;
+    }
+
+    if (json < end && *json == '.') {
+        ++json;
+        while (json < end && isAsciiDigit(*json)) {
+            isInt = isInt && *json == '0';
+            ++json;
+        }
+    }
+
+    if (json < end && (*json == 'e' || *json == 'E')) {
+        isInt = false;
+        ++json;
+        if (json < end && (*json == '-' || *json == '+'))
+            ++json;
+        while (json < end && isAsciiDigit(*json))
+            ++json;
+    }
+
+    // more digits may follow, unless this is the end of the whole input
+    if (json == end && !(containers.isEmpty() && atInputEnd()))
+        return NeedMoreData;
+
+    const QByteArray number = QByteArray::fromRawData(start, json - start);
+    bool ok = false;
+    if (isInt) {
+        integerValue = number.toLongLong(&ok);
+        doubleValue = double(integerValue);
+    }
+    if (!ok) {
+        doubleValue = number.toDouble(&ok);
+        if (!ok)
+            return parseError(QJsonParseError::IllegalNumber, start);
+        isInt = convertDoubleTo(doubleValue, &integerValue);
+    }
+
+    isInteger = isInt;
+    valueDone();
+    return setToken(QJsonStreamReader::Number, json);
+}
+
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::endContainer(const char *json)
+{
+    const bool isObject = containers.last().isObject;
+    containers.removeLast();
+    valueDone();
+    return setToken(isObject ? QJsonStreamReader::EndObject : QJsonStreamReader::EndArray, json);
+}
+
+/*!
+    Constructs a stream reader with no data. Use addData() or setDevice() to
+    supply it.
+
+    \sa addData(), setDevice()
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d(new QJsonStreamReaderPrivate(nullptr))
+{
+}
+
+/*!
+    Creates a stream reader that reads from \a data. The data is complete,
+    so a number at its end does not need to be followed by whitespace.
+
+    \sa addData(), setDevice()
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d(new QJsonStreamReaderPrivate(data))
+{
+}
+
+/*!
+    Creates a stream reader that reads from \a device. The device must be
+    open for reading.
+
+    \sa setDevice()
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d(new QJsonStreamReaderPrivate(device))
+{
+}
+
+/*!
+    Destroys the reader. The device, if any, is not closed.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device, and resets the reader to its
+    initial state.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    clear();
+    d->device = device;
+}
+
+/*!
+    Returns the current device, or \nullptr if none is set.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    return d->device;
+}
+
+/*!
+    Adds more \a data for the reader to read. This function does nothing if
+    the reader has a device().
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    d->compact();
+    d->buffer += data;
+    d->dataComplete = false;
+}
+
+/*!
+    \overload
+
+    Adds the \a len bytes of data starting at \a data for the reader to read.
+*/
+void QJsonStreamReader::addData(const char *data, qsizetype len)
+{
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    d->compact();
+    d->buffer.append(data, len);
+    d->dataComplete = false;
+}
+
+/*!
+    Removes any device() or data from the reader and resets its internal
+    state to the initial state. The setting of multipleDocuments() is kept.
+
+    \sa addData(), setDevice()
+*/
+void QJsonStreamReader::clear()
+{
+    d->clear();
+    d->device = nullptr;
+}
+
+/*!
+    If \a enable is \c true, the reader reads a sequence of top-level values
+    separated by optional whitespace, such as newline-delimited JSON (also
+    known as JSON Lines). Otherwise, which is the default, anything but
+    whitespace after the first top-level value is an error.
+
+    In both cases, EndDocument is reported once the data runs out between
+    two top-level values. With multiple documents, reading can continue
+    after that once more data is available.
+
+    \sa multipleDocuments()
+*/
+void QJsonStreamReader::setMultipleDocuments(bool enable)
+{
+    d->multipleDocuments = enable;
+}
+
+/*!
+    Returns \c true if the reader reads a sequence of top-level values.
+
+    \sa setMultipleDocuments()
+*/
+bool QJsonStreamReader::multipleDocuments() const
+{
+    return d->multipleDocuments;
+}
+
+/*!
+    Returns \c true if the reader has read until the end of the input, or if
+    an error has occurred. Otherwise, it returns \c false.
+
+    When atEnd() and hasError() return \c true and error() returns
+    PrematureEndOfDocumentError, the JSON has been well-formed so far, but it
+    is not complete yet. Reading can continue once more data is available.
+
+    \sa readNext(), hasError()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    return d->type == EndDocument || d->error != NoError;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    Once an error has been reported, readNext() keeps returning Invalid,
+    except when the error is PrematureEndOfDocumentError: then reading
+    continues with the data that has been added since.
+
+    \sa tokenType(), atEnd()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    d->readNext();
+    return d->type;
+}
+
+/*!
+    Reads until the next value in the current container, skipping the name
+    of an object member. Returns \c true if a value was reached, that is, if
+    the current token is StartArray, StartObject, String, Number, Bool or
+    Null. Returns \c false if the end of the current container, or of the
+    input, was reached or an error occurred.
+
+    \sa readValue(), skipCurrentValue()
+*/
+bool QJsonStreamReader::readNextValue()
+{
+    if (readNext() == Name)
+        readNext();
+    switch (d->type) {
+    case StartArray:
+    case StartObject:
+    case String:
+    case Number:
+    case Bool:
+    case Null:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*!
+    Skips the current value. If the current token is StartArray or
+    StartObject, reads until the matching EndArray or EndObject. Otherwise,
+    does nothing.
+
+    \sa readValue()
+*/
+void QJsonStreamReader::skipCurrentValue()
+{
+    if (d->type != StartArray && d->type != StartObject)
+        return;
+
+    const int depth = d->containers.size();
+    while (d->containers.size() >= depth && readNext() != Invalid) {
+    }
+}
+
+static QJsonValue readContainer(QJsonStreamReader &reader)
+{
+    if (reader.isStartArray()) {
+        QJsonArray array;
+        while (reader.readNextValue())
+            array.append(reader.readValue());
+        return array;
+    }
+
+    QJsonObject object;
+    while (reader.readNext() == QJsonStreamReader::Name) {
+        const QString name = reader.text().toString();
+        if (!reader.readNextValue())
+            break;
+        object.insert(name, reader.readValue());
+    }
+    return object;
+}
+
+/*!
+    Returns the current value. If the current token is StartArray or
+    StartObject, this function reads the whole array or object and the
+    current token is the matching EndArray or EndObject afterwards.
+
+    Returns an undefined value if the current token is not the start of a
+    value, or if an error occurs while reading it. Since a value cannot be
+    resumed after it has been partially read, this function should only be
+    used when the whole value is available, or with a device that blocks
+    until it is, such as a file.
+
+    \sa readNextValue(), value(), skipCurrentValue()
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    if (d->type != StartArray && d->type != StartObject)
+        return value();
+
+    QJsonValue result = readContainer(*this);
+    if (hasError())
+        return QJsonValue::Undefined;
+    return result;
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa readNext()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    return d->type;
+}
+
+/*!
+    Returns the number of arrays and objects that contain the current
+    token. StartArray and StartObject are counted as inside of their
+    container, EndArray and EndObject as outside of it.
+*/
+int QJsonStreamReader::depth() const
+{
+    return int(d->containers.size());
+}
+
+/*!
+    Returns the offset in bytes of the current token from the start of the
+    input. If an error occurred, returns the offset of the error.
+*/
+qint64 QJsonStreamReader::currentOffset() const
+{
+    return d->tokenOffset;
+}
+
+/*!
+    Returns the decoded text of the current Name or String token, or an
+    empty view for other tokens. The view is valid until the next call to
+    readNext().
+
+    \sa tokenType()
+*/
+QStringView QJsonStreamReader::text() const
+{
+    if (d->type == Name || d->type == String)
+        return d->text;
+    return {};
+}
+
+/*!
+    Returns \c true if the current token is a Number that can be represented
+    as a qint64 without loss of precision, under the same rules as
+    QJsonDocument::fromJson().
+
+    \sa toInteger(), toDouble()
+*/
+bool QJsonStreamReader::isInteger() const
+{
+    return d->type == Number && d->isInteger;
+}
+
+/*!
+    Returns the value of the current Number token as an integer, or 0 if it
+    is not a Number or not an integer.
+
+    \sa isInteger(), toDouble()
+*/
+qint64 QJsonStreamReader::toInteger() const
+{
+    return isInteger() ? d->integerValue : 0;
+}
+
+/*!
+    Returns the value of the current Number token, or 0 if the current token
+    is not a Number.
+
+    \sa toInteger()
+*/
+double QJsonStreamReader::toDouble() const
+{
+    return d->type == Number ? d->doubleValue : 0;
+}
+
+/*!
+    Returns the value of the current Bool token, or \c false if the current
+    token is not a Bool.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    return d->type == Bool && d->boolValue;
+}
+
+/*!
+    Returns the current String, Number, Bool or Null token as a QJsonValue.
+    For other tokens, returns an undefined value.
+
+    \sa readValue()
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    switch (d->type) {
+    case String:
+        return d->text;
+    case Number:
+        if (d->isInteger)
+            return d->integerValue;
+        return d->doubleValue;
+    case Bool:
+        return d->boolValue;
+    case Null:
+        return QJsonValue::Null;
+    default:
+        return QJsonValue::Undefined;
+    }
+}
+
+/*!
+    Returns the type of the current error, or NoError if no error occurred.
+
+    \sa errorString(), raiseError()
+*/
+QJsonStreamReader::Error QJsonStreamReader::error() const
+{
+    return d->error;
+}
+
+/*!
+    Returns the error message that was set with raiseError(), or the one of
+    the parse error that occurred.
+
+    \sa error(), currentOffset()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    return d->errorString;
+}
+
+/*!
+    Returns \c true if an error has occurred, otherwise \c false.
+
+    \sa error(), errorString()
+*/
+bool QJsonStreamReader::hasError() const
+{
+    return d->error != NoError;
+}
+
+/*!
+    Raises a custom error with an optional error \a message, for instance
+    when the data does not have the expected structure.
+
+    \sa error(), errorString()
+*/
+void QJsonStreamReader::raiseError(const QString &message)
+{
+    d->raiseError(CustomError, message);
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qjsonstreamreader.cpp"
@@ -0,0 +1,368 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qjsonstreamwriter.h"
+
+#include "qjsonwriter_p.h"
+#include <qcborvalue.h>
+#include <qiodevice.h>
+#include <qjsonvalue.h>
+#include <qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \ingroup qtserialization
+    \reentrant
+    \since 6.7
+
+    \brief The QJsonStreamWriter class is a simple JSON encoder operating on a
+    one-way stream.
+
+    QJsonStreamWriter writes JSON directly to a QIODevice or a QByteArray, as
+    the values are appended, without building a QJsonDocument first. It is
+    the counterpart of QJsonStreamReader, and its API follows the one of
+    QCborStreamWriter.
+
+    Arrays and objects are started with startArray() and startObject(), and
+    ended with endArray() and endObject(). Inside an object, the name of each
+    member is appended as a string before its value:
+
+    \snippet code/src_corelib_serialization_qjsonstream.cpp 2
+
+    The output is the same as the one of QJsonDocument::toJson() for the same
+    data, in the format() that was set. When more than one top-level value is
+    written in the QJsonDocument::Compact format, they are separated by a
+    newline, which produces newline-delimited JSON.
+
+    QJsonStreamWriter does not check that the values it is given form a valid
+    document; it asserts in debug builds if names and values don't alternate
+    inside objects, or if containers are ended when they were not started.
+
+    \sa QJsonStreamReader, QJsonDocument, QCborStreamWriter
+*/
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Container {
+        bool isObject;
+        bool expectingValue;
+        qsizetype count;
+    };
+
+    QIODevice *device = nullptr;
+    QByteArray *data = nullptr;
+    QByteArray buffer;
+    QVarLengthArray<Container, 16> containers;
+    qint64 documents = 0;
+    bool compact = false;
+
+    QJsonStreamWriterPrivate(QIODevice *device)
+        : device(device)
+    {
+    }
+
+    QJsonStreamWriterPrivate(QByteArray *data)
+        : data(data)
+    {
+    }
+
+    QByteArray &output()
+    {
+        return data ? *data : buffer;
+    }
+
+    void flush()
+    {
+        if (device && !buffer.isEmpty()) {
+            device->write(buffer);
+            buffer.resize(0);
+        }
+    }
+
+    void writeIndentation(int indent)
+    {
+        if (!compact)
+            output().append(4 * indent, ' ');
+    }
+
+    void startElement();
+    bool isNameExpected() const
+    {
+        return !containers.isEmpty() && containers.last().isObject
+                && !containers.last().expectingValue;
+    }
+    void valueDone();
+    void appendValue(const QCborValue &value);
+    bool endContainer(bool isObject);
+};
+
+/*
+    Writes what precedes a value or the name of an object member: the
+    separator from the previous one and the indentation.
+*/
+void QJsonStreamWriterPrivate::startElement()
+{
+    if (containers.isEmpty()) {
+        if (documents++ && compact)
+            output() += '\n';
+        return;
+    }
+
+    Container &container = containers.last();
+    if (container.expectingValue) {
+        container.expectingValue = false;
+        return;
+    }
+    if (container.count++)
+        output() += compact ? "," : ",\n";
+    writeIndentation(int(containers.size()));
+}
+
+void QJsonStreamWriterPrivate::valueDone()
+{
+    if (containers.isEmpty() && !compact)
+        output() += '\n';
+    flush();
+}
+
+void QJsonStreamWriterPrivate::appendValue(const QCborValue &value)
+{
+    Q_ASSERT_X(!isNameExpected(), "QJsonStreamWriter::append",
+               "The name of an object member must be a string");
+    startElement();
+    QJsonPrivate::Writer::valueToJson(value, output(), int(containers.size()), compact);
+    valueDone();
+}
+
+bool QJsonStreamWriterPrivate::endContainer(bool isObject)
+{
+    if (containers.isEmpty() || containers.last().isObject != isObject
+            || containers.last().expectingValue) {
+        Q_ASSERT_X(false, isObject ? "QJsonStreamWriter::endObject" : "QJsonStreamWriter::endArray",
+                   "Container is not the current one or is incomplete");
+        return false;
+    }
+
+    const Container container = containers.last();
+    containers.removeLast();
+    if (container.count && !compact)
+        output() += '\n';
+    writeIndentation(int(containers.size()));
+    output() += isObject ? '}' : ']';
+    valueDone();
+    return true;
+}
+
+/*!
+    Creates a QJsonStreamWriter object that will write the stream to \a
+    device. The device must be opened before the first append() call is made.
+
+    \sa setDevice()
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d(new QJsonStreamWriterPrivate(device))
+{
+}
+
+/*!
+    Creates a QJsonStreamWriter object that will append the stream to \a
+    data. All streaming is done immediately to the byte array, without the
+    need for flushing any buffers.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *data)
+    : d(new QJsonStreamWriterPrivate(data))
+{
+}
+
+/*!
+    Destroys this QJsonStreamWriter object and frees any resources associated
+    with it. QJsonStreamWriter does not verify that the values written form a
+    complete document.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+}
+
+/*!
+    Replaces the device or byte array that this QJsonStreamWriter object is
+    writing to with \a device.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    d->device = device;
+    d->data = nullptr;
+}
+
+/*!
+    Returns the QIODevice that this QJsonStreamWriter object is writing to,
+    or \nullptr if it is writing to a QByteArray.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    return d->device;
+}
+
+/*!
+    Sets the format of the output to \a format. The default is
+    QJsonDocument::Indented, as for QJsonDocument::toJson().
+
+    \sa format()
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    d->compact = format == QJsonDocument::Compact;
+}
+
+/*!
+    Returns the format of the output.
+
+    \sa setFormat()
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    return d->compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+}
+
+/*!
+    Appends the string \a str to the stream. Inside an object, the string is
+    the name of the next member if the previous member is complete, and its
+    value otherwise.
+*/
+void QJsonStreamWriter::append(QAnyStringView str)
+{
+    const bool isName = d->isNameExpected();
+    d->startElement();
+
+    const QByteArray escaped = str.visit([](auto s) {
+        if constexpr (std::is_same_v<decltype(s), QStringView>)
+            return QJsonPrivate::Writer::escapedString(s);
+        else
+            return QJsonPrivate::Writer::escapedString(s.toString());
+    });
+    QByteArray &json = d->output();
+    json += '"';
+    json += escaped;
+    json += '"';
+
+    if (isName) {
+        json += d->compact ? ":" : ": ";
+        d->containers.last().expectingValue = true;
+        return;
+    }
+    d->valueDone();
+}
+
+/*!
+    \overload
+
+    Appends the integer \a i to the stream.
+*/
+void QJsonStreamWriter::append(qint64 i)
+{
+    d->appendValue(QCborValue(i));
+}
+
+/*!
+    \overload
+
+    Appends the floating point number \a d to the stream. Infinities and NaN
+    are written as \c null, as JSON cannot represent them.
+*/
+void QJsonStreamWriter::append(double d)
+{
+    this->d->appendValue(QCborValue(d));
+}
+
+/*!
+    \overload
+
+    Appends the boolean value \a b to the stream.
+*/
+void QJsonStreamWriter::append(bool b)
+{
+    d->appendValue(QCborValue(b));
+}
+
+/*!
+    \overload
+
+    Appends \c null to the stream.
+*/
+void QJsonStreamWriter::append(std::nullptr_t)
+{
+    d->appendValue(QCborValue(nullptr));
+}
+
+/*!
+    \overload
+
+    Appends \a value to the stream, including the contents of arrays and
+    objects. An undefined value is written as \c null.
+*/
+void QJsonStreamWriter::append(const QJsonValue &value)
+{
+    d->appendValue(QCborValue::fromJsonValue(value));
+}
+
+/*!
+    Starts an array. The elements appended after this call belong to the
+    array, until endArray() is called.
+
+    \sa endArray(), startObject()
+*/
+void QJsonStreamWriter::startArray()
+{
+    Q_ASSERT_X(!d->isNameExpected(), "QJsonStreamWriter::startArray",
+               "The name of an object member must be a string");
+    d->startElement();
+    d->output() += d->compact ? "[" : "[\n";
+    d->containers.append({ false, false, 0 });
+}
+
+/*!
+    Ends the array started by the matching startArray() and returns \c true
+    if that was the current container.
+
+    \sa startArray(), endObject()
+*/
+bool QJsonStreamWriter::endArray()
+{
+    return d->endContainer(false);
+}
+
+/*!
+    Starts an object. Inside it, names and values are appended alternately
+    until endObject() is called.
+
+    \sa endObject(), startArray()
+*/
+void QJsonStreamWriter::startObject()
+{
+    Q_ASSERT_X(!d->isNameExpected(), "QJsonStreamWriter::startObject",
+               "The name of an object member must be a string");
+    d->startElement();
+    d->output() += d->compact ? "{" : "{\n";
+    d->containers.append({ true, false, 0 });
+}
+
+/*!
+    Ends the object started by the matching startObject() and returns \c true
+    if that was the current container and its last member is complete.
+
+    \sa startObject(), endArray()
+*/
+bool QJsonStreamWriter::endObject()
+{
+    return d->endContainer(true);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,59 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QJSONSTREAMWRITER_H
+#define QJSONSTREAMWRITER_H
+
+#include <QtCore/qanystringview.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qscopedpointer.h>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+class QJsonValue;
+
+class QJsonStreamWriterPrivate;
+class Q_CORE_EXPORT QJsonStreamWriter
+{
+public:
+    explicit QJsonStreamWriter(QIODevice *device);
+    explicit QJsonStreamWriter(QByteArray *data);
+    ~QJsonStreamWriter();
+    Q_DISABLE_COPY(QJsonStreamWriter)
+
+    void setDevice(QIODevice *device);
+    QIODevice *device() const;
+
+    void setFormat(QJsonDocument::JsonFormat format);
+    QJsonDocument::JsonFormat format() const;
+
+    void append(QAnyStringView str);
+    void append(const QString &str)     { append(QAnyStringView(str)); }
+    void append(QLatin1StringView str)  { append(QAnyStringView(str)); }
+    void append(qint64 i);
+    void append(double d);
+    void append(bool b);
+    void append(std::nullptr_t);
+    void append(const QJsonValue &value);
+
+#ifndef Q_QDOC
+    // overloads to make normal code not complain
+    void append(int i)              { append(qint64(i)); }
+    void append(uint u)             { append(qint64(u)); }
+    void append(const char *str)    { append(QAnyStringView(str)); }
+#endif
+
+    void startArray();
+    bool endArray();
+    void startObject();
+    bool endObject();
+
+private:
+    QScopedPointer<QJsonStreamWriterPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QJSONSTREAMWRITER_H
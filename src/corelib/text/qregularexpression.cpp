@@ -14,6 +14,8 @@
 #include <QtCore/qglobal.h>
 #include <QtCore/qatomic.h>
 #include <QtCore/qdatastream.h>
+#include <QtCore/qanystringview.h>
+#include <QtCore/private/qstringconverter_p.h>
 
 #if defined(Q_OS_MACOS)
 #include <QtCore/private/qcore_mac_p.h>
@@ -23,6 +25,8 @@
 
 #include <pcre2.h>
 
+#include <array>
+
 QT_BEGIN_NAMESPACE
 
 using namespace Qt::StringLiterals;
@@ -246,6 +250,19 @@ using namespace Qt::StringLiterals;
     It is possible to pass a starting offset and one or more match options to
     the globalMatch() function, exactly like normal matching with match().
 
+    \section2 Matching UTF-8 and Latin-1 data
+
+    QRegularExpression works on UTF-16 strings, but matchView() and
+    globalMatchView() also accept QUtf8StringView and QLatin1StringView
+    subjects. These are matched as they are, without a conversion to
+    QString, which saves both time and memory when the data is only
+    available in one of these encodings (for instance, lines read from a
+    log file). Offsets, both the ones passed in and the ones returned by
+    QRegularExpressionMatch, are then in the units of the subject: bytes
+    for UTF-8, characters for Latin-1.
+
+    \snippet code/src_corelib_text_qregularexpression.cpp 37
+
     \target partial matching
     \section1 Partial Matching
 
@@ -710,6 +727,10 @@ struct QRegularExpressionPrivate : QSharedData
     void compilePattern();
     void getPatternInfo();
     void optimizePattern();
+#ifndef QT_BOOTSTRAPPED
+    void compileUtf8Pattern();
+    void compileLatin1Pattern();
+#endif
 
     enum CheckSubjectStringOption {
         CheckSubjectString,
@@ -720,6 +741,13 @@ struct QRegularExpressionPrivate : QSharedData
                  qsizetype offset,
                  CheckSubjectStringOption checkSubjectStringOption = CheckSubjectString,
                  const QRegularExpressionMatchPrivate *previous = nullptr) const;
+    template <typename Pcre2>
+    void doMatch(const typename Pcre2::Code *code,
+                 QRegularExpressionMatchPrivate *priv,
+                 const typename Pcre2::CodeUnit *subject,
+                 qsizetype offset,
+                 int pcreOptions,
+                 bool previousMatchWasEmpty) const;
 
     int captureIndexForName(QStringView name) const;
 
@@ -736,6 +764,16 @@ struct QRegularExpressionPrivate : QSharedData
     // objects themselves; when the private is copied (i.e. a detach happened)
     // it is set to nullptr
     pcre2_code_16 *compiledPattern;
+#ifndef QT_BOOTSTRAPPED
+    // The programs for matching over UTF-8 and Latin-1 subjects, compiled
+    // from the same pattern the first time they are needed. There is no
+    // Latin-1 program if the pattern cannot be written in Latin-1; such
+    // subjects are then matched over a UTF-16 copy.
+    pcre2_code_8 *compiledUtf8Pattern;
+    pcre2_code_8 *compiledLatin1Pattern;
+    bool hasCompiledUtf8Pattern;
+    bool hasCompiledLatin1Pattern;
+#endif
     int errorCode;
     qsizetype errorOffset;
     int capturingCount;
@@ -747,19 +785,36 @@ struct QRegularExpressionMatchPrivate : QSharedData
 {
     QRegularExpressionMatchPrivate(const QRegularExpression &re,
                                    const QString &subjectStorage,
-                                   QStringView subject,
+                                   QAnyStringView subject,
                                    QRegularExpression::MatchType matchType,
                                    QRegularExpression::MatchOptions matchOptions);
 
     QRegularExpressionMatch nextMatch() const;
 
+    enum SubjectEncoding { Utf16, Utf8, Latin1 };
+    static SubjectEncoding encodingOf(QAnyStringView subject)
+    {
+        return subject.visit([](auto view) {
+            using View = decltype(view);
+            if constexpr (std::is_same_v<View, QStringView>)
+                return Utf16;
+            else if constexpr (std::is_same_v<View, QLatin1StringView>)
+                return Latin1;
+            else
+                return Utf8;
+        });
+    }
+
     const QRegularExpression regularExpression;
 
     // subject is what we match upon. If we've been asked to match over
     // a QString, then subjectStorage is a copy of that string
-    // (so that it's kept alive by us)
+    // (so that it's kept alive by us). If we've been asked to match over
+    // Latin-1 and the pattern has no Latin-1 program, then subjectStorage
+    // is the subject converted to UTF-16, which has the same offsets.
     const QString subjectStorage;
-    const QStringView subject;
+    const QAnyStringView subject;
+    const SubjectEncoding subjectEncoding;
 
     const QRegularExpression::MatchType matchType;
     const QRegularExpression::MatchOptions matchOptions;
@@ -824,6 +879,12 @@ QRegularExpressionPrivate::QRegularExpressionPrivate()
       pattern(),
       mutex(),
       compiledPattern(nullptr),
+#ifndef QT_BOOTSTRAPPED
+      compiledUtf8Pattern(nullptr),
+      compiledLatin1Pattern(nullptr),
+      hasCompiledUtf8Pattern(false),
+      hasCompiledLatin1Pattern(false),
+#endif
       errorCode(0),
       errorOffset(-1),
       capturingCount(0),
@@ -855,6 +916,12 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
       pattern(other.pattern),
       mutex(),
       compiledPattern(nullptr),
+#ifndef QT_BOOTSTRAPPED
+      compiledUtf8Pattern(nullptr),
+      compiledLatin1Pattern(nullptr),
+      hasCompiledUtf8Pattern(false),
+      hasCompiledLatin1Pattern(false),
+#endif
       errorCode(0),
       errorOffset(-1),
       capturingCount(0),
@@ -870,6 +937,14 @@ void QRegularExpressionPrivate::cleanCompiledPattern()
 {
     pcre2_code_free_16(compiledPattern);
     compiledPattern = nullptr;
+#ifndef QT_BOOTSTRAPPED
+    pcre2_code_free_8(compiledUtf8Pattern);
+    compiledUtf8Pattern = nullptr;
+    pcre2_code_free_8(compiledLatin1Pattern);
+    compiledLatin1Pattern = nullptr;
+    hasCompiledUtf8Pattern = false;
+    hasCompiledLatin1Pattern = false;
+#endif
     errorCode = 0;
     errorOffset = -1;
     capturingCount = 0;
@@ -953,8 +1028,18 @@ struct PcreJitStackFree
         if (stack)
             pcre2_jit_stack_free_16(stack);
     }
+#ifndef QT_BOOTSTRAPPED
+    void operator()(pcre2_jit_stack_8 *stack)
+    {
+        if (stack)
+            pcre2_jit_stack_free_8(stack);
+    }
+#endif
 };
 Q_CONSTINIT static thread_local std::unique_ptr<pcre2_jit_stack_16, PcreJitStackFree> jitStacks;
+#ifndef QT_BOOTSTRAPPED
+Q_CONSTINIT static thread_local std::unique_ptr<pcre2_jit_stack_8, PcreJitStackFree> jitStacks8;
+#endif
 }
 
 /*!
@@ -965,6 +1050,16 @@ static pcre2_jit_stack_16 *qtPcreCallback(void *)
     return jitStacks.get();
 }
 
+#ifndef QT_BOOTSTRAPPED
+/*!
+    \internal
+*/
+static pcre2_jit_stack_8 *qtPcreCallback8(void *)
+{
+    return jitStacks8.get();
+}
+#endif
+
 /*!
     \internal
 */
@@ -1007,6 +1102,166 @@ void QRegularExpressionPrivate::optimizePattern()
     pcre2_jit_compile_16(compiledPattern, PCRE2_JIT_COMPLETE | PCRE2_JIT_PARTIAL_SOFT | PCRE2_JIT_PARTIAL_HARD);
 }
 
+#ifndef QT_BOOTSTRAPPED
+/*!
+    \internal
+
+    Same as optimizePattern(), for the programs that match over UTF-8
+    and Latin-1 subjects.
+*/
+static void optimizePattern8(pcre2_code_8 *code)
+{
+    static const bool enableJit = isJitEnabled();
+
+    if (!code || !enableJit)
+        return;
+
+    pcre2_jit_compile_8(code, PCRE2_JIT_COMPLETE | PCRE2_JIT_PARTIAL_SOFT | PCRE2_JIT_PARTIAL_HARD);
+}
+
+/*!
+    \internal
+
+    The character tables of the Latin-1 program, laid out as
+    pcre2_maketables() lays them out. Like PCRE2's default tables, they
+    only classify ASCII characters; unlike them, they also give the case
+    of the Latin-1 letters, which PCRE2 folds in UTF mode.
+*/
+static constexpr auto latin1CharacterTables = [] {
+    enum {
+        // the four tables
+        LowerCaseTable = 0,
+        FlipCaseTable = 256,
+        ClassTable = 512,
+        TypeTable = 512 + 320,
+        TablesSize = TypeTable + 256,
+
+        // offsets of the bitmaps in ClassTable
+        SpaceClass = 0,
+        XDigitClass = 32,
+        DigitClass = 64,
+        UpperClass = 96,
+        LowerClass = 128,
+        WordClass = 160,
+        GraphClass = 192,
+        PrintClass = 224,
+        PunctClass = 256,
+        CntrlClass = 288,
+
+        // flags in TypeTable
+        SpaceType = 0x01,
+        LetterType = 0x02,
+        LowerCaseLetterType = 0x04,
+        DigitType = 0x08,
+        WordType = 0x10
+    };
+
+    std::array<uint8_t, TablesSize> tables = {};
+    for (uint c = 0; c < 256; ++c) {
+        const bool upper = c >= 'A' && c <= 'Z';
+        const bool lower = c >= 'a' && c <= 'z';
+        const bool digit = c >= '0' && c <= '9';
+        const bool word = upper || lower || digit || c == '_';
+        const bool space = c == ' ' || (c >= '\t' && c <= '\r');
+        const bool graph = c > ' ' && c < 0x7f;
+
+        // À to Þ and à to þ, except for × and ÷
+        const bool upperLatin1 = upper || (c >= 0xc0 && c <= 0xde && c != 0xd7);
+        const bool lowerLatin1 = lower || (c >= 0xe0 && c <= 0xfe && c != 0xf7);
+        tables[LowerCaseTable + c] = uint8_t(upperLatin1 ? c + 0x20 : c);
+        tables[FlipCaseTable + c] = uint8_t(upperLatin1 ? c + 0x20 : lowerLatin1 ? c - 0x20 : c);
+
+        const auto addToClass = [&](uint offset, bool member) {
+            if (member)
+                tables[ClassTable + offset + c / 8] |= uint8_t(1U << (c % 8));
+        };
+        addToClass(SpaceClass, space);
+        addToClass(XDigitClass, digit || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f'));
+        addToClass(DigitClass, digit);
+        addToClass(UpperClass, upper);
+        addToClass(LowerClass, lower);
+        addToClass(WordClass, word);
+        addToClass(GraphClass, graph);
+        addToClass(PrintClass, graph || c == ' ');
+        addToClass(PunctClass, graph && !(word && c != '_'));
+        addToClass(CntrlClass, c < ' ' || c == 0x7f);
+
+        tables[TypeTable + c] = uint8_t((space ? SpaceType : 0)
+                                        | (upper || lower ? LetterType : 0)
+                                        | (lower ? LowerCaseLetterType : 0)
+                                        | (digit ? DigitType : 0)
+                                        | (word ? WordType : 0));
+    }
+    return tables;
+}();
+
+/*!
+    \internal
+
+    Compiles the program that matches over UTF-8 subjects, unless that
+    was done already. It has the same capturing groups as compiledPattern.
+*/
+void QRegularExpressionPrivate::compileUtf8Pattern()
+{
+    const QMutexLocker lock(&mutex);
+
+    if (hasCompiledUtf8Pattern || !compiledPattern)
+        return;
+
+    hasCompiledUtf8Pattern = true;
+
+    const QByteArray utf8Pattern = pattern.toUtf8();
+    int utf8ErrorCode;
+    PCRE2_SIZE utf8ErrorOffset;
+    compiledUtf8Pattern = pcre2_compile_8(reinterpret_cast<PCRE2_SPTR8>(utf8Pattern.constData()),
+                                          utf8Pattern.size(),
+                                          convertToPcreOptions(patternOptions) | PCRE2_UTF,
+                                          &utf8ErrorCode,
+                                          &utf8ErrorOffset,
+                                          nullptr);
+    optimizePattern8(compiledUtf8Pattern);
+}
+
+/*!
+    \internal
+
+    Compiles the program that matches over Latin-1 subjects, unless that
+    was done already.
+
+    The program is compiled without PCRE2_UTF, so that it matches one byte
+    as one character. That can only match like compiledPattern if the
+    pattern doesn't need characters outside of Latin-1: if it has any, or
+    escapes for any, or turns UTF mode on, there is no program and Latin-1
+    subjects are matched over UTF-16 instead.
+*/
+void QRegularExpressionPrivate::compileLatin1Pattern()
+{
+    const QMutexLocker lock(&mutex);
+
+    if (hasCompiledLatin1Pattern || !compiledPattern)
+        return;
+
+    hasCompiledLatin1Pattern = true;
+
+    if (!QtPrivate::isLatin1(pattern))
+        return;
+
+    const QByteArray latin1Pattern = pattern.toLatin1();
+    pcre2_compile_context_8 *compileContext = pcre2_compile_context_create_8(nullptr);
+    pcre2_set_character_tables_8(compileContext, latin1CharacterTables.data());
+    int latin1ErrorCode;
+    PCRE2_SIZE latin1ErrorOffset;
+    compiledLatin1Pattern = pcre2_compile_8(reinterpret_cast<PCRE2_SPTR8>(latin1Pattern.constData()),
+                                            latin1Pattern.size(),
+                                            convertToPcreOptions(patternOptions) | PCRE2_NEVER_UTF,
+                                            &latin1ErrorCode,
+                                            &latin1ErrorOffset,
+                                            compileContext);
+    pcre2_compile_context_free_8(compileContext);
+    optimizePattern8(compiledLatin1Pattern);
+}
+#endif // QT_BOOTSTRAPPED
+
 /*!
     \internal
 
@@ -1042,29 +1297,100 @@ int QRegularExpressionPrivate::captureIndexForName(QStringView name) const
     return -1;
 }
 
+namespace {
+/*
+    The parts of the PCRE2 API that doMatch() uses, for the code unit
+    width and the encoding of each kind of subject.
+*/
+struct Pcre2Utf16
+{
+    using Code = pcre2_code_16;
+    using CodeUnit = char16_t;
+    using Subject = PCRE2_SPTR16;
+
+    static constexpr auto match = pcre2_match_16;
+    static constexpr auto matchContextCreate = pcre2_match_context_create_16;
+    static constexpr auto matchContextFree = pcre2_match_context_free_16;
+    static constexpr auto matchDataCreateFromPattern = pcre2_match_data_create_from_pattern_16;
+    static constexpr auto matchDataFree = pcre2_match_data_free_16;
+    static constexpr auto getOvectorPointer = pcre2_get_ovector_pointer_16;
+    static constexpr auto patternInfo = pcre2_pattern_info_16;
+    static constexpr auto jitStackCreate = pcre2_jit_stack_create_16;
+    static constexpr auto jitStackAssign = pcre2_jit_stack_assign_16;
+    static constexpr auto jitStackCallback = qtPcreCallback;
+    static auto &jitStack() { return jitStacks; }
+
+    // Returns true if c is not the first code unit of a character
+    static bool isContinuation(CodeUnit c) { return QChar::isLowSurrogate(c); }
+    // Returns the offset of the character count characters before the one at offset
+    static qsizetype charactersBack(const CodeUnit *, qsizetype offset, uint count)
+    { return offset - count; }
+};
+
+#ifndef QT_BOOTSTRAPPED
+struct Pcre2Latin1
+{
+    using Code = pcre2_code_8;
+    using CodeUnit = uchar;
+    using Subject = PCRE2_SPTR8;
+
+    static constexpr auto match = pcre2_match_8;
+    static constexpr auto matchContextCreate = pcre2_match_context_create_8;
+    static constexpr auto matchContextFree = pcre2_match_context_free_8;
+    static constexpr auto matchDataCreateFromPattern = pcre2_match_data_create_from_pattern_8;
+    static constexpr auto matchDataFree = pcre2_match_data_free_8;
+    static constexpr auto getOvectorPointer = pcre2_get_ovector_pointer_8;
+    static constexpr auto patternInfo = pcre2_pattern_info_8;
+    static constexpr auto jitStackCreate = pcre2_jit_stack_create_8;
+    static constexpr auto jitStackAssign = pcre2_jit_stack_assign_8;
+    static constexpr auto jitStackCallback = qtPcreCallback8;
+    static auto &jitStack() { return jitStacks8; }
+
+    static bool isContinuation(CodeUnit) { return false; }
+    static qsizetype charactersBack(const CodeUnit *, qsizetype offset, uint count)
+    { return offset - count; }
+};
+
+struct Pcre2Utf8 : Pcre2Latin1
+{
+    static bool isContinuation(CodeUnit c) { return (c & 0xc0) == 0x80; }
+    static qsizetype charactersBack(const CodeUnit *subject, qsizetype offset, uint count)
+    {
+        for ( ; count && offset > 0; --count) {
+            do {
+                --offset;
+            } while (offset > 0 && isContinuation(subject[offset]));
+        }
+        return offset;
+    }
+};
+#endif // QT_BOOTSTRAPPED
+} // unnamed namespace
+
 /*!
     \internal
 
-    This is a simple wrapper for pcre2_match_16 for handling the case in which the
+    This is a simple wrapper for pcre2_match for handling the case in which the
     JIT runs out of memory. In that case, we allocate a thread-local JIT stack
-    and re-run pcre2_match_16.
+    and re-run pcre2_match.
 */
-static int safe_pcre2_match_16(const pcre2_code_16 *code,
-                               PCRE2_SPTR16 subject, qsizetype length,
-                               qsizetype startOffset, int options,
-                               pcre2_match_data_16 *matchData,
-                               pcre2_match_context_16 *matchContext)
+template <typename Pcre2>
+static int safe_pcre2_match(const typename Pcre2::Code *code,
+                            typename Pcre2::Subject subject, qsizetype length,
+                            qsizetype startOffset, int options,
+                            decltype(Pcre2::matchDataCreateFromPattern(nullptr, nullptr)) matchData,
+                            decltype(Pcre2::matchContextCreate(nullptr)) matchContext)
 {
-    int result = pcre2_match_16(code, subject, length,
-                                startOffset, options, matchData, matchContext);
+    int result = Pcre2::match(code, subject, length,
+                              startOffset, options, matchData, matchContext);
 
-    if (result == PCRE2_ERROR_JIT_STACKLIMIT && !jitStacks) {
+    if (result == PCRE2_ERROR_JIT_STACKLIMIT && !Pcre2::jitStack()) {
         // The default JIT stack size in PCRE is 32K,
         // we allocate from 32K up to 512K.
-        jitStacks.reset(pcre2_jit_stack_create_16(32 * 1024, 512 * 1024, NULL));
+        Pcre2::jitStack().reset(Pcre2::jitStackCreate(32 * 1024, 512 * 1024, NULL));
 
-        result = pcre2_match_16(code, subject, length,
-                                startOffset, options, matchData, matchContext);
+        result = Pcre2::match(code, subject, length,
+                              startOffset, options, matchData, matchContext);
     }
 
     return result;
@@ -1083,7 +1409,7 @@ static int safe_pcre2_match_16(const pcre2_code_16 *code,
     previous. The subject string goes a Unicode validity check if
     \a checkSubjectString is CheckSubjectString and the match options don't
     include DontCheckSubjectStringMatchOption (PCRE doesn't like illegal
-    UTF-16 sequences).
+    UTF-16 or UTF-8 sequences).
 
     \a priv is modified to hold the results of the match.
 
@@ -1093,10 +1419,10 @@ static int safe_pcre2_match_16(const pcre2_code_16 *code,
     If the previous match matched an empty string, then an anchored, non-empty
     match is attempted at the offset position. If that succeeds, then we got
     the next match and we can return it. Otherwise, we advance by 1 position
-    (which can be one or two code units in UTF-16!) and reattempt a "normal"
-    match. We also have the problem of detecting the current newline format: if
-    the new advanced offset is pointing to the beginning of a CRLF sequence, we
-    must advance over it.
+    (which can be more than one code unit in UTF-16 and UTF-8!) and reattempt
+    a "normal" match. We also have the problem of detecting the current
+    newline format: if the new advanced offset is pointing to the beginning of
+    a CRLF sequence, we must advance over it.
 */
 void QRegularExpressionPrivate::doMatch(QRegularExpressionMatchPrivate *priv,
                                         qsizetype offset,
@@ -1141,59 +1467,109 @@ void QRegularExpressionPrivate::doMatch(QRegularExpressionMatchPrivate *priv,
         previousMatchWasEmpty = true;
     }
 
-    pcre2_match_context_16 *matchContext = pcre2_match_context_create_16(nullptr);
-    pcre2_jit_stack_assign_16(matchContext, &qtPcreCallback, nullptr);
-    pcre2_match_data_16 *matchData = pcre2_match_data_create_from_pattern_16(compiledPattern, nullptr);
+#ifndef QT_BOOTSTRAPPED
+    if (priv->subjectEncoding == QRegularExpressionMatchPrivate::Utf8) {
+        if (Q_UNLIKELY(!compiledUtf8Pattern)) {
+            qWarning("QRegularExpressionPrivate::doMatch(): cannot match the pattern '%ls' over UTF-8",
+                     qUtf16Printable(pattern));
+            return;
+        }
+        const auto utf8 = static_cast<const uchar *>(priv->subject.data());
+        // PCRE2's own check of the subject goes a byte at a time; do it
+        // with our vectorized validator instead, and only leave it to
+        // PCRE2 when it fails, so that we report the same errors
+        if (!(pcreOptions & PCRE2_NO_UTF_CHECK)
+                && QUtf8::isValidUtf8(QByteArrayView(utf8, subjectLength)).isValidUtf8
+                && (offset == subjectLength || !Pcre2Utf8::isContinuation(utf8[offset]))) {
+            pcreOptions |= PCRE2_NO_UTF_CHECK;
+        }
+        doMatch<Pcre2Utf8>(compiledUtf8Pattern, priv, utf8, offset, pcreOptions, previousMatchWasEmpty);
+        return;
+    }
+
+    if (priv->subjectEncoding == QRegularExpressionMatchPrivate::Latin1 && compiledLatin1Pattern) {
+        doMatch<Pcre2Latin1>(compiledLatin1Pattern, priv, static_cast<const uchar *>(priv->subject.data()),
+                             offset, pcreOptions, previousMatchWasEmpty);
+        return;
+    }
+#endif
+
+    // A Latin-1 subject without a Latin-1 program was converted to UTF-16
+    const char16_t *subjectUtf16 = priv->subjectEncoding == QRegularExpressionMatchPrivate::Utf16
+            ? static_cast<const char16_t *>(priv->subject.data())
+            : reinterpret_cast<const char16_t *>(priv->subjectStorage.utf16());
+    doMatch<Pcre2Utf16>(compiledPattern, priv, subjectUtf16,
+                        offset, pcreOptions, previousMatchWasEmpty);
+}
+
+/*!
+    \internal
+
+    Runs the match of doMatch() over \a subject, which has the code units
+    of priv->subject, with the program \a code.
+*/
+template <typename Pcre2>
+void QRegularExpressionPrivate::doMatch(const typename Pcre2::Code *code,
+                                        QRegularExpressionMatchPrivate *priv,
+                                        const typename Pcre2::CodeUnit *subject,
+                                        qsizetype offset,
+                                        int pcreOptions,
+                                        bool previousMatchWasEmpty) const
+{
+    using CodeUnit = typename Pcre2::CodeUnit;
+
+    const qsizetype subjectLength = priv->subject.size();
+
+    auto matchContext = Pcre2::matchContextCreate(nullptr);
+    Pcre2::jitStackAssign(matchContext, Pcre2::jitStackCallback, nullptr);
+    auto matchData = Pcre2::matchDataCreateFromPattern(code, nullptr);
 
     // PCRE does not accept a null pointer as subject string, even if
     // its length is zero. We however allow it in input: a QStringView
     // subject may have data == nullptr. In this case, to keep PCRE
     // happy, pass a pointer to a dummy character.
-    const char16_t dummySubject = 0;
-    const char16_t * const subjectUtf16 = [&]()
-    {
-        const auto subjectUtf16 = priv->subject.utf16();
-        if (subjectUtf16)
-            return subjectUtf16;
+    const CodeUnit dummySubject = 0;
+    if (!subject) {
         Q_ASSERT(subjectLength == 0);
-        return &dummySubject;
-    }();
+        subject = &dummySubject;
+    }
+    const auto pcreSubject = reinterpret_cast<typename Pcre2::Subject>(subject);
 
     int result;
 
     if (!previousMatchWasEmpty) {
-        result = safe_pcre2_match_16(compiledPattern,
-                                     reinterpret_cast<PCRE2_SPTR16>(subjectUtf16), subjectLength,
-                                     offset, pcreOptions,
-                                     matchData, matchContext);
+        result = safe_pcre2_match<Pcre2>(code,
+                                         pcreSubject, subjectLength,
+                                         offset, pcreOptions,
+                                         matchData, matchContext);
     } else {
-        result = safe_pcre2_match_16(compiledPattern,
-                                     reinterpret_cast<PCRE2_SPTR16>(subjectUtf16), subjectLength,
-                                     offset, pcreOptions | PCRE2_NOTEMPTY_ATSTART | PCRE2_ANCHORED,
-                                     matchData, matchContext);
+        result = safe_pcre2_match<Pcre2>(code,
+                                         pcreSubject, subjectLength,
+                                         offset, pcreOptions | PCRE2_NOTEMPTY_ATSTART | PCRE2_ANCHORED,
+                                         matchData, matchContext);
 
         if (result == PCRE2_ERROR_NOMATCH) {
             ++offset;
 
             if (usingCrLfNewlines
                     && offset < subjectLength
-                    && subjectUtf16[offset - 1] == u'\r'
-                    && subjectUtf16[offset] == u'\n') {
-                ++offset;
-            } else if (offset < subjectLength
-                       && QChar::isLowSurrogate(subjectUtf16[offset])) {
+                    && subject[offset - 1] == CodeUnit('\r')
+                    && subject[offset] == CodeUnit('\n')) {
                 ++offset;
+            } else {
+                while (offset < subjectLength && Pcre2::isContinuation(subject[offset]))
+                    ++offset;
             }
 
-            result = safe_pcre2_match_16(compiledPattern,
-                                         reinterpret_cast<PCRE2_SPTR16>(subjectUtf16), subjectLength,
-                                         offset, pcreOptions,
-                                         matchData, matchContext);
+            result = safe_pcre2_match<Pcre2>(code,
+                                             pcreSubject, subjectLength,
+                                             offset, pcreOptions,
+                                             matchData, matchContext);
         }
     }
 
 #ifdef QREGULAREXPRESSION_DEBUG
-    qDebug() << "Matching" <<  pattern << "against" << subject
+    qDebug() << "Matching" <<  pattern << "against" << priv->subject
              << "offset" << offset
              << priv->matchType << priv->matchOptions << previousMatchWasEmpty
              << "result" << result;
@@ -1227,7 +1603,7 @@ void QRegularExpressionPrivate::doMatch(QRegularExpressionMatchPrivate *priv,
 
     // copy the captured substrings offsets, if any
     if (priv->capturedCount) {
-        PCRE2_SIZE *ovector = pcre2_get_ovector_pointer_16(matchData);
+        PCRE2_SIZE *ovector = Pcre2::getOvectorPointer(matchData);
         qsizetype *const capturedOffsets = priv->capturedOffsets.data();
 
         // We rely on the fact that capturing groups that did not
@@ -1252,13 +1628,13 @@ void QRegularExpressionPrivate::doMatch(QRegularExpressionMatchPrivate *priv,
         // (Eventually, we could expose the lookbehind info in a future patch.)
         if (result == PCRE2_ERROR_PARTIAL) {
             unsigned int maximumLookBehind;
-            pcre2_pattern_info_16(compiledPattern, PCRE2_INFO_MAXLOOKBEHIND, &maximumLookBehind);
-            capturedOffsets[0] -= maximumLookBehind;
+            Pcre2::patternInfo(code, PCRE2_INFO_MAXLOOKBEHIND, &maximumLookBehind);
+            capturedOffsets[0] = Pcre2::charactersBack(subject, capturedOffsets[0], maximumLookBehind);
         }
     }
 
-    pcre2_match_data_free_16(matchData);
-    pcre2_match_context_free_16(matchContext);
+    Pcre2::matchDataFree(matchData);
+    Pcre2::matchContextFree(matchContext);
 }
 
 /*!
@@ -1266,12 +1642,13 @@ void QRegularExpressionPrivate::doMatch(QRegularExpressionMatchPrivate *priv,
 */
 QRegularExpressionMatchPrivate::QRegularExpressionMatchPrivate(const QRegularExpression &re,
                                                                const QString &subjectStorage,
-                                                               QStringView subject,
+                                                               QAnyStringView subject,
                                                                QRegularExpression::MatchType matchType,
                                                                QRegularExpression::MatchOptions matchOptions)
     : regularExpression(re),
       subjectStorage(subjectStorage),
       subject(subject),
+      subjectEncoding(encodingOf(subject)),
       matchType(matchType),
       matchOptions(matchOptions)
 {
@@ -1646,6 +2023,86 @@ QRegularExpressionMatch QRegularExpression::matchView(QStringView subjectView,
     return QRegularExpressionMatch(*priv);
 }
 
+#ifndef QT_BOOTSTRAPPED
+/*!
+    \since 6.7
+    \overload
+
+    Attempts to match the regular expression against the given UTF-8
+    \a subjectView, starting at the byte position \a offset inside the
+    subject, using a match of type \a matchType and honoring the given \a
+    matchOptions.
+
+    The match runs over the UTF-8 data itself, without converting it to
+    UTF-16 first, so the offsets in the returned QRegularExpressionMatch
+    are byte offsets into \a subjectView. \a offset must be at the start
+    of a character, or the match is not valid.
+    QRegularExpressionMatch::captured() returns the captured substrings
+    converted to QString, and QRegularExpressionMatch::capturedView()
+    returns null views.
+
+    \note The data referenced by \a subjectView must remain valid as long
+    as there are QRegularExpressionMatch objects using it.
+
+    \sa QRegularExpressionMatch, {normal matching}
+*/
+QRegularExpressionMatch QRegularExpression::matchView(QUtf8StringView subjectView,
+                                                      qsizetype offset,
+                                                      MatchType matchType,
+                                                      MatchOptions matchOptions) const
+{
+    d.data()->compilePattern();
+    d.data()->compileUtf8Pattern();
+    auto priv = new QRegularExpressionMatchPrivate(*this,
+                                                   QString(),
+                                                   subjectView,
+                                                   matchType,
+                                                   matchOptions);
+    d->doMatch(priv, offset);
+    return QRegularExpressionMatch(*priv);
+}
+
+/*!
+    \since 6.7
+    \overload
+
+    Attempts to match the regular expression against the given Latin-1
+    \a subjectView, starting at the position \a offset inside the subject,
+    using a match of type \a matchType and honoring the given \a
+    matchOptions.
+
+    The match runs over the Latin-1 data itself, unless the pattern
+    contains characters that Latin-1 cannot represent; in that case, a
+    UTF-16 copy of \a subjectView is matched instead. Either way, the
+    offsets in the returned QRegularExpressionMatch are the same as in
+    \a subjectView. QRegularExpressionMatch::captured() returns the
+    captured substrings converted to QString, and
+    QRegularExpressionMatch::capturedView() returns null views.
+
+    \note The data referenced by \a subjectView must remain valid as long
+    as there are QRegularExpressionMatch objects using it.
+
+    \sa QRegularExpressionMatch, {normal matching}
+*/
+QRegularExpressionMatch QRegularExpression::matchView(QLatin1StringView subjectView,
+                                                      qsizetype offset,
+                                                      MatchType matchType,
+                                                      MatchOptions matchOptions) const
+{
+    d.data()->compilePattern();
+    d.data()->compileLatin1Pattern();
+    // without a Latin-1 program, doMatch() matches over subjectStorage
+    const bool convertSubject = d->compiledPattern && !d->compiledLatin1Pattern;
+    auto priv = new QRegularExpressionMatchPrivate(*this,
+                                                   convertSubject ? QString(subjectView) : QString(),
+                                                   subjectView,
+                                                   matchType,
+                                                   matchOptions);
+    d->doMatch(priv, offset);
+    return QRegularExpressionMatch(*priv);
+}
+#endif // QT_BOOTSTRAPPED
+
 /*!
     Attempts to perform a global match of the regular expression against the
     given \a subject string, starting at the position \a offset inside the
@@ -1720,6 +2177,73 @@ QRegularExpressionMatchIterator QRegularExpression::globalMatchView(QStringView
     return QRegularExpressionMatchIterator(*priv);
 }
 
+#ifndef QT_BOOTSTRAPPED
+/*!
+    \since 6.7
+    \overload
+
+    Attempts to perform a global match of the regular expression against the
+    given UTF-8 \a subjectView, starting at the byte position \a offset inside
+    the subject, using a match of type \a matchType and honoring the given \a
+    matchOptions.
+
+    The returned QRegularExpressionMatchIterator is positioned before the
+    first match result (if any). The offsets of the matches are byte offsets
+    into \a subjectView, as with matchView().
+
+    \note The data referenced by \a subjectView must remain valid as
+    long as there are QRegularExpressionMatchIterator or
+    QRegularExpressionMatch objects using it.
+
+    \sa QRegularExpressionMatchIterator, {global matching}
+*/
+QRegularExpressionMatchIterator QRegularExpression::globalMatchView(QUtf8StringView subjectView,
+                                                                    qsizetype offset,
+                                                                    MatchType matchType,
+                                                                    MatchOptions matchOptions) const
+{
+    QRegularExpressionMatchIteratorPrivate *priv =
+            new QRegularExpressionMatchIteratorPrivate(*this,
+                                                       matchType,
+                                                       matchOptions,
+                                                       matchView(subjectView, offset, matchType, matchOptions));
+
+    return QRegularExpressionMatchIterator(*priv);
+}
+
+/*!
+    \since 6.7
+    \overload
+
+    Attempts to perform a global match of the regular expression against the
+    given Latin-1 \a subjectView, starting at the position \a offset inside
+    the subject, using a match of type \a matchType and honoring the given \a
+    matchOptions.
+
+    The returned QRegularExpressionMatchIterator is positioned before the
+    first match result (if any).
+
+    \note The data referenced by \a subjectView must remain valid as
+    long as there are QRegularExpressionMatchIterator or
+    QRegularExpressionMatch objects using it.
+
+    \sa QRegularExpressionMatchIterator, {global matching}
+*/
+QRegularExpressionMatchIterator QRegularExpression::globalMatchView(QLatin1StringView subjectView,
+                                                                    qsizetype offset,
+                                                                    MatchType matchType,
+                                                                    MatchOptions matchOptions) const
+{
+    QRegularExpressionMatchIteratorPrivate *priv =
+            new QRegularExpressionMatchIteratorPrivate(*this,
+                                                       matchType,
+                                                       matchOptions,
+                                                       matchView(subjectView, offset, matchType, matchOptions));
+
+    return QRegularExpressionMatchIterator(*priv);
+}
+#endif // QT_BOOTSTRAPPED
+
 /*!
     \since 5.4
 
@@ -2287,7 +2811,16 @@ bool QRegularExpressionMatch::hasCaptured(int nth) const
 */
 QString QRegularExpressionMatch::captured(int nth) const
 {
-    return capturedView(nth).toString();
+    if (d->subjectEncoding == QRegularExpressionMatchPrivate::Utf16)
+        return capturedView(nth).toString();
+
+    // UTF-8 and Latin-1 subjects have no QStringView of their captures
+    const qsizetype start = capturedStart(nth);
+
+    if (start == -1 || d->subject.isNull()) // didn't capture
+        return QString();
+
+    return d->subject.sliced(start, capturedLength(nth)).toString();
 }
 
 /*!
@@ -2296,7 +2829,9 @@ QString QRegularExpressionMatch::captured(int nth) const
     Returns a view of the substring captured by the \a nth capturing group.
 
     If the \a nth capturing group did not capture a string, or if there is no
-    such capturing group, returns a null QStringView.
+    such capturing group, returns a null QStringView. It also returns a null
+    QStringView if the subject was UTF-8 or Latin-1 data; use captured(), or
+    capturedStart() and capturedLength() on the subject, instead.
 
     \note The implicit capturing group number 0 captures the substring matched
     by the entire pattern.
@@ -2306,7 +2841,7 @@ QString QRegularExpressionMatch::captured(int nth) const
 */
 QStringView QRegularExpressionMatch::capturedView(int nth) const
 {
-    if (!hasCaptured(nth))
+    if (!hasCaptured(nth) || d->subjectEncoding != QRegularExpressionMatchPrivate::Utf16)
         return QStringView();
 
     qsizetype start = capturedStart(nth);
@@ -2314,7 +2849,8 @@ QStringView QRegularExpressionMatch::capturedView(int nth) const
     if (start == -1) // didn't capture
         return QStringView();
 
-    return d->subject.mid(start, capturedLength(nth));
+    const QStringView subject(static_cast<const QChar *>(d->subject.data()), d->subject.size());
+    return subject.mid(start, capturedLength(nth));
 }
 
 /*! \fn QString QRegularExpressionMatch::captured(const QString &name) const
@@ -2345,8 +2881,10 @@ QString QRegularExpressionMatch::captured(QStringView name) const
         qWarning("QRegularExpressionMatch::captured: empty capturing group name passed");
         return QString();
     }
-
-    return capturedView(name).toString();
+    int nth = d->regularExpression.d->captureIndexForName(name);
+    if (nth == -1)
+        return QString();
+    return captured(nth);
 }
 
 /*!
@@ -105,6 +105,16 @@ public:
                                       qsizetype offset          = 0,
                                       MatchType matchType       = NormalMatch,
                                       MatchOptions matchOptions = NoMatchOption) const;
+    [[nodiscard]]
+    QRegularExpressionMatch matchView(QUtf8StringView subjectView,
+                                      qsizetype offset          = 0,
+                                      MatchType matchType       = NormalMatch,
+                                      MatchOptions matchOptions = NoMatchOption) const;
+    [[nodiscard]]
+    QRegularExpressionMatch matchView(QLatin1StringView subjectView,
+                                      qsizetype offset          = 0,
+                                      MatchType matchType       = NormalMatch,
+                                      MatchOptions matchOptions = NoMatchOption) const;
 
     [[nodiscard]]
     QRegularExpressionMatchIterator globalMatch(const QString &subject,
@@ -126,6 +136,16 @@ public:
                                                     qsizetype offset          = 0,
                                                     MatchType matchType       = NormalMatch,
                                                     MatchOptions matchOptions = NoMatchOption) const;
+    [[nodiscard]]
+    QRegularExpressionMatchIterator globalMatchView(QUtf8StringView subjectView,
+                                                    qsizetype offset          = 0,
+                                                    MatchType matchType       = NormalMatch,
+                                                    MatchOptions matchOptions = NoMatchOption) const;
+    [[nodiscard]]
+    QRegularExpressionMatchIterator globalMatchView(QLatin1StringView subjectView,
+                                                    qsizetype offset          = 0,
+                                                    MatchType matchType       = NormalMatch,
+                                                    MatchOptions matchOptions = NoMatchOption) const;
 
     void optimize() const;
 
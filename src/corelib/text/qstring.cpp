@@ -8087,7 +8087,8 @@ QStringList QString::split(const QRegularExpression &re, Qt::SplitBehavior behav
 */
 QList<QStringView> QStringView::split(const QRegularExpression &re, Qt::SplitBehavior behavior) const
 {
-    return splitString<QList<QStringView>>(*this, re, &QRegularExpression::globalMatchView, behavior);
+    const auto matchingFunction = qOverload<QStringView, qsizetype, QRegularExpression::MatchType, QRegularExpression::MatchOptions>(&QRegularExpression::globalMatchView);
+    return splitString<QList<QStringView>>(*this, re, matchingFunction, behavior);
 }
 
 #endif // QT_CONFIG(regularexpression)
@@ -30,6 +30,8 @@
 #include <bit>
 #endif
 
+#include <array>
+
 QT_BEGIN_NAMESPACE
 
 using namespace QtMiscUtils;
@@ -464,6 +466,371 @@ static void simdCompareAscii(const qchar8_t *&, const qchar8_t *, const char16_t
 }
 #endif
 
+// Bulk conversion of text that isn't only US-ASCII. Unlike the functions
+// above, these are selected at runtime, so builds for the baseline x86-64
+// CPU use them too. They only convert complete sequences of valid UTF-8 of
+// up to three bytes (or, when encoding, characters outside the surrogate
+// range) and stop at the first block that has anything else, leaving it to
+// the scalar code.
+#if defined(__SSE2__) && QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+#  define QT_STRINGCONVERTER_RUNTIME_SIMD
+#  define QT_FUNCTION_TARGET_STRING_ARCH_SKYLAKE_AVX512_VBMI2     \
+    QT_FUNCTION_TARGET_STRING_ARCH_SKYLAKE_AVX512 ","           \
+    QT_FUNCTION_TARGET_STRING_AVX512VBMI2
+
+namespace {
+// Bit masks of the kinds of bytes in a block of UTF-8
+struct Utf8BlockMasks
+{
+    quint32 ascii;
+    quint32 continuation;
+    quint32 lead2;
+    quint32 lead3;
+    quint32 overlong2;      // C0 and C1
+    quint32 invalid3;       // overlong or a surrogate
+
+    // Returns the length of the valid, complete sequences at the start of
+    // a block of blockSize bytes
+    Q_ALWAYS_INLINE uint validLength(uint blockSize) const noexcept
+    {
+        const quint32 blockMask = quint32((quint64(1) << blockSize) - 1);
+        const quint32 lastByte = 1U << (blockSize - 1);
+        const quint64 expected = (quint64(lead2 | lead3) << 1) | (quint64(lead3) << 2);
+        const quint32 problems = ((continuation ^ quint32(expected))
+                                  | ~(ascii | continuation | lead2 | lead3)
+                                  | (lead2 & overlong2) | (lead3 & invalid3)
+                                  | ((lead2 | lead3) & lastByte) | (lead3 & (lastByte >> 1)))
+                                 & blockMask;
+        if (!problems)
+            return blockSize;
+
+        // stop at the start of the sequence that has the first problem: a
+        // missing continuation byte belongs to the sequence before it
+        const uint first = qCountTrailingZeroBits(problems);
+        if (!(quint32(expected) & (1U << first)))
+            return first;
+        const quint32 starts = ~continuation & ((1U << first) - 1);
+        return starts ? qBitScanReverse(starts) : 0;
+    }
+};
+
+// pshufb controls that move the 16-bit lanes selected by a mask to the front
+static constexpr auto utf16LaneCompressTable = [] {
+    std::array<std::array<uchar, 16>, 256> table = {};
+    for (uint mask = 0; mask < 256; ++mask) {
+        uint n = 0;
+        for (uint lane = 0; lane < 8; ++lane) {
+            if (mask & (1U << lane)) {
+                table[mask][2 * n] = uchar(2 * lane);
+                table[mask][2 * n + 1] = uchar(2 * lane + 1);
+                ++n;
+            }
+        }
+        for ( ; n < 8; ++n)
+            table[mask][2 * n] = table[mask][2 * n + 1] = 0x80;
+    }
+    return table;
+}();
+} // unnamed namespace
+
+// Decodes the sixteen bytes at src, assuming each one starts a sequence:
+// values has the character for each of them; the return value tells which
+// ones really do
+static Q_ALWAYS_INLINE QT_FUNCTION_TARGET(ARCH_HASWELL)
+Utf8BlockMasks decodeUtf8Block_avx2(const uchar *src, __m256i &values) noexcept
+{
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    const __m256i b0 = _mm256_cvtepu8_epi16(bytes);
+    const __m256i b1 = _mm256_cvtepu8_epi16(_mm_srli_si128(bytes, 1));
+    const __m256i b2 = _mm256_cvtepu8_epi16(_mm_srli_si128(bytes, 2));
+
+    const auto byteMask = [bytes](uchar mask, uchar value) QT_FUNCTION_TARGET(ARCH_HASWELL) {
+        const __m128i masked = _mm_and_si128(bytes, _mm_set1_epi8(char(mask)));
+        return quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(masked, _mm_set1_epi8(char(value)))));
+    };
+    const auto laneMask = [](__m256i v) QT_FUNCTION_TARGET(ARCH_HASWELL) {
+        const __m128i packed = _mm_packs_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        return quint32(_mm_movemask_epi8(packed));
+    };
+
+    const __m256i low6 = _mm256_set1_epi16(0x3f);
+    const __m256i value2 = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(b0, _mm256_set1_epi16(0x1f)), 6),
+                                           _mm256_and_si256(b1, low6));
+    const __m256i value3 = _mm256_or_si256(_mm256_slli_epi16(b0, 12),
+                                           _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(b1, low6), 6),
+                                                           _mm256_and_si256(b2, low6)));
+    const __m256i isLead2 = _mm256_cmpeq_epi16(_mm256_and_si256(b0, _mm256_set1_epi16(0xe0)),
+                                               _mm256_set1_epi16(0xc0));
+    const __m256i isLead3 = _mm256_cmpeq_epi16(_mm256_and_si256(b0, _mm256_set1_epi16(0xf0)),
+                                               _mm256_set1_epi16(0xe0));
+    values = _mm256_blendv_epi8(_mm256_blendv_epi8(b0, value2, isLead2), value3, isLead3);
+
+    const __m256i overlong3 = _mm256_cmpeq_epi16(_mm256_min_epu16(value3, _mm256_set1_epi16(0x7ff)), value3);
+    const __m256i surrogate = _mm256_cmpeq_epi16(_mm256_and_si256(value3, _mm256_set1_epi16(short(0xf800))),
+                                                 _mm256_set1_epi16(short(0xd800)));
+
+    Utf8BlockMasks masks;
+    masks.ascii = ~quint32(_mm_movemask_epi8(bytes)) & 0xffff;
+    masks.continuation = byteMask(0xc0, 0x80);
+    masks.lead2 = laneMask(isLead2);
+    masks.lead3 = laneMask(isLead3);
+    masks.overlong2 = byteMask(0xfe, 0xc0);
+    masks.invalid3 = laneMask(_mm256_or_si256(overlong3, surrogate));
+    return masks;
+}
+
+static QT_FUNCTION_TARGET(ARCH_HASWELL)
+void simdDecodeUtf8_avx2(char16_t *&dst, const uchar *&src, const uchar *end) noexcept
+{
+    // The stores below write eight characters for each half of the block,
+    // even if fewer were decoded. That never goes past the end of the
+    // destination: it has room for one character per byte of the source
+    // and each block is decoded to at most one character per byte.
+    for ( ; end - src >= 16; ) {
+        __m256i values;
+        const Utf8BlockMasks masks = decodeUtf8Block_avx2(src, values);
+        const uint length = masks.validLength(16);
+        if (!length)
+            break;
+
+        const quint32 starts = ~masks.continuation & ((1U << length) - 1);
+        const uint low = starts & 0xff;
+        const uint high = starts >> 8;
+        const auto control = [](uint mask) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf16LaneCompressTable[mask].data()));
+        };
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                         _mm_shuffle_epi8(_mm256_castsi256_si128(values), control(low)));
+        dst += qPopulationCount(low);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                         _mm_shuffle_epi8(_mm256_extracti128_si256(values, 1), control(high)));
+        dst += qPopulationCount(high);
+        src += length;
+    }
+}
+
+static QT_FUNCTION_TARGET(ARCH_HASWELL)
+const uchar *simdValidateUtf8_avx2(const uchar *src, const uchar *end) noexcept
+{
+    for ( ; end - src >= 16; ) {
+        __m256i values;
+        const uint length = decodeUtf8Block_avx2(src, values).validLength(16);
+        if (!length)
+            break;
+        src += length;
+    }
+    return src;
+}
+
+#  if QT_COMPILER_SUPPORTS_HERE(AVX512VBMI2)
+static Q_ALWAYS_INLINE QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512_VBMI2)
+Utf8BlockMasks decodeUtf8Block_avx512(const uchar *src, __m512i &values) noexcept
+{
+    // same as decodeUtf8Block_avx2, for 32 bytes
+    const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+    const __m512i b0 = _mm512_cvtepu8_epi16(bytes);
+    const __m512i b1 = _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(0x7fffffff, src + 1));
+    const __m512i b2 = _mm512_cvtepu8_epi16(_mm256_maskz_loadu_epi8(0x3fffffff, src + 2));
+
+    const auto byteMask = [bytes](uchar mask, uchar value) QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512_VBMI2) {
+        return quint32(_mm256_cmpeq_epi8_mask(_mm256_and_si256(bytes, _mm256_set1_epi8(char(mask))),
+                                              _mm256_set1_epi8(char(value))));
+    };
+
+    const __m512i low6 = _mm512_set1_epi16(0x3f);
+    const __m512i value2 = _mm512_or_si512(_mm512_slli_epi16(_mm512_and_si512(b0, _mm512_set1_epi16(0x1f)), 6),
+                                           _mm512_and_si512(b1, low6));
+    const __m512i value3 = _mm512_or_si512(_mm512_slli_epi16(b0, 12),
+                                           _mm512_or_si512(_mm512_slli_epi16(_mm512_and_si512(b1, low6), 6),
+                                                           _mm512_and_si512(b2, low6)));
+
+    Utf8BlockMasks masks;
+    masks.ascii = ~quint32(_mm256_movepi8_mask(bytes));
+    masks.continuation = byteMask(0xc0, 0x80);
+    masks.lead2 = byteMask(0xe0, 0xc0);
+    masks.lead3 = byteMask(0xf0, 0xe0);
+    masks.overlong2 = byteMask(0xfe, 0xc0);
+    masks.invalid3 = quint32(_mm512_cmplt_epu16_mask(value3, _mm512_set1_epi16(0x800)))
+            | quint32(_mm512_cmpeq_epi16_mask(_mm512_and_si512(value3, _mm512_set1_epi16(short(0xf800))),
+                                              _mm512_set1_epi16(short(0xd800))));
+
+    values = _mm512_mask_blend_epi16(masks.lead2, b0, value2);
+    values = _mm512_mask_blend_epi16(masks.lead3, values, value3);
+    return masks;
+}
+
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512_VBMI2)
+void simdDecodeUtf8_avx512(char16_t *&dst, const uchar *&src, const uchar *end) noexcept
+{
+    for ( ; end - src >= 32; ) {
+        __m512i values;
+        const Utf8BlockMasks masks = decodeUtf8Block_avx512(src, values);
+        const uint length = masks.validLength(32);
+        if (!length)
+            break;
+
+        const __mmask32 starts = ~masks.continuation & _bzhi_u32(~0U, length);
+        const uint count = qPopulationCount(quint32(starts));
+        _mm512_mask_storeu_epi16(dst, _bzhi_u32(~0U, count), _mm512_maskz_compress_epi16(starts, values));
+        dst += count;
+        src += length;
+    }
+}
+
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512_VBMI2)
+const uchar *simdValidateUtf8_avx512(const uchar *src, const uchar *end) noexcept
+{
+    for ( ; end - src >= 32; ) {
+        __m512i values;
+        const uint length = decodeUtf8Block_avx512(src, values).validLength(32);
+        if (!length)
+            break;
+        src += length;
+    }
+    return src;
+}
+
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512_VBMI2)
+void simdEncodeUtf8_avx512(uchar *&dst, const char16_t *&src, const char16_t *end) noexcept
+{
+    for ( ; end - src >= 16; ) {
+        const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        const __mmask16 surrogates =
+                _mm256_cmpeq_epi16_mask(_mm256_and_si256(chars, _mm256_set1_epi16(short(0xf800))),
+                                        _mm256_set1_epi16(short(0xd800)));
+        const uint count = surrogates ? qCountTrailingZeroBits(uint(surrogates)) : 16;
+        if (!count)
+            break;
+
+        // build the sequence for every character in its 32-bit lane
+        const __m512i c = _mm512_cvtepu16_epi32(chars);
+        const __m512i low6 = _mm512_set1_epi32(0x3f);
+        const __m512i continuation = _mm512_set1_epi32(0x80);
+        const __m512i last = _mm512_or_si512(_mm512_and_si512(c, low6), continuation);
+        const __m512i seq2 = _mm512_or_si512(_mm512_or_si512(_mm512_srli_epi32(c, 6), _mm512_set1_epi32(0xc0)),
+                                             _mm512_slli_epi32(last, 8));
+        const __m512i middle = _mm512_or_si512(_mm512_and_si512(_mm512_srli_epi32(c, 6), low6), continuation);
+        const __m512i seq3 = _mm512_or_si512(_mm512_or_si512(_mm512_srli_epi32(c, 12), _mm512_set1_epi32(0xe0)),
+                                             _mm512_or_si512(_mm512_slli_epi32(middle, 8),
+                                                             _mm512_slli_epi32(last, 16)));
+        const __mmask16 multiByte = _mm512_cmpge_epu32_mask(c, _mm512_set1_epi32(0x80));
+        const __mmask16 threeBytes = _mm512_cmpge_epu32_mask(c, _mm512_set1_epi32(0x800));
+        __m512i seq = _mm512_mask_blend_epi32(multiByte, c, seq2);
+        seq = _mm512_mask_blend_epi32(threeBytes, seq, seq3);
+
+        // keep as many bytes of each lane as its sequence is long
+        const __m512i one = _mm512_set1_epi32(0x01010101);
+        __m512i length = _mm512_mask_add_epi32(one, multiByte, one, one);
+        length = _mm512_mask_add_epi32(length, threeBytes, length, one);
+        const __mmask64 keep = _mm512_cmplt_epu8_mask(_mm512_set1_epi32(0x03020100), length)
+                & _bzhi_u64(~quint64(0), 4 * count);
+
+        const uint n = qPopulationCount(quint64(keep));
+        _mm512_mask_storeu_epi8(dst, _bzhi_u64(~quint64(0), n), _mm512_maskz_compress_epi8(keep, seq));
+        dst += n;
+        src += count;
+        if (count < 16)
+            break;
+    }
+}
+
+static QT_FUNCTION_TARGET(ARCH_SKYLAKE_AVX512_VBMI2)
+void simdLatin1ToUtf8_avx512(uchar *&dst, const uchar *&src, const uchar *end) noexcept
+{
+    for ( ; end - src >= 32; src += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        const __mmask32 nonAscii = _mm256_movepi8_mask(bytes);
+        if (!nonAscii) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), bytes);
+            dst += 32;
+            continue;
+        }
+
+        // U+0080 to U+00FF are two bytes, in the 16-bit lane of each character
+        const __m512i c = _mm512_cvtepu8_epi16(bytes);
+        const __m512i seq2 = _mm512_or_si512(_mm512_or_si512(_mm512_srli_epi16(c, 6), _mm512_set1_epi16(0xc0)),
+                                             _mm512_slli_epi16(_mm512_or_si512(_mm512_and_si512(c, _mm512_set1_epi16(0x3f)),
+                                                                               _mm512_set1_epi16(0x80)), 8));
+        const __m512i seq = _mm512_mask_blend_epi16(nonAscii, c, seq2);
+        const __mmask64 keep = Q_UINT64_C(0x5555555555555555)
+                | _pdep_u64(nonAscii, Q_UINT64_C(0xaaaaaaaaaaaaaaaa));
+        const uint n = 32 + qPopulationCount(quint32(nonAscii));
+        _mm512_mask_storeu_epi8(dst, _bzhi_u64(~quint64(0), n), _mm512_maskz_compress_epi8(keep, seq));
+        dst += n;
+    }
+}
+
+static bool hasUtf8Avx512()
+{
+    return qCpuHasFeature(ArchSkylakeAvx512) && qCpuHasFeature(AVX512VBMI2);
+}
+#  endif // AVX512VBMI2
+#endif // QT_STRINGCONVERTER_RUNTIME_SIMD
+
+static inline void simdDecodeUtf8(char16_t *&dst, const uchar *&src, const uchar *end) noexcept
+{
+#ifdef QT_STRINGCONVERTER_RUNTIME_SIMD
+#  if QT_COMPILER_SUPPORTS_HERE(AVX512VBMI2)
+    if (hasUtf8Avx512())
+        return simdDecodeUtf8_avx512(dst, src, end);
+#  endif
+    if (qCpuHasFeature(ArchHaswell))
+        return simdDecodeUtf8_avx2(dst, src, end);
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+}
+
+static inline const uchar *simdValidateUtf8(const uchar *src, const uchar *end) noexcept
+{
+#ifdef QT_STRINGCONVERTER_RUNTIME_SIMD
+#  if QT_COMPILER_SUPPORTS_HERE(AVX512VBMI2)
+    if (hasUtf8Avx512())
+        return simdValidateUtf8_avx512(src, end);
+#  endif
+    if (qCpuHasFeature(ArchHaswell))
+        return simdValidateUtf8_avx2(src, end);
+#else
+    Q_UNUSED(end);
+#endif
+    return src;
+}
+
+static inline void simdEncodeUtf8(uchar *&dst, const char16_t *&src, const char16_t *end) noexcept
+{
+#if defined(QT_STRINGCONVERTER_RUNTIME_SIMD) && QT_COMPILER_SUPPORTS_HERE(AVX512VBMI2)
+    if (hasUtf8Avx512())
+        simdEncodeUtf8_avx512(dst, src, end);
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+}
+
+static inline void simdLatin1ToUtf8(uchar *&dst, const uchar *&src, const uchar *end) noexcept
+{
+#if defined(QT_STRINGCONVERTER_RUNTIME_SIMD) && QT_COMPILER_SUPPORTS_HERE(AVX512VBMI2)
+    if (hasUtf8Avx512())
+        return simdLatin1ToUtf8_avx512(dst, src, end);
+#endif
+#if defined(__SSE2__)
+    // copy the US-ASCII blocks
+    for ( ; end - src >= 16; src += 16, dst += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        if (_mm_movemask_epi8(data))
+            break;
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), data);
+    }
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+}
+
 enum { HeaderDone = 1 };
 
 QByteArray QUtf8::convertFromUnicode(QStringView in)
@@ -481,14 +848,16 @@ QByteArray QUtf8::convertFromUnicode(QStringView in)
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
 
-        do {
+        // more non-ASCII is likely to follow, so try to encode it in bulk
+        simdEncodeUtf8(dst, src, end);
+        while (src < nextAscii) {
             char16_t u = *src++;
             int res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(u, dst, src, end);
             if (res < 0) {
                 // encoding error - append '?'
                 *dst++ = '?';
             }
-        } while (src < nextAscii);
+        }
     }
 
     result.truncate(dst - reinterpret_cast<uchar *>(const_cast<char *>(result.constData())));
@@ -547,7 +916,8 @@ char *QUtf8::convertFromUnicode(char *out, QStringView in, QStringConverter::Sta
         if (simdEncodeAscii(cursor, nextAscii, src, end))
             break;
 
-        do {
+        simdEncodeUtf8(cursor, src, end);
+        while (src < nextAscii) {
             char16_t uc = *src++;
             int res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
             if (Q_LIKELY(res >= 0))
@@ -567,7 +937,7 @@ char *QUtf8::convertFromUnicode(char *out, QStringView in, QStringConverter::Sta
                 }
                 return reinterpret_cast<char *>(cursor);
             }
-        } while (src < nextAscii);
+        }
     }
 
     return reinterpret_cast<char *>(cursor);
@@ -575,7 +945,12 @@ char *QUtf8::convertFromUnicode(char *out, QStringView in, QStringConverter::Sta
 
 char *QUtf8::convertFromLatin1(char *out, QLatin1StringView in)
 {
-    // ### SIMD-optimize:
+    uchar *dst = reinterpret_cast<uchar *>(out);
+    const uchar *src = reinterpret_cast<const uchar *>(in.data());
+    simdLatin1ToUtf8(dst, src, src + in.size());
+    out = reinterpret_cast<char *>(dst);
+    in = in.sliced(src - reinterpret_cast<const uchar *>(in.data()));
+
     for (uchar ch : in) {
         if (ch < 128) {
             *out++ = ch;
@@ -650,14 +1025,16 @@ char16_t *QUtf8::convertToUnicode(char16_t *dst, QByteArrayView in) noexcept
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
 
-            do {
+            // more non-ASCII is likely to follow, so try to decode it in bulk
+            simdDecodeUtf8(dst, src, end);
+            while (src < nextAscii) {
                 uchar b = *src++;
                 const qsizetype res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, dst, src, end);
                 if (res < 0) {
                     // decoding error
                     *dst++ = QChar::ReplacementCharacter;
                 }
-            } while (src < nextAscii);
+            }
         }
     }
 
@@ -750,8 +1127,13 @@ char16_t *QUtf8::convertToUnicode(char16_t *dst, QByteArrayView in, QStringConve
     res = 0;
     const uchar *nextAscii = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            simdDecodeUtf8(dst, src, end);
+            if (src == end)
+                break;
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
@@ -799,8 +1181,15 @@ QUtf8::ValidUtf8Result QUtf8::isValidUtf8(QByteArrayView in)
     bool isValidAscii = true;
 
     while (src < end) {
-        if (src >= nextAscii)
+        if (src >= nextAscii) {
             src = simdFindNonAscii(src, end, nextAscii);
+            if (src != end) {
+                // there's at least one non-ASCII character here
+                const uchar *validEnd = simdValidateUtf8(src, end);
+                isValidAscii = isValidAscii && validEnd == src;
+                src = validEnd;
+            }
+        }
         if (src == end)
             break;
 
@@ -255,6 +255,79 @@ int ResultStoreBase::updateInsertIndex(int index, int _count)
     return index;
 }
 
+/*
+  Chunks start small, so that futures with a handful of results don't pay
+  for a big allocation, and grow with the number of results stored so far.
+*/
+static constexpr int MinimumChunkCapacity = 4;
+static constexpr int MaximumChunkCapacity = 4096;
+
+/*!
+  \internal
+
+  Returns the chunk a result reported at \a index can be appended to, or
+  \nullptr if \a index is not the next in-order index, or if the last
+  item in the store is not a vector of results ending right before it.
+  The caller checks whether the chunk has room left: only the QList of
+  results knows its capacity.
+ */
+ResultItem *ResultStoreBase::appendableChunk(int index)
+{
+    if ((index != -1 && index != insertIndex) || m_results.isEmpty())
+        return nullptr;
+
+    const auto last = std::prev(m_results.end());
+    ResultItem &item = last.value();
+    if (!item.isVector() || last.key() + item.m_count != insertIndex - filteredResults) {
+        return nullptr;
+    }
+    return &item;
+}
+
+/*!
+  \internal
+
+  Returns the capacity of the chunk to allocate for a result reported at
+  \a index, or 0 if the result should be stored on its own. This is
+  the case for the first result and for out-of-order results.
+ */
+int ResultStoreBase::newChunkCapacity(int index) const
+{
+    if ((index != -1 && index != insertIndex) || m_results.isEmpty())
+        return 0;
+
+    const auto last = std::prev(m_results.cend());
+    const int storeIndex = insertIndex - filteredResults;
+    if (last.key() + last.value().count() != storeIndex)
+        return 0;
+    return qBound(MinimumChunkCapacity, storeIndex, MaximumChunkCapacity);
+}
+
+/*!
+  \internal
+
+  Updates the bookkeeping after a result was appended to \a chunk, as
+  returned by appendableChunk(). Returns the index of the result.
+ */
+int ResultStoreBase::appendedToChunk(ResultItem *chunk)
+{
+    const int index = updateInsertIndex(-1, 1);
+    ++chunk->m_count;
+
+    // the chunk is the last item, so there's nothing after it to sync with
+    if (resultCount == index - filteredResults)
+        ++resultCount;
+    if (!pendingResults.isEmpty())
+        syncPendingResults();
+    return index;
+}
+
+int ResultStoreBase::addChunk(int index, const void *chunk)
+{
+    ResultItem resultItem(chunk, 1);
+    return insertResultItem(index, resultItem);
+}
+
 } // namespace QtPrivate
 
 QT_END_NAMESPACE
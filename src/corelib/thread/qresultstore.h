@@ -4,8 +4,11 @@
 #ifndef QTCORE_RESULTSTORE_H
 #define QTCORE_RESULTSTORE_H
 
+#include <QtCore/qlist.h>
 #include <QtCore/qmap.h>
 
+#include <memory>
+#include <type_traits>
 #include <utility>
 
 QT_REQUIRE_CONFIG(future);
@@ -18,6 +21,11 @@ QT_BEGIN_NAMESPACE
     which indexes are in the store can be done either by iterating or by random
     access. In addition results can be removed from the front of the store,
     either individually or in batches.
+
+    Results added one by one in order are appended to chunks, i.e. QLists
+    that are allocated with room for several results and never reallocated,
+    so that streaming many results doesn't cost an allocation and a map
+    insertion per result. Out-of-order results are stored individually.
 */
 
 namespace QtPrivate {
@@ -110,6 +118,10 @@ protected:
     void syncPendingResults();
     void syncResultCount();
     int updateInsertIndex(int index, int _count);
+    ResultItem *appendableChunk(int index);
+    int newChunkCapacity(int index) const;
+    int appendedToChunk(ResultItem *chunk);
+    int addChunk(int index, const void *chunk);
 
     QMap<int, ResultItem> m_results;
     int insertIndex;     // The index where the next results(s) will be inserted.
@@ -137,6 +149,26 @@ public:
     template <typename T, typename...Args>
     int emplaceResult(int index, Args&&...args)
     {
+        // in-order results go to the end of a chunk, which can't already
+        // contain them (QList doesn't support move-only types)
+        if constexpr (std::is_copy_constructible_v<T>) {
+            if (ResultItem *chunk = appendableChunk(index)) {
+                // references to earlier results may be in use, so a chunk is
+                // only appended to while that doesn't reallocate it
+                auto results = static_cast<QList<T> *>(const_cast<void *>(chunk->result));
+                if (results->size() < results->capacity() && results->isDetached()) {
+                    results->emplaceBack(std::forward<Args>(args)...);
+                    return appendedToChunk(chunk);
+                }
+            }
+            if (const int capacity = newChunkCapacity(index)) {
+                auto results = std::make_unique<QList<T>>();
+                results->reserve(capacity);
+                results->emplaceBack(std::forward<Args>(args)...);
+                return addChunk(index, results.release());
+            }
+        }
+
         if (containsValidResultItem(index)) // reject if already present
             return -1;
         return addResult(index, static_cast<void *>(new T(std::forward<Args>(args)...)));
@@ -145,13 +177,13 @@ public:
     template <typename T>
     int addResult(int index, const T *result)
     {
-        if (containsValidResultItem(index)) // reject if already present
-            return -1;
-
-        if (result == nullptr)
+        if (result == nullptr) {
+            if (containsValidResultItem(index)) // reject if already present
+                return -1;
             return addResult(index, static_cast<void *>(nullptr));
+        }
 
-        return addResult(index, static_cast<void *>(new T(*result)));
+        return emplaceResult<T>(index, *result);
     }
 
     template <typename T>
@@ -15,6 +15,7 @@
 #include "private/qcoreapplication_p.h"
 
 #include <limits>
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 
@@ -81,6 +82,7 @@ QThreadData::~QThreadData()
     thread.storeRelease(nullptr);
     delete t;
 
+    mergePostEventIntake();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -109,6 +111,46 @@ void QThreadData::deref()
 #endif
 }
 
+void QThreadData::mergePostEventIntake()
+{
+    // always exchange, even if the intake looks empty: QObject::moveToThread
+    // relies on this to publish the receiver's new thread data to postEvent()
+    using IntakeNode = QPostEventList::IntakeNode;
+    IntakeNode *node = postEventList.intake.fetchAndStoreOrdered(nullptr);
+
+    // the intake is a stack, restore the posting order
+    IntakeNode *pending = nullptr;
+    while (node) {
+        IntakeNode *next = node->next;
+        node->next = pending;
+        pending = node;
+        node = next;
+    }
+
+    while (pending) {
+        std::unique_ptr<IntakeNode> current(pending);
+        pending = pending->next;
+        const QPostEvent &pe = current->event;
+
+        // the receiver can only leave this thread while our mutex is locked
+        QThreadData *target = pe.receiver->d_func()->threadData.loadAcquire();
+        if (Q_LIKELY(target == this)) {
+            postEventList.addEvent(pe);
+        } else if (target) {
+            // the receiver was moved to another thread while the event was
+            // being posted, follow it
+            target->postEventList.pushIntake(current.release());
+            if (QAbstractEventDispatcher *dispatcher = target->eventDispatcher.loadAcquire())
+                dispatcher->wakeUp();
+        } else {
+            // posting during destruction
+            --pe.receiver->d_func()->postedEvents;
+            pe.event->m_posted = false;
+            delete pe.event;
+        }
+    }
+}
+
 QAbstractEventDispatcher *QThreadData::createEventDispatcher()
 {
     QAbstractEventDispatcher *ed = QThreadPrivate::createEventDispatcher(this);
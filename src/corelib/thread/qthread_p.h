@@ -35,6 +35,7 @@ QT_BEGIN_NAMESPACE
 
 class QAbstractEventDispatcher;
 class QEventLoop;
+class QThreadData;
 
 class QPostEvent
 {
@@ -72,10 +73,34 @@ public:
 
     QMutex mutex;
 
+    // Events posted from other threads that are never compressed (queued
+    // calls) bypass the mutex and are pushed onto this lock-free stack
+    // instead. Whoever holds the mutex next merges them into the list.
+    struct IntakeNode
+    {
+        QPostEvent event;
+        IntakeNode *next;
+    };
+    QAtomicPointer<IntakeNode> intake;
+    // Bumped by QObject::moveToThread() before it merges the intake of the
+    // thread an object leaves, so that postEvent() can tell whether it has to
+    // merge again without touching the receiver after pushing.
+    QAtomicInteger<quint32> moveGeneration;
+
     inline QPostEventList() : QList<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0) { }
 
     void addEvent(const QPostEvent &ev);
 
+    // thread-safe
+    void pushIntake(IntakeNode *node)
+    {
+        IntakeNode *head = intake.loadRelaxed();
+        do {
+            node->next = head;
+        } while (!intake.testAndSetOrdered(head, node, head));
+    }
+    bool hasIntake() const { return intake.loadRelaxed() != nullptr; }
+
 private:
     //hides because they do not keep that list sorted. addEvent must be used
     using QList<QPostEvent>::append;
@@ -304,10 +329,18 @@ public:
         return createEventDispatcher();
     }
 
+    // require postEventList.mutex to be locked
+    void mergePostEventIntake();
+    void mergePendingPostEventIntake()
+    {
+        if (postEventList.hasIntake())
+            mergePostEventIntake();
+    }
+
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasIntake();
     }
 
 private:
@@ -21,6 +21,12 @@
 #endif
 
 #include <private/qeventdispatcher_unix_p.h>
+#if QT_CONFIG(epoll)
+#  include <private/qeventdispatcher_epoll_p.h>
+#endif
+#if QT_CONFIG(io_uring)
+#  include <private/qeventdispatcher_uring_p.h>
+#endif
 
 #include "qthreadstorage.h"
 
@@ -222,7 +228,20 @@ QAbstractEventDispatcher *QThreadPrivate::createEventDispatcher(QThreadData *dat
         return new QEventDispatcherUNIX;
 #elif defined(Q_OS_WASM)
     return new QEventDispatcherWasm();
-#elif !defined(QT_NO_GLIB)
+#else
+#  if QT_CONFIG(io_uring)
+    if (qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_IO_URING") > 0) {
+        if (QEventDispatcherIoUring *dispatcher = QEventDispatcherIoUring::create())
+            return dispatcher;
+    }
+#  endif
+#  if QT_CONFIG(epoll)
+    if (qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") > 0) {
+        if (QEventDispatcherEpoll *dispatcher = QEventDispatcherEpoll::create())
+            return dispatcher;
+    }
+#  endif
+#  if !defined(QT_NO_GLIB)
     const bool isQtMainThread = data->thread.loadAcquire() == QCoreApplicationPrivate::mainThread();
     if (qEnvironmentVariableIsEmpty("QT_NO_GLIB")
         && (isQtMainThread || qEnvironmentVariableIsEmpty("QT_NO_THREADED_GLIB"))
@@ -230,8 +249,9 @@ QAbstractEventDispatcher *QThreadPrivate::createEventDispatcher(QThreadData *dat
         return new QEventDispatcherGlib;
     else
         return new QEventDispatcherUNIX;
-#else
+#  else
     return new QEventDispatcherUNIX;
+#  endif
 #endif
 }
 
@@ -23,12 +23,20 @@ public:
     QThreadPoolThread(QThreadPoolPrivate *manager);
     void run() override;
     void registerThreadInactive();
+    QRunnable *takeLocalTask();
 
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // Tasks started with the default priority from within this thread, in
+    // the order they were started. Other threads steal from the front, too.
+    QMutex localMutex;
+    QList<QRunnable *> localQueue;
 };
 
+Q_CONSTINIT static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+
 /*
     QThreadPool private class.
 */
@@ -48,6 +56,7 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    currentPoolThread = this;
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -55,45 +64,49 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                // If autoDelete() is false, r might already be deleted after run(), so check status now.
-                const bool del = r->autoDelete();
-
-                // run the task
                 locker.unlock();
+                do {
+                    // If autoDelete() is false, r might already be deleted after run(), so check status now.
+                    const bool del = r->autoDelete();
+
+                    // run the task
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        registerThreadInactive();
+                        throw;
+                    }
 #endif
 
-                if (del)
-                    delete r;
+                    if (del)
+                        delete r;
+
+                    // Continue with the tasks this thread started itself, without
+                    // taking the pool's mutex, unless the queue holds something
+                    // with a higher priority.
+                    r = nullptr;
+                    if (manager->queuedPriority.loadRelaxed() <= 0)
+                        r = takeLocalTask();
+                } while (r);
                 locker.relock();
             }
 
             // if too many threads are active, stop working in this one
-            if (manager->tooManyThreadsActive())
+            if (manager->tooManyThreadsActive()) {
+                manager->requeueLocalTasks(this);
                 break;
+            }
 
             // all work is done, time to wait for more
-            if (manager->queue.isEmpty())
+            r = manager->takeTask(this);
+            if (!r)
                 break;
-
-            QueuePage *page = manager->queue.first();
-            r = page->pop();
-
-            if (page->isFinished()) {
-                manager->queue.removeFirst();
-                delete page;
-            }
         } while (true);
 
         // this thread is about to be deleted, do not wait or expire
@@ -106,10 +119,21 @@ void QThreadPoolThread::run()
         if (manager->tooManyThreadsActive()) {
             manager->expiredThreads.enqueue(this);
             registerThreadInactive();
+            manager->updateHints();
             return;
         }
         manager->waitingThreads.enqueue(this);
         registerThreadInactive();
+        manager->updateHints();
+        // a thread that didn't see the capacity published above yet may have
+        // queued a task locally in the meantime, see tryEnqueueLocalTask()
+        if (QRunnable *stolen = manager->stealLocalTask(this)) {
+            manager->waitingThreads.removeOne(this);
+            ++manager->activeThreads;
+            manager->updateHints();
+            runnable = stolen;
+            continue;
+        }
         // wait for work, exiting after the expiry timeout is reached
         runnableReady.wait(locker.mutex(), QDeadlineTimer(manager->expiryTimeout));
         // this thread is about to be deleted, do not work or expire
@@ -131,11 +155,18 @@ void QThreadPoolThread::registerThreadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+QRunnable *QThreadPoolThread::takeLocalTask()
+{
+    QMutexLocker locker(&localMutex);
+    return localQueue.isEmpty() ? nullptr : localQueue.takeFirst();
+}
+
 
 /*
     \internal
 */
 QThreadPoolPrivate:: QThreadPoolPrivate()
+    : queuedPriority(INT_MIN)
 { }
 
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
@@ -191,11 +222,131 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     for (QueuePage *page : std::as_const(queue)) {
         if (page->priority() == priority && !page->isFull()) {
             page->push(runnable);
+            updateHints();
             return;
         }
     }
     auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
     queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
+    updateHints();
+}
+
+/*
+    \internal
+
+    Called without the pool's mutex locked. If the current thread is one of our
+    workers and the pool has no idle capacity, pushes \a runnable onto that
+    worker's local queue, where it will either be run by the worker itself once
+    its current task returns, or be stolen by another worker running out of
+    work. Returns \c false if \a runnable needs to go through tryStart() and
+    the shared queue instead.
+
+    The capacity is checked with the local queue locked: a worker going idle
+    publishes the capacity before it looks at the local queues one last time,
+    so either it finds the task, or we see the capacity and leave the task to
+    tryStart(), which wakes it up.
+*/
+bool QThreadPoolPrivate::tryEnqueueLocalTask(QRunnable *runnable, int priority)
+{
+    // only the default priority, so that the local queues need no ordering
+    if (priority != 0 || spareCapacity.loadRelaxed())
+        return false;
+
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this)
+        return false;
+
+    QMutexLocker locker(&thread->localMutex);
+    if (spareCapacity.loadRelaxed())
+        return false;
+    thread->localQueue.append(runnable);
+    return true;
+}
+
+/*
+    \internal
+
+    Returns the next task for \a thread, which has run out of local work:
+    anything queued with a higher priority, then the thread's own local
+    tasks, then the rest of the shared queue and finally tasks stolen from
+    the local queues of the other workers. Must be called with the mutex
+    locked.
+*/
+QRunnable *QThreadPoolPrivate::takeTask(QThreadPoolThread *thread)
+{
+    if (!queue.isEmpty() && queue.first()->priority() > 0)
+        return takeQueuedTask();
+
+    if (QRunnable *r = thread->takeLocalTask())
+        return r;
+
+    if (!queue.isEmpty())
+        return takeQueuedTask();
+
+    return stealLocalTask(thread);
+}
+
+/*
+    \internal
+
+    Takes the oldest task from the local queue of any thread other than
+    \a thief, which may be \nullptr. Must be called with the mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::stealLocalTask(QThreadPoolThread *thief)
+{
+    for (QThreadPoolThread *victim : std::as_const(allThreads)) {
+        if (victim == thief)
+            continue;
+        QMutexLocker locker(&victim->localMutex);
+        if (!victim->localQueue.isEmpty())
+            return victim->localQueue.takeFirst();
+    }
+
+    return nullptr;
+}
+
+QRunnable *QThreadPoolPrivate::takeQueuedTask()
+{
+    Q_ASSERT(!queue.isEmpty());
+    QueuePage *page = queue.first();
+    QRunnable *r = page->pop();
+
+    if (page->isFinished()) {
+        queue.removeFirst();
+        delete page;
+    }
+    updateHints();
+    return r;
+}
+
+/*
+    \internal
+
+    Moves the local tasks of \a thread, which is about to stop working, to the
+    shared queue. Must be called with the mutex locked.
+*/
+void QThreadPoolPrivate::requeueLocalTasks(QThreadPoolThread *thread)
+{
+    QMutexLocker locker(&thread->localMutex);
+    const QList<QRunnable *> tasks = std::exchange(thread->localQueue, {});
+    locker.unlock();
+
+    for (QRunnable *r : tasks)
+        enqueueTask(r);
+}
+
+/*
+    \internal
+
+    Publishes the state that tryEnqueueLocalTask() and the worker loop look at
+    without taking the mutex. Both are hints only: acting on a stale value
+    merely makes a task take the slower path. Must be called with the mutex
+    locked whenever the queue or the thread counts change.
+*/
+void QThreadPoolPrivate::updateHints()
+{
+    queuedPriority.storeRelaxed(queue.isEmpty() ? INT_MIN : queue.first()->priority());
+    spareCapacity.storeRelaxed(!areAllThreadsActive());
 }
 
 int QThreadPoolPrivate::activeThreadCount() const
@@ -221,6 +372,18 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
             delete page;
         }
     }
+
+    // then hand the tasks waiting for busy (or blocked) threads to new ones
+    while (!areAllThreadsActive()) {
+        QRunnable *r = stealLocalTask(nullptr);
+        if (!r)
+            break;
+        if (!tryStart(r)) {
+            enqueueTask(r);
+            break;
+        }
+    }
+    updateHints();
 }
 
 bool QThreadPoolPrivate::areAllThreadsActive() const
@@ -278,6 +441,7 @@ void QThreadPoolPrivate::reset()
     }
 
     mutex.lock();
+    updateHints();
 }
 
 /*!
@@ -309,6 +473,14 @@ bool QThreadPoolPrivate::waitForDone(int msecs)
 void QThreadPoolPrivate::clear()
 {
     QMutexLocker locker(&mutex);
+    QList<QRunnable *> localTasks;
+    for (QThreadPoolThread *thread : std::as_const(allThreads)) {
+        QMutexLocker localLocker(&thread->localMutex);
+        localTasks += std::exchange(thread->localQueue, {});
+    }
+    for (QRunnable *r : std::as_const(localTasks))
+        enqueueTask(r);
+
     while (!queue.isEmpty()) {
         auto *page = queue.takeLast();
         while (!page->isFinished()) {
@@ -321,6 +493,7 @@ void QThreadPoolPrivate::clear()
         }
         delete page;
     }
+    updateHints();
 }
 
 /*!
@@ -354,10 +527,17 @@ bool QThreadPool::tryTake(QRunnable *runnable)
                 d->queue.removeOne(page);
                 delete page;
             }
+            d->updateHints();
             return true;
         }
     }
 
+    for (QThreadPoolThread *thread : std::as_const(d->allThreads)) {
+        QMutexLocker localLocker(&thread->localMutex);
+        if (thread->localQueue.removeOne(runnable))
+            return true;
+    }
+
     return false;
 }
 
@@ -503,6 +683,13 @@ QThreadPool *QThreadPoolPrivate::qtGuiInstance()
     ownership of \a runnable remains with the caller. Note that
     changing the auto-deletion on \a runnable after calling this
     functions results in undefined behavior.
+
+    If this function is called from one of the pool's threads while all
+    threads are busy, a \a runnable with the default \a priority is queued
+    for the calling thread, which runs it once its current task returns,
+    unless another thread runs out of work and takes it over first. Such
+    runnables are started in the order they were queued, but may start
+    before or after runnables queued with the same priority by other threads.
 */
 void QThreadPool::start(QRunnable *runnable, int priority)
 {
@@ -510,10 +697,14 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (d->tryEnqueueLocalTask(runnable, priority))
+        return;
+
     QMutexLocker locker(&d->mutex);
 
     if (!d->tryStart(runnable))
         d->enqueueTask(runnable, priority);
+    d->updateHints();
 }
 
 /*!
@@ -556,10 +747,9 @@ bool QThreadPool::tryStart(QRunnable *runnable)
 
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
-    if (d->tryStart(runnable))
-        return true;
-
-    return false;
+    const bool started = d->tryStart(runnable);
+    d->updateHints();
+    return started;
 }
 
 /*!
@@ -678,6 +868,7 @@ void QThreadPool::reserveThread()
     Q_D(QThreadPool);
     QMutexLocker locker(&d->mutex);
     ++d->reservedThreads;
+    d->updateHints();
 }
 
 /*! \property QThreadPool::stackSize
@@ -788,6 +979,7 @@ void QThreadPool::startOnReservedThread(QRunnable *runnable)
         // and something took the one minimum thread.
         d->enqueueTask(runnable, INT_MAX);
     }
+    d->updateHints();
 }
 
 /*!
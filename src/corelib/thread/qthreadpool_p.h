@@ -16,6 +16,7 @@
 //
 //
 
+#include "QtCore/qatomic.h"
 #include "QtCore/qmutex.h"
 #include "QtCore/qthread.h"
 #include "QtCore/qwaitcondition.h"
@@ -118,6 +119,12 @@ public:
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    bool tryEnqueueLocalTask(QRunnable *task, int priority);
+    QRunnable *takeTask(QThreadPoolThread *thread);
+    QRunnable *takeQueuedTask();
+    QRunnable *stealLocalTask(QThreadPoolThread *thief);
+    void requeueLocalTasks(QThreadPoolThread *thread);
+    void updateHints();
     int activeThreadCount() const;
 
     void tryToStartMoreThreads();
@@ -150,6 +157,10 @@ public:
     int activeThreads = 0;
     uint stackSize = 0;
     QThread::Priority threadPriority = QThread::InheritPriority;
+
+    // read without holding the mutex, see updateHints()
+    QAtomicInt queuedPriority;
+    QAtomicInt spareCapacity = 1; // bool
 };
 
 QT_END_NAMESPACE
@@ -10,6 +10,7 @@
 #include <qmutex.h>
 #include <qvarlengtharray.h>
 #include <private/qlocking_p.h>
+#include <private/qsimd_p.h>
 
 #include <array>
 #include <climits>
@@ -292,6 +293,568 @@ static constexpr bool useNonOpenSSLFallback(QCryptographicHash::Algorithm method
 }
 #endif // USING_OPENSSL30
 
+#if !defined(QT_BOOTSTRAPPED) && !defined(USING_OPENSSL30)
+/*
+    SHA-1, SHA-224 and SHA-256 process the message in blocks of 64 bytes.
+    The block functions below take the intermediate hash as an array of
+    words, so that the portable implementations and the ones using the
+    CPU's SHA instructions (x86 SHA extensions, ARMv8 Cryptography
+    Extension) are interchangeable. The generic ones forward to the code
+    from 3rdparty.
+*/
+#  if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(SHA) && QT_COMPILER_SUPPORTS_HERE(SSE4_1)
+#    define SHA_X86
+#    define QT_FUNCTION_TARGET_STRING_SHA_SSE4_1    QT_FUNCTION_TARGET_STRING_SHA "," QT_FUNCTION_TARGET_STRING_SSE4_1
+#  elif defined(Q_PROCESSOR_ARM_64) && QT_COMPILER_SUPPORTS_HERE(AES)
+#    define SHA_ARM
+#  endif
+#  if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(AVX2)
+#    define SHA256_MULTI_BUFFER
+#  endif
+
+static constexpr qsizetype ShaBlockSize = 64;
+
+alignas(16) static const quint32 sha256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static void sha1BlocksGeneric(quint32 *hash, const uchar *data, qsizetype blocks) noexcept
+{
+    Sha1State state;
+    state.h0 = hash[0];
+    state.h1 = hash[1];
+    state.h2 = hash[2];
+    state.h3 = hash[3];
+    state.h4 = hash[4];
+    for ( ; blocks; --blocks, data += ShaBlockSize)
+        sha1ProcessChunk(&state, data);
+    hash[0] = state.h0;
+    hash[1] = state.h1;
+    hash[2] = state.h2;
+    hash[3] = state.h3;
+    hash[4] = state.h4;
+}
+
+static void sha256BlocksGeneric(quint32 *hash, const uchar *data, qsizetype blocks) noexcept
+{
+    SHA256Context context;
+    memcpy(context.Intermediate_Hash, hash, sizeof(context.Intermediate_Hash));
+    for ( ; blocks; --blocks, data += ShaBlockSize) {
+        memcpy(context.Message_Block, data, ShaBlockSize);
+        SHA224_256ProcessMessageBlock(&context);
+    }
+    memcpy(hash, context.Intermediate_Hash, sizeof(context.Intermediate_Hash));
+}
+
+#ifdef SHA_X86
+static void QT_FUNCTION_TARGET(SHA_SSE4_1)
+sha1BlocksX86(quint32 *hash, const uchar *data, qsizetype blocks) noexcept
+{
+    // the words of the message are big endian, and the instructions want
+    // the first one in the most significant lane
+    const __m128i wordOrder = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash)), 0x1b);
+    __m128i e0 = _mm_set_epi32(int(hash[4]), 0, 0, 0);
+
+    for ( ; blocks; --blocks, data += ShaBlockSize) {
+        const __m128i abcdSaved = abcd;
+        const __m128i e0Saved = e0;
+
+        // the message schedule: m[g % 4] holds the words of group g
+        __m128i m[4];
+        for (int i = 0; i < 4; ++i) {
+            m[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i));
+            m[i] = _mm_shuffle_epi8(m[i], wordOrder);
+        }
+
+        // 20 groups of four rounds, the round function changing every five
+        __m128i e = _mm_add_epi32(e0, m[0]);
+        __m128i previousAbcd = abcd;
+        const auto group = [&](int g, auto function) QT_FUNCTION_TARGET(SHA_SSE4_1) {
+            if (g)
+                e = _mm_sha1nexte_epu32(previousAbcd, m[g & 3]);
+            previousAbcd = abcd;
+            abcd = _mm_sha1rnds4_epu32(abcd, e, decltype(function)::value);
+            if (g < 16) {
+                const __m128i next = _mm_xor_si128(_mm_sha1msg1_epu32(m[g & 3], m[(g + 1) & 3]),
+                                                   m[(g + 2) & 3]);
+                m[g & 3] = _mm_sha1msg2_epu32(next, m[(g + 3) & 3]);
+            }
+        };
+        for (int g = 0; g < 5; ++g)
+            group(g, std::integral_constant<int, 0>());
+        for (int g = 5; g < 10; ++g)
+            group(g, std::integral_constant<int, 1>());
+        for (int g = 10; g < 15; ++g)
+            group(g, std::integral_constant<int, 2>());
+        for (int g = 15; g < 20; ++g)
+            group(g, std::integral_constant<int, 3>());
+
+        e0 = _mm_sha1nexte_epu32(previousAbcd, e0Saved);
+        abcd = _mm_add_epi32(abcd, abcdSaved);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), _mm_shuffle_epi32(abcd, 0x1b));
+    hash[4] = quint32(_mm_extract_epi32(e0, 3));
+}
+
+static void QT_FUNCTION_TARGET(SHA_SSE4_1)
+sha256BlocksX86(quint32 *hash, const uchar *data, qsizetype blocks) noexcept
+{
+    const __m128i wordOrder = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // the instructions want the state as ABEF and CDGH
+    __m128i dcba = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hash));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hash + 4));
+    dcba = _mm_shuffle_epi32(dcba, 0xb1);                   // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1b);               // EFGH
+    __m128i state0 = _mm_alignr_epi8(dcba, state1, 8);      // ABEF
+    state1 = _mm_blend_epi16(state1, dcba, 0xf0);           // CDGH
+
+    for ( ; blocks; --blocks, data += ShaBlockSize) {
+        const __m128i state0Saved = state0;
+        const __m128i state1Saved = state1;
+
+        __m128i m[4];
+        for (int i = 0; i < 4; ++i) {
+            m[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i));
+            m[i] = _mm_shuffle_epi8(m[i], wordOrder);
+        }
+
+        // 16 groups of four rounds
+        for (int g = 0; g < 16; ++g) {
+            const __m128i k = _mm_load_si128(reinterpret_cast<const __m128i *>(sha256RoundConstants + 4 * g));
+            const __m128i wk = _mm_add_epi32(m[g & 3], k);
+            state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0e));
+            if (g < 12) {
+                __m128i next = _mm_sha256msg1_epu32(m[g & 3], m[(g + 1) & 3]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(m[(g + 3) & 3], m[(g + 2) & 3], 4));
+                m[g & 3] = _mm_sha256msg2_epu32(next, m[(g + 3) & 3]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, state0Saved);
+        state1 = _mm_add_epi32(state1, state1Saved);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);                                   // DCHG
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), _mm_blend_epi16(feba, state1, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash + 4), _mm_alignr_epi8(state1, feba, 8));
+}
+#endif // SHA_X86
+
+#ifdef SHA_ARM
+QT_FUNCTION_TARGET(AES)
+static void sha1BlocksArm(quint32 *hash, const uchar *data, qsizetype blocks) noexcept
+{
+    static const quint32 k[4] = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
+
+    uint32x4_t abcd = vld1q_u32(hash);
+    quint32 e0 = hash[4];
+
+    for ( ; blocks; --blocks, data += ShaBlockSize) {
+        const uint32x4_t abcdSaved = abcd;
+
+        uint32x4_t m[4];
+        for (int i = 0; i < 4; ++i)
+            m[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+
+        // 20 groups of four rounds, the round function changing every five
+        quint32 e = e0;
+        for (int g = 0; g < 20; ++g) {
+            const uint32x4_t wk = vaddq_u32(m[g & 3], vdupq_n_u32(k[g / 5]));
+            const quint32 nextE = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+            if (g < 5)
+                abcd = vsha1cq_u32(abcd, e, wk);
+            else if (g < 10 || g >= 15)
+                abcd = vsha1pq_u32(abcd, e, wk);
+            else
+                abcd = vsha1mq_u32(abcd, e, wk);
+            e = nextE;
+            if (g < 16) {
+                m[g & 3] = vsha1su1q_u32(vsha1su0q_u32(m[g & 3], m[(g + 1) & 3], m[(g + 2) & 3]),
+                                         m[(g + 3) & 3]);
+            }
+        }
+
+        e0 += e;
+        abcd = vaddq_u32(abcd, abcdSaved);
+    }
+
+    vst1q_u32(hash, abcd);
+    hash[4] = e0;
+}
+
+QT_FUNCTION_TARGET(AES)
+static void sha256BlocksArm(quint32 *hash, const uchar *data, qsizetype blocks) noexcept
+{
+    uint32x4_t state0 = vld1q_u32(hash);
+    uint32x4_t state1 = vld1q_u32(hash + 4);
+
+    for ( ; blocks; --blocks, data += ShaBlockSize) {
+        const uint32x4_t state0Saved = state0;
+        const uint32x4_t state1Saved = state1;
+
+        uint32x4_t m[4];
+        for (int i = 0; i < 4; ++i)
+            m[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+
+        // 16 groups of four rounds
+        for (int g = 0; g < 16; ++g) {
+            const uint32x4_t wk = vaddq_u32(m[g & 3], vld1q_u32(sha256RoundConstants + 4 * g));
+            if (g < 12) {
+                m[g & 3] = vsha256su1q_u32(vsha256su0q_u32(m[g & 3], m[(g + 1) & 3]),
+                                           m[(g + 2) & 3], m[(g + 3) & 3]);
+            }
+            const uint32x4_t abef = state0;
+            state0 = vsha256hq_u32(state0, state1, wk);
+            state1 = vsha256h2q_u32(state1, abef, wk);
+        }
+
+        state0 = vaddq_u32(state0, state0Saved);
+        state1 = vaddq_u32(state1, state1Saved);
+    }
+
+    vst1q_u32(hash, state0);
+    vst1q_u32(hash + 4, state1);
+}
+#endif // SHA_ARM
+
+static bool hasShaInstructions() noexcept
+{
+#if defined(SHA_X86)
+    return qCpuHasFeature(SHA) && qCpuHasFeature(SSE4_1);
+#elif defined(SHA_ARM)
+    // Do a runtime-only check, as qhash.cpp does: Yocto enables the Crypto
+    // extension for all ARMv8 configurations.
+    constexpr auto ShaFeatures = CpuFeatureSHA1 | CpuFeatureSHA2;
+    return (qCpuFeatures() & ShaFeatures) == ShaFeatures;
+#else
+    return false;
+#endif
+}
+
+static void sha1Blocks(quint32 *hash, const uchar *data, qsizetype blocks) noexcept
+{
+#if defined(SHA_X86)
+    if (hasShaInstructions())
+        return sha1BlocksX86(hash, data, blocks);
+#elif defined(SHA_ARM)
+    if (hasShaInstructions())
+        return sha1BlocksArm(hash, data, blocks);
+#endif
+    sha1BlocksGeneric(hash, data, blocks);
+}
+
+static void sha256Blocks(quint32 *hash, const uchar *data, qsizetype blocks) noexcept
+{
+#if defined(SHA_X86)
+    if (hasShaInstructions())
+        return sha256BlocksX86(hash, data, blocks);
+#elif defined(SHA_ARM)
+    if (hasShaInstructions())
+        return sha256BlocksArm(hash, data, blocks);
+#endif
+    sha256BlocksGeneric(hash, data, blocks);
+}
+
+/*
+    Replacements for sha1Update() and SHA256Input() that hand all complete
+    blocks to the block functions at once. Without SHA instructions, they
+    leave the work to the original functions.
+*/
+static void sha1Input(Sha1State *state, const uchar *data, qsizetype length) noexcept
+{
+    if (!hasShaInstructions())
+        return sha1Update(state, data, length);
+
+    quint32 hash[5] = { state->h0, state->h1, state->h2, state->h3, state->h4 };
+    const qsizetype buffered = qsizetype(state->messageSize % ShaBlockSize);
+    state->messageSize += length;
+
+    if (buffered) {
+        const qsizetype n = qMin(ShaBlockSize - buffered, length);
+        memcpy(state->buffer + buffered, data, n);
+        if (buffered + n < ShaBlockSize)
+            return;
+        sha1Blocks(hash, state->buffer, 1);
+        data += n;
+        length -= n;
+    }
+
+    const qsizetype blocks = length / ShaBlockSize;
+    sha1Blocks(hash, data, blocks);
+    memcpy(state->buffer, data + blocks * ShaBlockSize, length % ShaBlockSize);
+
+    state->h0 = hash[0];
+    state->h1 = hash[1];
+    state->h2 = hash[2];
+    state->h3 = hash[3];
+    state->h4 = hash[4];
+}
+
+static void sha256Input(SHA256Context *context, const uchar *data, qsizetype length) noexcept
+{
+    const quint64 bits = quint64(context->Length_High) << 32 | context->Length_Low;
+    const quint64 newBits = bits + quint64(length) * 8;
+    // let SHA256Input() deal with the errors
+    if (!hasShaInstructions() || context->Computed || context->Corrupted || newBits < bits) {
+        SHA256Input(context, data, uint(length));
+        return;
+    }
+
+    context->Length_High = quint32(newBits >> 32);
+    context->Length_Low = quint32(newBits);
+
+    if (const qsizetype buffered = context->Message_Block_Index) {
+        const qsizetype n = qMin(ShaBlockSize - buffered, length);
+        memcpy(context->Message_Block + buffered, data, n);
+        context->Message_Block_Index += n;
+        if (context->Message_Block_Index < ShaBlockSize)
+            return;
+        sha256Blocks(context->Intermediate_Hash, context->Message_Block, 1);
+        data += n;
+        length -= n;
+    }
+
+    const qsizetype blocks = length / ShaBlockSize;
+    sha256Blocks(context->Intermediate_Hash, data, blocks);
+    memcpy(context->Message_Block, data + blocks * ShaBlockSize, length % ShaBlockSize);
+    context->Message_Block_Index = length % ShaBlockSize;
+}
+
+#ifdef SHA256_MULTI_BUFFER
+/*
+    Runs the SHA-256 compression function for eight independent messages
+    at once: hash[i] holds word i of the intermediate hash of each of
+    them, and blocks[lane] points to the next block of message lane.
+*/
+static inline __m256i QT_FUNCTION_TARGET(AVX2) rotateRightAvx2(__m256i x, int n) noexcept
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+static void QT_FUNCTION_TARGET(AVX2)
+sha256EightBlocksAvx2(quint32 (*hash)[8], const uchar * const *blocks) noexcept
+{
+    const __m256i wordOrder = _mm256_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL,
+                                                0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // load the words of the blocks and transpose them, so that w[i] holds
+    // word i of each of the messages
+    __m256i w[16];
+    for (int half = 0; half < 2; ++half) {
+        __m256i r[8];
+        for (int lane = 0; lane < 8; ++lane) {
+            r[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(blocks[lane] + 32 * half));
+            r[lane] = _mm256_shuffle_epi8(r[lane], wordOrder);
+        }
+        __m256i t[8], u[8];
+        for (int i = 0; i < 4; ++i) {
+            t[2 * i] = _mm256_unpacklo_epi32(r[2 * i], r[2 * i + 1]);
+            t[2 * i + 1] = _mm256_unpackhi_epi32(r[2 * i], r[2 * i + 1]);
+        }
+        for (int i = 0; i < 2; ++i) {
+            u[4 * i] = _mm256_unpacklo_epi64(t[4 * i], t[4 * i + 2]);
+            u[4 * i + 1] = _mm256_unpackhi_epi64(t[4 * i], t[4 * i + 2]);
+            u[4 * i + 2] = _mm256_unpacklo_epi64(t[4 * i + 1], t[4 * i + 3]);
+            u[4 * i + 3] = _mm256_unpackhi_epi64(t[4 * i + 1], t[4 * i + 3]);
+        }
+        for (int i = 0; i < 4; ++i) {
+            w[8 * half + i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+            w[8 * half + i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+        }
+    }
+
+    __m256i state[8];
+    for (int i = 0; i < 8; ++i)
+        state[i] = _mm256_load_si256(reinterpret_cast<const __m256i *>(hash[i]));
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int t = 0; t < 64; ++t) {
+        if (t >= 16) {
+            const __m256i w15 = w[(t - 15) & 15];
+            const __m256i w2 = w[(t - 2) & 15];
+            const __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotateRightAvx2(w15, 7), rotateRightAvx2(w15, 18)),
+                                                _mm256_srli_epi32(w15, 3));
+            const __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotateRightAvx2(w2, 17), rotateRightAvx2(w2, 19)),
+                                                _mm256_srli_epi32(w2, 10));
+            w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], s0),
+                                         _mm256_add_epi32(w[(t - 7) & 15], s1));
+        }
+        const __m256i sigma1 = _mm256_xor_si256(_mm256_xor_si256(rotateRightAvx2(e, 6), rotateRightAvx2(e, 11)), rotateRightAvx2(e, 25));
+        const __m256i choice = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i k = _mm256_set1_epi32(int(sha256RoundConstants[t]));
+        const __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, sigma1),
+                                            _mm256_add_epi32(choice, _mm256_add_epi32(k, w[t & 15])));
+        const __m256i sigma0 = _mm256_xor_si256(_mm256_xor_si256(rotateRightAvx2(a, 2), rotateRightAvx2(a, 13)), rotateRightAvx2(a, 22));
+        const __m256i majority = _mm256_or_si256(_mm256_and_si256(a, b),
+                                                 _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, _mm256_add_epi32(sigma0, majority));
+    }
+
+    const __m256i result[8] = { a, b, c, d, e, f, g, h };
+    for (int i = 0; i < 8; ++i) {
+        _mm256_store_si256(reinterpret_cast<__m256i *>(hash[i]),
+                           _mm256_add_epi32(state[i], result[i]));
+    }
+}
+
+/*
+    The blocks of one message for the batch functions: the complete blocks
+    of the data, followed by the last, padded, one or two.
+*/
+class ShaMessageBlocks
+{
+public:
+    ShaMessageBlocks() = default;
+    explicit ShaMessageBlocks(QByteArrayView data) noexcept
+        : next(reinterpret_cast<const uchar *>(data.data())),
+          fullBlocks(data.size() / ShaBlockSize)
+    {
+        const qsizetype rest = data.size() % ShaBlockSize;
+        if (rest) // an empty message may not have any data
+            memcpy(tail, next + fullBlocks * ShaBlockSize, rest);
+        memset(tail + rest, 0, sizeof(tail) - rest);
+        tail[rest] = 0x80;
+        tailBlocks = rest + 1 + 8 > ShaBlockSize ? 2 : 1;
+        qToBigEndian(quint64(data.size()) * 8, tail + tailBlocks * ShaBlockSize - 8);
+    }
+
+    bool atEnd() const noexcept { return tailIndex == tailBlocks; }
+    const uchar *takeBlock() noexcept
+    {
+        Q_ASSERT(!atEnd());
+        if (fullBlocks) {
+            --fullBlocks;
+            return std::exchange(next, next + ShaBlockSize);
+        }
+        return tail + ShaBlockSize * tailIndex++;
+    }
+    // processes the remaining blocks of the message
+    template <typename BlockFunction>
+    void finish(quint32 *hash, BlockFunction blockFunction) noexcept
+    {
+        blockFunction(hash, next, fullBlocks);
+        blockFunction(hash, tail + ShaBlockSize * tailIndex, tailBlocks - tailIndex);
+        fullBlocks = 0;
+        tailIndex = tailBlocks;
+    }
+
+private:
+    const uchar *next = nullptr;
+    qsizetype fullBlocks = 0;
+    int tailBlocks = 0;
+    int tailIndex = 0;
+    uchar tail[2 * ShaBlockSize];
+};
+
+static QByteArray shaDigest(const quint32 *hash, int hashLength)
+{
+    QByteArray digest(hashLength, Qt::Uninitialized);
+    for (int i = 0; i < hashLength / 4; ++i)
+        qToBigEndian(hash[i], digest.data() + 4 * i);
+    return digest;
+}
+
+/*
+    Hashes each of data with SHA-224 or SHA-256, eight messages at a time
+    when the CPU supports AVX2. Returns false if there was nothing to gain
+    from that, and the messages should be hashed one after the other.
+*/
+static bool sha256Batch(const QList<QByteArrayView> &data, QCryptographicHash::Algorithm method,
+                        QByteArrayList *results)
+{
+    // one message at a time with the SHA instructions is as fast
+    if (!qCpuHasFeature(AVX2) || hasShaInstructions() || data.size() < 2)
+        return false;
+
+    const bool sha224 = method == QCryptographicHash::Sha224;
+    const quint32 *initialHash = sha224 ? SHA224_H0 : SHA256_H0;
+    const int hashLength = sha224 ? SHA224HashSize : SHA256HashSize;
+    enum { Lanes = 8 };
+
+    results->resize(data.size());
+    alignas(32) quint32 hash[8][Lanes];
+    ShaMessageBlocks messages[Lanes];
+    qsizetype messageIndex[Lanes];
+    qsizetype nextMessage = 0;
+    int activeLanes = 0;
+
+    const auto startMessage = [&](int lane) {
+        if (nextMessage == data.size()) {
+            messageIndex[lane] = -1;
+            return;
+        }
+        messageIndex[lane] = nextMessage;
+        messages[lane] = ShaMessageBlocks(data.at(nextMessage++));
+        for (int i = 0; i < 8; ++i)
+            hash[i][lane] = initialHash[i];
+        ++activeLanes;
+    };
+    const auto finishMessage = [&](int lane) {
+        quint32 laneHash[8];
+        for (int i = 0; i < 8; ++i)
+            laneHash[i] = hash[i][lane];
+        (*results)[messageIndex[lane]] = shaDigest(laneHash, hashLength);
+        --activeLanes;
+    };
+
+    for (int lane = 0; lane < Lanes; ++lane)
+        startMessage(lane);
+
+    static const uchar idleBlock[ShaBlockSize] = {};
+    // when few messages are left, the idle lanes would cost more than
+    // finishing the remaining ones on their own
+    while (activeLanes > Lanes / 2 || (activeLanes && nextMessage < data.size())) {
+        const uchar *blocks[Lanes];
+        for (int lane = 0; lane < Lanes; ++lane)
+            blocks[lane] = messageIndex[lane] < 0 ? idleBlock : messages[lane].takeBlock();
+
+        sha256EightBlocksAvx2(hash, blocks);
+
+        for (int lane = 0; lane < Lanes; ++lane) {
+            if (messageIndex[lane] >= 0 && messages[lane].atEnd()) {
+                finishMessage(lane);
+                startMessage(lane);
+            }
+        }
+    }
+
+    for (int lane = 0; lane < Lanes; ++lane) {
+        if (messageIndex[lane] < 0)
+            continue;
+        quint32 laneHash[8];
+        for (int i = 0; i < 8; ++i)
+            laneHash[i] = hash[i][lane];
+        messages[lane].finish(laneHash, sha256BlocksGeneric);
+        for (int i = 0; i < 8; ++i)
+            hash[i][lane] = laneHash[i];
+        finishMessage(lane);
+    }
+    return true;
+}
+#endif // SHA256_MULTI_BUFFER
+#endif // !QT_BOOTSTRAPPED && !USING_OPENSSL30
+
 class QCryptographicHashPrivate
 {
 public:
@@ -846,7 +1409,11 @@ void QCryptographicHashPrivate::State::addData(QCryptographicHash::Algorithm met
 #endif
         switch (method) {
         case QCryptographicHash::Sha1:
+#ifdef QT_BOOTSTRAPPED
             sha1Update(&sha1Context, (const unsigned char *)data, length);
+#else
+            sha1Input(&sha1Context, reinterpret_cast<const uchar *>(data), length);
+#endif
             break;
 #ifdef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
         default:
@@ -861,10 +1428,10 @@ void QCryptographicHashPrivate::State::addData(QCryptographicHash::Algorithm met
             MD5Update(&md5Context, (const unsigned char *)data, length);
             break;
         case QCryptographicHash::Sha224:
-            SHA224Input(&sha224Context, reinterpret_cast<const unsigned char *>(data), length);
+            sha256Input(&sha224Context, reinterpret_cast<const uchar *>(data), length);
             break;
         case QCryptographicHash::Sha256:
-            SHA256Input(&sha256Context, reinterpret_cast<const unsigned char *>(data), length);
+            sha256Input(&sha256Context, reinterpret_cast<const uchar *>(data), length);
             break;
         case QCryptographicHash::Sha384:
             SHA384Input(&sha384Context, reinterpret_cast<const unsigned char *>(data), length);
@@ -1126,6 +1693,38 @@ QByteArray QCryptographicHash::hash(QByteArrayView data, Algorithm method)
     return hash.resultView().toByteArray();
 }
 
+/*!
+  \since 6.7
+
+  Returns the hashes of each of the byte arrays in \a data using \a method,
+  in the same order.
+
+  The result is the same as calling hash() for each of them, but hashing
+  many small messages is faster this way: when the CPU has no instructions
+  for the algorithm, the SHA-224 and SHA-256 hashes of several messages
+  are computed at the same time with SIMD instructions.
+
+  \sa hash()
+*/
+QByteArrayList QCryptographicHash::hashBatch(const QList<QByteArrayView> &data, Algorithm method)
+{
+    QByteArrayList results;
+#ifdef SHA256_MULTI_BUFFER
+    if ((method == Sha224 || method == Sha256) && sha256Batch(data, method, &results))
+        return results;
+#endif
+
+    results.reserve(data.size());
+    QCryptographicHashPrivate hash(method);
+    for (QByteArrayView message : data) {
+        hash.reset();
+        hash.addData(message);
+        hash.finalizeUnchecked(); // no mutex needed: no-one but us has access to 'hash'
+        results.append(hash.resultView().toByteArray());
+    }
+    return results;
+}
+
 /*!
   Returns the size of the output of the selected hash \a method in bytes.
 
@@ -91,6 +91,7 @@ public:
     static QByteArray hash(const QByteArray &data, Algorithm method);
 #endif
     static QByteArray hash(QByteArrayView data, Algorithm method);
+    static QByteArrayList hashBatch(const QList<QByteArrayView> &data, Algorithm method);
     static int hashLength(Algorithm method);
     static bool supportsAlgorithm(Algorithm method);
 private:
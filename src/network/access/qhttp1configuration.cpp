@@ -13,6 +13,10 @@ static_assert(sizeof(QHttp1Configuration) == sizeof(void*),
               "You have added too many members to QHttp1Configuration::ShortData. "
               "Decrease their size or switch to using a d-pointer.");
 
+enum ShortDataFlag : std::uint8_t {
+    SharedConnectionPool = 0x1
+};
+
 /*!
     \class QHttp1Configuration
     \brief The QHttp1Configuration class controls HTTP/1 parameters and settings.
@@ -26,6 +30,13 @@ static_assert(sizeof(QHttp1Configuration) == sizeof(void*),
     QHttp1Configuration controls HTTP/1 parameters and settings that
     QNetworkAccessManager will use to send requests and process responses.
 
+    By default, QNetworkAccessManager opens up to numberOfConnectionsPerHost()
+    connections to each host and keeps them open until they are no longer
+    needed by any request. The pool can be made adaptive: with
+    setMaximumNumberOfConnectionsPerHost(), more connections are opened while
+    requests are waiting for a free one, and with setIdleConnectionTimeout(),
+    connections that were not used for a while are closed again.
+
     \note The configuration must be set before the first request
     was sent to a given host (and thus an HTTP/1 session established).
 
@@ -36,7 +47,7 @@ static_assert(sizeof(QHttp1Configuration) == sizeof(void*),
     Default constructs a QHttp1Configuration object.
 */
 QHttp1Configuration::QHttp1Configuration()
-    : u(ShortData{6, {}}) // QHttpNetworkConnectionPrivate::defaultHttpChannelCount
+    : u(ShortData{6, 0, 0, 0}) // QHttpNetworkConnectionPrivate::defaultHttpChannelCount
 {
 }
 
@@ -105,6 +116,107 @@ qsizetype QHttp1Configuration::numberOfConnectionsPerHost() const
     return u.data.numConnectionsPerHost;
 }
 
+/*!
+    \since 6.7
+
+    Sets the maximum number of connections (maximum: 255) used per http(s)
+    \e{host}:\e{port} combination to \a number.
+
+    When all numberOfConnectionsPerHost() connections are busy and further
+    requests are waiting, additional connections are opened, up to \a number
+    in total. Those connections are given up again once they are idle, see
+    setIdleConnectionTimeout().
+
+    If \a number is ≤ 0, does nothing. If \a number is > 255, 255 is used.
+    Values below numberOfConnectionsPerHost() disable the growth of the pool.
+
+    \sa maximumNumberOfConnectionsPerHost(), setNumberOfConnectionsPerHost()
+*/
+void QHttp1Configuration::setMaximumNumberOfConnectionsPerHost(qsizetype number)
+{
+    auto n = qt_saturate<std::uint8_t>(number);
+    if (n == 0)
+        return;
+    u.data.maxConnectionsPerHost = n;
+}
+
+/*!
+    \since 6.7
+
+    Returns the maximum number of connections used per http(s)
+    \e{host}:\e{port} combination. This is never less than
+    numberOfConnectionsPerHost(), which is also the default.
+
+    \sa setMaximumNumberOfConnectionsPerHost(), numberOfConnectionsPerHost()
+*/
+qsizetype QHttp1Configuration::maximumNumberOfConnectionsPerHost() const
+{
+    return qMax(u.data.numConnectionsPerHost, u.data.maxConnectionsPerHost);
+}
+
+/*!
+    \since 6.7
+
+    Sets the time after which a connection that has not been used for any
+    request is closed to \a timeout (maximum: 255 seconds). A \a timeout of
+    zero, the default, keeps idle connections open for as long as the
+    connection to the host is cached.
+
+    \sa idleConnectionTimeout(), QNetworkRequest::ConnectionCacheExpiryTimeoutSecondsAttribute
+*/
+void QHttp1Configuration::setIdleConnectionTimeout(std::chrono::seconds timeout)
+{
+    u.data.idleTimeoutSeconds = qt_saturate<std::uint8_t>(timeout.count());
+}
+
+/*!
+    \since 6.7
+
+    Returns the time after which an idle connection is closed, or zero if
+    idle connections are kept open.
+
+    \sa setIdleConnectionTimeout()
+*/
+std::chrono::seconds QHttp1Configuration::idleConnectionTimeout() const
+{
+    return std::chrono::seconds(u.data.idleTimeoutSeconds);
+}
+
+/*!
+    \since 6.7
+
+    If \a enable is \c true, requests using this configuration share their
+    connections with all QNetworkAccessManager instances in the process that
+    do the same, instead of each manager keeping its own connections. This
+    avoids opening several connection pools to the same host.
+
+    Connections are only shared between requests that use the same TLS
+    configuration and the same credentials, either from the URL or cached
+    by their manager.
+
+    \sa sharedConnectionPoolEnabled()
+*/
+void QHttp1Configuration::setSharedConnectionPoolEnabled(bool enable)
+{
+    if (enable)
+        u.data.flags |= SharedConnectionPool;
+    else
+        u.data.flags &= ~SharedConnectionPool;
+}
+
+/*!
+    \since 6.7
+
+    Returns \c true if connections are shared with other
+    QNetworkAccessManager instances. The default is \c false.
+
+    \sa setSharedConnectionPoolEnabled()
+*/
+bool QHttp1Configuration::sharedConnectionPoolEnabled() const
+{
+    return u.data.flags & SharedConnectionPool;
+}
+
 /*!
     \fn void QHttp1Configuration::swap(QHttp1Configuration &other)
 
@@ -140,7 +252,10 @@ qsizetype QHttp1Configuration::numberOfConnectionsPerHost() const
 */
 bool QHttp1Configuration::equals(const QHttp1Configuration &other) const noexcept
 {
-    return u.data.numConnectionsPerHost == other.u.data.numConnectionsPerHost;
+    return u.data.numConnectionsPerHost == other.u.data.numConnectionsPerHost
+        && maximumNumberOfConnectionsPerHost() == other.maximumNumberOfConnectionsPerHost()
+        && u.data.idleTimeoutSeconds == other.u.data.idleTimeoutSeconds
+        && u.data.flags == other.u.data.flags;
 }
 
 /*!
@@ -148,7 +263,8 @@ bool QHttp1Configuration::equals(const QHttp1Configuration &other) const noexcep
 */
 size_t QHttp1Configuration::hash(size_t seed) const noexcept
 {
-    return qHash(u.data.numConnectionsPerHost, seed);
+    return qHashMulti(seed, u.data.numConnectionsPerHost, maximumNumberOfConnectionsPerHost(),
+                      u.data.idleTimeoutSeconds, u.data.flags);
 }
 
 QT_END_NAMESPACE
@@ -6,6 +6,7 @@
 
 #include <QtNetwork/qtnetworkglobal.h>
 
+#include <chrono>
 #include <utility>
 #include <cstdint>
 
@@ -30,13 +31,24 @@ public:
     Q_NETWORK_EXPORT void setNumberOfConnectionsPerHost(qsizetype amount);
     Q_NETWORK_EXPORT qsizetype numberOfConnectionsPerHost() const;
 
+    Q_NETWORK_EXPORT void setMaximumNumberOfConnectionsPerHost(qsizetype amount);
+    Q_NETWORK_EXPORT qsizetype maximumNumberOfConnectionsPerHost() const;
+
+    Q_NETWORK_EXPORT void setIdleConnectionTimeout(std::chrono::seconds timeout);
+    Q_NETWORK_EXPORT std::chrono::seconds idleConnectionTimeout() const;
+
+    Q_NETWORK_EXPORT void setSharedConnectionPoolEnabled(bool enable);
+    Q_NETWORK_EXPORT bool sharedConnectionPoolEnabled() const;
+
     void swap(QHttp1Configuration &other) noexcept
     { std::swap(u, other.u); }
 
 private:
     struct ShortData {
         std::uint8_t numConnectionsPerHost;
-        char reserved[sizeof(void*) - sizeof(numConnectionsPerHost)];
+        std::uint8_t maxConnectionsPerHost; // 0: same as numConnectionsPerHost
+        std::uint8_t idleTimeoutSeconds;    // 0: never close idle connections
+        std::uint8_t flags;
     };
     union U {
         U(ShortData _data) : data(_data) {}
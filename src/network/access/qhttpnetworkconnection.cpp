@@ -52,6 +52,7 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &host
                        || type == QHttpNetworkConnection::ConnectionTypeHTTP2Direct
                        ? 1 : defaultHttpChannelCount)
   , channelCount(defaultHttpChannelCount)
+  , http1ChannelCount(defaultHttpChannelCount)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
@@ -70,7 +71,7 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(quint16 connectionC
                                                              QHttpNetworkConnection::ConnectionType type)
 : state(RunningState), networkLayerState(Unknown),
   hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true),
-  channelCount(connectionCount)
+  channelCount(connectionCount), http1ChannelCount(connectionCount)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
@@ -112,6 +113,9 @@ void QHttpNetworkConnectionPrivate::init()
 
     delayedConnectionTimer.setSingleShot(true);
     QObject::connect(&delayedConnectionTimer, SIGNAL(timeout()), q, SLOT(_q_connectDelayedChannel()));
+
+    idleChannelTimer.setSingleShot(true);
+    QObject::connect(&idleChannelTimer, &QTimer::timeout, q, [this] { closeIdleChannels(); });
 }
 
 void QHttpNetworkConnectionPrivate::pauseConnection()
@@ -156,7 +160,9 @@ void QHttpNetworkConnectionPrivate::resumeConnection()
 
 int QHttpNetworkConnectionPrivate::indexOf(QAbstractSocket *socket) const
 {
-    for (int i = 0; i < activeChannelCount; ++i)
+    // Channels beyond activeChannelCount may still have a socket, if the pool
+    // shrank after they were closed for being idle:
+    for (int i = 0; i < channelCount; ++i)
         if (channels[i].socket == socket)
             return i;
 
@@ -182,7 +188,8 @@ bool QHttpNetworkConnectionPrivate::shouldEmitChannelError(QAbstractSocket *sock
         channels[otherSocket].ensureConnection();
     }
 
-    if (activeChannelCount < channelCount) {
+    if (connectionType != QHttpNetworkConnection::ConnectionTypeHTTP) {
+        // HTTP/2 uses a single channel, there is no second one to fall back to
         if (networkLayerState == HostLookupPending || networkLayerState == IPv4or6)
             networkLayerState = QHttpNetworkConnectionPrivate::Unknown;
         channels[0].close();
@@ -1161,6 +1168,15 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
         neededOpenChannels--;
     }
 
+    // all channels we use are busy and there are still requests waiting:
+    // grow the pool towards the reserved number of channels
+    if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP) {
+        while (activeChannelCount < channelCount && neededOpenChannels > 0) {
+            channelsToConnect.enqueue(activeChannelCount++);
+            neededOpenChannels--;
+        }
+    }
+
     while (!channelsToConnect.isEmpty()) {
         const int channel = channelsToConnect.dequeue();
 
@@ -1174,6 +1190,56 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
 }
 
 
+void QHttpNetworkConnectionPrivate::channelBecameIdle(QHttpNetworkConnectionChannel &channel)
+{
+    if (http1Parameters.idleConnectionTimeout() == std::chrono::seconds::zero())
+        return;
+    channel.idleTimer.start();
+    if (!idleChannelTimer.isActive())
+        idleChannelTimer.start(http1Parameters.idleConnectionTimeout());
+}
+
+// Closes the kept-alive channels that did not get a new request within the
+// idle timeout, and gives back the channels the pool grew into once they are
+// no longer in use.
+void QHttpNetworkConnectionPrivate::closeIdleChannels()
+{
+    if (connectionType != QHttpNetworkConnection::ConnectionTypeHTTP)
+        return;
+
+    using namespace std::chrono;
+    const milliseconds timeout = http1Parameters.idleConnectionTimeout();
+    milliseconds nextCheck = milliseconds::max();
+    for (int i = 0; i < activeChannelCount; ++i) {
+        QHttpNetworkConnectionChannel &channel = channels[i];
+        if (channel.reply || channel.state != QHttpNetworkConnectionChannel::IdleState
+            || !channel.alreadyPipelinedRequests.isEmpty() || !channel.idleTimer.isValid()
+            || !channel.socket || channel.socket->state() != QAbstractSocket::ConnectedState) {
+            continue;
+        }
+        const milliseconds idle(channel.idleTimer.elapsed());
+        if (idle >= timeout) {
+            channel.idleTimer.invalidate();
+            channel.close();
+        } else {
+            nextCheck = qMin(nextCheck, timeout - idle);
+        }
+    }
+
+    while (activeChannelCount > http1ChannelCount) {
+        const QHttpNetworkConnectionChannel &channel = channels[activeChannelCount - 1];
+        if (channel.reply || channel.state != QHttpNetworkConnectionChannel::IdleState
+            || !channel.alreadyPipelinedRequests.isEmpty()
+            || (channel.socket && channel.socket->state() != QAbstractSocket::UnconnectedState)) {
+            break;
+        }
+        --activeChannelCount;
+    }
+
+    if (nextCheck != milliseconds::max())
+        idleChannelTimer.start(nextCheck);
+}
+
 void QHttpNetworkConnectionPrivate::readMoreLater(QHttpNetworkReply *reply)
 {
     for (int i = 0 ; i < activeChannelCount; ++i) {
@@ -1453,6 +1519,23 @@ void QHttpNetworkConnection::setConnectionType(ConnectionType type)
     d->connectionType = type;
 }
 
+QHttp1Configuration QHttpNetworkConnection::http1Parameters() const
+{
+    Q_D(const QHttpNetworkConnection);
+    return d->http1Parameters;
+}
+
+// Must be called before the first request is sent; the channels beyond
+// numberOfConnectionsPerHost() are only used while requests are waiting.
+void QHttpNetworkConnection::setHttp1Parameters(const QHttp1Configuration &params)
+{
+    Q_D(QHttpNetworkConnection);
+    d->http1Parameters = params;
+    d->http1ChannelCount = qMin(int(params.numberOfConnectionsPerHost()), d->channelCount);
+    if (d->connectionType == ConnectionTypeHTTP)
+        d->activeChannelCount = d->http1ChannelCount;
+}
+
 QHttp2Configuration QHttpNetworkConnection::http2Parameters() const
 {
     Q_D(const QHttpNetworkConnection);
@@ -20,6 +20,7 @@
 #include <QtNetwork/qnetworkreply.h>
 #include <QtNetwork/qabstractsocket.h>
 
+#include <qhttp1configuration.h>
 #include <qhttp2configuration.h>
 
 #include <private/qobject_p.h>
@@ -95,6 +96,9 @@ public:
     ConnectionType connectionType();
     void setConnectionType(ConnectionType type);
 
+    QHttp1Configuration http1Parameters() const;
+    void setHttp1Parameters(const QHttp1Configuration &params);
+
     QHttp2Configuration http2Parameters() const;
     void setHttp2Parameters(const QHttp2Configuration &params);
 
@@ -205,6 +209,9 @@ public:
 
     void removeReply(QHttpNetworkReply *reply);
 
+    void channelBecameIdle(QHttpNetworkConnectionChannel &channel);
+    void closeIdleChannels();
+
     QString hostName;
     quint16 port;
     bool encrypt;
@@ -214,7 +221,11 @@ public:
     int activeChannelCount;
     // The total number of channels we reserved:
     const int channelCount;
+    // Number of channels HTTP/1 starts out with; activeChannelCount can grow
+    // from there up to channelCount while requests are waiting:
+    int http1ChannelCount;
     QTimer delayedConnectionTimer;
+    QTimer idleChannelTimer;
     QHttpNetworkConnectionChannel *channels; // parallel connections to the server
     bool shouldEmitChannelError(QAbstractSocket *socket);
 
@@ -249,6 +260,7 @@ public:
     std::shared_ptr<QSslContext> sslContext;
 #endif
 
+    QHttp1Configuration http1Parameters;
     QHttp2Configuration http2Parameters;
 
     QString peerVerifyName;
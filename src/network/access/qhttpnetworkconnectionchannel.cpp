@@ -465,7 +465,7 @@ void QHttpNetworkConnectionChannel::allDone()
         } else {
             // Ok, whatever happened, we do not try HTTP/2 anymore ...
             connection->setConnectionType(QHttpNetworkConnection::ConnectionTypeHTTP);
-            connection->d_func()->activeChannelCount = connection->d_func()->channelCount;
+            connection->d_func()->activeChannelCount = connection->d_func()->http1ChannelCount;
         }
     }
 
@@ -535,9 +535,12 @@ void QHttpNetworkConnectionChannel::allDone()
 
         QMetaObject::invokeMethod(connection, "_q_startNextRequest", Qt::QueuedConnection);
     } else if (alreadyPipelinedRequests.isEmpty()) {
-        if (connectionCloseEnabled)
+        if (connectionCloseEnabled) {
             if (socket->state() != QAbstractSocket::UnconnectedState)
                 close();
+        } else if (!reply) {
+            connection->d_func()->channelBecameIdle(*this);
+        }
         if (qobject_cast<QHttpNetworkConnection*>(connection))
             QMetaObject::invokeMethod(connection, "_q_startNextRequest", Qt::QueuedConnection);
     }
@@ -1208,10 +1211,10 @@ void QHttpNetworkConnectionChannel::_q_encrypted()
 
             connection->setConnectionType(QHttpNetworkConnection::ConnectionTypeHTTP);
             // We use only one channel for HTTP/2, but normally six for
-            // HTTP/1.1 - let's restore this number to the reserved number of
+            // HTTP/1.1 - let's restore this number to the number of HTTP/1
             // channels:
-            if (connection->d_func()->activeChannelCount < connection->d_func()->channelCount) {
-                connection->d_func()->activeChannelCount = connection->d_func()->channelCount;
+            if (connection->d_func()->activeChannelCount < connection->d_func()->http1ChannelCount) {
+                connection->d_func()->activeChannelCount = connection->d_func()->http1ChannelCount;
                 // re-queue requests from HTTP/2 queue to HTTP queue, if any
                 requeueHttp2Requests();
             }
@@ -40,6 +40,7 @@
 #   include <QtNetwork/qtcpsocket.h>
 #endif
 
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qscopedpointer.h>
 
 #include <memory>
@@ -89,6 +90,7 @@ public:
     std::unique_ptr<QAbstractProtocolHandler> protocolHandler;
     QMultiMap<int, HttpMessagePair> h2RequestsToSend;
     bool switchedToHttp2 = false;
+    QElapsedTimer idleTimer; // since the last reply on a kept-alive connection was done
 #ifndef QT_NO_SSL
     bool ignoreAllSslErrors;
     QList<QSslError> ignoreSslErrorsList;
@@ -5,6 +5,7 @@
 #include <private/qhttpprotocolhandler_p.h>
 #include <private/qnoncontiguousbytedevice_p.h>
 #include <private/qhttpnetworkconnectionchannel_p.h>
+#include <private/qabstractsocket_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -20,10 +21,13 @@ void QHttpProtocolHandler::_q_receiveReply()
     Q_ASSERT(m_socket);
 
     if (!m_reply) {
-        if (m_socket->bytesAvailable() > 0)
+        // A queued call (see sendRequest()) can arrive after the reply it was
+        // meant for has been read; that leaves a kept-alive channel alone.
+        if (m_socket->bytesAvailable() > 0) {
             qWarning() << "QAbstractProtocolHandler::_q_receiveReply() called without QHttpNetworkReply,"
                        << m_socket->bytesAvailable() << "bytes on socket.";
-        m_channel->close();
+            m_channel->close();
+        }
         return;
     }
 
@@ -322,6 +326,41 @@ bool QHttpProtocolHandler::sendRequest()
             break;
         }
 
+#if QT_CONFIG(sendfile)
+        // On an unencrypted connection, let the kernel send an upload from a
+        // file straight from the page cache instead of reading it.
+        qint64 fileOffset = 0;
+        const qintptr fileHandle = m_channel->ssl ? -1 : uploadByteDevice->fileHandle(&fileOffset);
+        if (fileHandle != -1) {
+            if (!m_header.isEmpty()) {
+                m_socket->write(std::exchange(m_header, {}));
+                QMetaObject::invokeMethod(m_reply, "requestSent", Qt::QueuedConnection);
+            }
+            auto *socketPrivate = static_cast<QAbstractSocketPrivate *>(QObjectPrivate::get(m_socket));
+            const qint64 currentWriteSize = socketPrivate->sendFile(fileHandle, fileOffset,
+                                                                    m_channel->bytesTotal - m_channel->written);
+            if (currentWriteSize >= 0) {
+                // sendFile() makes the socket emit bytesWritten() to get us called again
+                if (currentWriteSize > 0) {
+                    m_channel->written += currentWriteSize;
+                    uploadByteDevice->advanceReadPointer(currentWriteSize);
+                    emit m_reply->dataSendProgress(m_channel->written, m_channel->bytesTotal);
+                    if (m_channel->written == m_channel->bytesTotal) {
+                        m_channel->state = QHttpNetworkConnectionChannel::WaitingState;
+                        sendRequest();
+                    }
+                }
+                break;
+            }
+            if (m_socket->state() != QAbstractSocket::ConnectedState) {
+                // socket broke down
+                m_connection->d_func()->emitReplyError(m_socket, m_reply, QNetworkReply::UnknownNetworkError);
+                return false;
+            }
+            // otherwise the socket cannot send files, read the data below
+        }
+#endif
+
         // only feed the QTcpSocket buffer when there is less than 32 kB in it;
         // note that the headers do not count towards these limits.
         const qint64 socketBufferFill = 32*1024;
@@ -9,6 +9,10 @@
 #include <QAuthenticator>
 #include <QEventLoop>
 #include <QCryptographicHash>
+#if QT_CONFIG(ssl)
+#include <QSslCipher>
+#include <QSslKey>
+#endif
 
 #include "private/qhttpnetworkreply_p.h"
 #include "private/qnetworkaccesscache_p.h"
@@ -140,6 +144,52 @@ static QByteArray makeCacheKey(QUrl &url, QNetworkProxy *proxy, const QString &p
     return "http-connection:" + std::move(result).toLatin1();
 }
 
+#if QT_CONFIG(ssl)
+// identifies everything a TLS connection is set up with
+static QByteArray makeSslConfigurationKey(const QSslConfiguration &configuration)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(configuration.localCertificate().toDer());
+    for (const QSslCertificate &certificate : configuration.localCertificateChain())
+        hash.addData(certificate.toDer());
+    hash.addData(configuration.privateKey().toDer());
+    for (const QSslCertificate &certificate : configuration.caCertificates())
+        hash.addData(certificate.digest(QCryptographicHash::Sha256));
+    for (const QSslCipher &cipher : configuration.ciphers())
+        hash.addData(cipher.name().toLatin1());
+    for (const QByteArray &protocol : configuration.allowedNextProtocols())
+        hash.addData(protocol);
+    const int settings[] = {
+        int(configuration.protocol()),
+        int(configuration.peerVerifyMode()),
+        configuration.peerVerifyDepth(),
+        configuration.testSslOption(QSsl::SslOptionDisableLegacyRenegotiation),
+        configuration.testSslOption(QSsl::SslOptionDisableServerNameIndication),
+        configuration.ocspStaplingEnabled(),
+    };
+    hash.addData(QByteArrayView(reinterpret_cast<const char *>(settings), sizeof(settings)));
+    return hash.result().toHex();
+}
+#endif
+
+// identifies the credentials requests to \a url are sent with, if any
+static QByteArray makeCredentialKey(const QUrl &url,
+                                    QNetworkAccessAuthenticationManager *authenticationManager)
+{
+    QString user = url.userName();
+    QString password = url.password();
+    if (user.isEmpty() && authenticationManager) {
+        const QNetworkAuthenticationCredential credential =
+                authenticationManager->fetchCachedCredentials(url, nullptr);
+        user = credential.user;
+        password = credential.password;
+    }
+    if (user.isEmpty())
+        return QByteArray();
+    return user.toUtf8().toPercentEncoding() + ':'
+            + QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha256).toHex();
+}
+
 class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
                                       public QNetworkAccessCache::CacheableObject
 {
@@ -292,13 +342,26 @@ void QHttpThreadDelegate::startRequest()
 #endif
         cacheKey = makeCacheKey(urlCopy, nullptr, httpRequest.peerVerifyName());
 
+    // Shared connections are used by the requests of all managers, so the
+    // key must tell apart the TLS configurations and the credentials that
+    // connections are set up and authenticated with.
+    if (http1Parameters.sharedConnectionPoolEnabled()) {
+#if QT_CONFIG(ssl)
+        if (ssl)
+            cacheKey += ":tls=" + makeSslConfigurationKey(*incomingSslConfiguration);
+#endif
+        cacheKey += ":auth=" + makeCredentialKey(httpRequest.url(), authenticationManager.get());
+    }
+
     // the http object is actually a QHttpNetworkConnection
     httpConnection = static_cast<QNetworkAccessCachedHttpConnection *>(connections.localData()->requestEntryNow(cacheKey));
     if (!httpConnection) {
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
-        httpConnection = new QNetworkAccessCachedHttpConnection(http1Parameters.numberOfConnectionsPerHost(), urlCopy.host(), urlCopy.port(), ssl,
+        // reserve channels up to the maximum, the pool grows into them on demand
+        httpConnection = new QNetworkAccessCachedHttpConnection(http1Parameters.maximumNumberOfConnectionsPerHost(), urlCopy.host(), urlCopy.port(), ssl,
                                                                 connectionType);
+        httpConnection->setHttp1Parameters(http1Parameters);
         if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
             || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
             httpConnection->setHttp2Parameters(http2Parameters);
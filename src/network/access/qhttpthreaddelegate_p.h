@@ -171,6 +171,8 @@ protected:
     bool m_atEnd;
     qint64 m_size;
     qint64 m_pos; // to match calls of haveDataSlot with the expected position
+    qintptr m_fileHandle; // of the file in the user thread, if it can be sent directly
+    qint64 m_fileOffset;
 public:
     QNonContiguousByteDeviceThreadForwardImpl(bool aE, qint64 s)
         : QNonContiguousByteDevice(),
@@ -179,10 +181,18 @@ public:
           m_data(nullptr),
           m_atEnd(aE),
           m_size(s),
-          m_pos(0)
+          m_pos(0),
+          m_fileHandle(-1),
+          m_fileOffset(0)
     {
     }
 
+    void setFileHandle(qintptr handle, qint64 offset)
+    {
+        m_fileHandle = handle;
+        m_fileOffset = offset;
+    }
+
     ~QNonContiguousByteDeviceThreadForwardImpl()
     {
     }
@@ -204,6 +214,7 @@ public:
         } else if (!wantDataPending) {
             len = 0;
             wantDataPending = true;
+            m_fileHandle = -1; // the data is sent from memory from now on
             emit wantData(maximumLength);
         } else {
             // Do nothing, we already sent a wantData signal and wait for results
@@ -214,11 +225,12 @@ public:
 
     bool advanceReadPointer(qint64 a) override
     {
-        if (m_data == nullptr)
+        if (m_data) {
+            m_amount -= a;
+            m_data += a;
+        } else if (m_fileHandle == -1) {
             return false;
-
-        m_amount -= a;
-        m_data += a;
+        }
         m_pos += a;
 
         // To main thread to inform about our state. The m_pos will be sent as a sanity check.
@@ -262,6 +274,14 @@ public:
         return m_size;
     }
 
+    qintptr fileHandle(qint64 *offset) const override
+    {
+        if (m_fileHandle == -1 || m_amount > 0)
+            return -1;
+        *offset = m_fileOffset + m_pos;
+        return m_fileHandle;
+    }
+
 public slots:
     // From user thread:
     void haveDataSlot(qint64 pos, const QByteArray &dataArray, bool dataAtEnd, qint64 dataSize)
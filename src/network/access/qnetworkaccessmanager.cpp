@@ -79,6 +79,32 @@ Q_GLOBAL_STATIC(QNetworkAccessDebugPipeBackendFactory, debugpipeBackend)
 
 Q_APPLICATION_STATIC(QFactoryLoader, qnabfLoader, QNetworkAccessBackendFactory_iid, "/networkaccess"_L1)
 
+namespace {
+// Runs the requests whose connections are shared between all managers, see
+// QHttp1Configuration::setSharedConnectionPoolEnabled(). The connection cache
+// is per thread, so running them in one thread is what shares it.
+struct QNetworkAccessSharedThread
+{
+    QNetworkAccessSharedThread()
+    {
+        thread->setObjectName(QStringLiteral("QNetworkAccessManager shared thread"));
+        thread->start();
+    }
+    ~QNetworkAccessSharedThread()
+    {
+        // Only asynchronous requests run in this thread and nothing in it
+        // blocks, so it returns as soon as its event loop gets to the quit.
+        // The application is going away, nobody would delete it later.
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+    QThread *thread = new QThread;
+};
+} // unnamed namespace
+
+Q_APPLICATION_STATIC(QNetworkAccessSharedThread, sharedThread)
+
 #if defined(Q_OS_MACOS)
 bool getProxyAuth(const QString& proxyHostname, const QString &scheme, QString& username, QString& password)
 {
@@ -1629,6 +1655,11 @@ QThread * QNetworkAccessManagerPrivate::createThread()
     return thread;
 }
 
+QThread *QNetworkAccessManagerPrivate::sharedHttpThread()
+{
+    return sharedThread()->thread;
+}
+
 void QNetworkAccessManagerPrivate::destroyThread()
 {
     if (thread) {
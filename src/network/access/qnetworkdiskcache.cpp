@@ -22,6 +22,7 @@
 #define CACHE_POSTFIX ".d"_L1
 #define CACHE_VERSION 8
 #define DATA_DIR "data"_L1
+#define INDEX_FILE "index"_L1
 
 #define MAX_COMPRESSION_SIZE (1024 * 1024 * 3)
 
@@ -41,6 +42,11 @@ using namespace Qt::StringLiterals;
     are compressed using qCompress.  Data is written to disk only in insert()
     and updateMetaData().
 
+    The size of each cache file and the order in which the files were last
+    used are recorded in an index file inside the cache directory, so that
+    lookups and expire() do not have to scan the directory. If the index is
+    missing, it is rebuilt from the files found in the cache directory.
+
     Currently you cannot share the same cache files with more than
     one disk cache.
 
@@ -117,6 +123,7 @@ void QNetworkDiskCache::setCacheDirectory(const QString &cacheDir)
 
     d->dataDirectory = d->cacheDirectory + DATA_DIR + QString::number(CACHE_VERSION) + u'/';
     d->prepareLayout();
+    d->loadIndex();
 }
 
 /*!
@@ -130,11 +137,7 @@ qint64 QNetworkDiskCache::cacheSize() const
     Q_D(const QNetworkDiskCache);
     if (d->cacheDirectory.isEmpty())
         return 0;
-    if (d->currentCacheSize < 0) {
-        QNetworkDiskCache *that = const_cast<QNetworkDiskCache*>(this);
-        that->d_func()->currentCacheSize = that->expire();
-    }
-    return d->currentCacheSize;
+    return d->indexedCacheSize;
 }
 
 /*!
@@ -230,20 +233,19 @@ void QNetworkDiskCachePrivate::prepareLayout()
 
 void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
 {
-    Q_Q(QNetworkDiskCache);
     Q_ASSERT(cacheItem->metaData.saveToDisk());
 
     QString fileName = cacheFileName(cacheItem->metaData.url());
     Q_ASSERT(!fileName.isEmpty());
 
-    if (QFile::exists(fileName)) {
+    if (isIndexed(fileName)) {
         if (!removeFile(fileName)) {
             qWarning() << "QNetworkDiskCache: couldn't remove the cache file " << fileName;
             return;
         }
     }
 
-    currentCacheSize = q->expire();
+    expireCache();
     if (!cacheItem->file) {
         cacheItem->file = new QSaveFile(fileName, &cacheItem->data);
         if (cacheItem->file->open(QFileDevice::WriteOnly)) {
@@ -259,8 +261,11 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
         // commit() invalidates the file-engine, and size() will create a new
         // one, pointing at an empty filename.
         qint64 size = cacheItem->file->size();
-        if (cacheItem->file->commit())
-            currentCacheSize += size;
+        // Index the file before committing it, so that a crash in between
+        // leaves a stale index entry rather than a file that never expires.
+        addToIndex(fileName, size);
+        if (!cacheItem->file->commit())
+            removeFromIndex(fileName);
         // Delete and unset the QSaveFile, it's invalid now.
         delete std::exchange(cacheItem->file, nullptr);
     }
@@ -303,15 +308,14 @@ bool QNetworkDiskCachePrivate::removeFile(const QString &file)
 #endif
     if (file.isEmpty())
         return false;
-    QFileInfo info(file);
-    QString fileName = info.fileName();
-    if (!fileName.endsWith(CACHE_POSTFIX))
+    if (!file.endsWith(CACHE_POSTFIX))
         return false;
-    qint64 size = info.size();
     if (QFile::remove(file)) {
-        currentCacheSize -= size;
+        removeFromIndex(file);
         return true;
     }
+    if (!QFile::exists(file))
+        removeFromIndex(file);
     return false;
 }
 
@@ -326,7 +330,10 @@ QNetworkCacheMetaData QNetworkDiskCache::metaData(const QUrl &url)
     Q_D(QNetworkDiskCache);
     if (d->lastItem.metaData.url() == url)
         return d->lastItem.metaData;
-    return fileMetaData(d->cacheFileName(url));
+    const QString fileName = d->cacheFileName(url);
+    if (!d->isIndexed(fileName))
+        return QNetworkCacheMetaData();
+    return fileMetaData(fileName);
 }
 
 /*!
@@ -340,12 +347,15 @@ QNetworkCacheMetaData QNetworkDiskCache::fileMetaData(const QString &fileName) c
     qDebug() << "QNetworkDiskCache::fileMetaData()" << fileName;
 #endif
     Q_D(const QNetworkDiskCache);
+    QNetworkDiskCachePrivate *that = const_cast<QNetworkDiskCachePrivate*>(d);
     QFile file(fileName);
-    if (!file.open(QFile::ReadOnly))
+    if (!file.open(QFile::ReadOnly)) {
+        if (!file.exists())
+            that->removeFromIndex(fileName);
         return QNetworkCacheMetaData();
+    }
     if (!d->lastItem.read(&file, false)) {
         file.close();
-        QNetworkDiskCachePrivate *that = const_cast<QNetworkDiskCachePrivate*>(d);
         that->removeFile(fileName);
     }
     return d->lastItem.metaData;
@@ -363,13 +373,19 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
     std::unique_ptr<QBuffer> buffer;
     if (!url.isValid())
         return nullptr;
+    const QString fileName = d->cacheFileName(url);
     if (d->lastItem.metaData.url() == url && d->lastItem.data.isOpen()) {
         buffer.reset(new QBuffer);
         buffer->setData(d->lastItem.data.data());
     } else {
-        QScopedPointer<QFile> file(new QFile(d->cacheFileName(url)));
-        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered))
+        if (!d->isIndexed(fileName))
+            return nullptr;
+        QScopedPointer<QFile> file(new QFile(fileName));
+        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered)) {
+            if (!file->exists())
+                d->removeFromIndex(fileName);
             return nullptr;
+        }
 
         if (!d->lastItem.read(file.data(), true)) {
             file->close();
@@ -385,6 +401,7 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
             buffer->setData(file->readAll());
         }
     }
+    d->touchIndex(fileName);
     buffer->open(QBuffer::ReadOnly);
     return buffer.release();
 }
@@ -446,7 +463,7 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
     bool expireCache = (size < d->maximumCacheSize);
     d->maximumCacheSize = size;
     if (expireCache)
-        d->currentCacheSize = expire();
+        d->expireCache();
 }
 
 /*!
@@ -455,80 +472,54 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
 
     When the current size of the cache is greater than the maximumCacheSize()
     older cache files are removed until the total size is less then 90% of
-    maximumCacheSize() starting with the oldest ones first using the file
-    creation date to determine how old a cache file is.
+    maximumCacheSize() starting with the ones that were least recently
+    inserted or read with data().
 
     Subclasses can reimplement this function to change the order that cache
     files are removed taking into account information in the application
     knows about that QNetworkDiskCache does not, for example the number of times
     a cache is accessed.
 
-    \note cacheSize() calls expire if the current cache size is unknown.
+    A reimplementation should remove cache files with remove(), which keeps
+    the index of the cache up to date. If it removes them otherwise, and the
+    size it returns differs from cacheSize(), QNetworkDiskCache checks which
+    of the files in its index still exist.
 
     \sa maximumCacheSize(), fileMetaData()
  */
 qint64 QNetworkDiskCache::expire()
 {
     Q_D(QNetworkDiskCache);
-    if (d->currentCacheSize >= 0 && d->currentCacheSize < maximumCacheSize())
-        return d->currentCacheSize;
-
     if (cacheDirectory().isEmpty()) {
         qWarning("QNetworkDiskCache::expire() The cache directory is not set");
         return 0;
     }
 
-    // close file handle to prevent "in use" error when QFile::remove() is called
-    d->lastItem.reset();
-
-    const QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
-    QDirIterator it(cacheDirectory(), filters, QDirIterator::Subdirectories);
-
-    struct CacheItem
-    {
-        std::chrono::milliseconds msecs;
-        QString path;
-        qint64 size = 0;
-    };
-    std::vector<CacheItem> cacheItems;
-    qint64 totalSize = 0;
-    while (it.hasNext()) {
-        QFileInfo info = it.nextFileInfo();
-        if (!info.fileName().endsWith(CACHE_POSTFIX))
-            continue;
-
-        QDateTime fileTime = info.birthTime(QTimeZone::UTC);
-        if (!fileTime.isValid())
-            fileTime = info.metadataChangeTime(QTimeZone::UTC);
-        const std::chrono::milliseconds msecs{fileTime.toMSecsSinceEpoch()};
-        const qint64 size = info.size();
-        cacheItems.push_back(CacheItem{msecs, info.filePath(), size});
-        totalSize += size;
-    }
+    if (d->indexedCacheSize < maximumCacheSize())
+        return d->indexedCacheSize;
 
     const qint64 goal = (maximumCacheSize() * 9) / 10;
-    if (totalSize < goal)
-        return totalSize; // Nothing to do
+    if (d->indexedCacheSize < goal)
+        return d->indexedCacheSize; // Nothing to do
 
-    auto byFileTime = [&](const auto &a, const auto &b) { return a.msecs < b.msecs; };
-    std::sort(cacheItems.begin(), cacheItems.end(), byFileTime);
+    // close file handle to prevent "in use" error when QFile::remove() is called
+    d->lastItem.reset();
 
     [[maybe_unused]] int removedFiles = 0; // used under QNETWORKDISKCACHE_DEBUG
-    for (const CacheItem &cached : cacheItems) {
-        QFile::remove(cached.path);
+    while (d->indexedCacheSize >= goal && !d->indexOrder.empty()) {
+        const QString fileName = d->cacheDirectory + d->indexOrder.front().key;
+        QFile::remove(fileName);
+        d->removeFromIndex(fileName);
         ++removedFiles;
-        totalSize -= cached.size;
-        if (totalSize < goal)
-            break;
     }
 #if defined(QNETWORKDISKCACHE_DEBUG)
     if (removedFiles > 0) {
         qDebug() << "QNetworkDiskCache::expire()"
                 << "Removed:" << removedFiles
-                << "Kept:" << cacheItems.count() - removedFiles;
+                << "Kept:" << d->index.size();
     }
 #endif
-    return totalSize;
+    return d->indexedCacheSize;
 }
 
 /*!
@@ -542,7 +533,7 @@ void QNetworkDiskCache::clear()
     Q_D(QNetworkDiskCache);
     qint64 size = d->maximumCacheSize;
     d->maximumCacheSize = 0;
-    d->currentCacheSize = expire();
+    d->expireCache();
     d->maximumCacheSize = size;
 }
 
@@ -680,6 +671,245 @@ bool QCacheItem::read(QFileDevice *device, bool readData)
     return metaData.isValid() && !metaData.rawHeaders().isEmpty();
 }
 
+enum
+{
+    IndexMagic = 0xe9,
+    CurrentIndexVersion = 1,
+    // the journal is compacted once it holds this many records more than
+    // twice the number of entries
+    MinimumIndexCompaction = 1024
+};
+
+static constexpr QDataStream::Version IndexStreamVersion = QDataStream::Qt_6_0;
+
+/*!
+    Returns the name of the cache file \a file relative to the cache
+    directory, which is what the index is keyed on.
+ */
+QString QNetworkDiskCachePrivate::indexKey(const QString &file) const
+{
+    if (cacheDirectory.isEmpty() || !file.startsWith(cacheDirectory))
+        return QString();
+    return file.mid(cacheDirectory.size());
+}
+
+/*!
+    Reads the index journal of the cache directory, rebuilding it from the
+    cache files if it is missing or unreadable.
+ */
+void QNetworkDiskCachePrivate::loadIndex()
+{
+    indexFile.close();
+    indexOrder.clear();
+    index.clear();
+    indexRecords = 0;
+    indexedCacheSize = 0;
+
+    indexFile.setFileName(dataDirectory + INDEX_FILE);
+    bool valid = false;
+    bool complete = false;
+    if (indexFile.open(QIODevice::ReadOnly)) {
+        QDataStream in(&indexFile);
+        in.setVersion(IndexStreamVersion);
+        qint32 marker = 0;
+        qint32 version = 0;
+        in >> marker >> version;
+        valid = in.status() == QDataStream::Ok && marker == IndexMagic
+                && version == CurrentIndexVersion;
+        complete = valid;
+        while (complete && !in.atEnd()) {
+            quint8 type = 0;
+            QString key;
+            qint64 size = 0;
+            in >> type >> key;
+            if (type == IndexInsert)
+                in >> size;
+            // a crash may have cut off the last record
+            if (in.status() != QDataStream::Ok || !key.endsWith(CACHE_POSTFIX)
+                    || key.contains(".."_L1)) {
+                complete = false;
+                break;
+            }
+
+            switch (type) {
+            case IndexInsert:
+                applyIndexInsert(key, size);
+                break;
+            case IndexAccess:
+                if (const auto it = index.constFind(key); it != index.cend())
+                    indexOrder.splice(indexOrder.end(), indexOrder, it.value());
+                break;
+            case IndexRemove:
+                applyIndexRemove(key);
+                break;
+            default:
+                complete = false;
+                break;
+            }
+            ++indexRecords;
+        }
+        indexFile.close();
+    }
+
+    if (!valid)
+        rebuildIndex();
+    if (!complete || indexRecords > 2 * index.size() + MinimumIndexCompaction) {
+        writeIndex();
+    } else if (!indexFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered)) {
+        qWarning() << "QNetworkDiskCache: couldn't open the cache index" << indexFile.fileName();
+    }
+}
+
+/*!
+    Builds the index from the cache files found in the cache directory,
+    taking the oldest ones as the least recently used.
+ */
+void QNetworkDiskCachePrivate::rebuildIndex()
+{
+    const QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
+    QDirIterator it(cacheDirectory, filters, QDirIterator::Subdirectories);
+    const QDir dir(cacheDirectory);
+
+    struct CacheItem
+    {
+        std::chrono::milliseconds msecs;
+        QString key;
+        qint64 size = 0;
+    };
+    std::vector<CacheItem> cacheItems;
+    while (it.hasNext()) {
+        QFileInfo info = it.nextFileInfo();
+        if (!info.fileName().endsWith(CACHE_POSTFIX))
+            continue;
+
+        QDateTime fileTime = info.birthTime(QTimeZone::UTC);
+        if (!fileTime.isValid())
+            fileTime = info.metadataChangeTime(QTimeZone::UTC);
+        const std::chrono::milliseconds msecs{fileTime.toMSecsSinceEpoch()};
+        cacheItems.push_back(CacheItem{msecs, dir.relativeFilePath(info.filePath()), info.size()});
+    }
+
+    auto byFileTime = [&](const auto &a, const auto &b) { return a.msecs < b.msecs; };
+    std::sort(cacheItems.begin(), cacheItems.end(), byFileTime);
+    for (const CacheItem &cached : cacheItems)
+        applyIndexInsert(cached.key, cached.size);
+}
+
+/*!
+    Replaces the index journal with one holding a single record per entry.
+ */
+void QNetworkDiskCachePrivate::writeIndex()
+{
+    indexFile.close();
+    QSaveFile file(indexFile.fileName());
+    if (file.open(QIODevice::WriteOnly)) {
+        QDataStream out(&file);
+        out.setVersion(IndexStreamVersion);
+        out << qint32(IndexMagic) << qint32(CurrentIndexVersion);
+        for (const IndexEntry &entry : indexOrder)
+            out << quint8(IndexInsert) << entry.key << entry.size;
+        if (file.commit()
+                && indexFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered)) {
+            indexRecords = index.size();
+            return;
+        }
+    }
+    // Without a journal, the index is rebuilt from the cache files next time.
+    qWarning() << "QNetworkDiskCache: couldn't write the cache index" << indexFile.fileName();
+    indexFile.remove();
+}
+
+void QNetworkDiskCachePrivate::appendIndexRecord(IndexRecord type, const QString &key, qint64 size)
+{
+    if (!indexFile.isOpen())
+        return;
+
+    QByteArray record;
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out.setVersion(IndexStreamVersion);
+    out << quint8(type) << key;
+    if (type == IndexInsert)
+        out << size;
+    // one write() per record, so that a crash can only cut off the last one
+    if (indexFile.write(record) != record.size()) {
+        qWarning() << "QNetworkDiskCache: couldn't write the cache index" << indexFile.fileName();
+        indexFile.remove();
+        return;
+    }
+    if (++indexRecords > 2 * index.size() + MinimumIndexCompaction)
+        writeIndex();
+}
+
+void QNetworkDiskCachePrivate::applyIndexInsert(const QString &key, qint64 size)
+{
+    applyIndexRemove(key);
+    indexOrder.push_back(IndexEntry{key, size});
+    index.insert(key, std::prev(indexOrder.end()));
+    indexedCacheSize += size;
+}
+
+void QNetworkDiskCachePrivate::applyIndexRemove(const QString &key)
+{
+    const auto it = index.constFind(key);
+    if (it == index.cend())
+        return;
+    indexedCacheSize -= it.value()->size;
+    indexOrder.erase(it.value());
+    index.erase(it);
+}
+
+void QNetworkDiskCachePrivate::addToIndex(const QString &file, qint64 size)
+{
+    const QString key = indexKey(file);
+    if (key.isEmpty())
+        return;
+    applyIndexInsert(key, size);
+    appendIndexRecord(IndexInsert, key, size);
+}
+
+void QNetworkDiskCachePrivate::removeFromIndex(const QString &file)
+{
+    const QString key = indexKey(file);
+    if (!index.contains(key))
+        return;
+    applyIndexRemove(key);
+    appendIndexRecord(IndexRemove, key);
+}
+
+/*!
+    Calls expire(), which may be reimplemented. If the size it returns isn't
+    the indexed one, a reimplementation removed cache files without remove(),
+    and their entries are dropped from the index.
+ */
+void QNetworkDiskCachePrivate::expireCache()
+{
+    Q_Q(QNetworkDiskCache);
+    if (q->expire() == indexedCacheSize)
+        return;
+
+    QStringList removedFiles;
+    for (const IndexEntry &entry : indexOrder) {
+        const QString file = cacheDirectory + entry.key;
+        if (!QFile::exists(file))
+            removedFiles.append(file);
+    }
+    for (const QString &file : std::as_const(removedFiles))
+        removeFromIndex(file);
+}
+
+/*!
+    Marks the cache file \a file as the most recently used one.
+ */
+void QNetworkDiskCachePrivate::touchIndex(const QString &file)
+{
+    const QString key = indexKey(file);
+    const auto it = index.constFind(key);
+    if (it == index.cend() || std::next(it.value()) == indexOrder.end())
+        return;
+    indexOrder.splice(indexOrder.end(), indexOrder, it.value());
+    appendIndexRecord(IndexAccess, key);
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qnetworkdiskcache.cpp"
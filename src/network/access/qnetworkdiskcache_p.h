@@ -19,9 +19,12 @@
 #include "private/qabstractnetworkcache_p.h"
 
 #include <qbuffer.h>
+#include <qfile.h>
 #include <qhash.h>
 #include <qsavefile.h>
 
+#include <list>
+
 QT_REQUIRE_CONFIG(networkdiskcache);
 
 QT_BEGIN_NAMESPACE
@@ -60,21 +63,55 @@ public:
     QNetworkDiskCachePrivate()
         : QAbstractNetworkCachePrivate()
         , maximumCacheSize(1024 * 1024 * 50)
-        , currentCacheSize(-1)
         {}
 
     static QString uniqueFileName(const QUrl &url);
     QString cacheFileName(const QUrl &url) const;
     bool removeFile(const QString &file);
     void storeItem(QCacheItem *item);
+    void expireCache();
     void prepareLayout();
     static quint32 crc32(const char *data, uint len);
 
+    // The index tracks the size of every cache file and the order in which
+    // they were used, least recently used first. It is kept on disk as an
+    // append-only journal, so that neither lookups nor expire() need to
+    // scan the cache directory.
+    enum IndexRecord : quint8 {
+        IndexInsert = 1,
+        IndexAccess = 2,
+        IndexRemove = 3
+    };
+    struct IndexEntry
+    {
+        QString key;            // file name relative to cacheDirectory
+        qint64 size;
+    };
+    using IndexList = std::list<IndexEntry>;
+
+    void loadIndex();
+    void rebuildIndex();
+    void writeIndex();
+    void appendIndexRecord(IndexRecord type, const QString &key, qint64 size = 0);
+    QString indexKey(const QString &file) const;
+    bool isIndexed(const QString &file) const
+        { return index.contains(indexKey(file)); }
+    void addToIndex(const QString &file, qint64 size);
+    void removeFromIndex(const QString &file);
+    void touchIndex(const QString &file);
+    void applyIndexInsert(const QString &key, qint64 size);
+    void applyIndexRemove(const QString &key);
+
     mutable QCacheItem lastItem;
     QString cacheDirectory;
     QString dataDirectory;
     qint64 maximumCacheSize;
-    qint64 currentCacheSize;
+
+    IndexList indexOrder;
+    QHash<QString, IndexList::iterator> index;
+    QFile indexFile;
+    qsizetype indexRecords = 0;
+    qint64 indexedCacheSize = 0;  // the sum of the sizes in the index
 
     QHash<QIODevice*, QCacheItem*> inserting;
     Q_DECLARE_PUBLIC(QNetworkDiskCache)
@@ -625,6 +625,9 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
         thread->setObjectName(QStringLiteral("Qt HTTP synchronous thread"));
         QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
         thread->start();
+    } else if (request.http1Configuration().sharedConnectionPoolEnabled()) {
+        // The connections are shared with all other managers, so is the thread.
+        thread = QNetworkAccessManagerPrivate::sharedHttpThread();
     } else {
         // We use the manager-global thread.
         // At some point we could switch to having multiple threads if it makes sense.
@@ -908,6 +911,12 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
             QNonContiguousByteDeviceThreadForwardImpl *forwardUploadDevice =
                     new QNonContiguousByteDeviceThreadForwardImpl(uploadByteDevice->atEnd(), uploadByteDevice->size());
             forwardUploadDevice->setParent(delegate); // needed to make sure it is moved on moveToThread()
+            qint64 fileOffset = 0;
+            const qintptr fileHandle = uploadByteDevice->fileHandle(&fileOffset);
+            if (fileHandle != -1) {
+                // the HTTP thread can send the file without us reading it
+                forwardUploadDevice->setFileHandle(fileHandle, fileOffset);
+            }
             delegate->httpRequest.setUploadByteDevice(forwardUploadDevice);
 
             // If the device in the user thread claims it has more data, keep the flow to HTTP thread going
@@ -100,6 +100,58 @@ ci.ifa_prefered = ci.ifa_valid = 0;
 }
 ")
 
+# sendmmsg
+qt_config_compile_test(sendmmsg
+    LABEL "sendmmsg() and recvmmsg()"
+    CODE
+"#include <sys/types.h>
+#include <sys/socket.h>
+
+int main(void)
+{
+    /* BEGIN TEST: */
+struct mmsghdr msgs[2] = {};
+sendmmsg(0, msgs, 2, 0);
+recvmmsg(0, msgs, 2, 0, nullptr);
+    /* END TEST: */
+    return 0;
+}
+")
+
+# sendfile
+qt_config_compile_test(sendfile
+    LABEL "sendfile()"
+    CODE
+"#include <sys/types.h>
+#include <sys/sendfile.h>
+
+int main(void)
+{
+    /* BEGIN TEST: */
+off_t offset = 0;
+sendfile(0, 0, &offset, 0);
+    /* END TEST: */
+    return 0;
+}
+")
+
+# memfd_create
+qt_config_compile_test(memfd_create
+    LABEL "memfd_create()"
+    CODE
+"#include <sys/mman.h>
+#include <fcntl.h>
+
+int main(void)
+{
+    /* BEGIN TEST: */
+int fd = memfd_create(\"qt\", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW);
+    /* END TEST: */
+    return 0;
+}
+")
+
 # res_setserver
 qt_config_compile_test(res_setservers
     LABEL "res_setservers()"
@@ -235,6 +287,14 @@ qt_feature("linux-netlink" PRIVATE
     LABEL "Linux AF_NETLINK"
     CONDITION LINUX AND NOT ANDROID AND TEST_linux_netlink
 )
+qt_feature("sendmmsg" PRIVATE
+    LABEL "sendmmsg() and recvmmsg()"
+    CONDITION UNIX AND TEST_sendmmsg
+)
+qt_feature("sendfile" PRIVATE
+    LABEL "sendfile()"
+    CONDITION LINUX AND TEST_sendfile
+)
 qt_feature("res_setservers" PRIVATE
     LABEL "res_setservers()"
     CONDITION QT_FEATURE_libresolv AND TEST_res_setservers
@@ -331,6 +391,10 @@ qt_feature("localserver" PUBLIC
     CONDITION QT_FEATURE_temporaryfile
 )
 qt_feature_definition("localserver" "QT_NO_LOCALSERVER" NEGATE VALUE "1")
+qt_feature("localsocket-sharedmemory" PRIVATE
+    LABEL "QLocalSocket shared memory transport"
+    CONDITION QT_FEATURE_localserver AND LINUX AND TEST_memfd_create
+)
 qt_feature("dnslookup" PUBLIC
     SECTION "Networking"
     LABEL "QDnsLookup"
@@ -515,6 +515,8 @@ void QAbstractSocketPrivate::resetSocketLayer()
 #endif
 
     hasPendingData = false;
+    sendFilePending = false;
+    sendFileBytesWritten = 0;
     if (socketEngine) {
         socketEngine->close();
         socketEngine->disconnect();
@@ -709,7 +711,10 @@ bool QAbstractSocketPrivate::canWriteNotification()
     qDebug("QAbstractSocketPrivate::canWriteNotification() flushing");
 #endif
 
-    return writeToSocket();
+    const bool dataWasWritten = writeToSocket();
+    if (std::exchange(sendFilePending, false))
+        emitBytesWritten(std::exchange(sendFileBytesWritten, 0));
+    return dataWasWritten;
 }
 
 /*! \internal
@@ -796,6 +801,58 @@ bool QAbstractSocketPrivate::writeToSocket()
     return written > 0;
 }
 
+/*! \internal
+
+    Writes up to \a size bytes of the file open as \a fileHandle, starting
+    at \a offset, to the socket without copying them into the write buffer.
+    Nothing is sent from the file while the write buffer is not empty.
+
+    Returns the number of bytes sent, or 0 if the socket cannot take more
+    data right now. Either way, bytesWritten() is emitted with the number of
+    bytes sent once the socket can be written to again, so that the caller
+    knows when to continue.
+
+    Returns -1 if the socket engine cannot send the file, in which case the
+    data has to be written with write() instead. If the socket failed, the
+    error is emitted and the socket is aborted.
+*/
+qint64 QAbstractSocketPrivate::sendFile(qintptr fileHandle, qint64 offset, qint64 size)
+{
+    Q_Q(QAbstractSocket);
+    if (!socketEngine || !socketEngine->isValid() || state != QAbstractSocket::ConnectedState)
+        return -1;
+
+    if (!allWriteBuffersEmpty()) {
+        // Not flushing here: bytesWritten() would be emitted while the
+        // caller is still computing what to send. writeToSocket() emits it
+        // once the buffered data is out.
+        socketEngine->setWriteNotificationEnabled(true);
+        return 0;
+    }
+
+    const qint64 written = socketEngine->sendFile(fileHandle, offset, size);
+    if (written < 0) {
+        if (socketEngine->error() == QAbstractSocket::UnsupportedSocketOperationError)
+            return -1;
+#if defined (QABSTRACTSOCKET_DEBUG)
+        qDebug() << "QAbstractSocketPrivate::sendFile() error, aborting."
+                 << socketEngine->errorString();
+#endif
+        setErrorAndEmit(socketEngine->error(), socketEngine->errorString());
+        q->abort();
+        return -1;
+    }
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::sendFile() %lld bytes sent to the network", written);
+#endif
+
+    sendFileBytesWritten += written;
+    sendFilePending = true;
+    socketEngine->setWriteNotificationEnabled(true);
+    return written;
+}
+
 /*! \internal
 
     Writes pending data in the write buffers to the socket. The function
@@ -101,6 +101,7 @@ public:
     void fetchConnectionParameters();
     bool readFromSocket();
     virtual bool writeToSocket();
+    qint64 sendFile(qintptr fileHandle, qint64 offset, qint64 size);
     void emitReadyRead(int channel = 0);
     void emitBytesWritten(qint64 bytes, int channel = 0);
 
@@ -110,6 +111,8 @@ public:
     qint64 readBufferMaxSize = 0;
     bool isBuffered = false;
     bool hasPendingData = false;
+    bool sendFilePending = false;
+    qint64 sendFileBytesWritten = 0;
 
     QTimer *connectTimer = nullptr;
 
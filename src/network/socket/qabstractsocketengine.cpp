@@ -109,6 +109,80 @@ void QAbstractSocketEngine::setError(QAbstractSocket::SocketError error, const Q
     d->socketErrorString = errorString;
 }
 
+#ifndef QT_NO_UDPSOCKET
+/*
+    Receives up to \a count datagrams. \a sizes holds the capacity of each
+    of the buffers in \a data, and is set to the size of each datagram that
+    was received. If \a headers is not null, it has room for \a count headers.
+
+    Returns the number of datagrams received, -2 if no datagram was pending,
+    or -1 if an error occurred. An error after the first datagram is reported
+    by the next call.
+
+    The default implementation reads one datagram at a time.
+*/
+qsizetype QAbstractSocketEngine::readDatagrams(char *const *data, qint64 *sizes,
+                                               QIpPacketHeader *headers, qsizetype count,
+                                               PacketHeaderOptions options)
+{
+    qsizetype received = 0;
+    while (received < count && (received == 0 || hasPendingDatagrams())) {
+        const qint64 size = readDatagram(data[received], sizes[received],
+                                         headers ? headers + received : nullptr, options);
+        if (size < 0)
+            return received ? received : qsizetype(size);
+        sizes[received++] = size;
+    }
+    return received;
+}
+
+/*
+    Sends \a count datagrams, each of \a sizes bytes at \a data, to the
+    destinations in \a headers.
+
+    Returns the number of datagrams sent, -2 if none could be sent without
+    blocking, or -1 if an error occurred. An error after the first datagram
+    is reported by the next call.
+
+    The default implementation writes one datagram at a time.
+*/
+qsizetype QAbstractSocketEngine::writeDatagrams(const char *const *data, const qint64 *sizes,
+                                                const QIpPacketHeader *const *headers,
+                                                qsizetype count)
+{
+    qsizetype sent = 0;
+    for (; sent < count; ++sent) {
+        const qint64 size = writeDatagram(data[sent], sizes[sent], *headers[sent]);
+        if (size < 0)
+            return sent ? sent : qsizetype(size);
+    }
+    return sent;
+}
+#endif // QT_NO_UDPSOCKET
+
+/*
+    Writes up to \a size bytes of the file open as \a fileHandle, starting
+    at \a offset, to the socket without copying them through user space.
+    The file position of \a fileHandle is not changed.
+
+    Returns the number of bytes written, 0 if none could be written without
+    blocking, or -1 if an error occurred. The error is
+    QAbstractSocket::UnsupportedSocketOperationError if the engine or the
+    file cannot be used this way; the caller should then write the data
+    with write().
+
+    The default implementation always fails.
+*/
+qint64 QAbstractSocketEngine::sendFile(qintptr fileHandle, qint64 offset, qint64 size)
+{
+    Q_UNUSED(fileHandle);
+    Q_UNUSED(offset);
+    Q_UNUSED(size);
+    setError(QAbstractSocket::UnsupportedSocketOperationError,
+             QAbstractSocket::tr("Operation on socket is not supported"));
+    return -1;
+}
+
 void QAbstractSocketEngine::setReceiver(QAbstractSocketEngineReceiver *receiver)
 {
     d_func()->receiver = receiver;
@@ -123,6 +123,13 @@ public:
     virtual qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader *header = nullptr,
                                 PacketHeaderOptions = WantNone) = 0;
     virtual qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &header) = 0;
+#ifndef QT_NO_UDPSOCKET
+    virtual qsizetype readDatagrams(char *const *data, qint64 *sizes, QIpPacketHeader *headers,
+                                    qsizetype count, PacketHeaderOptions = WantNone);
+    virtual qsizetype writeDatagrams(const char *const *data, const qint64 *sizes,
+                                     const QIpPacketHeader *const *headers, qsizetype count);
+#endif
+    virtual qint64 sendFile(qintptr fileHandle, qint64 offset, qint64 size);
     virtual qint64 bytesToWrite() const = 0;
 
     virtual int option(SocketOption option) const = 0;
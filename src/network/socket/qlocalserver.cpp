@@ -74,6 +74,18 @@ using namespace Qt::StringLiterals;
     The listening socket will be created in the abstract namespace. This flag is specific to Linux.
     In case of other platforms, for the sake of code portability, this flag is equivalent
     to WorldAccessOption.
+    \value [since 6.7] SharedMemoryTransportOption
+    Clients that connect with QLocalSocket::SharedMemoryTransportOption
+    exchange their data with the server through memory shared between the
+    two processes. Other clients use the socket as usual, but what the
+    server writes is held back until the client sent its first data, so
+    that the two kinds of clients can be told apart. This flag is specific
+    to Linux; on other platforms it is ignored.
+    \warning In protocols where the server speaks first, such as ones that
+    start with a greeting, a client that does not set the option sends
+    nothing and waits for the server. The server then only sends what it
+    held back after three seconds without data from the client. Only set
+    this option for protocols in which the client speaks first.
 
     \sa socketOptions
 */
@@ -267,6 +279,8 @@ void QLocalServer::incomingConnection(quintptr socketDescriptor)
 {
     Q_D(QLocalServer);
     QLocalSocket *socket = new QLocalSocket(this);
+    if (d->socketOptions.value().testFlag(SharedMemoryTransportOption))
+        socket->setSocketOptions(QLocalSocket::SharedMemoryTransportOption);
     socket->setSocketDescriptor(socketDescriptor);
     d->pendingConnections.enqueue(socket);
     emit newConnection();
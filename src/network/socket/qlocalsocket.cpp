@@ -40,6 +40,16 @@ QT_BEGIN_NAMESPACE
     \value AbstractNamespaceOption
     The socket will try to connect to an abstract address. This flag is specific
     to Linux and Android. On other platforms is ignored.
+    \value [since 6.7] SharedMemoryTransportOption
+    The data is exchanged through a ring buffer in memory shared with the
+    peer process, and the socket is only used to signal the other end. This
+    avoids copying the data through the kernel. A socket using this option
+    can only connect to servers that set
+    QLocalServer::SharedMemoryTransportOption: with other servers, the
+    connection attempt fails with ConnectionError as soon as the server
+    sends data, or is aborted when the server does not answer within 30
+    seconds. This flag is specific to Linux; on other platforms it is
+    ignored.
 
     \sa socketOptions
 */
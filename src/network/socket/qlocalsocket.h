@@ -51,7 +51,8 @@ public:
 
     enum SocketOption {
         NoOptions = 0x00,
-        AbstractNamespaceOption = 0x01
+        AbstractNamespaceOption = 0x01,
+        SharedMemoryTransportOption = 0x02
     };
     Q_DECLARE_FLAGS(SocketOptions, SocketOption)
     Q_FLAG(SocketOptions)
@@ -20,6 +20,7 @@
 #include "qlocalsocket.h"
 #include "private/qiodevice_p.h"
 
+#include <qdeadlinetimer.h>
 #include <qtimer.h>
 
 QT_REQUIRE_CONFIG(localserver);
@@ -35,6 +36,10 @@ QT_REQUIRE_CONFIG(localserver);
 #   include <qtcpsocket.h>
 #   include <qsocketnotifier.h>
 #   include <errno.h>
+#   if QT_CONFIG(localsocket_sharedmemory)
+#       include "private/qringbuffer_p.h"
+#       include "qlocalsocketsharedmemory_p.h"
+#   endif
 #endif
 
 struct sockaddr_un;
@@ -114,7 +119,9 @@ public:
     void _q_errorOccurred(QAbstractSocket::SocketError newError);
     void _q_connectToSocket();
     void _q_abortConnectionAttempt();
+    void _q_canRead();
     void cancelDelayedConnect();
+    void finishConnecting();
     void describeSocket(qintptr socketDescriptor);
     static bool parseSockaddr(const sockaddr_un &addr, uint len,
                               QString &fullServerName, QString &serverName, bool &abstractNamespace);
@@ -123,6 +130,36 @@ public:
     QString connectingName;
     int connectingSocket;
     QIODevice::OpenMode connectingOpenMode;
+#if QT_CONFIG(localsocket_sharedmemory)
+    enum class SharedMemoryState {
+        None,
+        AwaitingHello,      // server end, until the client sent a hello or other data
+        AwaitingReply,      // client end, until the server answered the hello
+        Active
+    };
+    // how long the server end waits for the hello before it sends what it
+    // held back; a plain client may wait for the server to speak first
+    enum { HelloTimeout = 3000 };
+    void receiveSharedMemoryHello();
+    void receiveSharedMemoryReply();
+    void startSharedMemoryTransport();
+    void startPlainTransport();
+    bool waitForSharedMemoryHello(QDeadlineTimer deadline);
+    void handleDoorbell();
+    void ringDoorbell();
+    qint64 writeToSharedMemory(const char *data, qint64 size);
+    bool flushSharedMemoryWrites();
+    void queueBytesWritten(qint64 bytes);
+    qint64 readFromSharedMemory(char *data, qint64 maxSize);
+    void resetSharedMemory();
+    SharedMemoryState sharedMemoryState = SharedMemoryState::None;
+    std::unique_ptr<QLocalSocketSharedMemory> sharedMemory;
+    QTimer *helloTimer = nullptr;
+    QRingBuffer pendingWrites;
+    qint64 pendingBytesWritten = 0;
+    bool bytesWrittenQueued = false;
+    bool disconnectPending = false;
+#endif
 #endif
     QLocalSocket::LocalSocketState state;
     QString serverName;
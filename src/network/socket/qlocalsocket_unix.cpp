@@ -14,6 +14,7 @@
 
 #include <qdir.h>
 #include <qdebug.h>
+#include <qdeadlinetimer.h>
 #include <qelapsedtimer.h>
 #include <qstringconverter.h>
 
@@ -66,7 +67,8 @@ void QLocalSocketPrivate::init()
     // QIODevice signals
     q->connect(&unixSocket, SIGNAL(bytesWritten(qint64)),
                q, SIGNAL(bytesWritten(qint64)));
-    q->connect(&unixSocket, SIGNAL(readyRead()), q, SIGNAL(readyRead()));
+    QObjectPrivate::connect(&unixSocket, &QIODevice::readyRead,
+                            this, &QLocalSocketPrivate::_q_canRead);
     // QAbstractSocket signals
     q->connect(&unixSocket, SIGNAL(connected()), q, SIGNAL(connected()));
     q->connect(&unixSocket, SIGNAL(disconnected()), q, SIGNAL(disconnected()));
@@ -97,6 +99,15 @@ void QLocalSocketPrivate::_q_stateChanged(QAbstractSocket::SocketState newState)
         state = QLocalSocket::UnconnectedState;
         serverName.clear();
         fullServerName.clear();
+#if QT_CONFIG(localsocket_sharedmemory)
+        // the client went away in the middle of its hello
+        if (sharedMemoryState == SharedMemoryState::AwaitingHello) {
+            helloTimer->stop();
+            sharedMemoryState = SharedMemoryState::None;
+            pendingWrites.clear();
+            disconnectPending = false;
+        }
+#endif
         break;
     case QAbstractSocket::ConnectingState:
         state = QLocalSocket::ConnectingState;
@@ -251,6 +262,13 @@ void QLocalSocketPrivate::_q_connectToSocket()
 {
     Q_Q(QLocalSocket);
 
+#if QT_CONFIG(localsocket_sharedmemory)
+    if (sharedMemoryState == SharedMemoryState::AwaitingReply) {
+        receiveSharedMemoryReply();
+        return;
+    }
+#endif
+
     QLocalSocket::SocketOptions options = optionsForPlatform(socketOptions);
     const QString connectingPathName = pathNameForConnection(connectingName, options);
     const QByteArray encodedConnectingPathName = QFile::encodeName(connectingPathName);
@@ -320,6 +338,31 @@ void QLocalSocketPrivate::_q_connectToSocket()
 
     serverName = connectingName;
     fullServerName = connectingPathName;
+#if QT_CONFIG(localsocket_sharedmemory)
+    if (socketOptions.value().testFlag(QLocalSocket::SharedMemoryTransportOption)) {
+        if (!QLocalSocketSharedMemory::sendHello(connectingSocket)) {
+            QString function = "QLocalSocket::connectToServer"_L1;
+            setErrorAndEmit(QLocalSocket::ConnectionError, function);
+            return;
+        }
+        // stay in ConnectingState until the server answered
+        sharedMemoryState = SharedMemoryState::AwaitingReply;
+        delayConnect = new QSocketNotifier(connectingSocket, QSocketNotifier::Read, q);
+        q->connect(delayConnect, SIGNAL(activated(QSocketDescriptor)), q, SLOT(_q_connectToSocket()));
+        connectTimer = new QTimer(q);
+        q->connect(connectTimer, SIGNAL(timeout()),
+                         q, SLOT(_q_abortConnectionAttempt()),
+                         Qt::DirectConnection);
+        connectTimer->start(QT_CONNECT_TIMEOUT);
+        return;
+    }
+#endif
+    finishConnecting();
+}
+
+void QLocalSocketPrivate::finishConnecting()
+{
+    Q_Q(QLocalSocket);
     if (unixSocket.setSocketDescriptor(connectingSocket,
         QAbstractSocket::ConnectedState, connectingOpenMode)) {
         q->QIODevice::open(connectingOpenMode);
@@ -333,6 +376,271 @@ void QLocalSocketPrivate::_q_connectToSocket()
     connectingOpenMode = { };
 }
 
+void QLocalSocketPrivate::_q_canRead()
+{
+    Q_Q(QLocalSocket);
+#if QT_CONFIG(localsocket_sharedmemory)
+    switch (sharedMemoryState) {
+    case SharedMemoryState::AwaitingHello:
+        receiveSharedMemoryHello();
+        return;
+    case SharedMemoryState::Active:
+        // the socket only carries doorbells now
+        unixSocket.skip(unixSocket.bytesAvailable());
+        handleDoorbell();
+        return;
+    default:
+        break;
+    }
+#endif
+    emit q->readyRead();
+}
+
+#if QT_CONFIG(localsocket_sharedmemory)
+/*!
+    \internal
+
+    Called on the client end, once the server sent something after the
+    hello. A server that does not use the shared memory transport either
+    says nothing or already talks the application's protocol; as it has
+    received the hello as application data, the connection is unusable.
+*/
+void QLocalSocketPrivate::receiveSharedMemoryReply()
+{
+    Q_Q(QLocalSocket);
+    switch (QLocalSocketSharedMemory::receiveReply(connectingSocket, &sharedMemory)) {
+    case QLocalSocketSharedMemory::ReplyStatus::Incomplete:
+        return;
+    case QLocalSocketSharedMemory::ReplyStatus::NotAReply:
+    case QLocalSocketSharedMemory::ReplyStatus::Error:
+        setErrorAndEmit(QLocalSocket::ConnectionError, "QLocalSocket::connectToServer"_L1);
+        return;
+    case QLocalSocketSharedMemory::ReplyStatus::Accepted:
+        sharedMemoryState = SharedMemoryState::Active;
+        break;
+    case QLocalSocketSharedMemory::ReplyStatus::Declined:
+        sharedMemoryState = SharedMemoryState::None;
+        break;
+    }
+
+    cancelDelayedConnect();
+    finishConnecting();
+    if (q->state() == QLocalSocket::ConnectedState
+        && sharedMemoryState == SharedMemoryState::Active) {
+        handleDoorbell();
+    }
+}
+
+/*!
+    \internal
+
+    Called on the server end for the first data sent by the client. Until
+    then, or until helloTimer expires, data written to the socket is kept in
+    pendingWrites.
+*/
+void QLocalSocketPrivate::receiveSharedMemoryHello()
+{
+    char hello[QLocalSocketSharedMemory::HandshakeSize];
+    const qint64 size = unixSocket.peek(hello, sizeof(hello));
+    if (size <= 0)
+        return;
+    if (QLocalSocketSharedMemory::isHelloPrefix(hello, size)) {
+        if (size < qint64(sizeof(hello)))
+            return;
+        helloTimer->stop();
+        unixSocket.skip(size);
+        // if this fails, the reply declines the transport
+        sharedMemory = QLocalSocketSharedMemory::create();
+        if (!QLocalSocketSharedMemory::sendReply(int(unixSocket.socketDescriptor()),
+                                                 sharedMemory.get())) {
+            setErrorAndEmit(QLocalSocket::ConnectionError, "QLocalSocket"_L1);
+            return;
+        }
+        if (sharedMemory) {
+            startSharedMemoryTransport();
+            return;
+        }
+    }
+    startPlainTransport();
+}
+
+/*!
+    \internal
+
+    Blocks on the server end until the client sent its hello, or until the
+    hello timeout expired. Returns \c false if \a deadline expired first or
+    the connection failed.
+*/
+bool QLocalSocketPrivate::waitForSharedMemoryHello(QDeadlineTimer deadline)
+{
+    if (sharedMemoryState != SharedMemoryState::AwaitingHello)
+        return true;
+    // helloTimer cannot fire while blocking
+    const QDeadlineTimer helloDeadline(helloTimer->remainingTime());
+    while (sharedMemoryState == SharedMemoryState::AwaitingHello) {
+        const bool helloFirst = helloDeadline < deadline;
+        if (unixSocket.waitForReadyRead((helloFirst ? helloDeadline : deadline).remainingTime()))
+            continue;
+        if (!helloFirst || unixSocket.state() != QAbstractSocket::ConnectedState)
+            return false;
+        startPlainTransport();
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Called on the server end when the client did not send a hello: sends
+    what was held back and passes on what the client sent.
+*/
+void QLocalSocketPrivate::startPlainTransport()
+{
+    Q_Q(QLocalSocket);
+    helloTimer->stop();
+    sharedMemoryState = SharedMemoryState::None;
+    while (!pendingWrites.isEmpty()) {
+        const qint64 blockSize = pendingWrites.nextDataBlockSize();
+        unixSocket.writeData(pendingWrites.readPointer(), blockSize);
+        pendingWrites.free(blockSize);
+    }
+    if (std::exchange(disconnectPending, false))
+        unixSocket.disconnectFromHost();
+    if (unixSocket.bytesAvailable())
+        emit q->readyRead();
+}
+
+void QLocalSocketPrivate::startSharedMemoryTransport()
+{
+    sharedMemoryState = SharedMemoryState::Active;
+    handleDoorbell();
+}
+
+/*!
+    \internal
+
+    Called whenever the peer rang the doorbell: it either made room in the
+    outgoing ring, or put data into the incoming one.
+*/
+void QLocalSocketPrivate::handleDoorbell()
+{
+    Q_Q(QLocalSocket);
+    if (!flushSharedMemoryWrites())
+        return;
+    if (sharedMemory->armReader())
+        emit q->readyRead();
+}
+
+void QLocalSocketPrivate::ringDoorbell()
+{
+    // The doorbell bypasses unixSocket, so that it never buffers anything.
+    // If the peer's socket buffer is full, it has doorbells to process anyway.
+    const char doorbell = 0;
+    qt_safe_write_nosignal(int(unixSocket.socketDescriptor()), &doorbell, 1);
+}
+
+void QLocalSocketPrivate::queueBytesWritten(qint64 bytes)
+{
+    Q_Q(QLocalSocket);
+    pendingBytesWritten += bytes;
+    if (bytesWrittenQueued)
+        return;
+    bytesWrittenQueued = true;
+    QMetaObject::invokeMethod(q, [this] {
+        bytesWrittenQueued = false;
+        if (const qint64 written = std::exchange(pendingBytesWritten, 0))
+            emit q_func()->bytesWritten(written);
+    }, Qt::QueuedConnection);
+}
+
+qint64 QLocalSocketPrivate::writeToSharedMemory(const char *data, qint64 size)
+{
+    qint64 written = 0;
+    if (pendingWrites.isEmpty()) {
+        written = sharedMemory->write(data, size);
+        if (written < 0) {
+            setErrorAndEmit(QLocalSocket::ConnectionError, "QLocalSocket::writeData"_L1);
+            return -1;
+        }
+        if (written > 0) {
+            if (sharedMemory->wakeReader())
+                ringDoorbell();
+            queueBytesWritten(written);
+        }
+    }
+    if (written < size) {
+        pendingWrites.append(data + written, size - written);
+        if (!flushSharedMemoryWrites())
+            return -1;
+    }
+    return size;
+}
+
+/*!
+    \internal
+
+    Moves as much of pendingWrites as possible into the outgoing ring. If
+    the ring is full, the reader is asked to ring the doorbell once it made
+    room. Returns \c false if the shared memory turned out to be unusable.
+*/
+bool QLocalSocketPrivate::flushSharedMemoryWrites()
+{
+    qint64 written = 0;
+    for (;;) {
+        while (!pendingWrites.isEmpty()) {
+            const qint64 blockWritten = sharedMemory->write(pendingWrites.readPointer(),
+                                                            pendingWrites.nextDataBlockSize());
+            if (blockWritten <= 0)
+                break;
+            pendingWrites.free(blockWritten);
+            written += blockWritten;
+        }
+        if (pendingWrites.isEmpty() || sharedMemory->hasError() || !sharedMemory->armWriter())
+            break;
+    }
+    if (sharedMemory->hasError()) {
+        setErrorAndEmit(QLocalSocket::ConnectionError, "QLocalSocket::flush"_L1);
+        return false;
+    }
+
+    if (written) {
+        if (sharedMemory->wakeReader())
+            ringDoorbell();
+        queueBytesWritten(written);
+    }
+    if (pendingWrites.isEmpty() && std::exchange(disconnectPending, false))
+        unixSocket.disconnectFromHost();
+    return true;
+}
+
+qint64 QLocalSocketPrivate::readFromSharedMemory(char *data, qint64 maxSize)
+{
+    const qint64 readBytes = sharedMemory->read(data, maxSize);
+    if (readBytes < 0) {
+        setErrorAndEmit(QLocalSocket::ConnectionError, "QLocalSocket::readData"_L1);
+        return -1;
+    }
+    if (readBytes > 0) {
+        if (sharedMemory->wakeWriter())
+            ringDoorbell();
+        return readBytes;
+    }
+    // like QAbstractSocket, report EOF once the peer is gone
+    if (maxSize && unixSocket.state() != QAbstractSocket::ConnectedState)
+        return -1;
+    return 0;
+}
+
+void QLocalSocketPrivate::resetSharedMemory()
+{
+    sharedMemoryState = SharedMemoryState::None;
+    sharedMemory.reset();
+    pendingWrites.clear();
+    pendingBytesWritten = 0;
+    disconnectPending = false;
+}
+#endif // QT_CONFIG(localsocket_sharedmemory)
+
 bool QLocalSocket::setSocketDescriptor(qintptr socketDescriptor,
         LocalSocketState socketState, OpenMode openMode)
 {
@@ -355,6 +663,22 @@ bool QLocalSocket::setSocketDescriptor(qintptr socketDescriptor,
     QIODevice::open(openMode);
     d->state = socketState;
     d->describeSocket(socketDescriptor);
+#if QT_CONFIG(localsocket_sharedmemory)
+    // this is the server end; the client may send a hello first
+    if (d->socketOptions.value().testFlag(SharedMemoryTransportOption)
+        && socketState == ConnectedState) {
+        d->sharedMemoryState = QLocalSocketPrivate::SharedMemoryState::AwaitingHello;
+        if (!d->helloTimer) {
+            d->helloTimer = new QTimer(this);
+            d->helloTimer->setSingleShot(true);
+            connect(d->helloTimer, &QTimer::timeout, this, [d] {
+                if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::AwaitingHello)
+                    d->startPlainTransport();
+            });
+        }
+        d->helloTimer->start(QLocalSocketPrivate::HelloTimeout);
+    }
+#endif
     return d->unixSocket.setSocketDescriptor(socketDescriptor,
                                              newSocketState, openMode);
 }
@@ -444,6 +768,12 @@ qintptr QLocalSocket::socketDescriptor() const
 qint64 QLocalSocket::readData(char *data, qint64 c)
 {
     Q_D(QLocalSocket);
+#if QT_CONFIG(localsocket_sharedmemory)
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::Active)
+        return d->readFromSharedMemory(data, c);
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::AwaitingHello)
+        return 0;
+#endif
     return d->unixSocket.read(data, c);
 }
 
@@ -452,6 +782,16 @@ qint64 QLocalSocket::readLineData(char *data, qint64 maxSize)
     if (!maxSize)
         return 0;
 
+#if QT_CONFIG(localsocket_sharedmemory)
+    Q_D(QLocalSocket);
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::Active) {
+        const qint64 newline = d->sharedMemory->indexOf('\n', maxSize);
+        return d->readFromSharedMemory(data, newline == -1 ? maxSize : newline + 1);
+    }
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::AwaitingHello)
+        return 0;
+#endif
+
     // QIODevice::readLine() reserves space for the trailing '\0' byte,
     // so we must read 'maxSize + 1' bytes.
     return d_func()->unixSocket.readLine(data, maxSize + 1);
@@ -459,12 +799,30 @@ qint64 QLocalSocket::readLineData(char *data, qint64 maxSize)
 
 qint64 QLocalSocket::skipData(qint64 maxSize)
 {
+#if QT_CONFIG(localsocket_sharedmemory)
+    Q_D(QLocalSocket);
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::Active)
+        return d->readFromSharedMemory(nullptr, maxSize);
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::AwaitingHello)
+        return 0;
+#endif
     return d_func()->unixSocket.skip(maxSize);
 }
 
 qint64 QLocalSocket::writeData(const char *data, qint64 c)
 {
     Q_D(QLocalSocket);
+#if QT_CONFIG(localsocket_sharedmemory)
+    switch (d->sharedMemoryState) {
+    case QLocalSocketPrivate::SharedMemoryState::AwaitingHello:
+        d->pendingWrites.append(data, c);
+        return c;
+    case QLocalSocketPrivate::SharedMemoryState::Active:
+        return d->writeToSharedMemory(data, c);
+    default:
+        break;
+    }
+#endif
     return d->unixSocket.writeData(data, c);
 }
 
@@ -478,18 +836,37 @@ void QLocalSocket::abort()
 qint64 QLocalSocket::bytesAvailable() const
 {
     Q_D(const QLocalSocket);
+#if QT_CONFIG(localsocket_sharedmemory)
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::Active)
+        return QIODevice::bytesAvailable() + d->sharedMemory->bytesAvailable();
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::AwaitingHello)
+        return QIODevice::bytesAvailable();
+#endif
     return QIODevice::bytesAvailable() + d->unixSocket.bytesAvailable();
 }
 
 qint64 QLocalSocket::bytesToWrite() const
 {
     Q_D(const QLocalSocket);
+#if QT_CONFIG(localsocket_sharedmemory)
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::Active
+        || d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::AwaitingHello) {
+        return d->pendingWrites.size();
+    }
+#endif
     return d->unixSocket.bytesToWrite();
 }
 
 bool QLocalSocket::canReadLine() const
 {
     Q_D(const QLocalSocket);
+#if QT_CONFIG(localsocket_sharedmemory)
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::Active)
+        return QIODevice::canReadLine()
+               || d->sharedMemory->indexOf('\n', d->sharedMemory->bytesAvailable()) != -1;
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::AwaitingHello)
+        return QIODevice::canReadLine();
+#endif
     return QIODevice::canReadLine() || d->unixSocket.canReadLine();
 }
 
@@ -507,23 +884,61 @@ void QLocalSocket::close()
     d->connectingOpenMode = { };
     d->serverName.clear();
     d->fullServerName.clear();
+#if QT_CONFIG(localsocket_sharedmemory)
+    d->resetSharedMemory();
+#endif
 }
 
 bool QLocalSocket::waitForBytesWritten(int msecs)
 {
     Q_D(QLocalSocket);
+#if QT_CONFIG(localsocket_sharedmemory)
+    using SharedMemoryState = QLocalSocketPrivate::SharedMemoryState;
+    QDeadlineTimer deadline(msecs);
+    if (!d->waitForSharedMemoryHello(deadline))
+        return false;
+    if (d->sharedMemoryState == SharedMemoryState::Active) {
+        if (!d->pendingBytesWritten && d->pendingWrites.isEmpty())
+            return false;
+        // doorbells from the reader flush pendingWrites
+        while (!d->pendingBytesWritten) {
+            if (!d->unixSocket.waitForReadyRead(deadline.remainingTime())
+                || d->sharedMemoryState != SharedMemoryState::Active) {
+                return false;
+            }
+        }
+        emit bytesWritten(std::exchange(d->pendingBytesWritten, 0));
+        return true;
+    }
+    return d->unixSocket.waitForBytesWritten(deadline.remainingTime());
+#else
     return d->unixSocket.waitForBytesWritten(msecs);
+#endif
 }
 
 bool QLocalSocket::flush()
 {
     Q_D(QLocalSocket);
+#if QT_CONFIG(localsocket_sharedmemory)
+    if (d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::Active) {
+        const qint64 pending = d->pendingWrites.size();
+        return pending && d->flushSharedMemoryWrites() && d->pendingWrites.size() < pending;
+    }
+#endif
     return d->unixSocket.flush();
 }
 
 void QLocalSocket::disconnectFromServer()
 {
     Q_D(QLocalSocket);
+#if QT_CONFIG(localsocket_sharedmemory)
+    // disconnect once the data held back so far went out
+    if (d->sharedMemoryState != QLocalSocketPrivate::SharedMemoryState::None
+        && !d->pendingWrites.isEmpty()) {
+        d->disconnectPending = true;
+        return;
+    }
+#endif
     d->unixSocket.disconnectFromHost();
 }
 
@@ -619,7 +1034,30 @@ bool QLocalSocket::waitForReadyRead(int msecs)
     Q_D(QLocalSocket);
     if (state() == QLocalSocket::UnconnectedState)
         return false;
+#if QT_CONFIG(localsocket_sharedmemory)
+    using SharedMemoryState = QLocalSocketPrivate::SharedMemoryState;
+    QDeadlineTimer deadline(msecs);
+    if (!d->waitForSharedMemoryHello(deadline))
+        return false;
+    if (d->sharedMemoryState == SharedMemoryState::Active) {
+        // data may have arrived without a doorbell
+        if (d->sharedMemory->armReader()) {
+            emit readyRead();
+            return true;
+        }
+        // the doorbell handling emits readyRead()
+        const qint64 available = d->sharedMemory->bytesAvailable();
+        do {
+            if (!d->unixSocket.waitForReadyRead(deadline.remainingTime()))
+                return false;
+        } while (d->sharedMemoryState == SharedMemoryState::Active
+                 && d->sharedMemory->bytesAvailable() <= available);
+        return d->sharedMemoryState == SharedMemoryState::Active;
+    }
+    return d->unixSocket.waitForReadyRead(deadline.remainingTime());
+#else
     return (d->unixSocket.waitForReadyRead(msecs));
+#endif
 }
 
 QT_END_NAMESPACE
@@ -0,0 +1,368 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qlocalsocketsharedmemory_p.h"
+#include "qnet_unix_p.h"
+
+#include "qplatformdefs.h"
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+
+#include <atomic>
+#include <new>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    The mapping starts with a copy of the handshake reply, followed by the
+    control block of the client-to-server ring, the control block of the
+    server-to-client ring and the data of the two rings, in the same order.
+
+    head and tail are free-running counters, the offset into the data is taken
+    modulo the (power of two) capacity. Only the producer stores head and only
+    the consumer stores tail.
+
+    readerWaiting and writerWaiting implement the wake-ups: a side that wants
+    to be woken sets the flag and then re-checks the ring, the other side
+    updates the ring and then clears the flag, sending a single doorbell byte
+    over the socket if it was set. Both use read-modify-write operations on
+    the flag, so one of the two always sees the other's update.
+*/
+
+static_assert(std::atomic<quint32>::is_always_lock_free);
+
+namespace {
+constexpr char HelloMagic[8] = { '\x7f', 'Q', 't', 'L', 'S', 'H', 'M', '?' };
+constexpr char ReplyMagic[8] = { '\x7f', 'Q', 't', 'L', 'S', 'H', 'M', '!' };
+constexpr quint32 MaximumCapacity = 256 * 1024 * 1024;
+
+struct Handshake
+{
+    char magic[8];
+    quint32 version;
+    quint32 capacity;       // 0 if the transport was declined
+};
+static_assert(sizeof(Handshake) == QLocalSocketSharedMemory::HandshakeSize);
+}
+
+struct QLocalSocketSharedMemory::Ring
+{
+    alignas(64) std::atomic<quint32> head;
+    alignas(64) std::atomic<quint32> tail;
+    alignas(64) std::atomic<quint32> readerWaiting;
+    std::atomic<quint32> writerWaiting;
+};
+
+static constexpr size_t ringsOffset = 64;
+static_assert(sizeof(Handshake) <= ringsOffset);
+
+static constexpr size_t dataOffset()
+{
+    return ringsOffset + 2 * sizeof(QLocalSocketSharedMemory::Ring);
+}
+
+static constexpr size_t mappingSize(quint32 capacity)
+{
+    return dataOffset() + 2 * size_t(capacity);
+}
+
+static bool isValidCapacity(quint32 capacity)
+{
+    return capacity && capacity <= MaximumCapacity && !(capacity & (capacity - 1));
+}
+
+QLocalSocketSharedMemory::QLocalSocketSharedMemory(int fd, void *mapping, quint32 capacity,
+                                                   bool creator)
+    : mapping(mapping), fd(fd), ringCapacity(capacity)
+{
+    char *base = static_cast<char *>(mapping);
+    Ring *rings = reinterpret_cast<Ring *>(base + ringsOffset);
+    char *data = base + dataOffset();
+    // the creator is the server end of the connection
+    in = creator ? &rings[0] : &rings[1];
+    out = creator ? &rings[1] : &rings[0];
+    inData = creator ? data : data + capacity;
+    outData = creator ? data + capacity : data;
+}
+
+QLocalSocketSharedMemory::~QLocalSocketSharedMemory()
+{
+    ::munmap(mapping, mappingSize(ringCapacity));
+    qt_safe_close(fd);
+}
+
+std::unique_ptr<QLocalSocketSharedMemory> QLocalSocketSharedMemory::create(quint32 capacity)
+{
+    Q_ASSERT(isValidCapacity(capacity));
+    const size_t size = mappingSize(capacity);
+
+    const int fd = ::memfd_create("QLocalSocket", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd == -1)
+        return nullptr;
+    // the peer must not be able to shrink the file under our mapping
+    if (QT_FTRUNCATE(fd, QT_OFF_T(size)) == -1
+        || ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == -1) {
+        qt_safe_close(fd);
+        return nullptr;
+    }
+    void *mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        qt_safe_close(fd);
+        return nullptr;
+    }
+
+    // the file is zero-filled, which is the initial state of the rings
+    Handshake *header = static_cast<Handshake *>(mapping);
+    memcpy(header->magic, ReplyMagic, sizeof(header->magic));
+    header->version = Version;
+    header->capacity = capacity;
+    Ring *rings = reinterpret_cast<Ring *>(static_cast<char *>(mapping) + ringsOffset);
+    new (&rings[0]) Ring{};
+    new (&rings[1]) Ring{};
+
+    return std::unique_ptr<QLocalSocketSharedMemory>(
+                new QLocalSocketSharedMemory(fd, mapping, capacity, true));
+}
+
+std::unique_ptr<QLocalSocketSharedMemory> QLocalSocketSharedMemory::attach(int fd, quint32 capacity)
+{
+    const auto fail = [fd] {
+        qt_safe_close(fd);
+        return nullptr;
+    };
+    if (!isValidCapacity(capacity))
+        return fail();
+
+    // refuse files that could be truncated while mapped
+    const size_t size = mappingSize(capacity);
+    QT_STATBUF st;
+    const int seals = ::fcntl(fd, F_GET_SEALS);
+    if (QT_FSTAT(fd, &st) == -1 || !S_ISREG(st.st_mode) || size_t(st.st_size) != size
+        || seals == -1 || !(seals & F_SEAL_SHRINK)) {
+        return fail();
+    }
+
+    void *mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+        return fail();
+    const Handshake *header = static_cast<const Handshake *>(mapping);
+    if (memcmp(header->magic, ReplyMagic, sizeof(header->magic)) != 0
+        || header->version != Version || header->capacity != capacity) {
+        ::munmap(mapping, size);
+        return fail();
+    }
+
+    return std::unique_ptr<QLocalSocketSharedMemory>(
+                new QLocalSocketSharedMemory(fd, mapping, capacity, false));
+}
+
+static bool sendHandshake(int socket, const char (&magic)[8], quint32 capacity, int fd)
+{
+    Handshake message;
+    memcpy(message.magic, magic, sizeof(message.magic));
+    message.version = QLocalSocketSharedMemory::Version;
+    message.capacity = capacity;
+
+    iovec vec;
+    vec.iov_base = &message;
+    vec.iov_len = sizeof(message);
+
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &vec;
+    msg.msg_iovlen = 1;
+
+    union {
+        cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+    if (fd != -1) {
+        memset(&control, 0, sizeof(control));
+        msg.msg_control = control.buffer;
+        msg.msg_controllen = sizeof(control.buffer);
+        cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    }
+
+    // the socket is still empty, so the whole message fits into its buffer
+    return qt_safe_sendmsg(socket, &msg, 0) == int(sizeof(message));
+}
+
+bool QLocalSocketSharedMemory::sendHello(int socket)
+{
+    return sendHandshake(socket, HelloMagic, DefaultCapacity, -1);
+}
+
+bool QLocalSocketSharedMemory::isHelloPrefix(const char *data, qsizetype size)
+{
+    return memcmp(data, HelloMagic, qMin(size, qsizetype(sizeof(HelloMagic)))) == 0;
+}
+
+bool QLocalSocketSharedMemory::sendReply(int socket, const QLocalSocketSharedMemory *memory)
+{
+    if (!memory)
+        return sendHandshake(socket, ReplyMagic, 0, -1);
+    return sendHandshake(socket, ReplyMagic, memory->capacity(), memory->fileDescriptor());
+}
+
+QLocalSocketSharedMemory::ReplyStatus
+QLocalSocketSharedMemory::receiveReply(int socket, std::unique_ptr<QLocalSocketSharedMemory> *memory)
+{
+    Handshake message;
+    qint64 peeked;
+    EINTR_LOOP(peeked, ::recv(socket, &message, sizeof(message), MSG_PEEK));
+    if (peeked == -1)
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? ReplyStatus::Incomplete
+                                                         : ReplyStatus::Error;
+    // a server that does not know about the transport may start talking first
+    if (memcmp(&message, ReplyMagic, qMin(size_t(peeked), sizeof(ReplyMagic))) != 0)
+        return ReplyStatus::NotAReply;
+    if (peeked < qint64(sizeof(message)))
+        return peeked ? ReplyStatus::Incomplete : ReplyStatus::Error;
+
+    iovec vec;
+    vec.iov_base = &message;
+    vec.iov_len = sizeof(message);
+
+    union {
+        cmsghdr header;
+        char buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &vec;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    if (qt_safe_recvmsg(socket, &msg, MSG_CMSG_CLOEXEC) != int(sizeof(message)))
+        return ReplyStatus::Error;
+
+    int fd = -1;
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS
+            && cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
+            memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+        }
+    }
+
+    if (message.capacity == 0) {
+        if (fd != -1)
+            qt_safe_close(fd);
+        return ReplyStatus::Declined;
+    }
+    if (fd == -1 || message.version != Version || (msg.msg_flags & MSG_CTRUNC)) {
+        if (fd != -1)
+            qt_safe_close(fd);
+        return ReplyStatus::Error;
+    }
+
+    *memory = attach(fd, message.capacity);
+    return *memory ? ReplyStatus::Accepted : ReplyStatus::Error;
+}
+
+qint64 QLocalSocketSharedMemory::bytesAvailable() const
+{
+    const quint32 available = in->head.load(std::memory_order_acquire)
+            - in->tail.load(std::memory_order_relaxed);
+    if (available > ringCapacity) {
+        error = true;
+        return 0;
+    }
+    return available;
+}
+
+qint64 QLocalSocketSharedMemory::indexOf(char c, qint64 maxLength) const
+{
+    const quint32 tail = in->tail.load(std::memory_order_relaxed);
+    const qint64 length = qMin(bytesAvailable(), maxLength);
+    const quint32 offset = tail & (ringCapacity - 1);
+    const qint64 first = qMin(length, qint64(ringCapacity - offset));
+
+    if (const void *p = memchr(inData + offset, c, size_t(first)))
+        return static_cast<const char *>(p) - (inData + offset);
+    if (const void *p = memchr(inData, c, size_t(length - first)))
+        return first + (static_cast<const char *>(p) - inData);
+    return -1;
+}
+
+qint64 QLocalSocketSharedMemory::read(char *data, qint64 maxSize)
+{
+    const quint32 tail = in->tail.load(std::memory_order_relaxed);
+    const quint32 length = quint32(qMin(bytesAvailable(), maxSize));
+    if (error)
+        return -1;
+
+    if (data) {
+        const quint32 offset = tail & (ringCapacity - 1);
+        const quint32 first = qMin(length, ringCapacity - offset);
+        memcpy(data, inData + offset, first);
+        memcpy(data + first, inData, length - first);
+    }
+    in->tail.store(tail + length, std::memory_order_release);
+    return length;
+}
+
+qint64 QLocalSocketSharedMemory::bytesFree() const
+{
+    const quint32 used = out->head.load(std::memory_order_relaxed)
+            - out->tail.load(std::memory_order_acquire);
+    if (used > ringCapacity) {
+        error = true;
+        return 0;
+    }
+    return ringCapacity - used;
+}
+
+qint64 QLocalSocketSharedMemory::write(const char *data, qint64 size)
+{
+    const quint32 head = out->head.load(std::memory_order_relaxed);
+    const quint32 length = quint32(qMin(bytesFree(), size));
+    if (error)
+        return -1;
+
+    const quint32 offset = head & (ringCapacity - 1);
+    const quint32 first = qMin(length, ringCapacity - offset);
+    memcpy(outData + offset, data, first);
+    memcpy(outData, data + first, length - first);
+    out->head.store(head + length, std::memory_order_release);
+    return length;
+}
+
+bool QLocalSocketSharedMemory::wakeReader()
+{
+    return out->readerWaiting.exchange(0) != 0;
+}
+
+bool QLocalSocketSharedMemory::wakeWriter()
+{
+    return in->writerWaiting.exchange(0) != 0;
+}
+
+bool QLocalSocketSharedMemory::armReader()
+{
+    in->readerWaiting.exchange(1);
+    const quint32 head = in->head.load(std::memory_order_acquire);
+    if (head == notifiedHead)
+        return false;
+    notifiedHead = head;
+    return true;
+}
+
+bool QLocalSocketSharedMemory::armWriter()
+{
+    out->writerWaiting.exchange(1);
+    return bytesFree() > 0;
+}
+
+QT_END_NAMESPACE
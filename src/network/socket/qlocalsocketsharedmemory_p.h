@@ -0,0 +1,95 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QLOCALSOCKETSHAREDMEMORY_P_H
+#define QLOCALSOCKETSHAREDMEMORY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the QLocalSocket class.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+
+#include <memory>
+
+QT_REQUIRE_CONFIG(localsocket_sharedmemory);
+
+QT_BEGIN_NAMESPACE
+
+// A pair of single-producer, single-consumer byte rings in a sealed memfd
+// mapping, shared by the two ends of a QLocalSocket connection. The socket
+// itself is only used to pass the memfd and to wake up the peer.
+class QLocalSocketSharedMemory
+{
+    Q_DISABLE_COPY_MOVE(QLocalSocketSharedMemory)
+public:
+    enum : quint32 {
+        Version = 1,
+        DefaultCapacity = 4 * 1024 * 1024,
+        HandshakeSize = 16
+    };
+
+    struct Ring;
+
+    ~QLocalSocketSharedMemory();
+
+    static std::unique_ptr<QLocalSocketSharedMemory> create(quint32 capacity = DefaultCapacity);
+    static std::unique_ptr<QLocalSocketSharedMemory> attach(int fd, quint32 capacity);
+
+    // The handshake: the client sends a hello, the server answers with a
+    // reply carrying the memfd, or with a reply that declines the transport.
+    enum class ReplyStatus {
+        Incomplete,
+        NotAReply,
+        Declined,
+        Accepted,
+        Error
+    };
+    static bool sendHello(int socket);
+    static bool isHelloPrefix(const char *data, qsizetype size);
+    static bool sendReply(int socket, const QLocalSocketSharedMemory *memory);
+    static ReplyStatus receiveReply(int socket, std::unique_ptr<QLocalSocketSharedMemory> *memory);
+
+    int fileDescriptor() const { return fd; }
+    quint32 capacity() const { return ringCapacity; }
+    bool hasError() const { return error; }
+
+    qint64 bytesAvailable() const;
+    qint64 indexOf(char c, qint64 maxLength) const;
+    qint64 read(char *data, qint64 maxSize);
+    qint64 bytesFree() const;
+    qint64 write(const char *data, qint64 size);
+
+    // Each returns whether the peer has to be woken up over the socket.
+    bool wakeReader();
+    bool wakeWriter();
+
+    // Returns whether new data arrived since the last call.
+    bool armReader();
+    // Returns whether there is room for writing.
+    bool armWriter();
+
+private:
+    QLocalSocketSharedMemory(int fd, void *mapping, quint32 capacity, bool creator);
+
+    void *mapping;
+    Ring *in;
+    Ring *out;
+    char *inData;
+    char *outData;
+    int fd;
+    quint32 ringCapacity;
+    quint32 notifiedHead = 0;
+    mutable bool error = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QLOCALSOCKETSHAREDMEMORY_P_H
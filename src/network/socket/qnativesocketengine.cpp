@@ -866,6 +866,54 @@ qint64 QNativeSocketEngine::writeDatagram(const char *data, qint64 size, const Q
     return d->nativeSendDatagram(data, size, header);
 }
 
+#ifndef QT_NO_UDPSOCKET
+/*!
+    Receives up to \a count datagrams with as few system calls as the
+    platform allows. See QAbstractSocketEngine::readDatagrams().
+
+    \sa readDatagram()
+*/
+qsizetype QNativeSocketEngine::readDatagrams(char *const *data, qint64 *sizes,
+                                             QIpPacketHeader *headers, qsizetype count,
+                                             PacketHeaderOptions options)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::readDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#if QT_CONFIG(sendmmsg)
+    return d->nativeReceiveDatagrams(data, sizes, headers, count, options);
+#else
+    return QAbstractSocketEngine::readDatagrams(data, sizes, headers, count, options);
+#endif
+}
+
+/*!
+    Sends \a count datagrams with as few system calls as the platform
+    allows. On Linux, consecutive datagrams of the same size for the same
+    destination are passed to the kernel as one buffer, if the network path
+    supports UDP segmentation offload. See QAbstractSocketEngine::writeDatagrams().
+
+    \sa writeDatagram()
+*/
+qsizetype QNativeSocketEngine::writeDatagrams(const char *const *data, const qint64 *sizes,
+                                              const QIpPacketHeader *const *headers,
+                                              qsizetype count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#if QT_CONFIG(sendmmsg)
+    return d->nativeSendDatagrams(data, sizes, headers, count);
+#else
+    return QAbstractSocketEngine::writeDatagrams(data, sizes, headers, count);
+#endif
+}
+#endif // QT_NO_UDPSOCKET
+
 /*!
     Writes a block of \a size bytes from \a data to the socket.
     Returns the number of bytes written, or -1 if an error occurred.
@@ -882,6 +930,29 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
     return d->nativeWrite(data, size);
 }
 
+/*!
+    Writes up to \a size bytes of the file open as \a fileHandle, starting
+    at \a offset, to the socket with sendfile(), so that the data does not
+    have to be copied through user space. Returns the number of bytes
+    written, 0 if the socket buffer is full, or -1 if an error occurred.
+    See QAbstractSocketEngine::sendFile().
+
+    \sa write()
+*/
+qint64 QNativeSocketEngine::sendFile(qintptr fileHandle, qint64 offset, qint64 size)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::sendFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::sendFile(), QAbstractSocket::ConnectedState, -1);
+    Q_CHECK_TYPE(QNativeSocketEngine::sendFile(), QAbstractSocket::TcpSocket, -1);
+
+#if QT_CONFIG(sendfile)
+    return d->nativeSendFile(fileHandle, offset, size);
+#else
+    return QAbstractSocketEngine::sendFile(fileHandle, offset, size);
+#endif
+}
+
 
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
@@ -141,6 +141,13 @@ public:
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = nullptr,
                         PacketHeaderOptions = WantNone) override;
     qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &) override;
+#ifndef QT_NO_UDPSOCKET
+    qsizetype readDatagrams(char *const *data, qint64 *sizes, QIpPacketHeader *headers,
+                            qsizetype count, PacketHeaderOptions = WantNone) override;
+    qsizetype writeDatagrams(const char *const *data, const qint64 *sizes,
+                             const QIpPacketHeader *const *headers, qsizetype count) override;
+#endif
+    qint64 sendFile(qintptr fileHandle, qint64 offset, qint64 size) override;
     qint64 bytesToWrite() const override;
 
 #if 0   // currently unused
@@ -144,8 +144,19 @@ public:
     qint64 nativeReceiveDatagram(char *data, qint64 maxLength, QIpPacketHeader *header,
                                  QAbstractSocketEngine::PacketHeaderOptions options);
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
+#if QT_CONFIG(sendmmsg)
+    qsizetype nativeReceiveDatagrams(char *const *data, qint64 *sizes, QIpPacketHeader *headers,
+                                     qsizetype count,
+                                     QAbstractSocketEngine::PacketHeaderOptions options);
+    qsizetype nativeSendDatagrams(const char *const *data, const qint64 *sizes,
+                                  const QIpPacketHeader *const *headers, qsizetype count);
+    bool udpGsoUnsupported = false;
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+#if QT_CONFIG(sendfile)
+    qint64 nativeSendFile(qintptr fileHandle, qint64 offset, qint64 size);
+#endif
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
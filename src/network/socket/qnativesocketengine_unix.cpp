@@ -39,6 +39,9 @@
 #endif
 
 #include <netinet/tcp.h>
+#if QT_CONFIG(sendmmsg) && defined(Q_OS_LINUX)
+#include <netinet/udp.h>
+#endif
 #ifndef QT_NO_SCTP
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -876,18 +879,92 @@ qint64 QNativeSocketEnginePrivate::nativePendingDatagramSize() const
     return qint64(recvResult);
 }
 
-qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
-                                                         QAbstractSocketEngine::PacketHeaderOptions options)
-{
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+// we use quintptr to force the alignment
+using ReceiveControlBuffer = quintptr[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
 #if !defined(IP_PKTINFO) && defined(IP_RECVIF) && defined(Q_OS_BSD4)
-                   + CMSG_SPACE(sizeof(sockaddr_dl))
+                                       + CMSG_SPACE(sizeof(sockaddr_dl))
 #endif
 #ifndef QT_NO_SCTP
-                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
+                                       + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
 #endif
-                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
+                                       + sizeof(quintptr) - 1) / sizeof(quintptr)];
+
+/*
+    Fills \a header from the sender address \a aa and the ancillary data
+    of the message \a msg received on a socket bound to \a localPort.
+*/
+static void qt_socket_fillPacketHeader(msghdr &msg, const qt_sockaddr &aa, quint16 localPort,
+                                       QIpPacketHeader *header)
+{
+    qt_socket_getPortAndAddress(&aa, &header->senderPort, &header->senderAddress);
+    header->destinationPort = localPort;
+    header->endOfRecord = (msg.msg_flags & MSG_EOR) != 0;
+
+    // parse the ancillary data
+    struct cmsghdr *cmsgptr;
+    QT_WARNING_PUSH
+    QT_WARNING_DISABLE_CLANG("-Wsign-compare")
+    for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != nullptr;
+         cmsgptr = CMSG_NXTHDR(&msg, cmsgptr)) {
+        QT_WARNING_POP
+        if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
+            in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
+            header->ifindex = info->ipi6_ifindex;
+            if (header->ifindex)
+                header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
+        }
+
+#ifdef IP_PKTINFO
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
+            in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
+            header->ifindex = info->ipi_ifindex;
+        }
+#else
+#  ifdef IP_RECVDSTADDR
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
+            in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(ntohl(addr->s_addr));
+        }
+#  endif
+#  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
+            sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
+            header->ifindex = sdl->sdl_index;
+        }
+#  endif
+#endif
+
+        if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
+                && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
+                    || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
+            static_assert(sizeof(header->hopLimit) == sizeof(int));
+            memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
+        }
+
+#ifndef QT_NO_SCTP
+        if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
+            && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
+            sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
+
+            header->streamNumber = int(rcvInfo->sinfo_stream);
+        }
+#endif
+    }
+}
+
+qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
+                                                         QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    ReceiveControlBuffer cbuf;
 
     struct msghdr msg;
     struct iovec vec;
@@ -935,69 +1012,7 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
             header->clear();
     } else if (options != QAbstractSocketEngine::WantNone) {
         Q_ASSERT(header);
-        qt_socket_getPortAndAddress(&aa, &header->senderPort, &header->senderAddress);
-        header->destinationPort = localPort;
-        header->endOfRecord = (msg.msg_flags & MSG_EOR) != 0;
-
-        // parse the ancillary data
-        struct cmsghdr *cmsgptr;
-        QT_WARNING_PUSH
-        QT_WARNING_DISABLE_CLANG("-Wsign-compare")
-        for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != nullptr;
-             cmsgptr = CMSG_NXTHDR(&msg, cmsgptr)) {
-            QT_WARNING_POP
-            if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
-                in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
-                header->ifindex = info->ipi6_ifindex;
-                if (header->ifindex)
-                    header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
-            }
-
-#ifdef IP_PKTINFO
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
-                in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
-                header->ifindex = info->ipi_ifindex;
-            }
-#else
-#  ifdef IP_RECVDSTADDR
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
-                in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(ntohl(addr->s_addr));
-            }
-#  endif
-#  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
-                sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
-                header->ifindex = sdl->sdl_index;
-            }
-#  endif
-#endif
-
-            if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
-                    && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
-                        || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
-                static_assert(sizeof(header->hopLimit) == sizeof(int));
-                memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
-            }
-
-#ifndef QT_NO_SCTP
-            if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
-                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
-                sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
-
-                header->streamNumber = int(rcvInfo->sinfo_stream);
-            }
-#endif
-        }
+        qt_socket_fillPacketHeader(msg, aa, localPort, header);
     }
 
 #if defined (QNATIVESOCKETENGINE_DEBUG)
@@ -1139,6 +1154,239 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return qint64(sentBytes);
 }
 
+#if QT_CONFIG(sendmmsg)
+// the largest number of datagrams passed to one recvmmsg() or sendmmsg() call
+static constexpr int MaxDatagramBatch = 64;
+
+qsizetype QNativeSocketEnginePrivate::nativeReceiveDatagrams(char *const *data, qint64 *sizes,
+                                                             QIpPacketHeader *headers, qsizetype count,
+                                                             QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    const bool wantControl = options & (QAbstractSocketEngine::WantDatagramHopLimit
+                                        | QAbstractSocketEngine::WantDatagramDestination
+                                        | QAbstractSocketEngine::WantStreamNumber);
+    mmsghdr msgs[MaxDatagramBatch];
+    iovec vecs[MaxDatagramBatch];
+    qt_sockaddr addresses[MaxDatagramBatch];
+    ReceiveControlBuffer cbufs[MaxDatagramBatch];
+    char c;
+
+    qsizetype received = 0;
+    while (received < count) {
+        const int batch = int(qMin(count - received, qsizetype(MaxDatagramBatch)));
+        memset(msgs, 0, batch * sizeof(mmsghdr));
+        for (int i = 0; i < batch; ++i) {
+            const qint64 maxSize = sizes[received + i];
+            // we need to receive at least one byte, even if our user isn't interested in it
+            vecs[i].iov_base = maxSize ? data[received + i] : &c;
+            vecs[i].iov_len = maxSize ? maxSize : 1;
+            msghdr &msg = msgs[i].msg_hdr;
+            msg.msg_iov = &vecs[i];
+            msg.msg_iovlen = 1;
+            if (options != QAbstractSocketEngine::WantNone)
+                memset(&addresses[i], 0, sizeof(qt_sockaddr));
+            if (options & QAbstractSocketEngine::WantDatagramSender) {
+                msg.msg_name = &addresses[i];
+                msg.msg_namelen = sizeof(qt_sockaddr);
+            }
+            if (wantControl) {
+                msg.msg_control = cbufs[i];
+                msg.msg_controllen = sizeof(ReceiveControlBuffer);
+            }
+        }
+
+        const int result = qt_safe_recvmmsg(socketDescriptor, msgs, batch, 0);
+        if (result == -1) {
+            // an error after the first datagram is reported by the next call
+            if (received)
+                break;
+            switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+            case EWOULDBLOCK:
+#endif
+            case EAGAIN:
+                // No datagram was available for reading
+                return -2;
+            case ECONNREFUSED:
+                setError(QAbstractSocket::ConnectionRefusedError, ConnectionRefusedErrorString);
+                return -1;
+            default:
+                setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+                return -1;
+            }
+        }
+
+        for (int i = 0; i < result; ++i, ++received) {
+            if (sizes[received])
+                sizes[received] = qint64(msgs[i].msg_len);
+            if (options != QAbstractSocketEngine::WantNone)
+                qt_socket_fillPacketHeader(msgs[i].msg_hdr, addresses[i], localPort, &headers[received]);
+        }
+        if (result < batch)
+            break;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagrams(%p, %lld) == %lld",
+           data, qlonglong(count), qlonglong(received));
+#endif
+
+    return received;
+}
+
+/*
+    Returns \c true if sending a datagram with \a header needs ancillary
+    data, see nativeSendDatagram().
+*/
+static bool qt_datagramNeedsControlMessages(const QIpPacketHeader &header)
+{
+    return header.hopLimit != -1 || header.ifindex != 0 || !header.senderAddress.isNull()
+            || header.streamNumber != -1;
+}
+
+qsizetype QNativeSocketEnginePrivate::nativeSendDatagrams(const char *const *data, const qint64 *sizes,
+                                                          const QIpPacketHeader *const *headers,
+                                                          qsizetype count)
+{
+#ifdef UDP_SEGMENT
+    // Linux can send several datagrams of the same size to the same
+    // destination as one buffer (generic segmentation offload)
+    constexpr int MaxGsoSegments = 64;
+    constexpr qint64 MaxGsoPayload = 65507;
+    using SegmentControlBuffer = quintptr[(CMSG_SPACE(sizeof(quint16)) + sizeof(quintptr) - 1)
+                                          / sizeof(quintptr)];
+    SegmentControlBuffer cbufs[MaxDatagramBatch];
+#endif
+    mmsghdr msgs[MaxDatagramBatch];
+    iovec vecs[MaxDatagramBatch];
+    qt_sockaddr addresses[MaxDatagramBatch];
+    int segments[MaxDatagramBatch];
+
+    qsizetype sent = 0;
+    while (sent < count) {
+        // datagrams that need ancillary data are sent one by one
+        if (qt_datagramNeedsControlMessages(*headers[sent])) {
+            const qint64 result = nativeSendDatagram(data[sent], sizes[sent], *headers[sent]);
+            if (result < 0)
+                return sent ? sent : qsizetype(result);
+            ++sent;
+            continue;
+        }
+
+#ifdef UDP_SEGMENT
+        const bool useGso = socketType == QAbstractSocket::UdpSocket && !udpGsoUnsupported;
+        bool gsoUsed = false;
+        qint64 messageSize = 0;
+#endif
+        int messageCount = 0;
+        int datagramCount = 0;
+        for (qsizetype i = sent; i < count && datagramCount < MaxDatagramBatch; ++i) {
+            const QIpPacketHeader &header = *headers[i];
+            if (qt_datagramNeedsControlMessages(header))
+                break;
+
+            iovec &vec = vecs[datagramCount++];
+            vec.iov_base = const_cast<char *>(data[i]);
+            vec.iov_len = sizes[i];
+
+#ifdef UDP_SEGMENT
+            if (useGso && messageCount) {
+                // append as another segment if the previous message is for the same
+                // destination, and all its segments have the size of this datagram
+                msghdr &previous = msgs[messageCount - 1].msg_hdr;
+                const qsizetype first = i - segments[messageCount - 1];
+                if (sizes[i] > 0 && sizes[i] <= sizes[first] && sizes[i - 1] == sizes[first]
+                    && segments[messageCount - 1] < MaxGsoSegments
+                    && messageSize + sizes[i] <= MaxGsoPayload
+                    && headers[first]->destinationPort == header.destinationPort
+                    && headers[first]->destinationAddress == header.destinationAddress) {
+                    ++previous.msg_iovlen;
+                    ++segments[messageCount - 1];
+                    messageSize += sizes[i];
+                    gsoUsed = true;
+                    continue;
+                }
+            }
+#endif
+
+            msghdr &msg = msgs[messageCount].msg_hdr;
+            memset(&msgs[messageCount], 0, sizeof(mmsghdr));
+            msg.msg_iov = &vec;
+            msg.msg_iovlen = 1;
+            if (header.destinationPort != 0) {
+                memset(&addresses[messageCount], 0, sizeof(qt_sockaddr));
+                msg.msg_name = &addresses[messageCount].a;
+                setPortAndAddress(header.destinationPort, header.destinationAddress,
+                                  &addresses[messageCount], &msg.msg_namelen);
+            }
+            segments[messageCount++] = 1;
+#ifdef UDP_SEGMENT
+            messageSize = sizes[i];
+#endif
+        }
+
+#ifdef UDP_SEGMENT
+        for (int m = 0; gsoUsed && m < messageCount; ++m) {
+            if (segments[m] < 2)
+                continue;
+            msghdr &msg = msgs[m].msg_hdr;
+            msg.msg_control = cbufs[m];
+            msg.msg_controllen = CMSG_SPACE(sizeof(quint16));
+            cmsghdr *cmsgptr = CMSG_FIRSTHDR(&msg);
+            cmsgptr->cmsg_level = IPPROTO_UDP;
+            cmsgptr->cmsg_type = UDP_SEGMENT;
+            cmsgptr->cmsg_len = CMSG_LEN(sizeof(quint16));
+            const quint16 segmentSize = quint16(msg.msg_iov[0].iov_len);
+            memcpy(CMSG_DATA(cmsgptr), &segmentSize, sizeof(segmentSize));
+        }
+#endif
+
+        const int result = qt_safe_sendmmsg(socketDescriptor, msgs, messageCount, 0);
+        if (result == -1) {
+#ifdef UDP_SEGMENT
+            if (gsoUsed && (errno == EIO || errno == EINVAL)) {
+                // the route or the device cannot segment (e.g. no checksum
+                // offload), so send the datagrams individually from now on
+                udpGsoUnsupported = true;
+                continue;
+            }
+#endif
+            // an error after the first datagram is reported by the next call
+            if (sent)
+                break;
+            switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+            case EWOULDBLOCK:
+#endif
+            case EAGAIN:
+                return -2;
+            case EMSGSIZE:
+                setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+                return -1;
+            case ECONNRESET:
+                setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+                return -1;
+            default:
+                setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
+                return -1;
+            }
+        }
+
+        for (int m = 0; m < result; ++m)
+            sent += segments[m];
+        if (result < messageCount)
+            break;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendDatagrams(%p, %lld) == %lld",
+           data, qlonglong(count), qlonglong(sent));
+#endif
+
+    return sent;
+}
+#endif // QT_CONFIG(sendmmsg)
+
 bool QNativeSocketEnginePrivate::fetchConnectionParameters()
 {
     localPort = 0;
@@ -1303,6 +1551,59 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+
+#if QT_CONFIG(sendfile)
+qint64 QNativeSocketEnginePrivate::nativeSendFile(qintptr fileHandle, qint64 offset, qint64 size)
+{
+    Q_Q(QNativeSocketEngine);
+
+    // the kernel transfers at most 0x7ffff000 bytes per call anyway
+    const qint64 chunk = qMin(size, qint64(0x7ffff000));
+    qint64 writtenBytes = qt_safe_sendfile(socketDescriptor, int(fileHandle), offset, chunk);
+
+    if (writtenBytes == 0 && chunk > 0) {
+        // the file ended before offset + size; let the caller read it to find out
+        writtenBytes = -1;
+        setError(QAbstractSocket::UnsupportedSocketOperationError, OperationUnsupportedErrorString);
+    } else if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            writtenBytes = -1;
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+#if EWOULDBLOCK-0 && EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        case EINVAL:
+        case ENOSYS:
+        case EOVERFLOW:
+        case ESPIPE:
+            // the file cannot be mmap()ed by the kernel, or the offset is out of range
+            writtenBytes = -1;
+            setError(QAbstractSocket::UnsupportedSocketOperationError,
+                     OperationUnsupportedErrorString);
+            break;
+        default:
+            writtenBytes = -1;
+            setError(QAbstractSocket::UnknownSocketError, UnknownSocketErrorString);
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendFile(%lld, %lld, %lld) == %lld",
+           qint64(fileHandle), offset, size, writtenBytes);
+#endif
+
+    return writtenBytes;
+}
+#endif // QT_CONFIG(sendfile)
+
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
@@ -21,6 +21,9 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#if QT_CONFIG(sendfile)
+#  include <sys/sendfile.h>
+#endif
 
 #if defined(Q_OS_VXWORKS)
 #  include <sockLib.h>
@@ -156,6 +159,42 @@ static inline int qt_safe_recvmsg(int sockfd, struct msghdr *msg, int flags)
     return ret;
 }
 
+#if QT_CONFIG(sendmmsg)
+static inline int qt_safe_sendmmsg(int sockfd, struct mmsghdr *msgs, unsigned int count, int flags)
+{
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#else
+    qt_ignore_sigpipe();
+#endif
+
+    int ret;
+    EINTR_LOOP(ret, ::sendmmsg(sockfd, msgs, count, flags));
+    return ret;
+}
+
+static inline int qt_safe_recvmmsg(int sockfd, struct mmsghdr *msgs, unsigned int count, int flags)
+{
+    int ret;
+
+    EINTR_LOOP(ret, ::recvmmsg(sockfd, msgs, count, flags, nullptr));
+    return ret;
+}
+#endif // QT_CONFIG(sendmmsg)
+
+#if QT_CONFIG(sendfile)
+static inline qint64 qt_safe_sendfile(int sockfd, int fd, qint64 offset, qint64 count)
+{
+    // sendfile() has no MSG_NOSIGNAL
+    qt_ignore_sigpipe();
+
+    off_t off = off_t(offset);
+    ssize_t ret;
+    EINTR_LOOP(ret, ::sendfile(sockfd, fd, &off, size_t(count)));
+    return qint64(ret);
+}
+#endif // QT_CONFIG(sendfile)
+
 QT_END_NAMESPACE
 
 #endif // QNET_UNIX_P_H
@@ -36,6 +36,10 @@
     \note An incoming datagram should be read when you receive the readyRead()
     signal, otherwise this signal will not be emitted for the next datagram.
 
+    Applications that handle many datagrams per second can use
+    receiveDatagrams() and writeDatagrams() to transfer a batch of datagrams
+    at once, which needs fewer system calls on platforms that support it.
+
     Example:
 
     \snippet code/src_network_socket_qudpsocket.cpp 0
@@ -66,6 +70,10 @@
 #include "qnetworkdatagram.h"
 #include "qnetworkinterface.h"
 #include "qabstractsocket_p.h"
+#include "private/qbytearray_p.h"
+#include "qvarlengtharray.h"
+
+#include <numeric>
 
 QT_BEGIN_NAMESPACE
 
@@ -89,6 +97,9 @@ public:
 
     inline bool ensureInitialized(const QHostAddress &remoteAddress)
     { return doEnsureInitialized(QHostAddress(), 0, remoteAddress); }
+
+    // receiveDatagrams() reads into this, it grows to the largest batch
+    QByteArray receiveArena;
 };
 
 bool QUdpSocketPrivate::doEnsureInitialized(const QHostAddress &bindAddress, quint16 bindPort,
@@ -440,6 +451,149 @@ QNetworkDatagram QUdpSocket::receiveDatagram(qint64 maxSize)
     return result;
 }
 
+/*!
+    \since 6.7
+
+    Receives up to \a maxCount datagrams that are already pending, each no
+    larger than \a maxSize bytes, and returns them along with their sender's
+    host address and port and, if possible, their destination address and
+    hop count. Returns an empty list if no datagram is pending or an error
+    occurred. At most 1024 datagrams are received per call.
+
+    Where the platform supports it, the datagrams are received with a single
+    system call. This makes this function preferable to calling
+    receiveDatagram() repeatedly when datagrams arrive at a high rate.
+
+    If a datagram is larger than \a maxSize, the rest of it is lost. If \a
+    maxSize is -1 (the default), datagrams of up to 64 KB can be received;
+    since the socket keeps a buffer for \a maxCount datagrams of that size
+    for the following calls, pass the largest size you expect if it is
+    known.
+
+    \sa receiveDatagram(), writeDatagrams(), hasPendingDatagrams()
+*/
+QList<QNetworkDatagram> QUdpSocket::receiveDatagrams(qsizetype maxCount, qint64 maxSize)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::receiveDatagrams(%lld, %lld)", qlonglong(maxCount), maxSize);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::receiveDatagrams()", QList<QNetworkDatagram>());
+
+    // the most that recvmmsg() accepts on Linux
+    constexpr qsizetype MaxBatchCount = 1024;
+    if (maxCount <= 0)
+        return QList<QNetworkDatagram>();
+    maxCount = qMin(maxCount, MaxBatchCount);
+    if (maxSize < 0)
+        maxSize = 64 * 1024;
+
+    qint64 arenaSize;
+    if (qMulOverflow(qint64(maxCount), maxSize, &arenaSize) || arenaSize > MaxByteArraySize) {
+        qWarning("QUdpSocket::receiveDatagrams: cannot allocate %lld datagrams of %lld bytes",
+                 qlonglong(maxCount), maxSize);
+        return QList<QNetworkDatagram>();
+    }
+    if (d->receiveArena.size() < arenaSize)
+        d->receiveArena = QByteArray(arenaSize, Qt::Uninitialized);
+    char *arena = d->receiveArena.data();
+
+    QVarLengthArray<char *, 64> data(maxCount);
+    QVarLengthArray<qint64, 64> sizes(maxCount);
+    QVarLengthArray<QIpPacketHeader, 64> headers(maxCount);
+    for (qsizetype i = 0; i < maxCount; ++i) {
+        data[i] = arena + i * maxSize;
+        sizes[i] = maxSize;
+    }
+
+    const qsizetype received = d->socketEngine->readDatagrams(data.data(), sizes.data(),
+                                                              headers.data(), maxCount,
+                                                              QAbstractSocketEngine::WantAll);
+    d->hasPendingData = false;
+    d->socketEngine->setReadNotificationEnabled(true);
+
+    QList<QNetworkDatagram> result;
+    if (received < 0) {
+        // -2 means that no datagram was pending
+        if (received != -2)
+            d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+        return result;
+    }
+
+    result.reserve(received);
+    for (qsizetype i = 0; i < received; ++i) {
+        // a QNetworkDatagram owns its data, so it can't refer to the arena
+        QNetworkDatagram datagram(QByteArray(data[i], sizes[i]));
+        datagram.d->header = headers[i];
+        result.append(std::move(datagram));
+    }
+    return result;
+}
+
+/*!
+    \since 6.7
+
+    Sends all \a datagrams to the destinations contained in each of them,
+    like writeDatagram(), and returns the number of datagrams sent. Returns
+    -1 if no datagram could be sent.
+
+    Where the platform supports it, the datagrams are sent with as few system
+    calls as possible. On Linux, consecutive datagrams of equal size for the
+    same destination are also passed to the kernel as a single buffer, to be
+    segmented by the network stack or the network interface.
+
+    If fewer datagrams than given were sent, the socket's send buffer was
+    full or an error occurred; the error is reported by the next call.
+    The bytesWritten() signal is emitted once for all datagrams sent.
+
+    \sa writeDatagram(), receiveDatagrams()
+*/
+qsizetype QUdpSocket::writeDatagrams(const QList<QNetworkDatagram> &datagrams)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%lld)", qlonglong(datagrams.size()));
+#endif
+    if (datagrams.isEmpty())
+        return 0;
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, datagrams.first().destinationAddress()))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+
+    QVarLengthArray<const char *, 64> data;
+    QVarLengthArray<qint64, 64> sizes;
+    QVarLengthArray<const QIpPacketHeader *, 64> headers;
+    data.reserve(datagrams.size());
+    sizes.reserve(datagrams.size());
+    headers.reserve(datagrams.size());
+    for (const QNetworkDatagram &datagram : datagrams) {
+        data.append(datagram.d->data.constData());
+        sizes.append(datagram.d->data.size());
+        headers.append(&datagram.d->header);
+    }
+
+    const qsizetype sent = d->socketEngine->writeDatagrams(data.constData(), sizes.constData(),
+                                                           headers.constData(), datagrams.size());
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    if (sent < 0) {
+        if (sent == -2) {
+            // Socket engine reports EAGAIN. Treat as a temporary error.
+            d->setErrorAndEmit(QAbstractSocket::TemporaryError,
+                               tr("Unable to send a datagram"));
+            return -1;
+        }
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+        return -1;
+    }
+
+    if (sent > 0)
+        emit bytesWritten(std::accumulate(sizes.cbegin(), sizes.cbegin() + sent, qint64(0)));
+    return sent;
+}
+
 /*!
     Receives a datagram no larger than \a maxSize bytes and stores
     it in \a data. The sender's host address and port is stored in
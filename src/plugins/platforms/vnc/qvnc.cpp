@@ -7,6 +7,7 @@
 #include "QtNetwork/qtcpsocket.h"
 #include <qendian.h>
 #include <qthread.h>
+#include <qthreadpool.h>
 
 #include <QtGui/qguiapplication.h>
 #include <QtGui/QWindow>
@@ -498,6 +499,92 @@ void QRfbRawEncoder::write()
     socket->flush();
 }
 
+QRfbCompressingEncoder::QRfbCompressingEncoder(QVncClient *s, QRfbCompressor *c,
+                                               int compressionLevel, int qualityLevel)
+    : QRfbEncoder(s), compressor(c), compressionLevel(compressionLevel), qualityLevel(qualityLevel)
+{
+}
+
+QRfbCompressingEncoder::~QRfbCompressingEncoder()
+{
+    // the compressor must not be used by the thread pool once the client
+    // and its compressors are gone
+    waitForIdle();
+}
+
+void QRfbCompressingEncoder::waitForIdle()
+{
+    QMutexLocker locker(&mutex);
+    while (running)
+        idle.wait(&mutex);
+}
+
+void QRfbCompressingEncoder::write()
+{
+    // the client does not ask for an update before the last one was sent,
+    // but the compressing thread might not have returned yet
+    waitForIdle();
+
+    QRegion rgn = client->dirtyRegion();
+    qCDebug(lcVnc) << "QRfbCompressingEncoder::write()" << rgn;
+
+    const QImage screenImage = client->server()->screenImage();
+    rgn &= screenImage.rect();
+
+    compressor->setFormat(client->clientFormat());
+    compressor->setCompressionLevel(compressionLevel);
+    compressor->setQualityLevel(qualityLevel);
+
+    // the screen image can change as soon as we return, so take a copy of
+    // the dirty pixels in the client's format
+    const int bytesPerPixel = client->clientBytesPerPixel();
+    const qsizetype linestep = screenImage.bytesPerLine();
+    const int depth = screenImage.depth();
+    QList<QRfbPixelRect> rects;
+    rects.reserve(rgn.rectCount());
+    for (const QRect &tileRect : rgn) {
+        QRfbPixelRect pixelRect;
+        pixelRect.rect = tileRect;
+        const int bstep = tileRect.width() * bytesPerPixel;
+        pixelRect.pixels.resize(bstep * tileRect.height());
+
+        const uchar *screendata = screenImage.scanLine(tileRect.y())
+                                  + tileRect.x() * depth / 8;
+        char *b = pixelRect.pixels.data();
+        for (int i = 0; i < tileRect.height(); ++i) {
+            if (client->doPixelConversion())
+                client->convertPixels(b, reinterpret_cast<const char *>(screendata), tileRect.width(), depth);
+            else
+                memcpy(b, screendata, bstep);
+            screendata += linestep;
+            b += bstep;
+        }
+        if (compressor->needsImage())
+            pixelRect.image = screenImage.copy(tileRect);
+        rects.append(std::move(pixelRect));
+    }
+
+    {
+        QMutexLocker locker(&mutex);
+        running = true;
+    }
+    QThreadPool::globalInstance()->start([this, rects = std::move(rects)] {
+        QByteArray data;
+        const int count = compressor->encode(rects, &data);
+
+        // the client waits for this encoder before it goes away, so it is
+        // still there when the update is queued
+        QVncClient *c = client;
+        QMetaObject::invokeMethod(c, [c, data = std::move(data), count] {
+            c->writeFrameBufferUpdate(data, count);
+        }, Qt::QueuedConnection);
+
+        QMutexLocker locker(&mutex);
+        running = false;
+        idle.wakeAll();
+    });
+}
+
 #if QT_CONFIG(cursor)
 QVncClientCursor::QVncClientCursor()
 {
@@ -5,9 +5,12 @@
 #define QVNC_P_H
 
 #include "qvncscreen.h"
+#include "qvnccompressor_p.h"
 
 #include <QtCore/QLoggingCategory>
 #include <QtCore/qbytearray.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qwaitcondition.h>
 #include <QtCore/qvarlengtharray.h>
 #include <qpa/qplatformcursor.h>
 
@@ -170,6 +173,8 @@ public:
     virtual ~QRfbEncoder() {}
 
     virtual void write() = 0;
+    // true if write() returns before the update has been sent
+    virtual bool isAsynchronous() const { return false; }
 
 protected:
     QVncClient *client;
@@ -186,6 +191,28 @@ private:
     QByteArray buffer;
 };
 
+// Converts the dirty rectangles on the GUI thread and compresses them in
+// the global thread pool; the client sends the update once that is done.
+class QRfbCompressingEncoder : public QRfbEncoder
+{
+public:
+    QRfbCompressingEncoder(QVncClient *s, QRfbCompressor *c, int compressionLevel, int qualityLevel);
+    ~QRfbCompressingEncoder();
+
+    void write() override;
+    bool isAsynchronous() const override { return true; }
+
+private:
+    void waitForIdle();
+
+    QRfbCompressor *compressor; // owned by the client
+    int compressionLevel;
+    int qualityLevel;
+    QMutex mutex;
+    QWaitCondition idle;
+    bool running = false;
+};
+
 template <class SRC> class QRfbHextileEncoder;
 
 template <class SRC>
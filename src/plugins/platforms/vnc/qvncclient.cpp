@@ -31,6 +31,7 @@ QVncClient::QVncClient(QTcpSocket *clientSocket, QVncServer *server)
     , m_wantUpdate(false)
     , m_dirtyCursor(false)
     , m_updatePending(false)
+    , m_updateInProgress(false)
     , m_protocolVersion(V3_3)
 {
     connect(m_clientSocket,SIGNAL(readyRead()),this,SLOT(readClient()));
@@ -61,6 +62,37 @@ void QVncClient::setDirty(const QRegion &region)
     }
 }
 
+QRfbClientFormat QVncClient::clientFormat() const
+{
+    QRfbClientFormat format;
+    format.bytesPerPixel = clientBytesPerPixel();
+    format.bigEndian = m_pixelFormat.bigEndian;
+    format.trueColor = m_pixelFormat.trueColor;
+    format.redMax = (1 << m_pixelFormat.redBits) - 1;
+    format.greenMax = (1 << m_pixelFormat.greenBits) - 1;
+    format.blueMax = (1 << m_pixelFormat.blueBits) - 1;
+    format.redShift = m_pixelFormat.redShift;
+    format.greenShift = m_pixelFormat.greenShift;
+    format.blueShift = m_pixelFormat.blueShift;
+    return format;
+}
+
+void QVncClient::writeFrameBufferUpdate(const QByteArray &rects, int rectCount)
+{
+    m_updateInProgress = false;
+    if (m_state == Disconnected)
+        return;
+
+    const char header[4] = { 0, 0, // msg type, padding
+                             char(rectCount >> 8), char(rectCount) };
+    m_clientSocket->write(header, sizeof(header));
+    m_clientSocket->write(rects);
+    m_clientSocket->flush();
+
+    // the client may have asked for the next update in the meantime
+    checkUpdate();
+}
+
 void QVncClient::convertPixels(char *dst, const char *src, int count, int screendepth) const
 {
     // cutoffs
@@ -384,7 +416,7 @@ void QVncClient::discardClient()
 
 void QVncClient::checkUpdate()
 {
-    if (!m_wantUpdate)
+    if (!m_wantUpdate || m_updateInProgress)
         return;
 #if QT_CONFIG(cursor)
     if (m_dirtyCursor) {
@@ -395,8 +427,10 @@ void QVncClient::checkUpdate()
     }
 #endif
     if (!m_dirtyRegion.isEmpty()) {
-        if (m_encoder)
+        if (m_encoder) {
             m_encoder->write();
+            m_updateInProgress = m_encoder->isAsynchronous();
+        }
         m_wantUpdate = false;
         m_dirtyRegion = QRegion();
     }
@@ -471,13 +505,23 @@ void QVncClient::setEncodings()
         RRE = 2,
         CoRRE = 4,
         Hextile = 5,
+        Tight = 7,
         ZRLE = 16,
         Cursor = -239,
-        DesktopSize = -223
+        DesktopSize = -223,
+        CompressionLevel0 = -256,
+        CompressionLevel9 = -247,
+        QualityLevel0 = -32,
+        QualityLevel9 = -23
     };
 
     if (m_encodingsPending && (unsigned)m_clientSocket->bytesAvailable() >=
                                 m_encodingsPending * sizeof(quint32)) {
+        // the client lists the encodings in the order it prefers them, but
+        // the levels apply to whichever encoding is picked
+        int preferred = -1;
+        int compressionLevel = 6;
+        int qualityLevel = -1;
         for (int i = 0; i < m_encodingsPending; ++i) {
             qint32 enc;
             m_clientSocket->read((char *)&enc, sizeof(qint32));
@@ -485,10 +529,8 @@ void QVncClient::setEncodings()
             qCDebug(lcVnc, "QVncServer::setEncodings: %d", enc);
             switch (enc) {
             case Raw:
-                if (!m_encoder) {
-                    m_encoder = new QRfbRawEncoder(this);
-                    qCDebug(lcVnc, "QVncServer::setEncodings: using raw");
-                }
+                if (preferred < 0)
+                    preferred = Raw;
                break;
             case CopyRect:
                 m_supportCopyRect = true;
@@ -504,8 +546,15 @@ void QVncClient::setEncodings()
                 if (m_encoder)
                     break;
                 break;
+            case Tight:
+                m_supportTight = true;
+                if (preferred < 0)
+                    preferred = Tight;
+                break;
             case ZRLE:
                 m_supportZRLE = true;
+                if (preferred < 0)
+                    preferred = ZRLE;
                 break;
             case Cursor:
                 m_supportCursor = true;
@@ -515,11 +564,40 @@ void QVncClient::setEncodings()
                 m_supportDesktopSize = true;
                 break;
             default:
+                if (enc >= CompressionLevel0 && enc <= CompressionLevel9)
+                    compressionLevel = enc - CompressionLevel0;
+                else if (enc >= QualityLevel0 && enc <= QualityLevel9)
+                    qualityLevel = enc - QualityLevel0;
                 break;
             }
         }
         m_handleMsg = false;
         m_encodingsPending = 0;
+
+        switch (preferred) {
+        case Raw:
+            m_encoder = new QRfbRawEncoder(this);
+            qCDebug(lcVnc, "QVncServer::setEncodings: using raw");
+            break;
+        case ZRLE:
+            if (!m_zrleCompressor)
+                m_zrleCompressor = std::make_unique<QRfbZrleCompressor>();
+            m_encoder = new QRfbCompressingEncoder(this, m_zrleCompressor.get(),
+                                                   compressionLevel, qualityLevel);
+            qCDebug(lcVnc, "QVncServer::setEncodings: using ZRLE, compression level %d",
+                    compressionLevel);
+            break;
+        case Tight:
+            if (!m_tightCompressor)
+                m_tightCompressor = std::make_unique<QRfbTightCompressor>();
+            m_encoder = new QRfbCompressingEncoder(this, m_tightCompressor.get(),
+                                                   compressionLevel, qualityLevel);
+            qCDebug(lcVnc, "QVncServer::setEncodings: using Tight, compression level %d, quality level %d",
+                    compressionLevel, qualityLevel);
+            break;
+        default:
+            break;
+        }
     }
 
     if (!m_encoder) {
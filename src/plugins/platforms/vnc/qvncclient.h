@@ -8,6 +8,8 @@
 
 #include "qvnc_p.h"
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 class QTcpSocket;
@@ -43,6 +45,9 @@ public:
 
     void convertPixels(char *dst, const char *src, int count, int depth) const;
     inline bool doPixelConversion() const { return m_needConversion; }
+    QRfbClientFormat clientFormat() const;
+
+    void writeFrameBufferUpdate(const QByteArray &rects, int rectCount);
 
 signals:
 
@@ -80,6 +85,9 @@ private:
     QVncServer *m_server;
     QTcpSocket *m_clientSocket;
     QRfbEncoder *m_encoder;
+    // the compression state lives as long as the connection
+    std::unique_ptr<QRfbZrleCompressor> m_zrleCompressor;
+    std::unique_ptr<QRfbTightCompressor> m_tightCompressor;
 
     // Client State
     ClientState m_state;
@@ -95,12 +103,14 @@ private:
     uint m_supportCoRRE : 1;
     uint m_supportHextile : 1;
     uint m_supportZRLE : 1;
+    uint m_supportTight : 1;
     uint m_supportCursor : 1;
     uint m_supportDesktopSize : 1;
     bool m_wantUpdate;
     Qt::KeyboardModifiers m_keymod;
     bool m_dirtyCursor;
     bool m_updatePending;
+    bool m_updateInProgress;
 #if Q_BYTE_ORDER == Q_BIG_ENDIAN
     bool m_swapBytes;
 #endif
@@ -0,0 +1,573 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qvnccompressor_p.h"
+
+#include <QtCore/qbuffer.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qmath.h>
+#include <QtGui/qimagewriter.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+// A deflate stream that lives as long as the client's inflate stream does
+class QRfbZStream
+{
+public:
+    explicit QRfbZStream(int level)
+        : level(level)
+    {
+        memset(&stream, 0, sizeof(stream));
+        valid = deflateInit(&stream, level) == Z_OK;
+    }
+    ~QRfbZStream()
+    {
+        if (valid)
+            deflateEnd(&stream);
+    }
+
+    void setLevel(int newLevel)
+    {
+        // the stream is flushed after every rectangle, so this never has to
+        // compress pending input
+        if (valid && newLevel != level && deflateParams(&stream, newLevel, Z_DEFAULT_STRATEGY) == Z_OK)
+            level = newLevel;
+    }
+
+    // compresses size bytes of data and appends them to out, flushed so
+    // that the client can decode all of it
+    bool deflate(const char *data, qsizetype size, QByteArray *out)
+    {
+        if (!valid)
+            return false;
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        stream.avail_in = uInt(size);
+        do {
+            const qsizetype offset = out->size();
+            const qsizetype chunk = qMax(qsizetype(deflateBound(&stream, stream.avail_in)), qsizetype(1024));
+            out->resize(offset + chunk);
+            stream.next_out = reinterpret_cast<Bytef *>(out->data() + offset);
+            stream.avail_out = uInt(chunk);
+            const int ret = ::deflate(&stream, Z_SYNC_FLUSH);
+            out->resize(offset + chunk - stream.avail_out);
+            if (ret != Z_OK && ret != Z_BUF_ERROR)
+                return false;
+        } while (stream.avail_out == 0);
+        return true;
+    }
+
+private:
+    z_stream stream;
+    int level;
+    bool valid;
+};
+
+// Maps the colors of a tile to palette indexes
+template <int MaxColors>
+class QRfbPalette
+{
+public:
+    void clear()
+    {
+        size = 0;
+        std::fill(std::begin(indexes), std::end(indexes), qint16(-1));
+    }
+
+    // returns false if the color is new and the palette is full
+    bool insert(quint32 pixel)
+    {
+        int slot = hash(pixel);
+        while (indexes[slot] >= 0) {
+            if (colors[indexes[slot]] == pixel)
+                return true;
+            slot = (slot + 1) & (SlotCount - 1);
+        }
+        if (size == MaxColors)
+            return false;
+        indexes[slot] = qint16(size);
+        colors[size++] = pixel;
+        return true;
+    }
+
+    int indexOf(quint32 pixel) const
+    {
+        int slot = hash(pixel);
+        while (colors[indexes[slot]] != pixel)
+            slot = (slot + 1) & (SlotCount - 1);
+        return indexes[slot];
+    }
+
+    quint32 colors[MaxColors];
+    int size = 0;
+
+private:
+    static constexpr int SlotCount = int(qNextPowerOfTwo(quint32(MaxColors * 2 - 1)));
+    static int hash(quint32 pixel) { return ((pixel * 0x9e3779b1u) >> 16) & (SlotCount - 1); }
+
+    qint16 indexes[SlotCount];
+};
+
+static inline quint32 readPixel(const uchar *data, int bpp)
+{
+    quint32 pixel = 0;
+    memcpy(&pixel, data, bpp);
+    return pixel;
+}
+
+// Run lengths are written as a sequence of bytes that add up to length - 1
+static inline void appendRunLength(QByteArray *data, int length)
+{
+    int n = length - 1;
+    for (; n >= 255; n -= 255)
+        data->append(char(255));
+    data->append(char(n));
+}
+
+static inline int runLengthSize(int length)
+{
+    return (length - 1) / 255 + 1;
+}
+
+static quint32 channelMask(const QRfbClientFormat &format)
+{
+    return (quint32(format.redMax) << format.redShift)
+         | (quint32(format.greenMax) << format.greenShift)
+         | (quint32(format.blueMax) << format.blueShift);
+}
+
+int QRfbClientFormat::compactPixelSize() const
+{
+    if (bytesPerPixel != 4 || !trueColor)
+        return bytesPerPixel;
+    const quint32 mask = channelMask(*this);
+    return (!(mask & 0xff000000) || !(mask & 0x000000ff)) ? 3 : 4;
+}
+
+int QRfbClientFormat::compactPixelOffset() const
+{
+    if (compactPixelSize() != 3)
+        return 0;
+    // the least significant bytes come first in little endian pixels
+    const bool fitsLow = !(channelMask(*this) & 0xff000000);
+    return fitsLow == !bigEndian ? 0 : 1;
+}
+
+bool QRfbClientFormat::isRgb888() const
+{
+    return bytesPerPixel == 4 && trueColor
+        && redMax == 255 && greenMax == 255 && blueMax == 255;
+}
+
+QRfbCompressor::~QRfbCompressor()
+    = default;
+
+void QRfbCompressor::appendRectHeader(QByteArray *data, const QRect &rect, qint32 encoding)
+{
+    char header[12];
+    qToBigEndian<quint16>(rect.x(), header);
+    qToBigEndian<quint16>(rect.y(), header + 2);
+    qToBigEndian<quint16>(rect.width(), header + 4);
+    qToBigEndian<quint16>(rect.height(), header + 6);
+    qToBigEndian<qint32>(encoding, header + 8);
+    data->append(header, sizeof(header));
+}
+
+/*
+    ZRLE (RFC 6143, 7.7.6): every rectangle is cut into 64x64 tiles, which
+    are sent raw, as a single color, with a packed palette, or run-length
+    encoded, whichever is smallest. The tiles of a rectangle are compressed
+    with the zlib stream of the connection.
+*/
+
+QRfbZrleCompressor::QRfbZrleCompressor()
+    = default;
+
+QRfbZrleCompressor::~QRfbZrleCompressor()
+    = default;
+
+int QRfbZrleCompressor::encode(const QList<QRfbPixelRect> &rects, QByteArray *data)
+{
+    if (!stream)
+        stream = std::make_unique<QRfbZStream>(compressionLevel);
+    else
+        stream->setLevel(compressionLevel);
+
+    bpp = clientFormat.bytesPerPixel;
+    cpixelOffset = clientFormat.compactPixelOffset();
+    cpixelSize = clientFormat.compactPixelSize();
+
+    for (const QRfbPixelRect &source : rects) {
+        const int width = source.rect.width();
+        const int height = source.rect.height();
+        const int stride = width * bpp;
+        const uchar *pixels = reinterpret_cast<const uchar *>(source.pixels.constData());
+
+        tiles.clear();
+        for (int y = 0; y < height; y += TileSize) {
+            for (int x = 0; x < width; x += TileSize) {
+                encodeTile(pixels + y * stride + x * bpp, stride,
+                           qMin(int(TileSize), width - x), qMin(int(TileSize), height - y));
+            }
+        }
+
+        appendRectHeader(data, source.rect, 16);
+        const qsizetype lengthOffset = data->size();
+        data->append(4, '\0');
+        stream->deflate(tiles.constData(), tiles.size(), data);
+        qToBigEndian<quint32>(data->size() - lengthOffset - 4, data->data() + lengthOffset);
+    }
+    return rects.size();
+}
+
+void QRfbZrleCompressor::appendCompactPixel(quint32 pixel)
+{
+    tiles.append(reinterpret_cast<const char *>(&pixel) + cpixelOffset, cpixelSize);
+}
+
+void QRfbZrleCompressor::encodeTile(const uchar *pixels, int stride, int width, int height)
+{
+    enum SubEncoding {
+        Raw = 0,
+        Solid = 1,
+        PlainRle = 128,
+        PaletteRle = 128 // + palette size
+    };
+
+    // Collect the colors and the sizes the run-length encodings would have
+    QRfbPalette<127> palette;
+    palette.clear();
+    bool paletteFull = false;
+    int plainRleSize = 0;
+    int paletteRleSize = 0;
+
+    quint32 runPixel = readPixel(pixels, bpp);
+    int runLength = 0;
+    const auto endRun = [&] {
+        plainRleSize += cpixelSize + runLengthSize(runLength);
+        paletteRleSize += runLength == 1 ? 1 : 1 + runLengthSize(runLength);
+    };
+    for (int y = 0; y < height; ++y) {
+        const uchar *p = pixels + y * stride;
+        for (int x = 0; x < width; ++x, p += bpp) {
+            const quint32 pixel = readPixel(p, bpp);
+            if (pixel == runPixel && runLength) {
+                ++runLength;
+                continue;
+            }
+            if (runLength)
+                endRun();
+            runPixel = pixel;
+            runLength = 1;
+            if (!paletteFull)
+                paletteFull = !palette.insert(pixel);
+        }
+    }
+    endRun();
+
+    if (!paletteFull && palette.size == 1) {
+        tiles.append(char(Solid));
+        appendCompactPixel(palette.colors[0]);
+        return;
+    }
+
+    int bestSize = width * height * cpixelSize;
+    int subEncoding = Raw;
+    if (plainRleSize < bestSize) {
+        bestSize = plainRleSize;
+        subEncoding = PlainRle;
+    }
+    int bitsPerIndex = 0;
+    if (!paletteFull) {
+        const int paletteSize = palette.size * cpixelSize;
+        if (paletteSize + paletteRleSize < bestSize) {
+            bestSize = paletteSize + paletteRleSize;
+            subEncoding = PaletteRle + palette.size;
+        }
+        if (palette.size <= 16) {
+            const int bits = palette.size <= 2 ? 1 : palette.size <= 4 ? 2 : 4;
+            const int packedSize = paletteSize + (width * bits + 7) / 8 * height;
+            if (packedSize <= bestSize) {
+                bestSize = packedSize;
+                subEncoding = palette.size;
+                bitsPerIndex = bits;
+            }
+        }
+    }
+
+    tiles.append(char(subEncoding));
+    if (subEncoding == Raw) {
+        for (int y = 0; y < height; ++y) {
+            const uchar *p = pixels + y * stride;
+            if (cpixelSize == bpp) {
+                tiles.append(reinterpret_cast<const char *>(p), width * bpp);
+                continue;
+            }
+            for (int x = 0; x < width; ++x, p += bpp)
+                appendCompactPixel(readPixel(p, bpp));
+        }
+        return;
+    }
+
+    if (subEncoding != PlainRle) {
+        for (int i = 0; i < palette.size; ++i)
+            appendCompactPixel(palette.colors[i]);
+    }
+
+    if (bitsPerIndex) {
+        // packed palette, every row starts at a byte boundary
+        for (int y = 0; y < height; ++y) {
+            const uchar *p = pixels + y * stride;
+            uint byte = 0;
+            int bits = 0;
+            for (int x = 0; x < width; ++x, p += bpp) {
+                byte = (byte << bitsPerIndex) | palette.indexOf(readPixel(p, bpp));
+                bits += bitsPerIndex;
+                if (bits == 8) {
+                    tiles.append(char(byte));
+                    byte = 0;
+                    bits = 0;
+                }
+            }
+            if (bits)
+                tiles.append(char(byte << (8 - bits)));
+        }
+        return;
+    }
+
+    runLength = 0;
+    const auto writeRun = [&] {
+        if (subEncoding == PlainRle) {
+            appendCompactPixel(runPixel);
+            appendRunLength(&tiles, runLength);
+        } else if (runLength == 1) {
+            tiles.append(char(palette.indexOf(runPixel)));
+        } else {
+            tiles.append(char(palette.indexOf(runPixel) | 128));
+            appendRunLength(&tiles, runLength);
+        }
+    };
+    for (int y = 0; y < height; ++y) {
+        const uchar *p = pixels + y * stride;
+        for (int x = 0; x < width; ++x, p += bpp) {
+            const quint32 pixel = readPixel(p, bpp);
+            if (pixel == runPixel && runLength) {
+                ++runLength;
+                continue;
+            }
+            if (runLength)
+                writeRun();
+            runPixel = pixel;
+            runLength = 1;
+        }
+    }
+    writeRun();
+}
+
+/*
+    Tight: rectangles of a single color are sent as such, photo-like ones
+    as JPEG if the client asked for it, and all others with a palette or
+    as they are, compressed with one of four zlib streams.
+*/
+
+QRfbTightCompressor::QRfbTightCompressor()
+    = default;
+
+QRfbTightCompressor::~QRfbTightCompressor()
+    = default;
+
+int QRfbTightCompressor::encode(const QList<QRfbPixelRect> &rects, QByteArray *data)
+{
+    for (auto &stream : streams) {
+        if (stream)
+            stream->setLevel(compressionLevel);
+    }
+
+    // Tight limits the width and the size of a rectangle
+    int count = 0;
+    for (const QRfbPixelRect &source : rects) {
+        const int width = source.rect.width();
+        const int height = source.rect.height();
+        for (int x = 0; x < width; x += MaxRectWidth) {
+            const int w = qMin(int(MaxRectWidth), width - x);
+            const int rows = qMax(1, MaxRectSize / w);
+            for (int y = 0; y < height; y += rows) {
+                encodeRect(source, QRect(x, y, w, qMin(rows, height - y)), data);
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+void QRfbTightCompressor::appendTightPixel(QByteArray *data, quint32 pixel) const
+{
+    if (!clientFormat.isRgb888()) {
+        data->append(reinterpret_cast<const char *>(&pixel), clientFormat.bytesPerPixel);
+        return;
+    }
+    const quint32 value = clientFormat.bigEndian ? qFromBigEndian(pixel) : qFromLittleEndian(pixel);
+    const char rgb[3] = { char(value >> clientFormat.redShift),
+                          char(value >> clientFormat.greenShift),
+                          char(value >> clientFormat.blueShift) };
+    data->append(rgb, sizeof(rgb));
+}
+
+// Tight's compact length: 7 bits per byte, at most three bytes
+static void appendCompactLength(QByteArray *data, quint32 length)
+{
+    data->append(char((length & 0x7f) | (length > 0x7f ? 0x80 : 0)));
+    if (length > 0x7f) {
+        data->append(char(((length >> 7) & 0x7f) | (length > 0x3fff ? 0x80 : 0)));
+        if (length > 0x3fff)
+            data->append(char(length >> 14));
+    }
+}
+
+void QRfbTightCompressor::appendCompressed(QByteArray *data, int streamId, const QByteArray &bytes)
+{
+    // data shorter than 12 bytes is sent as it is
+    if (bytes.size() < 12) {
+        data->append(bytes);
+        return;
+    }
+
+    std::unique_ptr<QRfbZStream> &stream = streams[streamId];
+    if (!stream)
+        stream = std::make_unique<QRfbZStream>(compressionLevel);
+    scratch.clear();
+    stream->deflate(bytes.constData(), bytes.size(), &scratch);
+
+    appendCompactLength(data, scratch.size());
+    data->append(scratch);
+}
+
+bool QRfbTightCompressor::appendJpeg(QByteArray *data, const QImage &image)
+{
+    // the quality levels of the client's pseudo-encodings, as other servers map them
+    static const int qualities[] = { 15, 29, 41, 42, 62, 77, 79, 86, 92, 100 };
+
+    QByteArray jpeg;
+    QBuffer buffer(&jpeg);
+    buffer.open(QIODevice::WriteOnly);
+    QImageWriter writer(&buffer, "jpeg");
+    writer.setQuality(qualities[qBound(0, qualityLevel, 9)]);
+    if (!writer.write(image))
+        return false;
+
+    data->append(char(0x90));
+    appendCompactLength(data, jpeg.size());
+    data->append(jpeg);
+    return true;
+}
+
+void QRfbTightCompressor::encodeRect(const QRfbPixelRect &source, const QRect &rect, QByteArray *data)
+{
+    enum {
+        Fill = 0x80,
+        ExplicitFilter = 0x40,
+        PaletteFilter = 1
+    };
+    enum Stream {
+        FullColorStream = 0,
+        MonoStream = 1,
+        IndexedStream = 2
+    };
+
+    const int bpp = clientFormat.bytesPerPixel;
+    const int stride = source.rect.width() * bpp;
+    const uchar *pixels = reinterpret_cast<const uchar *>(source.pixels.constData())
+                          + rect.y() * stride + rect.x() * bpp;
+    const int width = rect.width();
+    const int height = rect.height();
+    appendRectHeader(data, rect.translated(source.rect.topLeft()), 7);
+
+    QRfbPalette<256> palette;
+    palette.clear();
+    bool paletteFull = false;
+    for (int y = 0; y < height && !paletteFull; ++y) {
+        const uchar *p = pixels + y * stride;
+        quint32 previous = ~readPixel(p, bpp);
+        for (int x = 0; x < width; ++x, p += bpp) {
+            const quint32 pixel = readPixel(p, bpp);
+            if (pixel == previous)
+                continue;
+            previous = pixel;
+            if (!palette.insert(pixel)) {
+                paletteFull = true;
+                break;
+            }
+        }
+    }
+
+    if (palette.size == 1 && !paletteFull) {
+        data->append(char(Fill));
+        appendTightPixel(data, palette.colors[0]);
+        return;
+    }
+
+    if (paletteFull && qualityLevel >= 0 && clientFormat.isRgb888() && !source.image.isNull()
+        && width * height >= MinJpegSize) {
+        if (appendJpeg(data, source.image.copy(rect)))
+            return;
+    }
+
+    QByteArray bytes;
+    const int tightPixelSize = clientFormat.isRgb888() ? 3 : bpp;
+    if (!paletteFull && palette.size == 2) {
+        data->append(char(ExplicitFilter | (MonoStream << 4)));
+        data->append(char(PaletteFilter));
+        data->append(char(palette.size - 1));
+        appendTightPixel(data, palette.colors[0]);
+        appendTightPixel(data, palette.colors[1]);
+        bytes.reserve((width + 7) / 8 * height);
+        for (int y = 0; y < height; ++y) {
+            const uchar *p = pixels + y * stride;
+            uint byte = 0;
+            int bits = 0;
+            for (int x = 0; x < width; ++x, p += bpp) {
+                byte = (byte << 1) | (readPixel(p, bpp) == palette.colors[1]);
+                if (++bits == 8) {
+                    bytes.append(char(byte));
+                    byte = 0;
+                    bits = 0;
+                }
+            }
+            if (bits)
+                bytes.append(char(byte << (8 - bits)));
+        }
+        appendCompressed(data, MonoStream, bytes);
+    } else if (!paletteFull && tightPixelSize > 1) {
+        data->append(char(ExplicitFilter | (IndexedStream << 4)));
+        data->append(char(PaletteFilter));
+        data->append(char(palette.size - 1));
+        for (int i = 0; i < palette.size; ++i)
+            appendTightPixel(data, palette.colors[i]);
+        bytes.reserve(width * height);
+        for (int y = 0; y < height; ++y) {
+            const uchar *p = pixels + y * stride;
+            for (int x = 0; x < width; ++x, p += bpp)
+                bytes.append(char(palette.indexOf(readPixel(p, bpp))));
+        }
+        appendCompressed(data, IndexedStream, bytes);
+    } else {
+        data->append(char(FullColorStream << 4));
+        bytes.reserve(width * height * tightPixelSize);
+        for (int y = 0; y < height; ++y) {
+            const uchar *p = pixels + y * stride;
+            if (tightPixelSize == bpp) {
+                bytes.append(reinterpret_cast<const char *>(p), width * bpp);
+                continue;
+            }
+            for (int x = 0; x < width; ++x, p += bpp)
+                appendTightPixel(&bytes, readPixel(p, bpp));
+        }
+        appendCompressed(data, FullColorStream, bytes);
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,129 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QVNCCOMPRESSOR_P_H
+#define QVNCCOMPRESSOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrect.h>
+#include <QtGui/qimage.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+class QRfbZStream;
+
+// The parts of the client's pixel format the compressing encoders need
+class QRfbClientFormat
+{
+public:
+    int bytesPerPixel = 4;
+    bool bigEndian = false;
+    bool trueColor = true;
+    int redMax = 255;
+    int greenMax = 255;
+    int blueMax = 255;
+    int redShift = 16;
+    int greenShift = 8;
+    int blueShift = 0;
+
+    // offset and size of the compact pixel inside a client pixel
+    int compactPixelOffset() const;
+    int compactPixelSize() const;
+    bool isRgb888() const;
+};
+
+// A rectangle of the screen, converted to the client's pixel format
+class QRfbPixelRect
+{
+public:
+    QRect rect;
+    QByteArray pixels; // rect.width() * rect.height() client pixels, row by row
+    QImage image;      // the screen pixels, only set for encoders that can use them
+};
+
+// Encodes the rectangles of a FramebufferUpdate message. The compression
+// state persists from one update to the next, as the client's does, so one
+// compressor must only be used by one thread at a time.
+class QRfbCompressor
+{
+public:
+    virtual ~QRfbCompressor();
+
+    // appends the rectangles to data and returns the number of rectangles
+    // written, which can be more than rects.size()
+    virtual int encode(const QList<QRfbPixelRect> &rects, QByteArray *data) = 0;
+    virtual bool needsImage() const { return false; }
+
+    void setFormat(const QRfbClientFormat &format) { clientFormat = format; }
+    // 0 - 9, as in the client's pseudo-encodings; a quality level of -1
+    // means that the client did not ask for lossy compression
+    void setCompressionLevel(int level) { compressionLevel = level; }
+    void setQualityLevel(int level) { qualityLevel = level; }
+
+protected:
+    static void appendRectHeader(QByteArray *data, const QRect &rect, qint32 encoding);
+
+    QRfbClientFormat clientFormat;
+    int compressionLevel = 6;
+    int qualityLevel = -1;
+};
+
+class QRfbZrleCompressor : public QRfbCompressor
+{
+public:
+    QRfbZrleCompressor();
+    ~QRfbZrleCompressor();
+
+    int encode(const QList<QRfbPixelRect> &rects, QByteArray *data) override;
+
+private:
+    void encodeTile(const uchar *pixels, int stride, int width, int height);
+    void appendCompactPixel(quint32 pixel);
+
+    enum { TileSize = 64 };
+
+    std::unique_ptr<QRfbZStream> stream;
+    QByteArray tiles; // uncompressed data of the current rectangle
+    int bpp = 4;
+    int cpixelOffset = 0;
+    int cpixelSize = 4;
+};
+
+class QRfbTightCompressor : public QRfbCompressor
+{
+public:
+    QRfbTightCompressor();
+    ~QRfbTightCompressor();
+
+    int encode(const QList<QRfbPixelRect> &rects, QByteArray *data) override;
+    bool needsImage() const override { return qualityLevel >= 0; }
+
+private:
+    void encodeRect(const QRfbPixelRect &source, const QRect &rect, QByteArray *data);
+    void appendTightPixel(QByteArray *data, quint32 pixel) const;
+    void appendCompressed(QByteArray *data, int streamId, const QByteArray &bytes);
+    bool appendJpeg(QByteArray *data, const QImage &image);
+
+    enum { MaxRectWidth = 2048, MaxRectSize = 65536, MinJpegSize = 4096, StreamCount = 4 };
+
+    std::unique_ptr<QRfbZStream> streams[StreamCount];
+    QByteArray scratch;
+};
+
+QT_END_NAMESPACE
+
+#endif // QVNCCOMPRESSOR_P_H
@@ -1180,7 +1180,7 @@ bool QIBaseResult::gotoNext(QSqlCachedResult::ValueCache& row, int rowIdx)
     if (d->queryType == isc_info_sql_stmt_exec_procedure) {
         // the first "fetch" shall succeed, all consecutive ones will fail since
         // we only have one row to fetch for stored procedures
-        if (rowIdx != 0)
+        if (at() != QSql::BeforeFirstRow)
             stat = 100;
     } else {
         stat = isc_dsql_fetch(d->status, &d->stmt, FBVERSION, d->sqlda);
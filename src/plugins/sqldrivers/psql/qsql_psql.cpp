@@ -19,6 +19,7 @@
 #include <QtSql/private/qsqldriver_p.h>
 #include <QtCore/private/qlocale_tools_p.h>
 
+#include <algorithm>
 #include <queue>
 
 #include <libpq-fe.h>
@@ -26,6 +27,13 @@
 
 #include <cmath>
 
+#ifdef Q_OS_WIN
+#  include <winsock2.h>
+#else
+#  include <errno.h>
+#  include <poll.h>
+#endif
+
 // workaround for postgres defining their OIDs in a private header file
 #define QBOOLOID 16
 #define QINT8OID 20
@@ -80,6 +88,11 @@ static const int PGRES_SINGLE_TUPLE = 9;
 typedef int StatementId;
 static const StatementId InvalidStatementId = 0;
 
+// number of batch rows sent before the pipeline is synced and their results are read
+static constexpr qsizetype PipelineWindow = 1000;
+// amount of COPY data handed to libpq at once
+static constexpr qsizetype CopyChunkSize = 64 * 1024;
+
 class QPSQLResultPrivate;
 
 class QPSQLResult final : public QSqlResult
@@ -109,6 +122,7 @@ protected:
     QVariant lastInsertId() const override;
     bool prepare(const QString &query) override;
     bool exec() override;
+    bool execBatch(bool arrayBind = false) override;
 };
 
 class QPSQLDriverPrivate final : public QSqlDriverPrivate
@@ -256,9 +270,14 @@ public:
 
     QString fieldSerial(qsizetype i) const override { return QString("$%1"_L1).arg(i + 1); }
     void deallocatePreparedStmt();
+#ifdef LIBPQ_HAS_PIPELINING
+    bool execPipelined(const QList<QVariantList> &columns, qsizetype rowCount);
+#endif
+    bool execCopy(const QList<QVariantList> &columns, qsizetype rowCount);
 
     std::queue<PGresult*> nextResultSets;
     QString preparedStmtId;
+    QString copyStmt; // COPY equivalent of the prepared statement, if it is a plain INSERT
     PGresult *result = nullptr;
     StatementId stmtId = InvalidStatementId;
     int currentSize = -1;
@@ -837,6 +856,26 @@ QString qMakePreparedStmtId()
     return id;
 }
 
+/*
+   Returns the COPY FROM STDIN statement that inserts the same rows as
+   \a query, or a null string if \a query is not a plain INSERT with one
+   positional placeholder per listed column.
+ */
+static QString qMakeCopyStatement(const QString &query)
+{
+    static const QRegularExpression rx(QStringLiteral(
+            "^\\s*INSERT\\s+INTO\\s+((?:\"(?:[^\"]|\"\")+\"|\\w+)(?:\\.(?:\"(?:[^\"]|\"\")+\"|\\w+))?)"
+            "\\s*\\(([^()?]+)\\)\\s*VALUES\\s*\\(\\s*(\\?(?:\\s*,\\s*\\?)*)\\s*\\)\\s*;?\\s*$"),
+            QRegularExpression::CaseInsensitiveOption);
+    const QRegularExpressionMatch match = rx.match(query);
+    if (!match.hasMatch())
+        return QString();
+    const QString columns = match.captured(2);
+    if (columns.count(u',') != match.captured(3).count(u','))
+        return QString();
+    return QStringLiteral("COPY %1 (%2) FROM STDIN").arg(match.captured(1), columns.trimmed());
+}
+
 bool QPSQLResult::prepare(const QString &query)
 {
     Q_D(QPSQLResult);
@@ -847,6 +886,7 @@ bool QPSQLResult::prepare(const QString &query)
 
     if (!d->preparedStmtId.isEmpty())
         d->deallocatePreparedStmt();
+    d->copyStmt.clear();
 
     const QString stmtId = qMakePreparedStmtId();
     const QString stmt = QStringLiteral("PREPARE %1 AS ").arg(stmtId).append(d->positionalToNamedBinding(query));
@@ -863,6 +903,7 @@ bool QPSQLResult::prepare(const QString &query)
 
     PQclear(result);
     d->preparedStmtId = stmtId;
+    d->copyStmt = qMakeCopyStatement(query);
     return true;
 }
 
@@ -900,6 +941,320 @@ bool QPSQLResult::exec()
     return d->processResults();
 }
 
+/*
+   Returns \c true if \a value can be passed through COPY the same way
+   EXECUTE would pass it.
+ */
+static bool qIsCopyable(const QVariant &value)
+{
+    // EXECUTE passes timestamps in UTC and lets the server convert them to
+    // the column's type; COPY into a column without time zone would drop
+    // the offset instead.
+    if (value.typeId() == QMetaType::QDateTime)
+        return false;
+    if (QSqlResultPrivate::isVariantNull(value))
+        return true;
+    switch (value.typeId()) {
+    case QMetaType::Bool:
+    case QMetaType::Float:
+    case QMetaType::Double:
+    case QMetaType::QByteArray:
+#if QT_CONFIG(datestring)
+    case QMetaType::QDate:
+    case QMetaType::QTime:
+#endif
+        return true;
+    default:
+        return value.canConvert<QString>();
+    }
+}
+
+/*
+   Appends \a value, for which qIsCopyable() returned \c true, to \a out in
+   the text format of COPY.
+ */
+static void qAppendCopyValue(const QVariant &value, QByteArray *out)
+{
+    Q_ASSERT(qIsCopyable(value));
+    if (QSqlResultPrivate::isVariantNull(value)) {
+        out->append("\\N");
+        return;
+    }
+    switch (value.typeId()) {
+    case QMetaType::Bool:
+        out->append(value.toBool() ? 't' : 'f');
+        return;
+    case QMetaType::Float:
+    case QMetaType::Double: {
+        const double d = value.toDouble();
+        if (qIsNaN(d))
+            out->append("NaN");
+        else if (qIsInf(d))
+            out->append(d < 0 ? "-Infinity" : "Infinity");
+        else
+            out->append(value.toString().toLatin1());
+        return;
+    }
+#if QT_CONFIG(datestring)
+    case QMetaType::QDate:
+        out->append(value.toDate().toString(Qt::ISODate).toLatin1());
+        return;
+    case QMetaType::QTime:
+        out->append(value.toTime().toString(u"hh:mm:ss.zzz").toLatin1());
+        return;
+#endif
+    case QMetaType::QByteArray:
+        // bytea hex input, with COPY's escaping of the leading backslash
+        out->append("\\\\x");
+        out->append(value.toByteArray().toHex());
+        return;
+    default:
+        break;
+    }
+    const QByteArray text = value.toString().toUtf8();
+    for (const char c : text) {
+        switch (c) {
+        case '\\':
+            out->append("\\\\");
+            break;
+        case '\n':
+            out->append("\\n");
+            break;
+        case '\r':
+            out->append("\\r");
+            break;
+        case '\t':
+            out->append("\\t");
+            break;
+        default:
+            out->append(c);
+            break;
+        }
+    }
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+/*
+   Waits until the socket of \a connection is readable or writable.
+ */
+static bool qWaitForSocket(PGconn *connection)
+{
+    pollfd pfd = {};
+    pfd.fd = PQsocket(connection);
+    pfd.events = POLLIN | POLLOUT;
+#ifdef Q_OS_WIN
+    return WSAPoll(&pfd, 1, -1) > 0;
+#else
+    int ret;
+    do {
+        ret = ::poll(&pfd, 1, -1);
+    } while (ret == -1 && errno == EINTR);
+    return ret > 0;
+#endif
+}
+
+/*
+   Sends everything libpq buffered for \a connection, which is in nonblocking
+   mode. Results arriving in the meantime are read into libpq's buffer, so
+   that the server never stalls on sending them while we wait for it to
+   accept more queries.
+ */
+static bool qFlushPipeline(PGconn *connection)
+{
+    for (;;) {
+        const int ret = PQflush(connection);
+        if (ret <= 0)
+            return ret == 0;
+        if (!qWaitForSocket(connection) || !PQconsumeInput(connection))
+            return false;
+    }
+}
+
+bool QPSQLResultPrivate::execPipelined(const QList<QVariantList> &columns, qsizetype rowCount)
+{
+    Q_Q(QPSQLResult);
+    QPSQLDriverPrivate *drv = drv_d_func();
+    PGconn *connection = drv->connection;
+    const auto sendError = [drv] {
+        return qMakeError(QCoreApplication::translate("QPSQLResult", "Unable to send query"),
+                          QSqlError::StatementError, drv);
+    };
+
+    drv->discardResults();
+    if (PQsetnonblocking(connection, 1) != 0 || PQenterPipelineMode(connection) != 1) {
+        PQsetnonblocking(connection, 0);
+        q->setLastError(sendError());
+        return false;
+    }
+    stmtId = drv->currentStmtId = drv->generateStatementId();
+
+    // Each window of rows runs in one implicit transaction, so a failing
+    // row rolls back the rows sent along with it, and no further windows
+    // are sent. A window that was only partly sent still ends with a sync
+    // point, and all results up to it are read, so that the connection is
+    // idle when leaving pipeline mode.
+    QSqlError error;
+    QList<QVariant> row(columns.size());
+    for (qsizetype first = 0; first < rowCount && !error.isValid(); first += PipelineWindow) {
+        const qsizetype last = qMin(first + PipelineWindow, rowCount);
+        for (qsizetype i = first; i < last && !error.isValid(); ++i) {
+            for (qsizetype j = 0; j < columns.size(); ++j)
+                row[j] = columns.at(j).at(i);
+            const QString params = qCreateParamString(row, q->driver());
+            const QString stmt = params.isEmpty()
+                    ? QStringLiteral("EXECUTE %1").arg(preparedStmtId)
+                    : QStringLiteral("EXECUTE %1 (%2)").arg(preparedStmtId, params);
+            if (!PQsendQueryParams(connection, stmt.toUtf8().constData(), 0, nullptr, nullptr,
+                                   nullptr, nullptr, 0)) {
+                error = sendError();
+            }
+        }
+
+        const bool synced = PQpipelineSync(connection) == 1 && qFlushPipeline(connection);
+        if (!synced && !error.isValid())
+            error = sendError();
+
+        // Read the results up to the sync point; a null result only
+        // separates the results of two statements. Without a sync point,
+        // two null results in a row mean that nothing is pending anymore.
+        bool previousWasNull = false;
+        while (PQstatus(connection) == CONNECTION_OK) {
+            PGresult *res = PQgetResult(connection);
+            if (!res) {
+                if (!synced && previousWasNull)
+                    break;
+                previousWasNull = true;
+                continue;
+            }
+            previousWasNull = false;
+            const ExecStatusType status = PQresultStatus(res);
+            if (status == PGRES_PIPELINE_SYNC) {
+                PQclear(res);
+                break;
+            }
+            if (status == PGRES_PIPELINE_ABORTED) {
+                PQclear(res);
+            } else if (status != PGRES_COMMAND_OK && status != PGRES_TUPLES_OK) {
+                if (!error.isValid()) {
+                    error = qMakeError(QCoreApplication::translate("QPSQLResult",
+                                       "Unable to execute statement"), QSqlError::StatementError,
+                                       drv, res);
+                }
+                PQclear(res);
+            } else {
+                if (result)
+                    PQclear(result);
+                result = res;
+            }
+        }
+        if (PQstatus(connection) != CONNECTION_OK && !error.isValid()) {
+            error = qMakeError(QCoreApplication::translate("QPSQLResult",
+                               "Unable to execute statement"), QSqlError::StatementError, drv);
+        }
+    }
+
+    PQexitPipelineMode(connection);
+    PQsetnonblocking(connection, 0);
+    drv->checkPendingNotifications();
+    if (error.isValid()) {
+        q->setLastError(error);
+        q->setActive(false);
+        return false;
+    }
+    return processResults();
+}
+#endif // LIBPQ_HAS_PIPELINING
+
+bool QPSQLResultPrivate::execCopy(const QList<QVariantList> &columns, qsizetype rowCount)
+{
+    Q_Q(QPSQLResult);
+    QPSQLDriverPrivate *drv = drv_d_func();
+    PGconn *connection = drv->connection;
+
+    PGresult *res = drv->exec(copyStmt);
+    stmtId = drv->currentStmtId;
+    if (PQresultStatus(res) != PGRES_COPY_IN) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                   "Unable to start COPY"), QSqlError::StatementError, drv, res));
+        PQclear(res);
+        return false;
+    }
+    PQclear(res);
+
+    // the caller checked all values with qIsCopyable(), so sending only
+    // fails if the connection does
+    QByteArray buffer;
+    buffer.reserve(CopyChunkSize + 1024);
+    bool sent = true;
+    for (qsizetype i = 0; i < rowCount && sent; ++i) {
+        for (qsizetype j = 0; j < columns.size(); ++j) {
+            if (j)
+                buffer.append('\t');
+            qAppendCopyValue(columns.at(j).at(i), &buffer);
+        }
+        buffer.append('\n');
+        if (buffer.size() >= CopyChunkSize || i == rowCount - 1) {
+            sent = PQputCopyData(connection, buffer.constData(), int(buffer.size())) == 1;
+            buffer.clear();
+        }
+    }
+    if (sent)
+        sent = PQputCopyEnd(connection, nullptr) == 1;
+    if (!sent) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                   "Unable to send COPY data"), QSqlError::StatementError, drv));
+        drv->discardResults();
+        return false;
+    }
+
+    result = PQgetResult(connection);
+    drv->discardResults();
+    drv->checkPendingNotifications();
+    return processResults();
+}
+
+bool QPSQLResult::execBatch(bool arrayBind)
+{
+    Q_D(QPSQLResult);
+    if (!d->preparedQueriesEnabled)
+        return QSqlResult::execBatch(arrayBind);
+
+    const QList<QVariant> values = boundValues();
+    if (values.isEmpty())
+        return false;
+    QList<QVariantList> columns;
+    columns.reserve(values.size());
+    for (const QVariant &value : values)
+        columns.append(value.toList());
+    const qsizetype rowCount = columns.constFirst().size();
+    for (const QVariantList &column : std::as_const(columns)) {
+        if (column.size() != rowCount) {
+            setLastError(QSqlError(QString(), QCoreApplication::translate("QPSQLResult",
+                                   "Bound value lists differ in length"),
+                                   QSqlError::StatementError));
+            return false;
+        }
+    }
+
+    // COPY is only used when asked for, since it e.g. bypasses INSERT rules,
+    // and only if every single value can be sent with it
+    const bool useCopy = arrayBind && !d->copyStmt.isEmpty()
+            && std::all_of(columns.cbegin(), columns.cend(), [](const QVariantList &column) {
+                   return std::all_of(column.cbegin(), column.cend(), qIsCopyable);
+               });
+#ifndef LIBPQ_HAS_PIPELINING
+    if (!useCopy)
+        return QSqlResult::execBatch(arrayBind);
+#endif
+
+    cleanup();
+#ifdef LIBPQ_HAS_PIPELINING
+    if (!useCopy)
+        return d->execPipelined(columns, rowCount);
+#endif
+    return d->execCopy(columns, rowCount);
+}
+
 ///////////////////////////////////////////////////////////////////
 
 bool QPSQLDriverPrivate::setEncodingUtf8()
@@ -28,6 +28,7 @@
 #endif
 
 #include <sqlite3.h>
+#include <algorithm>
 #include <functional>
 
 Q_DECLARE_OPAQUE_POINTER(sqlite3*)
@@ -117,6 +118,7 @@ public:
     sqlite3 *access = nullptr;
     QList<QSQLiteResult *> results;
     QStringList notificationid;
+    bool atomicBatch = false;
 };
 
 
@@ -132,6 +134,8 @@ public:
     // initializes the recordInfo and the cache
     void initColumns(bool emptyResultset);
     void finalize();
+    int bindValue(int index, const QVariant &value);
+    bool execBatchNative(const QList<QVariant> &values);
 
     sqlite3_stmt *stmt = nullptr;
     QSqlRecord rInf;
@@ -314,6 +318,64 @@ bool QSQLiteResultPrivate::fetchNext(QSqlCachedResult::ValueCache &values, int i
     return false;
 }
 
+int QSQLiteResultPrivate::bindValue(int index, const QVariant &value)
+{
+    int res = SQLITE_OK;
+    if (QSqlResultPrivate::isVariantNull(value)) {
+        res = sqlite3_bind_null(stmt, index);
+    } else {
+        switch (value.userType()) {
+        case QMetaType::QByteArray: {
+            const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
+            res = sqlite3_bind_blob(stmt, index, ba->constData(),
+                                    ba->size(), SQLITE_STATIC);
+            break; }
+        case QMetaType::Int:
+        case QMetaType::Bool:
+            res = sqlite3_bind_int(stmt, index, value.toInt());
+            break;
+        case QMetaType::Double:
+            res = sqlite3_bind_double(stmt, index, value.toDouble());
+            break;
+        case QMetaType::UInt:
+        case QMetaType::LongLong:
+            res = sqlite3_bind_int64(stmt, index, value.toLongLong());
+            break;
+        case QMetaType::QDateTime: {
+            const QDateTime dateTime = value.toDateTime();
+            const QString str = dateTime.toString(Qt::ISODateWithMs);
+            res = sqlite3_bind_text16(stmt, index, str.data(),
+                                      int(str.size() * sizeof(ushort)),
+                                      SQLITE_TRANSIENT);
+            break;
+        }
+        case QMetaType::QTime: {
+            const QTime time = value.toTime();
+            const QString str = time.toString(u"hh:mm:ss.zzz");
+            res = sqlite3_bind_text16(stmt, index, str.data(),
+                                      int(str.size() * sizeof(ushort)),
+                                      SQLITE_TRANSIENT);
+            break;
+        }
+        case QMetaType::QString: {
+            // lifetime of string == lifetime of its qvariant
+            const QString *str = static_cast<const QString*>(value.constData());
+            res = sqlite3_bind_text16(stmt, index, str->unicode(),
+                                      int(str->size()) * sizeof(QChar),
+                                      SQLITE_STATIC);
+            break; }
+        default: {
+            const QString str = value.toString();
+            // SQLITE_TRANSIENT makes sure that sqlite buffers the data
+            res = sqlite3_bind_text16(stmt, index, str.data(),
+                                      int(str.size()) * sizeof(QChar),
+                                      SQLITE_TRANSIENT);
+            break; }
+        }
+    }
+    return res;
+}
+
 QSQLiteResult::QSQLiteResult(const QSQLiteDriver* db)
     : QSqlCachedResult(*new QSQLiteResultPrivate(this, db))
 {
@@ -376,15 +438,106 @@ bool QSQLiteResult::prepare(const QString &query)
     return true;
 }
 
+bool QSQLiteResultPrivate::execBatchNative(const QList<QVariant> &values)
+{
+    Q_Q(QSQLiteResult);
+    sqlite3 *access = drv_d_func()->access;
+
+    // the bound list of values of each parameter; a named placeholder that
+    // is used more than once is only one parameter to SQLite
+    const int paramCount = sqlite3_bind_parameter_count(stmt);
+    QList<QVariantList> columns;
+    columns.reserve(paramCount);
+    for (int i = 0; i < paramCount; ++i) {
+        qsizetype column = i;
+        if (paramCount != values.size()) {
+            const char *name = sqlite3_bind_parameter_name(stmt, i + 1);
+            const QList<int> positions = name ? indexes.value(QString::fromUtf8(name))
+                                              : QList<int>();
+            column = positions.isEmpty() ? values.size() : positions.first();
+        }
+        if (column >= values.size())
+            break;
+        columns.append(values.at(column).toList());
+    }
+    const qsizetype rowCount = columns.isEmpty() ? 0 : columns.constFirst().size();
+    const bool sameSize = std::all_of(columns.cbegin(), columns.cend(),
+                                      [rowCount](const QVariantList &column) {
+                                          return column.size() == rowCount;
+                                      });
+    if (columns.size() != paramCount || !sameSize) {
+        q->setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
+                        "Parameter count mismatch"), QString(), QSqlError::StatementError));
+        return false;
+    }
+
+    // Outside of a transaction, every row would otherwise be committed on
+    // its own. Releasing the savepoint commits the rows that succeeded, as
+    // exec() would have; with QSQLITE_ATOMIC_BATCH a failure undoes them.
+    const bool savepoint =
+            sqlite3_exec(access, "SAVEPOINT qt_batch", nullptr, nullptr, nullptr) == SQLITE_OK;
+    QSqlError error;
+    for (qsizetype row = 0; row < rowCount && !error.isValid(); ++row) {
+        sqlite3_reset(stmt);
+        for (int i = 0; i < paramCount; ++i) {
+            const int res = bindValue(i + 1, columns.at(i).at(row));
+            if (res != SQLITE_OK) {
+                error = qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                                   "Unable to bind parameters"), QSqlError::StatementError, res);
+                break;
+            }
+        }
+        if (error.isValid())
+            break;
+        const int res = sqlite3_step(stmt);
+        if (res != SQLITE_DONE && res != SQLITE_ROW) {
+            error = qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                               "Unable to fetch row"), QSqlError::ConnectionError, res);
+        }
+    }
+    sqlite3_reset(stmt);
+    // the bound strings and blobs belong to columns
+    sqlite3_clear_bindings(stmt);
+
+    if (savepoint) {
+        if (error.isValid() && drv_d_func()->atomicBatch)
+            sqlite3_exec(access, "ROLLBACK TO qt_batch", nullptr, nullptr, nullptr);
+        const int res = sqlite3_exec(access, "RELEASE qt_batch", nullptr, nullptr, nullptr);
+        if (res != SQLITE_OK && !error.isValid()) {
+            error = qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                               "Unable to commit batch"), QSqlError::TransactionError, res);
+            sqlite3_exec(access, "ROLLBACK TO qt_batch", nullptr, nullptr, nullptr);
+            sqlite3_exec(access, "RELEASE qt_batch", nullptr, nullptr, nullptr);
+        }
+    }
+
+    q->setLastError(error);
+    q->setSelect(false);
+    q->setActive(!error.isValid());
+    return !error.isValid();
+}
+
 bool QSQLiteResult::execBatch(bool arrayBind)
 {
     Q_UNUSED(arrayBind);
-    Q_D(QSqlResult);
-    QScopedValueRollback<QList<QVariant>> valuesScope(d->values);
-    QList<QVariant> values = d->values;
+    Q_D(QSQLiteResult);
+    const QList<QVariant> values = d->values;
     if (values.size() == 0)
         return false;
 
+    // Statements returning rows go through exec(), so that the rows of the
+    // last execution can be read.
+    if (d->stmt && sqlite3_column_count(d->stmt) == 0
+            && sqlite3_bind_parameter_count(d->stmt) > 0) {
+        d->skippedStatus = false;
+        d->skipRow = false;
+        d->rInf.clear();
+        clearValues();
+        return d->execBatchNative(values);
+    }
+
+    QScopedValueRollback<QList<QVariant>> valuesScope(d->values);
+
     for (int i = 0; i < values.at(0).toList().size(); ++i) {
         d->values.clear();
         QScopedValueRollback<QHash<QString, QList<int>>> indexesScope(d->indexes);
@@ -462,61 +615,7 @@ bool QSQLiteResult::exec()
 
     if (paramCountIsValid) {
         for (int i = 0; i < paramCount; ++i) {
-            res = SQLITE_OK;
-            const QVariant &value = values.at(i);
-
-            if (QSqlResultPrivate::isVariantNull(value)) {
-                res = sqlite3_bind_null(d->stmt, i + 1);
-            } else {
-                switch (value.userType()) {
-                case QMetaType::QByteArray: {
-                    const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
-                    res = sqlite3_bind_blob(d->stmt, i + 1, ba->constData(),
-                                            ba->size(), SQLITE_STATIC);
-                    break; }
-                case QMetaType::Int:
-                case QMetaType::Bool:
-                    res = sqlite3_bind_int(d->stmt, i + 1, value.toInt());
-                    break;
-                case QMetaType::Double:
-                    res = sqlite3_bind_double(d->stmt, i + 1, value.toDouble());
-                    break;
-                case QMetaType::UInt:
-                case QMetaType::LongLong:
-                    res = sqlite3_bind_int64(d->stmt, i + 1, value.toLongLong());
-                    break;
-                case QMetaType::QDateTime: {
-                    const QDateTime dateTime = value.toDateTime();
-                    const QString str = dateTime.toString(Qt::ISODateWithMs);
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.data(),
-                                              int(str.size() * sizeof(ushort)),
-                                              SQLITE_TRANSIENT);
-                    break;
-                }
-                case QMetaType::QTime: {
-                    const QTime time = value.toTime();
-                    const QString str = time.toString(u"hh:mm:ss.zzz");
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.data(),
-                                              int(str.size() * sizeof(ushort)),
-                                              SQLITE_TRANSIENT);
-                    break;
-                }
-                case QMetaType::QString: {
-                    // lifetime of string == lifetime of its qvariant
-                    const QString *str = static_cast<const QString*>(value.constData());
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str->unicode(),
-                                              int(str->size()) * sizeof(QChar),
-                                              SQLITE_STATIC);
-                    break; }
-                default: {
-                    const QString str = value.toString();
-                    // SQLITE_TRANSIENT makes sure that sqlite buffers the data
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.data(),
-                                              int(str.size()) * sizeof(QChar),
-                                              SQLITE_TRANSIENT);
-                    break; }
-                }
-            }
+            res = d->bindValue(i + 1, values.at(i));
             if (res != SQLITE_OK) {
                 setLastError(qMakeError(d->drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
                              "Unable to bind parameters"), QSqlError::StatementError, res));
@@ -717,6 +816,7 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
     bool useExtendedResultCodes = true;
     bool useQtVfs = false;
     bool useQtCaseFolding = false;
+    bool atomicBatch = false;
 #if QT_CONFIG(regularexpression)
     static const auto regexpConnectOption = "QSQLITE_ENABLE_REGEXP"_L1;
     bool defineRegexp = false;
@@ -746,6 +846,8 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
             useExtendedResultCodes = false;
         } else if (option == "QSQLITE_ENABLE_NON_ASCII_CASE_FOLDING"_L1) {
             useQtCaseFolding = true;
+        } else if (option == "QSQLITE_ATOMIC_BATCH"_L1) {
+            atomicBatch = true;
         }
 #if QT_CONFIG(regularexpression)
         else if (option.startsWith(regexpConnectOption)) {
@@ -777,6 +879,7 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
     if (res == SQLITE_OK) {
         sqlite3_busy_timeout(d->access, timeOut);
         sqlite3_extended_result_codes(d->access, useExtendedResultCodes);
+        d->atomicBatch = atomicBatch;
         setOpen(true);
         setOpenError(false);
 #if QT_CONFIG(regularexpression)
@@ -14,17 +14,192 @@ QT_BEGIN_NAMESPACE
    backwards over the results again.
 
    All you need to do is to inherit from QSqlCachedResult and reimplement
-   gotoNext(). gotoNext() will have a reference to the internal cache and
+   gotoNext(). gotoNext() will have a reference to a one row buffer and
    will give you an index where you can start filling in your data. Special
    case: If the user actually wants a forward-only query, idx will be -1
    to indicate that we are not interested in the actual values.
+
+   Once a row is fetched, its values are moved out of the buffer into one
+   QSqlCachedColumn per column. A column keeps values of a trivially
+   copyable type in a flat array and strings and byte arrays back to back
+   in an arena, so no QVariant is kept around per cell; data() creates
+   one on demand. Columns that mix types fall back to storing QVariants.
 */
 
-static constexpr qsizetype initial_cache_size = 128;
+static bool isFixedSize(QMetaType type)
+{
+    constexpr auto complexFlags = QMetaType::NeedsCopyConstruction
+            | QMetaType::NeedsDestruction | QMetaType::IsPointer;
+    return !(type.flags() & complexFlags) && type.sizeOf() > 0 && type.sizeOf() <= 16
+            && type.alignOf() <= qsizetype(alignof(quint64));
+}
+
+// pointer values are stored as they are, a null pointer is not a null row
+static bool isNullValue(const QVariant &value)
+{
+    return value.isNull() && !(value.metaType().flags() & QMetaType::IsPointer);
+}
+
+void QSqlCachedColumn::append(QVariant &&value)
+{
+    const bool null = isNullValue(value);
+    if (storage == Unknown && !null)
+        setStorage(value.metaType());
+    if (storage != Variant && !canStore(value, null))
+        convertToVariants();
+
+    if (storage == Variant) {
+        variants.append(std::move(value));
+        ++count;
+        return;
+    }
+    if (null) {
+        nullType = value.metaType();
+        hasNullType = true;
+        appendNull();
+        return;
+    }
+
+    switch (storage) {
+    case Fixed: {
+        const qsizetype offset = fixedValues.size();
+        fixedValues.resize(offset + fixedStride);
+        memcpy(fixedValues.data() + offset, value.constData(), valueType.sizeOf());
+        break;
+    }
+    case String:
+        strings.append(*static_cast<const QString *>(value.constData()));
+        ends.append(strings.size());
+        break;
+    case Bytes:
+        bytes.append(*static_cast<const QByteArray *>(value.constData()));
+        ends.append(bytes.size());
+        break;
+    case Unknown:
+    case Variant:
+        Q_UNREACHABLE();
+    }
+    nulls.append(false);
+    ++count;
+}
+
+QVariant QSqlCachedColumn::value(qsizetype row) const
+{
+    Q_ASSERT(row >= 0 && row < count);
+    if (storage == Variant)
+        return variants.at(row);
+    if (nulls.at(row))
+        return QVariant(nullType);
+
+    const qsizetype begin = row ? ends.value(row - 1) : 0;
+    switch (storage) {
+    case Fixed:
+        return QVariant(valueType, fixedValues.constData() + row * fixedStride);
+    case String:
+        return QString(strings.constData() + begin, ends.at(row) - begin);
+    case Bytes:
+        return bytes.mid(begin, ends.at(row) - begin);
+    case Unknown:
+    case Variant:
+        break;
+    }
+    Q_UNREACHABLE_RETURN(QVariant());
+}
+
+bool QSqlCachedColumn::isNull(qsizetype row) const
+{
+    Q_ASSERT(row >= 0 && row < count);
+    if (storage == Variant)
+        return variants.at(row).isNull();
+    return nulls.at(row);
+}
+
+void QSqlCachedColumn::clear()
+{
+    *this = QSqlCachedColumn();
+}
+
+bool QSqlCachedColumn::canStore(const QVariant &value, bool null) const
+{
+    if (null)
+        return !hasNullType || value.metaType() == nullType;
+    if (value.metaType() != valueType)
+        return false;
+    // a null string or byte array is not a null row, but the arena can't tell
+    switch (storage) {
+    case String:
+        return !static_cast<const QString *>(value.constData())->isNull();
+    case Bytes:
+        return !static_cast<const QByteArray *>(value.constData())->isNull();
+    default:
+        return true;
+    }
+}
+
+void QSqlCachedColumn::setStorage(QMetaType type)
+{
+    Q_ASSERT(storage == Unknown);
+    valueType = type;
+    if (type == QMetaType::fromType<QString>()) {
+        storage = String;
+    } else if (type == QMetaType::fromType<QByteArray>()) {
+        storage = Bytes;
+    } else if (isFixedSize(type)) {
+        storage = Fixed;
+        fixedStride = (type.sizeOf() + sizeof(quint64) - 1) / sizeof(quint64);
+    } else {
+        convertToVariants();
+        return;
+    }
+
+    // the rows so far were all null
+    if (storage == Fixed)
+        fixedValues.resize(count * fixedStride);
+    else
+        ends.resize(count);
+}
+
+void QSqlCachedColumn::convertToVariants()
+{
+    QList<QVariant> converted;
+    converted.reserve(count);
+    for (qsizetype row = 0; row < count; ++row)
+        converted.append(value(row));
+
+    nulls = QList<bool>();
+    fixedValues = QList<quint64>();
+    strings = QString();
+    bytes = QByteArray();
+    ends = QList<qsizetype>();
+    variants = std::move(converted);
+    storage = Variant;
+}
+
+void QSqlCachedColumn::appendNull()
+{
+    switch (storage) {
+    case Fixed:
+        fixedValues.resize(fixedValues.size() + fixedStride);
+        break;
+    case String:
+    case Bytes:
+        ends.append(ends.isEmpty() ? 0 : ends.last());
+        break;
+    case Unknown:
+        break;
+    case Variant:
+        Q_UNREACHABLE();
+    }
+    nulls.append(true);
+    ++count;
+}
+
+//////////////
 
 void QSqlCachedResultPrivate::cleanup()
 {
     cache.clear();
+    columns.clear();
     atEnd = false;
     colCount = 0;
     rowCacheEnd = 0;
@@ -36,24 +211,18 @@ void QSqlCachedResultPrivate::init(int count, bool fo)
     cleanup();
     forwardOnly = fo;
     colCount = count;
-    if (fo) {
-        cache.resize(count);
+    cache.resize(count);
+    columns.resize(count);
+    if (fo)
         rowCacheEnd = count;
-    } else {
-        cache.resize(initial_cache_size * count);
-    }
 }
 
 int QSqlCachedResultPrivate::nextIndex()
 {
-    if (forwardOnly)
-        return 0;
-    int newIdx = rowCacheEnd;
-    if (newIdx + colCount > cache.size())
-        cache.resize(qMin(cache.size() * 2, cache.size() + 10000));
-    rowCacheEnd += colCount;
-
-    return newIdx;
+    // gotoNext() always fills in the start of the buffer, storeRow() empties it
+    if (!forwardOnly)
+        rowCacheEnd += colCount;
+    return 0;
 }
 
 bool QSqlCachedResultPrivate::canSeek(int i) const
@@ -70,6 +239,12 @@ void QSqlCachedResultPrivate::revertLast()
     rowCacheEnd -= colCount;
 }
 
+void QSqlCachedResultPrivate::storeRow()
+{
+    for (int i = 0; i < colCount; ++i)
+        columns[i].append(std::move(cache[i]));
+}
+
 inline int QSqlCachedResultPrivate::cacheCount() const
 {
     Q_ASSERT(!forwardOnly);
@@ -185,7 +360,7 @@ QVariant QSqlCachedResult::data(int i)
     if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
         return QVariant();
 
-    return d->cache.at(idx);
+    return d->forwardOnly ? d->cache.at(idx) : d->columns.at(i).value(at());
 }
 
 bool QSqlCachedResult::isNull(int i)
@@ -195,7 +370,7 @@ bool QSqlCachedResult::isNull(int i)
     if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
         return true;
 
-    return d->cache.at(idx).isNull();
+    return d->forwardOnly ? d->cache.at(idx).isNull() : d->columns.at(i).isNull(at());
 }
 
 void QSqlCachedResult::cleanup()
@@ -212,6 +387,8 @@ void QSqlCachedResult::clearValues()
     setAt(QSql::BeforeFirstRow);
     d->rowCacheEnd = 0;
     d->atEnd = false;
+    for (QSqlCachedColumn &column : d->columns)
+        column.clear();
 }
 
 bool QSqlCachedResult::cacheNext()
@@ -229,6 +406,8 @@ bool QSqlCachedResult::cacheNext()
         d->atEnd = true;
         return false;
     }
+    if (!d->forwardOnly)
+        d->storeRow();
     setAt(at() + 1);
     return true;
 }
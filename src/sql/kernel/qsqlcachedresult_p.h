@@ -18,12 +18,14 @@
 #include <QtSql/private/qtsqlglobal_p.h>
 #include "QtSql/qsqlresult.h"
 #include "QtSql/private/qsqlresult_p.h"
-#include <QtCore/qcontainerfwd.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmetatype.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
 
 QT_BEGIN_NAMESPACE
 
-class QVariant;
-
 class QSqlCachedResultPrivate;
 
 class Q_SQL_EXPORT QSqlCachedResult: public QSqlResult
@@ -60,6 +62,43 @@ private:
     bool cacheNext();
 };
 
+class QSqlCachedColumn
+{
+public:
+    void append(QVariant &&value);
+    QVariant value(qsizetype row) const;
+    bool isNull(qsizetype row) const;
+    void clear();
+
+private:
+    enum Storage : quint8 {
+        Unknown,    // only nulls so far
+        Fixed,      // trivially copyable values of valueType in fixedValues
+        String,     // QStrings in the strings arena
+        Bytes,      // QByteArrays in the bytes arena
+        Variant     // anything else, one QVariant per row
+    };
+
+    bool canStore(const QVariant &value, bool null) const;
+    void setStorage(QMetaType type);
+    void convertToVariants();
+    void appendNull();
+
+    QList<bool> nulls;
+    QList<quint64> fixedValues;     // fixedStride words per row
+    QString strings;
+    QByteArray bytes;
+    QList<qsizetype> ends;          // end offset of each row in strings or bytes
+    QList<QVariant> variants;
+    QMetaType valueType;
+    QMetaType nullType;
+    qsizetype count = 0;
+    qsizetype fixedStride = 0;
+    Storage storage = Unknown;
+    bool hasNullType = false;
+};
+Q_DECLARE_TYPEINFO(QSqlCachedColumn, Q_RELOCATABLE_TYPE);
+
 class Q_SQL_EXPORT QSqlCachedResultPrivate: public QSqlResultPrivate
 {
     Q_DECLARE_PUBLIC(QSqlCachedResult)
@@ -73,8 +112,11 @@ public:
     void cleanup();
     int nextIndex();
     void revertLast();
+    void storeRow();
 
+    // for forward-only results the current row, otherwise the row gotoNext() is filling in
     QSqlCachedResult::ValueCache cache;
+    QList<QSqlCachedColumn> columns;
     int rowCacheEnd = 0;
     int colCount = 0;
     bool atEnd = false;
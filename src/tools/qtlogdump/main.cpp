@@ -0,0 +1,90 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+
+#include <private/qstructuredlogging_p.h>
+
+#include <stdio.h>
+
+QT_USE_NAMESPACE
+
+using namespace Qt::StringLiterals;
+
+static const char *typeName(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:    return "debug";
+    case QtInfoMsg:     return "info";
+    case QtWarningMsg:  return "warning";
+    case QtCriticalMsg: return "critical";
+    case QtFatalMsg:    return "fatal";
+    }
+    return "unknown";
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(u"Renders the binary output of the qCStructured logging "
+                                     "macros (see QT_LOGGING_STRUCTURED_FILE) as text."_s);
+    parser.addHelpOption();
+    parser.addPositionalArgument(u"file"_s, u"The structured log file to render."_s);
+
+    QCommandLineOption absoluteTimeOption(u"absolute-time"_s,
+                                          u"Print the date and time of each message, instead "
+                                          "of the seconds since the log was started."_s);
+    parser.addOption(absoluteTimeOption);
+    QCommandLineOption locationOption(u"location"_s,
+                                      u"Print the source location of each message."_s);
+    parser.addOption(locationOption);
+    parser.process(app);
+
+    const QStringList files = parser.positionalArguments();
+    if (files.size() != 1)
+        parser.showHelp(EXIT_FAILURE);
+
+    QFile file(files.first());
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "qtlogdump: cannot open %s: %s\n", qPrintable(file.fileName()),
+                qPrintable(file.errorString()));
+        return EXIT_FAILURE;
+    }
+
+    QStructuredLogReader reader(file.readAll());
+    if (!reader.isValid()) {
+        fprintf(stderr, "qtlogdump: %s is not a structured log file\n",
+                qPrintable(file.fileName()));
+        return EXIT_FAILURE;
+    }
+
+    const bool absoluteTime = parser.isSet(absoluteTimeOption);
+    const bool location = parser.isSet(locationOption);
+    const QDateTime startTime = reader.startTime().toLocalTime();
+    QStructuredLogReader::Message message;
+    while (reader.readNext(&message)) {
+        if (absoluteTime) {
+            const QDateTime time = startTime.addMSecs(message.timestamp / (1000 * 1000));
+            printf("%s", qPrintable(time.toString(Qt::ISODateWithMs)));
+        } else {
+            const qint64 us = message.timestamp / 1000;
+            printf("%6lld.%06lld", us / (1000 * 1000), us % (1000 * 1000));
+        }
+        printf(" [%llx] %s.%s: %s", message.threadId, message.category.constData(),
+               typeName(message.type), qPrintable(message.message));
+        if (location)
+            printf(" (%s:%d)", message.file.constData(), message.line);
+        putchar('\n');
+    }
+
+    if (reader.hasError()) {
+        fprintf(stderr, "qtlogdump: %s is corrupt or truncated\n", qPrintable(file.fileName()));
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
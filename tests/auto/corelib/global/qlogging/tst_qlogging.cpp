@@ -37,6 +37,8 @@ private slots:
     void qMessagePattern_data();
     void qMessagePattern();
     void setMessagePattern();
+    void asynchronousOutput_data();
+    void asynchronousOutput();
 
     void formatLogMessage_data();
     void formatLogMessage();
@@ -914,6 +916,45 @@ void tst_qmessagehandler::setMessagePattern()
 #endif // QT_CONFIG(process)
 }
 
+void tst_qmessagehandler::asynchronousOutput_data()
+{
+    QTest::addColumn<QString>("mode");
+
+    QTest::newRow("block") << "block";
+    QTest::newRow("drop") << "drop";
+    QTest::newRow("count") << "count";
+}
+
+void tst_qmessagehandler::asynchronousOutput()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+#ifdef Q_OS_ANDROID
+    QSKIP("This test crashes on Android");
+#endif
+    QFETCH(QString, mode);
+
+    // the output, including the order of the messages, is the same as the
+    // synchronous output
+    auto runHelper = [this](const QString &mode) {
+        QProcess process;
+        QProcessEnvironment environment = m_baseEnvironment;
+        if (!mode.isEmpty())
+            environment.insert("QT_LOGGING_ASYNC", mode);
+        process.setProcessEnvironment(environment);
+        process.start(backtraceHelperPath());
+        if (!process.waitForStarted() || !process.waitForFinished())
+            return QByteArray();
+        return process.readAllStandardError();
+    };
+
+    const QByteArray expected = runHelper(QString());
+    QVERIFY(!expected.isEmpty());
+    QCOMPARE(QString::fromLatin1(runHelper(mode)), QString::fromLatin1(expected));
+#endif // QT_CONFIG(process)
+}
+
 Q_DECLARE_METATYPE(QtMsgType)
 
 void tst_qmessagehandler::formatLogMessage_data()
@@ -0,0 +1,214 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QFile>
+#include <QScopeGuard>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QtCore/qstructuredlogging.h>
+
+#include <private/qstructuredlogging_p.h>
+
+using namespace Qt::StringLiterals;
+
+Q_LOGGING_CATEGORY(lcStructured, "tst.structured")
+
+enum class Color : quint8 { Red = 1, Green = 2 };
+
+class tst_QStructuredLogging : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void cleanup();
+    void text();
+    void disabledCategory();
+    void binary();
+    void threads();
+    void corrupt();
+
+private:
+    struct Message
+    {
+        QtMsgType type;
+        QByteArray category;
+        QString text;
+    };
+    static QList<Message> messages;
+    static void handler(QtMsgType type, const QMessageLogContext &context, const QString &text)
+    {
+        messages.append({ type, context.category, text });
+    }
+};
+
+QList<tst_QStructuredLogging::Message> tst_QStructuredLogging::messages;
+
+void tst_QStructuredLogging::cleanup()
+{
+    QLoggingCategory::setStructuredOutputFile(QString());
+    messages.clear();
+}
+
+void tst_QStructuredLogging::text()
+{
+    // without structured output, the messages go to the message handler
+    const QtMessageHandler oldHandler = qInstallMessageHandler(handler);
+    const auto restore = qScopeGuard([&] { qInstallMessageHandler(oldHandler); });
+
+    const int *pointer = reinterpret_cast<const int *>(quintptr(0x1234));
+    qCStructuredDebug(lcStructured, "no arguments");
+    qCStructuredInfo(lcStructured, "%2 before %1", 1, -2);
+    qCStructuredWarning(lcStructured, "%1 %2 %3 %4", true, 2.5, Color::Green, pointer);
+    qCStructuredCritical(lcStructured, "%1, %2, %3, %4, %5", "c-string", u"string"_s,
+                         "latin1"_L1, QByteArray("bytes"), QStringView(u"view"));
+    qCStructuredDebug(lcStructured, "%1%%5 %0 %3", 100);
+
+    QCOMPARE(messages.size(), 5);
+    QCOMPARE(messages.at(0).type, QtDebugMsg);
+    QCOMPARE(messages.at(0).category, "tst.structured"_ba);
+    QCOMPARE(messages.at(0).text, u"no arguments"_s);
+    QCOMPARE(messages.at(1).type, QtInfoMsg);
+    QCOMPARE(messages.at(1).text, u"-2 before 1"_s);
+    QCOMPARE(messages.at(2).type, QtWarningMsg);
+    QCOMPARE(messages.at(2).text, u"true 2.5 2 0x1234"_s);
+    QCOMPARE(messages.at(3).type, QtCriticalMsg);
+    QCOMPARE(messages.at(3).text, u"c-string, string, latin1, bytes, view"_s);
+    QCOMPARE(messages.at(4).text, u"100%%5 %0 %3"_s);
+}
+
+void tst_QStructuredLogging::disabledCategory()
+{
+    QLoggingCategory category("tst.structured.disabled", QtWarningMsg);
+    int evaluated = 0;
+    auto argument = [&evaluated] { return ++evaluated; };
+    qCStructuredDebug(category, "%1", argument());
+    qCStructuredInfo(category, "%1", argument());
+    QCOMPARE(evaluated, 0);
+
+    const QtMessageHandler oldHandler = qInstallMessageHandler(handler);
+    qCStructuredWarning(category, "%1", argument());
+    qInstallMessageHandler(oldHandler);
+    QCOMPARE(evaluated, 1);
+    QCOMPARE(messages.size(), 1);
+}
+
+void tst_QStructuredLogging::binary()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(u"log.bin"_s);
+    QVERIFY(QLoggingCategory::setStructuredOutputFile(fileName));
+
+    // nothing goes to the message handler
+    const QtMessageHandler oldHandler = qInstallMessageHandler(handler);
+    for (int i = 0; i < 3; ++i)
+        qCStructuredDebug(lcStructured, "iteration %1 of %2", i, 3u);
+    const int line = __LINE__ + 1;
+    qCStructuredWarning(lcStructured, "%1 %2 %3 %4 %5", false, -0.25, u"grüß"_s,
+                        "caf\xc3\xa9", "latin1"_L1);
+    QLoggingCategory other("tst.structured.other");
+    qCStructuredCritical(other, "pointer %1", static_cast<void *>(nullptr));
+    qInstallMessageHandler(oldHandler);
+    QVERIFY(messages.isEmpty());
+
+    QVERIFY(QLoggingCategory::setStructuredOutputFile(QString()));
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QStructuredLogReader reader(file.readAll());
+    QVERIFY(reader.isValid());
+    QVERIFY(qAbs(reader.startTime().secsTo(QDateTime::currentDateTime())) < 60);
+
+    QStructuredLogReader::Message message;
+    qint64 lastTimestamp = -1;
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(reader.readNext(&message));
+        QCOMPARE(message.type, QtDebugMsg);
+        QCOMPARE(message.category, "tst.structured"_ba);
+        QCOMPARE(message.message, u"iteration %1 of 3"_s.arg(i));
+        QVERIFY(message.timestamp >= lastTimestamp);
+        lastTimestamp = message.timestamp;
+    }
+
+    QVERIFY(reader.readNext(&message));
+    QCOMPARE(message.type, QtWarningMsg);
+    QCOMPARE(message.message, u"false -0.25 grüß café latin1"_s);
+    QCOMPARE(message.line, line);
+    QVERIFY(message.file.endsWith("tst_qstructuredlogging.cpp"));
+
+    QVERIFY(reader.readNext(&message));
+    QCOMPARE(message.type, QtCriticalMsg);
+    QCOMPARE(message.category, "tst.structured.other"_ba);
+    QCOMPARE(message.message, u"pointer 0x0"_s);
+
+    QVERIFY(!reader.readNext(&message));
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QStructuredLogging::threads()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(u"log.bin"_s);
+    QVERIFY(QLoggingCategory::setStructuredOutputFile(fileName));
+
+    constexpr int ThreadCount = 4;
+    constexpr int MessageCount = 1000;
+    QList<QThread *> threads;
+    for (int t = 0; t < ThreadCount; ++t) {
+        threads.append(QThread::create([t] {
+            for (int i = 0; i < MessageCount; ++i)
+                qCStructuredDebug(lcStructured, "thread %1 message %2", t, i);
+        }));
+        threads.last()->start();
+    }
+    for (QThread *thread : std::as_const(threads)) {
+        QVERIFY(thread->wait());
+        delete thread;
+    }
+    QVERIFY(QLoggingCategory::setStructuredOutputFile(QString()));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QStructuredLogReader reader(file.readAll());
+    QStructuredLogReader::Message message;
+    QList<int> next(ThreadCount, 0);
+    int count = 0;
+    while (reader.readNext(&message)) {
+        const QStringList words = message.message.split(u' ');
+        QCOMPARE(words.size(), 4);
+        const int t = words.at(1).toInt();
+        QCOMPARE(words.at(3).toInt(), next[t]++);
+        ++count;
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(count, ThreadCount * MessageCount);
+}
+
+void tst_QStructuredLogging::corrupt()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(u"log.bin"_s);
+    QVERIFY(QLoggingCategory::setStructuredOutputFile(fileName));
+    qCStructuredDebug(lcStructured, "%1 %2", u"a string argument"_s, 42);
+    QVERIFY(QLoggingCategory::setStructuredOutputFile(QString()));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+
+    QVERIFY(!QStructuredLogReader(QByteArray()).isValid());
+    QVERIFY(!QStructuredLogReader("not a log file"_ba).isValid());
+
+    // every truncation is either the end of a record or an error
+    for (qsizetype size = data.size() - 1; size > 0; --size) {
+        QStructuredLogReader reader(data.left(size));
+        QStructuredLogReader::Message message;
+        if (reader.isValid())
+            QVERIFY(!reader.readNext(&message));
+    }
+}
+
+QTEST_MAIN(tst_QStructuredLogging)
+#include "tst_qstructuredlogging.moc"
@@ -511,6 +511,115 @@ void tst_QCoreApplication::deliverInDefinedOrder()
     QObject::connect(&obj, SIGNAL(done()), &app, SLOT(quit()));
     app.exec();
 }
+
+class ValueEvent : public QEvent
+{
+public:
+    explicit ValueEvent(int value) : QEvent(QEvent::User), value(value) {}
+    int value;
+};
+
+class RecordingObject : public QObject
+{
+public:
+    QList<int> values;
+
+    bool event(QEvent *event) override
+    {
+        if (event->type() == QEvent::User)
+            values.append(static_cast<ValueEvent *>(event)->value);
+        return QObject::event(event);
+    }
+};
+
+void tst_QCoreApplication::deliverCrossThreadPostsInOrder()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // Queued calls from other threads take a different path than other
+    // events; make sure posting order and priorities are still respected.
+    constexpr int ThreadCount = 4;
+    constexpr int CallCount = 200;
+    RecordingObject receiver;
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < ThreadCount; ++t) {
+        threads.emplace_back(QThread::create([&receiver, t] {
+            for (int i = 0; i < CallCount; ++i) {
+                const int value = t * CallCount + i;
+                QMetaObject::invokeMethod(&receiver, [&receiver, value] {
+                    receiver.values.append(value);
+                }, Qt::QueuedConnection);
+                if (i == CallCount / 2) {
+                    QCoreApplication::postEvent(&receiver, new ValueEvent(-1 - t),
+                                                Qt::HighEventPriority);
+                }
+            }
+        }));
+        threads.back()->start();
+    }
+    for (const auto &thread : threads)
+        QVERIFY(thread->wait());
+
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(receiver.values.size(), ThreadCount * (CallCount + 1));
+
+    // the high priority events overtake all queued calls
+    QList<int> last(ThreadCount, -1);
+    for (int i = 0; i < receiver.values.size(); ++i) {
+        const int value = receiver.values.at(i);
+        if (i < ThreadCount) {
+            QVERIFY2(value < 0, qPrintable(QString::number(i)));
+            continue;
+        }
+        QVERIFY2(value >= 0, qPrintable(QString::number(i)));
+        // and queued calls from the same thread are delivered in order
+        const int t = value / CallCount;
+        QCOMPARE(value, last[t] < 0 ? t * CallCount : last[t] + 1);
+        last[t] = value;
+    }
+}
+
+void tst_QCoreApplication::deliverCrossThreadPostsWhileMoving()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // Queued calls that are posted while the receiver moves between threads
+    // must follow it, whichever thread's queue they end up in first.
+    constexpr int CallCount = 20000;
+    constexpr int MoveCount = 200;
+    QObject receiver;
+    QAtomicInt delivered;
+    QThread worker;
+    worker.start();
+
+    std::unique_ptr<QThread> poster(QThread::create([&receiver, &delivered] {
+        for (int i = 0; i < CallCount; ++i) {
+            QMetaObject::invokeMethod(&receiver, [&delivered] {
+                delivered.ref();
+            }, Qt::QueuedConnection);
+        }
+    }));
+    poster->start();
+
+    QThread *mainThread = QThread::currentThread();
+    for (int i = 0; i < MoveCount; ++i) {
+        receiver.moveToThread(&worker);
+        QMetaObject::invokeMethod(&receiver, [&receiver, mainThread] {
+            receiver.moveToThread(mainThread);
+        }, Qt::BlockingQueuedConnection);
+        QCoreApplication::sendPostedEvents();
+    }
+    QVERIFY(poster->wait());
+    worker.quit();
+    QVERIFY(worker.wait());
+
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(delivered.loadRelaxed(), CallCount);
+}
 #endif // QT_CONFIG(thread)
 
 void tst_QCoreApplication::applicationPid()
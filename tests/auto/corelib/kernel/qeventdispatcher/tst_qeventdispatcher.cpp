@@ -12,6 +12,21 @@
 #include <QTimer>
 #include <QThreadPool>
 
+#ifdef USE_EPOLL_DISPATCHER
+#  define tst_QEventDispatcher tst_QEventDispatcher_Epoll
+static bool epollEnabled = []() {
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    return true;
+}();
+#endif
+#ifdef USE_IO_URING_DISPATCHER
+#  define tst_QEventDispatcher tst_QEventDispatcher_IoUring
+static bool ioUringEnabled = []() {
+    qputenv("QT_EVENT_DISPATCHER_IO_URING", "1");
+    return true;
+}();
+#endif
+
 enum {
     PreciseTimerInterval    =   10,
     CoarseTimerInterval     =  200,
@@ -81,6 +96,13 @@ bool tst_QEventDispatcher::event(QEvent *e)
 // drain the system event queue after the test starts to avoid destabilizing the test functions
 void tst_QEventDispatcher::initTestCase()
 {
+#ifdef USE_EPOLL_DISPATCHER
+    QCOMPARE(eventDispatcher->metaObject()->className(), "QEventDispatcherEpoll");
+#endif
+#ifdef USE_IO_URING_DISPATCHER
+    if (qstrcmp(eventDispatcher->metaObject()->className(), "QEventDispatcherIoUring") != 0)
+        QSKIP("io_uring is not supported by this kernel");
+#endif
     QElapsedTimer elapsedTimer;
     elapsedTimer.start();
     while (!elapsedTimer.hasExpired(CoarseTimerInterval) && eventDispatcher->processEvents(QEventLoop::AllEvents)) {
@@ -423,6 +445,8 @@ void tst_QEventDispatcher::postEventFromEventHandler()
     // QXcbUnixEventDispatcher and QEventDispatcherUNIX do not do this correctly on any platform;
     // both Windows event dispatchers fail as well.
     const bool knownToFail = eventDispatcherName.contains("UNIX")
+                          || eventDispatcherName.contains("Epoll")
+                          || eventDispatcherName.contains("IoUring")
                           || eventDispatcherName.contains("Unix")
                           || eventDispatcherName.contains("Win32")
                           || eventDispatcherName.contains("WindowsGui")
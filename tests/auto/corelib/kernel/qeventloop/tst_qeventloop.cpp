@@ -14,6 +14,12 @@
   #if defined(HAVE_GLIB)
     #include <private/qeventdispatcher_glib_p.h>
   #endif
+  #if defined(USE_EPOLL_DISPATCHER)
+    #include <private/qeventdispatcher_epoll_p.h>
+  #endif
+  #if defined(USE_IO_URING_DISPATCHER)
+    #include <private/qeventdispatcher_uring_p.h>
+  #endif
 #endif
 #include <qmutex.h>
 #include <qthread.h>
@@ -23,6 +29,21 @@
 #include <QTcpSocket>
 #include <QSignalSpy>
 
+#ifdef USE_EPOLL_DISPATCHER
+#  define tst_QEventLoop tst_QEventLoop_Epoll
+static bool epollEnabled = []() {
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    return true;
+}();
+#endif
+#ifdef USE_IO_URING_DISPATCHER
+#  define tst_QEventLoop tst_QEventLoop_IoUring
+static bool ioUringEnabled = []() {
+    qputenv("QT_EVENT_DISPATCHER_IO_URING", "1");
+    return true;
+}();
+#endif
+
 class EventLoopExiter : public QObject
 {
     Q_OBJECT
@@ -491,10 +512,16 @@ void tst_QEventLoop::processEventsExcludeTimers()
     if (!qobject_cast<QEventDispatcherUNIX *>(eventDispatcher)
   #if defined(HAVE_GLIB)
         && !qobject_cast<QEventDispatcherGlib *>(eventDispatcher)
+  #endif
+  #if defined(USE_EPOLL_DISPATCHER)
+        && !qobject_cast<QEventDispatcherEpoll *>(eventDispatcher)
+  #endif
+  #if defined(USE_IO_URING_DISPATCHER)
+        && !qobject_cast<QEventDispatcherIoUring *>(eventDispatcher)
   #endif
         )
 #endif
-        QEXPECT_FAIL("", "X11ExcludeTimers only supported in the UNIX/Glib dispatchers", Continue);
+        QEXPECT_FAIL("", "X11ExcludeTimers only supported in the UNIX, Glib, epoll and io_uring dispatchers", Continue);
 
     QCOMPARE(timerReceiver.gotTimerEvent, -1);
     timerReceiver.gotTimerEvent = -1;
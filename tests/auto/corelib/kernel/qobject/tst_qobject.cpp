@@ -103,6 +103,7 @@ private slots:
     void disconnectByMetaMethod();
     void disconnectNotSignalMetaMethod();
     void autoConnectionBehavior();
+    void autoConnectionAfterMoveToThread();
     void baseDestroyed();
     void pointerConnect();
     void pointerDisconnect();
@@ -4431,6 +4432,42 @@ void tst_QObject::autoConnectionBehavior()
     delete receiver;
 }
 
+void tst_QObject::autoConnectionAfterMoveToThread()
+{
+    // activate() takes a shortcut while all connections are direct calls into
+    // the sender's thread; moving a receiver away and back must be honored
+    SenderObject sender;
+    ReceiverObject receiver1;
+    ReceiverObject receiver2;
+    receiver1.reset();
+    receiver2.reset();
+    connect(&sender, &SenderObject::signal1, &receiver1, &ReceiverObject::slot1);
+    connect(&sender, &SenderObject::signal1, &receiver2, &ReceiverObject::slot1);
+
+    sender.emitSignal1();
+    QCOMPARE(receiver1.count_slot1, 1);
+    QCOMPARE(receiver2.count_slot1, 1);
+
+    QThread thread;
+    receiver2.moveToThread(&thread);
+    sender.emitSignal1();
+    QCOMPARE(receiver1.count_slot1, 2);
+    QCOMPARE(receiver2.count_slot1, 1);
+
+    thread.start();
+    QThread *mainThread = QThread::currentThread();
+    QMetaObject::invokeMethod(&receiver2, [&] {
+        receiver2.moveToThread(mainThread);
+    }, Qt::BlockingQueuedConnection);
+    thread.quit();
+    QVERIFY(thread.wait());
+    QCOMPARE(receiver2.count_slot1, 2);
+
+    sender.emitSignal1();
+    QCOMPARE(receiver1.count_slot1, 3);
+    QCOMPARE(receiver2.count_slot1, 3);
+}
+
 class BaseDestroyed : public QObject
 { Q_OBJECT
     QList<QString> fooList;
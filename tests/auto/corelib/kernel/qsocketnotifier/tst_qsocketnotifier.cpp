@@ -26,6 +26,21 @@
 
 using namespace std::chrono_literals;
 
+#ifdef USE_EPOLL_DISPATCHER
+#  define tst_QSocketNotifier tst_QSocketNotifier_Epoll
+static bool epollEnabled = []() {
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    return true;
+}();
+#endif
+#ifdef USE_IO_URING_DISPATCHER
+#  define tst_QSocketNotifier tst_QSocketNotifier_IoUring
+static bool ioUringEnabled = []() {
+    qputenv("QT_EVENT_DISPATCHER_IO_URING", "1");
+    return true;
+}();
+#endif
+
 class tst_QSocketNotifier : public QObject
 {
     Q_OBJECT
@@ -0,0 +1,295 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValueView>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QTemporaryFile>
+
+using namespace Qt::StringLiterals;
+
+class tst_QCborValueView : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void basics();
+    void scalars_data();
+    void scalars();
+    void containers();
+    void stringsAreViews();
+    void chunkedStrings();
+    void tags();
+    void malformed_data();
+    void malformed();
+    void fromCborErrors_data();
+    void fromCborErrors();
+    void fromFile();
+};
+
+static QCborDocumentView documentFor(const QCborValue &value)
+{
+    return QCborDocumentView::fromCbor(value.toCbor());
+}
+
+void tst_QCborValueView::basics()
+{
+    QCborDocumentView document;
+    QVERIFY(document.isNull());
+    QVERIFY(document.data().isNull());
+    QVERIFY(document.root().isInvalid());
+
+    QCborValueView view;
+    QCOMPARE(view.type(), QCborValue::Invalid);
+    QCOMPARE(view.size(), 0);
+    QVERIFY(view.at(0).isInvalid());
+    QVERIFY(view.value("key").isInvalid());
+    QVERIFY(view.utf8StringView().isNull());
+    QVERIFY(view.encoded().isNull());
+    QCOMPARE(view.toInteger(42), 42);
+    QCOMPARE(view.toCborValue(), QCborValue(QCborValue::Invalid));
+}
+
+void tst_QCborValueView::scalars_data()
+{
+    QTest::addColumn<QCborValue>("value");
+
+    QTest::newRow("zero") << QCborValue(0);
+    QTest::newRow("small") << QCborValue(23);
+    QTest::newRow("one-byte") << QCborValue(24);
+    QTest::newRow("negative") << QCborValue(-1000);
+    QTest::newRow("int64-max") << QCborValue(std::numeric_limits<qint64>::max());
+    QTest::newRow("int64-min") << QCborValue(std::numeric_limits<qint64>::min());
+    QTest::newRow("double") << QCborValue(1.5);
+    QTest::newRow("float") << QCborValue(0.1);
+    QTest::newRow("false") << QCborValue(false);
+    QTest::newRow("true") << QCborValue(true);
+    QTest::newRow("null") << QCborValue(nullptr);
+    QTest::newRow("undefined") << QCborValue();
+    QTest::newRow("simple-type") << QCborValue(QCborSimpleType(32));
+    QTest::newRow("empty-string") << QCborValue(u""_s);
+    QTest::newRow("string") << QCborValue(u"Hello, wörld"_s);
+    QTest::newRow("bytearray") << QCborValue("\x01\x02\x03"_ba);
+}
+
+void tst_QCborValueView::scalars()
+{
+    QFETCH(QCborValue, value);
+
+    const QCborDocumentView document = documentFor(value);
+    QVERIFY(!document.isNull());
+    const QCborValueView view = document.root();
+    QCOMPARE(view.type(), value.type());
+    QCOMPARE(view.isSimpleType(), value.isSimpleType());
+    QCOMPARE(view.toInteger(-1), value.toInteger(-1));
+    QCOMPARE(view.toDouble(-1), value.toDouble(-1));
+    QCOMPARE(view.toBool(), value.toBool());
+    QCOMPARE(view.toSimpleType(), value.toSimpleType());
+    QCOMPARE(view.toString(u"default"_s), value.toString(u"default"_s));
+    QCOMPARE(view.toByteArray("default"), value.toByteArray("default"));
+    QCOMPARE(view.encoded(), document.data());
+    QCOMPARE(view.toCborValue(), value);
+    QCOMPARE(view.size(), 0);
+}
+
+void tst_QCborValueView::containers()
+{
+    const QCborMap map = {
+        { u"name"_s, u"config"_s },
+        { u"values"_s, QCborArray{ 1, 2.5, u"three"_s, QCborArray{ 4 }, QCborMap{} } },
+        { 7, u"integer key"_s },
+        { u"nested"_s, QCborMap{ { u"enabled"_s, true } } },
+    };
+    const QCborDocumentView document = documentFor(map);
+    const QCborValueView root = document.root();
+
+    QVERIFY(root.isMap());
+    QCOMPARE(root.size(), map.size());
+    for (qsizetype i = 0; i < map.size(); ++i) {
+        QCOMPARE(root.keyAt(i).toCborValue(), QCborValue((map.constBegin() + i).key()));
+        QCOMPARE(root.valueAt(i).toCborValue(), QCborValue((map.constBegin() + i).value()));
+    }
+    QVERIFY(root.keyAt(-1).isInvalid());
+    QVERIFY(root.valueAt(map.size()).isInvalid());
+    QVERIFY(root.at(0).isInvalid());
+
+    QCOMPARE(root["name"].toString(), u"config"_s);
+    QCOMPARE(root[u"name"].toString(), u"config"_s);
+    QCOMPARE(root["name"_L1].toString(), u"config"_s);
+    QCOMPARE(root[7].toString(), u"integer key"_s);
+    QVERIFY(root["missing"].isInvalid());
+    QVERIFY(root[8].isInvalid());
+    QVERIFY(root["nested"]["enabled"].isTrue());
+
+    const QCborValueView values = root.value(u"values"_s);
+    QVERIFY(values.isArray());
+    QCOMPARE(values.size(), 5);
+    QCOMPARE(values.at(0).toInteger(), 1);
+    QCOMPARE(values[1].toDouble(), 2.5);
+    QCOMPARE(values[2].toString(), u"three"_s);
+    QCOMPARE(values[3][0].toInteger(), 4);
+    QVERIFY(values[4].isMap());
+    QCOMPARE(values[4].size(), 0);
+    QVERIFY(values.at(5).isInvalid());
+    QVERIFY(values.at(-1).isInvalid());
+    QVERIFY(values["name"].isInvalid());
+
+    QCOMPARE(root.toCborValue(), QCborValue(map));
+    QCOMPARE(values.toJsonValue(), QCborValue(map.value(u"values"_s)).toJsonValue());
+    QCOMPARE(root.toJsonValue().toObject().value("name"_L1).toString(), u"config"_s);
+
+    // copies share the index
+    const QCborDocumentView copy = document;
+    QCOMPARE(copy.root()["values"][2].toString(), u"three"_s);
+}
+
+void tst_QCborValueView::stringsAreViews()
+{
+    const QCborDocumentView document = documentFor(QCborArray{ u"text"_s, "bytes"_ba });
+    const QByteArrayView data = document.data();
+    const auto isInData = [&](const void *ptr) {
+        return std::less_equal<>()(data.data(), static_cast<const char *>(ptr))
+                && std::less<>()(static_cast<const char *>(ptr), data.data() + data.size());
+    };
+
+    const QUtf8StringView text = document.root()[0].utf8StringView();
+    QCOMPARE(text.toString(), u"text"_s);
+    QVERIFY(isInData(text.data()));
+    QVERIFY(document.root()[0].byteArrayView().isNull());
+
+    const QByteArrayView bytes = document.root()[1].byteArrayView();
+    QCOMPARE(bytes.toByteArray(), "bytes"_ba);
+    QVERIFY(isInData(bytes.data()));
+    QVERIFY(document.root()[1].utf8StringView().isNull());
+
+    // and so are documents over raw data
+    const QByteArray encoded = QCborValue(u"raw"_s).toCbor();
+    const QCborDocumentView raw =
+            QCborDocumentView::fromCbor(QByteArray::fromRawData(encoded.constData(), encoded.size()));
+    QVERIFY(raw.data().data() == encoded.constData());
+    QVERIFY(raw.root().utf8StringView().data() == encoded.constData() + 1);
+}
+
+void tst_QCborValueView::chunkedStrings()
+{
+    // ["ab" "c", h'01' h'0203', {"k" "ey": 1}]
+    const QByteArray encoded = "\x83\x7f\x62" "ab" "\x61" "c" "\xff"
+                               "\x5f\x41\x01\x42\x02\x03\xff"
+                               "\xa1\x7f\x61k\x62" "ey" "\xff\x01"_ba;
+    const QCborDocumentView document = QCborDocumentView::fromCbor(encoded);
+    const QCborValueView root = document.root();
+    QCOMPARE(root.size(), 3);
+
+    QVERIFY(root[0].isString());
+    QCOMPARE(root[0].toString(), u"abc"_s);
+    QVERIFY(root[0].utf8StringView().isNull());
+    QVERIFY(root[1].isByteArray());
+    QCOMPARE(root[1].toByteArray(), "\x01\x02\x03"_ba);
+    QVERIFY(root[1].byteArrayView().isNull());
+    QCOMPARE(root[2]["key"].toInteger(), 1);
+
+    QCOMPARE(root.toCborValue(), QCborValue::fromCbor(encoded));
+}
+
+void tst_QCborValueView::tags()
+{
+    const QCborValue tagged(QCborKnownTags::Signature, QCborArray{ 1, u"x"_s });
+    const QCborDocumentView document = documentFor(tagged);
+    const QCborValueView root = document.root();
+
+    QVERIFY(root.isTag());
+    QCOMPARE(root.tag(), QCborTag(QCborKnownTags::Signature));
+    QCOMPARE(root.taggedValue().size(), 2);
+    QCOMPARE(root.taggedValue()[1].toString(), u"x"_s);
+    QCOMPARE(root.toCborValue(), tagged);
+
+    QCOMPARE(root.taggedValue().tag(QCborTag(42)), QCborTag(42));
+    QVERIFY(root.taggedValue().taggedValue().isInvalid());
+}
+
+void tst_QCborValueView::malformed_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("truncated-array") << "\x83\x01\x02"_ba;
+    QTest::newRow("truncated-element") << "\x82\x01\x19\x01"_ba;
+    QTest::newRow("truncated-string") << "\x82\x01\x65" "abc"_ba;
+    QTest::newRow("huge-count") << "\x9b\xff\xff\xff\xff\xff\xff\xff\xff\x01"_ba;
+    QTest::newRow("huge-map") << "\xbb\x80\x00\x00\x00\x00\x00\x00\x00\x01"_ba;
+    QTest::newRow("missing-break") << "\x9f\x01\x02"_ba;
+    QTest::newRow("odd-map") << "\xbf\x01\xff"_ba;
+    QTest::newRow("break-in-array") << "\x82\x01\xff"_ba;
+    QTest::newRow("reserved-info") << "\x82\x01\x1c"_ba;
+    QTest::newRow("bad-chunk") << "\x81\x7f\x41\x00\xff"_ba;
+}
+
+void tst_QCborValueView::malformed()
+{
+    QFETCH(QByteArray, data);
+
+    const QCborDocumentView document = QCborDocumentView::fromCbor(data);
+    QVERIFY(!document.isNull());
+    const QCborValueView root = document.root();
+    QVERIFY(root.isArray() || root.isMap());
+    QCOMPARE(root.size(), 0);
+    QVERIFY(root.at(0).isInvalid());
+    QVERIFY(root.encoded().isNull());
+    QVERIFY(root.toCborValue().isInvalid());
+}
+
+void tst_QCborValueView::fromCborErrors_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QCborError::Code>("error");
+
+    QTest::newRow("empty") << QByteArray() << QCborError::EndOfFile;
+    QTest::newRow("truncated") << "\x19\x01"_ba << QCborError::EndOfFile;
+    QTest::newRow("break") << "\xff"_ba << QCborError::UnexpectedBreak;
+    QTest::newRow("reserved") << "\x1d"_ba << QCborError::IllegalNumber;
+    QTest::newRow("indefinite-integer") << "\x1f"_ba << QCborError::IllegalNumber;
+}
+
+void tst_QCborValueView::fromCborErrors()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QCborError::Code, error);
+
+    QCborParserError parserError;
+    const QCborDocumentView document = QCborDocumentView::fromCbor(data, &parserError);
+    QVERIFY(document.isNull());
+    QCOMPARE(parserError.error.c, error);
+    QCOMPARE(parserError.offset, 0);
+
+    QVERIFY(!QCborDocumentView::fromCbor("\x01"_ba, &parserError).isNull());
+    QCOMPARE(parserError.error.c, QCborError::NoError);
+}
+
+void tst_QCborValueView::fromFile()
+{
+    QCborMap map;
+    for (int i = 0; i < 1000; ++i)
+        map.insert(u"key"_s + QString::number(i), QCborArray{ i, QString(100, u'x') });
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write(map.toCborValue().toCbor());
+    file.close();
+
+    QCborParserError error;
+    const QCborDocumentView document = QCborDocumentView::fromFile(file.fileName(), &error);
+    QCOMPARE(error.error.c, QCborError::NoError);
+    QVERIFY(!document.isNull());
+    QCOMPARE(document.root().size(), 1000);
+    QCOMPARE(document.root()["key500"][0].toInteger(), 500);
+    QCOMPARE(document.root()["key999"][1].utf8StringView().size(), 100);
+    QCOMPARE(document.root().toCborValue(), map.toCborValue());
+
+    QVERIFY(QCborDocumentView::fromFile(file.fileName() + u".does-not-exist"_s, &error).isNull());
+    QCOMPARE(error.error.c, QCborError::InputOutputError);
+}
+
+QTEST_APPLESS_MAIN(tst_QCborValueView)
+#include "tst_qcborvalueview.moc"
@@ -0,0 +1,442 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonStreamReader>
+
+using namespace Qt::StringLiterals;
+
+class tst_QJsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void tokens_data();
+    void tokens();
+    void chunked_data() { tokens_data(); }
+    void chunked();
+    void device_data() { tokens_data(); }
+    void device();
+    void errors_data();
+    void errors();
+    void numbers_data();
+    void numbers();
+    void strings_data();
+    void strings();
+    void readValue_data();
+    void readValue();
+    void skipCurrentValue();
+    void multipleDocuments();
+    void garbageAtEnd();
+    void numberAtSequentialEnd();
+    void deepNesting();
+    void customError();
+};
+
+// a compact description of the tokens of a document
+static QString describe(QJsonStreamReader &reader, bool resume = false)
+{
+    QString result;
+    for (;;) {
+        switch (reader.readNext()) {
+        case QJsonStreamReader::StartArray:
+            result += u'[';
+            break;
+        case QJsonStreamReader::EndArray:
+            result += u']';
+            break;
+        case QJsonStreamReader::StartObject:
+            result += u'{';
+            break;
+        case QJsonStreamReader::EndObject:
+            result += u'}';
+            break;
+        case QJsonStreamReader::Name:
+            result += "N:"_L1 + reader.text().toString() + u' ';
+            break;
+        case QJsonStreamReader::String:
+            result += "S:"_L1 + reader.text().toString() + u' ';
+            break;
+        case QJsonStreamReader::Number:
+            result += (reader.isInteger() ? "I:"_L1 : "D:"_L1)
+                    + QString::number(reader.toDouble()) + u' ';
+            break;
+        case QJsonStreamReader::Bool:
+            result += reader.toBool() ? "true "_L1 : "false "_L1;
+            break;
+        case QJsonStreamReader::Null:
+            result += "null "_L1;
+            break;
+        case QJsonStreamReader::EndDocument:
+            return result;
+        case QJsonStreamReader::Invalid:
+            if (resume && reader.error() == QJsonStreamReader::PrematureEndOfDocumentError)
+                return result;
+            return result + "error "_L1 + reader.errorString();
+        case QJsonStreamReader::NoToken:
+            Q_UNREACHABLE();
+        }
+    }
+}
+
+void tst_QJsonStreamReader::tokens_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("empty-array") << "[]"_ba << "[]";
+    QTest::newRow("empty-object") << "{}"_ba << "{}";
+    QTest::newRow("spaces") << " \t\r\n[ \n] \n"_ba << "[]";
+    QTest::newRow("bom") << "\xef\xbb\xbf[1]"_ba << "[I:1 ]";
+    QTest::newRow("array")
+            << "[1, 2.5, \"x\", true, false, null]"_ba
+            << "[I:1 D:2.5 S:x true false null ]";
+    QTest::newRow("object")
+            << "{\"a\": 1, \"b\" : [ {} ], \"c\":{\"d\":null}}"_ba
+            << "{N:a I:1 N:b [{}]N:c {N:d null }}";
+    QTest::newRow("nested-arrays") << "[[[]],[[1]]]"_ba << "[[[]][[I:1 ]]]";
+    QTest::newRow("top-level-string") << "\"hello\""_ba << "S:hello ";
+    QTest::newRow("top-level-number") << "42 "_ba << "I:42 ";
+    QTest::newRow("top-level-number-at-end") << "42"_ba << "I:42 ";
+    QTest::newRow("top-level-literal") << "true"_ba << "true ";
+}
+
+void tst_QJsonStreamReader::tokens()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QCOMPARE(describe(reader), expected);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.depth(), 0);
+}
+
+void tst_QJsonStreamReader::chunked()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    if (QByteArrayView(QTest::currentDataTag()) == "top-level-number-at-end")
+        QSKIP("Data added with addData() can always be continued");
+
+    // feed the data one byte at a time
+    QJsonStreamReader reader;
+    QString result;
+    for (char c : std::as_const(json)) {
+        reader.addData(&c, 1);
+        result += describe(reader, true);
+    }
+    QCOMPARE(result, expected);
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QJsonStreamReader::device()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+    QCOMPARE(describe(reader), expected);
+}
+
+void tst_QJsonStreamReader::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("expected");
+    QTest::addColumn<int>("offset");
+
+    // the tokens before the error, and the error message
+    const auto expected = [](QLatin1StringView tokens, QJsonParseError::ParseError error) {
+        QJsonParseError e;
+        e.error = error;
+        return QString(tokens + "error "_L1 + e.errorString());
+    };
+
+    QTest::newRow("missing-name-separator") << "{\"a\" 1}"_ba
+            << expected("{"_L1, QJsonParseError::MissingNameSeparator) << 5;
+    QTest::newRow("missing-value-separator") << "[1 2]"_ba
+            << expected("[I:1 "_L1, QJsonParseError::MissingValueSeparator) << 3;
+    QTest::newRow("unterminated-object") << "{\"a\":1 \"b\":2}"_ba
+            << expected("{N:a I:1 "_L1, QJsonParseError::UnterminatedObject) << 7;
+    QTest::newRow("trailing-comma-array") << "[1,]"_ba
+            << expected("[I:1 "_L1, QJsonParseError::MissingObject) << 3;
+    QTest::newRow("trailing-comma-object") << "{\"a\":1,}"_ba
+            << expected("{N:a I:1 "_L1, QJsonParseError::MissingObject) << 7;
+    QTest::newRow("name-not-string") << "{1:2}"_ba
+            << expected("{"_L1, QJsonParseError::UnterminatedObject) << 1;
+    QTest::newRow("illegal-value") << "[tru]"_ba
+            << expected("["_L1, QJsonParseError::IllegalValue) << 1;
+    QTest::newRow("illegal-number") << "[-]"_ba
+            << expected("["_L1, QJsonParseError::IllegalNumber) << 1;
+    QTest::newRow("illegal-escape") << "[\"\\u12\"]"_ba
+            << expected("["_L1, QJsonParseError::IllegalEscapeSequence) << 2;
+    QTest::newRow("illegal-utf8") << "[\"\xff\"]"_ba
+            << expected("["_L1, QJsonParseError::IllegalUTF8String) << 2;
+}
+
+void tst_QJsonStreamReader::errors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+    QFETCH(int, offset);
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(describe(reader), expected);
+    QCOMPARE(reader.error(), QJsonStreamReader::NotWellFormedError);
+    QCOMPARE(reader.currentOffset(), offset);
+    QVERIFY(reader.atEnd());
+
+    // errors are final
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::NotWellFormedError);
+
+    // and the same as the ones of QJsonDocument
+    QJsonParseError error;
+    QJsonDocument::fromJson(json, &error);
+    QVERIFY(expected.endsWith(error.errorString()));
+}
+
+void tst_QJsonStreamReader::numbers_data()
+{
+    QTest::addColumn<QByteArray>("number");
+    QTest::addColumn<bool>("isInteger");
+
+    QTest::newRow("zero") << "0"_ba << true;
+    QTest::newRow("negative") << "-17"_ba << true;
+    QTest::newRow("integral-double") << "3.0"_ba << true;
+    QTest::newRow("fraction") << "0.125"_ba << false;
+    QTest::newRow("exponent") << "1e3"_ba << true;
+    QTest::newRow("negative-exponent") << "-2.5E-3"_ba << false;
+    QTest::newRow("max-int64") << "9223372036854775807"_ba << true;
+    QTest::newRow("beyond-int64") << "18446744073709551616"_ba << false;
+    QTest::newRow("huge") << "1e300"_ba << false;
+}
+
+void tst_QJsonStreamReader::numbers()
+{
+    QFETCH(QByteArray, number);
+    QFETCH(bool, isInteger);
+
+    // the same value and type as QJsonDocument
+    const QJsonValue expected = QJsonDocument::fromJson('[' + number + ']').array().at(0);
+    QJsonStreamReader reader('[' + number + ']');
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.value(), expected);
+    QCOMPARE(reader.isInteger(), isInteger);
+    QCOMPARE(reader.toDouble(), expected.toDouble());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+}
+
+void tst_QJsonStreamReader::strings_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("empty") << "\"\""_ba << QString();
+    QTest::newRow("ascii") << "\"hello world\""_ba << u"hello world"_s;
+    QTest::newRow("utf8") << "\"gr\xc3\xbc\xc3\x9f \xe2\x82\xac\""_ba << u"grüß €"_s;
+    QTest::newRow("escapes") << "\"\\\"\\\\\\/\\b\\f\\n\\r\\t\""_ba << u"\"\\/\b\f\n\r\t"_s;
+    QTest::newRow("unicode-escape") << "\"\\u00e9\\u20ac\""_ba << u"é€"_s;
+    QTest::newRow("surrogates") << "\"\\ud83d\\ude00\""_ba << u"\U0001F600"_s;
+    QTest::newRow("escaped-backslash-at-end") << "\"a\\\\\""_ba << u"a\\"_s;
+}
+
+void tst_QJsonStreamReader::strings()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, expected);
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), expected);
+    QCOMPARE(reader.value(), QJsonValue(expected));
+
+    // split in two at every position
+    for (qsizetype i = 1; i < json.size(); ++i) {
+        QJsonStreamReader chunked;
+        chunked.addData(json.left(i));
+        QCOMPARE(chunked.readNext(), QJsonStreamReader::Invalid);
+        QCOMPARE(chunked.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+        chunked.addData(json.mid(i));
+        QCOMPARE(chunked.readNext(), QJsonStreamReader::String);
+        QCOMPARE(chunked.text(), expected);
+    }
+}
+
+void tst_QJsonStreamReader::readValue_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("array") << "[1, \"two\", [3], {\"four\": 4}, null, true]"_ba;
+    QTest::newRow("object") << "{\"b\": [1, 2], \"a\": {\"x\": {}}, \"a\": 3}"_ba;
+    QTest::newRow("empty-array") << "[]"_ba;
+    QTest::newRow("empty-object") << "{}"_ba;
+}
+
+void tst_QJsonStreamReader::readValue()
+{
+    QFETCH(QByteArray, json);
+
+    const QJsonDocument document = QJsonDocument::fromJson(json);
+    QJsonStreamReader reader(json);
+    QVERIFY(reader.readNextValue());
+    const QJsonValue value = reader.readValue();
+    QVERIFY(!reader.hasError());
+    QCOMPARE(value.isArray() ? QJsonDocument(value.toArray()) : QJsonDocument(value.toObject()),
+             document);
+    QCOMPARE(reader.depth(), 0);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+void tst_QJsonStreamReader::skipCurrentValue()
+{
+    QJsonStreamReader reader("{\"skip\": [1, {\"a\": [2, 3]}, [[]]], \"keep\": 4}"_ba);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.depth(), 2);
+    reader.skipCurrentValue();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), u"keep"_s);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), 4);
+}
+
+void tst_QJsonStreamReader::multipleDocuments()
+{
+    QJsonStreamReader reader;
+    reader.setMultipleDocuments(true);
+    QVERIFY(reader.multipleDocuments());
+
+    reader.addData("{\"id\": 1}\n[2]\n\"thr"_ba);
+    QVERIFY(reader.readNextValue());
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonObject({ { "id"_L1, 1 } })));
+    QVERIFY(reader.readNextValue());
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonArray({ 2 })));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+
+    reader.addData("ee\"\n4"_ba);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), u"three"_s);
+    // more digits could follow
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+
+    reader.addData("2\n"_ba);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), 42);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(reader.atEnd());
+
+    // reading continues after EndDocument once there is more data
+    reader.addData("null"_ba);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Null);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(!reader.hasError());
+
+    // from a file, the last number is complete at the end
+    QByteArray data = "1 2 3"_ba;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    reader.setDevice(&buffer);
+    QVERIFY(reader.multipleDocuments());
+    QCOMPARE(describe(reader), u"I:1 I:2 I:3 "_s);
+}
+
+void tst_QJsonStreamReader::garbageAtEnd()
+{
+    QJsonStreamReader reader("[] x"_ba);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::NotWellFormedError);
+    QCOMPARE(reader.currentOffset(), 3);
+
+    QJsonStreamReader incomplete("[1"_ba);
+    QCOMPARE(incomplete.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(incomplete.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(incomplete.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+    QVERIFY(incomplete.atEnd());
+}
+
+void tst_QJsonStreamReader::numberAtSequentialEnd()
+{
+    // like a pipe or socket that the other side has nothing more to write to
+    class SequentialDevice : public QIODevice
+    {
+    public:
+        explicit SequentialDevice(const QByteArray &data) : data(data) {}
+        bool isSequential() const override { return true; }
+        qint64 bytesAvailable() const override
+        { return data.size() + QIODevice::bytesAvailable(); }
+
+    protected:
+        qint64 readData(char *out, qint64 maxSize) override
+        {
+            const qint64 n = qMin(maxSize, qint64(data.size()));
+            memcpy(out, data.constData(), n);
+            data.remove(0, n);
+            return n;
+        }
+        qint64 writeData(const char *, qint64) override { return -1; }
+
+    private:
+        QByteArray data;
+    };
+
+    SequentialDevice buffer("42"_ba);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    // more data may still arrive
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+
+    buffer.close();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.toInteger(), 42);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QJsonStreamReader::deepNesting()
+{
+    const QByteArray json = QByteArray(2000, '[') + QByteArray(2000, ']');
+    QJsonStreamReader reader(json);
+    while (reader.readNext() == QJsonStreamReader::StartArray) {
+    }
+    QCOMPARE(reader.error(), QJsonStreamReader::NotWellFormedError);
+    QCOMPARE(reader.depth(), 1024);
+}
+
+void tst_QJsonStreamReader::customError()
+{
+    QJsonStreamReader reader("[1, 2]"_ba);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    reader.raiseError(u"unexpected array"_s);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::CustomError);
+    QCOMPARE(reader.errorString(), u"unexpected array"_s);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+
+    reader.clear();
+    QVERIFY(!reader.hasError());
+    reader.addData("{}"_ba);
+    QCOMPARE(describe(reader), u"{}"_s);
+}
+
+QTEST_APPLESS_MAIN(tst_QJsonStreamReader)
+#include "tst_qjsonstreamreader.moc"
@@ -0,0 +1,228 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonStreamReader>
+#include <QJsonStreamWriter>
+
+using namespace Qt::StringLiterals;
+
+class tst_QJsonStreamWriter : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void sameAsToJson_data();
+    void sameAsToJson();
+    void scalars_data();
+    void scalars();
+    void names();
+    void multipleDocuments();
+    void device();
+    void roundTrip();
+};
+
+// writes value the way a user of the streaming API would
+static void write(QJsonStreamWriter &writer, const QJsonValue &value)
+{
+    if (value.isArray()) {
+        writer.startArray();
+        for (const QJsonValue element : value.toArray())
+            write(writer, element);
+        QVERIFY(writer.endArray());
+    } else if (value.isObject()) {
+        const QJsonObject object = value.toObject();
+        writer.startObject();
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            writer.append(it.key());
+            write(writer, it.value());
+        }
+        QVERIFY(writer.endObject());
+    } else {
+        writer.append(value);
+    }
+}
+
+void tst_QJsonStreamWriter::sameAsToJson_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("empty-array") << "[]"_ba;
+    QTest::newRow("empty-object") << "{}"_ba;
+    QTest::newRow("array") << "[1, 2.5, \"x\", true, false, null]"_ba;
+    QTest::newRow("object") << "{\"a\": 1, \"b\": [{}, []], \"c\": {\"d\": null, \"e\": [[1]]}}"_ba;
+    QTest::newRow("escapes") << "[\"\\\"\\\\\\n\\u0001 gr\xc3\xbc\xc3\x9f\"]"_ba;
+    QTest::newRow("numbers") << "[0, -1, 9223372036854775807, 1e300, 0.1, -2.5e-3]"_ba;
+}
+
+void tst_QJsonStreamWriter::sameAsToJson()
+{
+    QFETCH(QByteArray, json);
+
+    const QJsonDocument document = QJsonDocument::fromJson(json);
+    QVERIFY(!document.isNull());
+    const QJsonValue value = document.isArray() ? QJsonValue(document.array())
+                                                : QJsonValue(document.object());
+
+    for (auto format : { QJsonDocument::Indented, QJsonDocument::Compact }) {
+        QByteArray output;
+        QJsonStreamWriter writer(&output);
+        writer.setFormat(format);
+        QCOMPARE(writer.format(), format);
+        write(writer, value);
+        QCOMPARE(output, document.toJson(format));
+
+        // and the whole value at once
+        output.clear();
+        QJsonStreamWriter valueWriter(&output);
+        valueWriter.setFormat(format);
+        valueWriter.append(value);
+        QCOMPARE(output, document.toJson(format));
+    }
+}
+
+void tst_QJsonStreamWriter::scalars_data()
+{
+    QTest::addColumn<QJsonValue>("value");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::newRow("integer") << QJsonValue(42) << "42"_ba;
+    QTest::newRow("double") << QJsonValue(0.5) << "0.5"_ba;
+    QTest::newRow("infinity") << QJsonValue(qInf()) << "null"_ba;
+    QTest::newRow("true") << QJsonValue(true) << "true"_ba;
+    QTest::newRow("null") << QJsonValue(QJsonValue::Null) << "null"_ba;
+    QTest::newRow("string") << QJsonValue(u"a\tb"_s) << "\"a\\tb\""_ba;
+}
+
+void tst_QJsonStreamWriter::scalars()
+{
+    QFETCH(QJsonValue, value);
+    QFETCH(QByteArray, expected);
+
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.setFormat(QJsonDocument::Compact);
+    writer.append(value);
+    QCOMPARE(output, expected);
+
+    // the typed overloads write the same
+    output.clear();
+    QJsonStreamWriter typedWriter(&output);
+    typedWriter.setFormat(QJsonDocument::Compact);
+    switch (value.type()) {
+    case QJsonValue::Double:
+        if (value.isDouble() && value.toInteger(-1) == value.toDouble())
+            typedWriter.append(value.toInteger());
+        else
+            typedWriter.append(value.toDouble());
+        break;
+    case QJsonValue::Bool:
+        typedWriter.append(value.toBool());
+        break;
+    case QJsonValue::Null:
+        typedWriter.append(nullptr);
+        break;
+    case QJsonValue::String:
+        typedWriter.append(value.toString());
+        break;
+    default:
+        QFAIL("unexpected type");
+    }
+    QCOMPARE(output, expected);
+}
+
+void tst_QJsonStreamWriter::names()
+{
+    // all kinds of strings can be names and values
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.setFormat(QJsonDocument::Compact);
+    writer.startObject();
+    writer.append("latin1"_L1);
+    writer.append(u"utf16"_s);
+    writer.append(QUtf8StringView("utf8 \xc3\xbc"));
+    writer.append(QStringView(u"view"));
+    writer.append("ints");
+    writer.startArray();
+    writer.append(1);
+    writer.append(2u);
+    writer.append(qint64(3));
+    QVERIFY(writer.endArray());
+    QVERIFY(writer.endObject());
+    QCOMPARE(output, "{\"latin1\":\"utf16\",\"utf8 \xc3\xbc\":\"view\",\"ints\":[1,2,3]}"_ba);
+}
+
+void tst_QJsonStreamWriter::multipleDocuments()
+{
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.setFormat(QJsonDocument::Compact);
+    for (int i = 0; i < 3; ++i) {
+        writer.startObject();
+        writer.append("id"_L1);
+        writer.append(i);
+        writer.endObject();
+    }
+    writer.append(u"last"_s);
+    QCOMPARE(output, "{\"id\":0}\n{\"id\":1}\n{\"id\":2}\n\"last\""_ba);
+
+    output.clear();
+    QJsonStreamWriter indented(&output);
+    indented.startArray();
+    indented.endArray();
+    indented.append(1);
+    QCOMPARE(output, "[\n]\n1\n"_ba);
+}
+
+void tst_QJsonStreamWriter::device()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QJsonStreamWriter writer(&buffer);
+    QCOMPARE(writer.device(), &buffer);
+    writer.startArray();
+    writer.append(1);
+    QCOMPARE(buffer.data(), "[\n    1"_ba);
+    writer.endArray();
+    QCOMPARE(buffer.data(), "[\n    1\n]\n"_ba);
+}
+
+void tst_QJsonStreamWriter::roundTrip()
+{
+    // a large array, written and read back element by element
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.setFormat(QJsonDocument::Compact);
+    writer.startArray();
+    for (int i = 0; i < 1000; ++i) {
+        writer.startObject();
+        writer.append("index"_L1);
+        writer.append(i);
+        writer.append("name"_L1);
+        writer.append(QString::number(i));
+        writer.endObject();
+    }
+    writer.endArray();
+
+    QBuffer buffer(&output);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    int count = 0;
+    while (reader.readNextValue()) {
+        const QJsonObject object = reader.readValue().toObject();
+        QCOMPARE(object.value("index"_L1).toInteger(), count);
+        QCOMPARE(object.value("name"_L1).toString(), QString::number(count));
+        ++count;
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(count, 1000);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+}
+
+QTEST_APPLESS_MAIN(tst_QJsonStreamWriter)
+#include "tst_qjsonstreamwriter.moc"
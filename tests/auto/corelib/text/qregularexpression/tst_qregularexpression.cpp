@@ -15,6 +15,8 @@
 #include <iostream>
 #include <optional>
 
+using namespace Qt::StringLiterals;
+
 Q_DECLARE_METATYPE(QRegularExpression::PatternOptions)
 Q_DECLARE_METATYPE(QRegularExpression::MatchType)
 Q_DECLARE_METATYPE(QRegularExpression::MatchOptions)
@@ -61,6 +63,9 @@ private slots:
     void JOptionUsage_data();
     void JOptionUsage();
     void QStringAndQStringViewEquivalence();
+    void utf8AndLatin1Subjects_data();
+    void utf8AndLatin1Subjects();
+    void invalidUtf8Subject();
     void threadSafety_data();
     void threadSafety();
 
@@ -2351,6 +2356,178 @@ private:
     const QString &m_subject;
 };
 
+void tst_QRegularExpression::utf8AndLatin1Subjects_data()
+{
+    QTest::addColumn<QRegularExpression>("regexp");
+    QTest::addColumn<QString>("subject");
+    QTest::addColumn<qsizetype>("offset");
+    QTest::addColumn<QRegularExpression::MatchType>("matchType");
+
+    const auto caseless = QRegularExpression::CaseInsensitiveOption;
+    const auto ucp = QRegularExpression::UseUnicodePropertiesOption;
+
+    QTest::newRow("ascii") << QRegularExpression("(\\w+)=(\\d+)")
+                           << "size=1024 status=404" << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("ascii-offset") << QRegularExpression("(\\w+)=(\\d+)")
+                                  << "size=1024 status=404" << qsizetype(4) << QRegularExpression::NormalMatch;
+    QTest::newRow("ascii-negative-offset") << QRegularExpression("\\d+")
+                                           << "size=1024 status=404" << qsizetype(-3) << QRegularExpression::NormalMatch;
+    QTest::newRow("named") << QRegularExpression("(?<key>\\w+)=(?<value>\\w+)?")
+                           << "a= b=c" << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("latin1") << QRegularExpression("caf(.)\\s+(\\S+)")
+                            << u"au café crème"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("latin1-caseless") << QRegularExpression(u"ÉTÉ|Ü+"_s, caseless)
+                                     << u"un été à Zürich, üÜü"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("latin1-caseless-range") << QRegularExpression(u"[à-å]+"_s, caseless)
+                                           << u"xxÀÄâ!"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("latin1-word") << QRegularExpression("\\w+")
+                                 << u"éa"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("latin1-word-ucp") << QRegularExpression("\\w+", ucp)
+                                     << u"éa"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("latin1-posix") << QRegularExpression("[[:alpha:]]+", caseless)
+                                  << u"Ökonomie"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("latin1-property") << QRegularExpression("\\p{Lu}\\p{Ll}+")
+                                     << u"das Ökonomie"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("non-latin1-pattern") << QRegularExpression(u"(€|é)(\\d)"_s)
+                                        << u"prix é5"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("non-latin1-escape") << QRegularExpression("\\x{20ac}?(\\d)")
+                                       << u"prix 5"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("utf-verb") << QRegularExpression("(*UTF)é")
+                              << u"é"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("multibyte") << QRegularExpression(u"(\\S+) (\\S+)"_s)
+                               << u"Привет, 世界 😀!"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("multibyte-caseless") << QRegularExpression(u"мир"_s, caseless)
+                                        << u"Здравствуй, МИР"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("multibyte-offset") << QRegularExpression(u"."_s)
+                                      << u"世界😀x"_s << qsizetype(2) << QRegularExpression::NormalMatch;
+    QTest::newRow("empty-matches") << QRegularExpression("x*")
+                                   << u"aé世😀"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("empty-matches-crlf") << QRegularExpression("(*CRLF)(?m)^")
+                                        << u"a\r\né\r\n世\r\n"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("partial-lookbehind") << QRegularExpression("\\bstring\\b")
+                                        << u"a str"_s << qsizetype(0) << QRegularExpression::PartialPreferCompleteMatch;
+    QTest::newRow("partial-lookbehind-multibyte") << QRegularExpression(u"(?<=é)string"_s)
+                                                  << u"xxé str"_s << qsizetype(0) << QRegularExpression::PartialPreferFirstMatch;
+    QTest::newRow("partial-multibyte") << QRegularExpression(u"世界大戦"_s)
+                                       << u"xx世界"_s << qsizetype(0) << QRegularExpression::PartialPreferCompleteMatch;
+    QTest::newRow("no-match") << QRegularExpression("\\d")
+                              << u"none"_s << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("empty") << QRegularExpression("^$")
+                           << QString() << qsizetype(0) << QRegularExpression::NormalMatch;
+    QTest::newRow("no-match-type") << QRegularExpression("a")
+                                   << u"a"_s << qsizetype(0) << QRegularExpression::NoMatch;
+}
+
+// Checks that match has the same results as the match over UTF-16
+// reference, with the offsets mapped to the subject's units by toUnits
+template <typename ToUnits>
+static void compareMatches(const QRegularExpressionMatch &match,
+                           const QRegularExpressionMatch &reference,
+                           ToUnits toUnits)
+{
+    QCOMPARE(match.isValid(), reference.isValid());
+    QCOMPARE(match.hasMatch(), reference.hasMatch());
+    QCOMPARE(match.hasPartialMatch(), reference.hasPartialMatch());
+    QCOMPARE(match.lastCapturedIndex(), reference.lastCapturedIndex());
+    for (int i = 0; i <= reference.lastCapturedIndex(); ++i) {
+        QCOMPARE(match.hasCaptured(i), reference.hasCaptured(i));
+        QCOMPARE(match.captured(i), reference.captured(i));
+        QVERIFY(match.capturedView(i).isNull());
+        if (reference.hasCaptured(i)) {
+            QCOMPARE(match.capturedStart(i), toUnits(reference.capturedStart(i)));
+            QCOMPARE(match.capturedEnd(i), toUnits(reference.capturedEnd(i)));
+        } else {
+            QCOMPARE(match.capturedStart(i), -1);
+            QVERIFY(match.captured(i).isNull());
+        }
+    }
+    const QStringList names = reference.regularExpression().namedCaptureGroups();
+    for (const QString &name : names) {
+        if (!name.isEmpty())
+            QCOMPARE(match.captured(name), reference.captured(name));
+    }
+}
+
+void tst_QRegularExpression::utf8AndLatin1Subjects()
+{
+    QFETCH(QRegularExpression, regexp);
+    QFETCH(QString, subject);
+    QFETCH(qsizetype, offset);
+    QFETCH(QRegularExpression::MatchType, matchType);
+
+    const QByteArray utf8 = subject.toUtf8();
+    const auto toUtf8Units = [&](qsizetype offset) {
+        return offset < 0 ? offset : QStringView(subject).first(offset).toUtf8().size();
+    };
+    const auto toLatin1Units = [](qsizetype offset) { return offset; };
+    const qsizetype utf8Offset = offset < 0
+            ? -QStringView(subject).last(-offset).toUtf8().size() : toUtf8Units(offset);
+
+    const QRegularExpressionMatch reference = regexp.matchView(QStringView(subject), offset, matchType);
+    compareMatches(regexp.matchView(QUtf8StringView(utf8), utf8Offset, matchType),
+                   reference, toUtf8Units);
+    if (QTest::currentTestFailed())
+        return;
+
+    // a partial match at the end of the subject is found again and again
+    // by a global match, so only iterate over complete matches
+    const bool iterate = matchType == QRegularExpression::NormalMatch;
+    if (iterate) {
+        QRegularExpressionMatchIterator referenceIterator =
+                regexp.globalMatchView(QStringView(subject), offset, matchType);
+        QRegularExpressionMatchIterator iterator =
+                regexp.globalMatchView(QUtf8StringView(utf8), utf8Offset, matchType);
+        while (referenceIterator.hasNext()) {
+            QVERIFY(iterator.hasNext());
+            compareMatches(iterator.next(), referenceIterator.next(), toUtf8Units);
+            if (QTest::currentTestFailed())
+                return;
+        }
+        QVERIFY(!iterator.hasNext());
+    }
+
+    if (!QtPrivate::isLatin1(subject))
+        return;
+
+    const QByteArray latin1 = subject.toLatin1();
+    compareMatches(regexp.matchView(QLatin1StringView(latin1), offset, matchType),
+                   reference, toLatin1Units);
+    if (QTest::currentTestFailed() || !iterate)
+        return;
+
+    QRegularExpressionMatchIterator referenceIterator =
+            regexp.globalMatchView(QStringView(subject), offset, matchType);
+    QRegularExpressionMatchIterator iterator =
+            regexp.globalMatchView(QLatin1StringView(latin1), offset, matchType);
+    while (referenceIterator.hasNext()) {
+        QVERIFY(iterator.hasNext());
+        compareMatches(iterator.next(), referenceIterator.next(), toLatin1Units);
+        if (QTest::currentTestFailed())
+            return;
+    }
+    QVERIFY(!iterator.hasNext());
+}
+
+void tst_QRegularExpression::invalidUtf8Subject()
+{
+    const QRegularExpression re("b+");
+    const QByteArray subject = "a\xff\xfe bb";
+
+    QRegularExpressionMatch match = re.matchView(QUtf8StringView(subject));
+    QVERIFY(!match.isValid());
+    QVERIFY(!match.hasMatch());
+
+    // an offset inside of a character
+    const QByteArray multibyte = "\xc3\xa9 bb";
+    match = re.matchView(QUtf8StringView(multibyte), 1);
+    QVERIFY(!match.isValid());
+    match = re.matchView(QUtf8StringView(multibyte), 2);
+    QVERIFY(match.isValid());
+    QVERIFY(match.hasMatch());
+    QCOMPARE(match.capturedStart(), 3);
+    QCOMPARE(match.captured(), u"bb"_s);
+}
+
 void tst_QRegularExpression::threadSafety_data()
 {
     QTest::addColumn<QString>("pattern");
@@ -155,6 +155,8 @@ private slots:
 
     void utf8Codec_data();
     void utf8Codec();
+    void utf8Blocks_data();
+    void utf8Blocks();
 
     void utf8bom_data();
     void utf8bom();
@@ -1782,6 +1784,87 @@ void tst_QStringConverter::utf8Codec()
     QCOMPARE(str, res);
 }
 
+// long runs of non-ASCII text, which the vector code decodes in blocks
+void tst_QStringConverter::utf8Blocks_data()
+{
+    QTest::addColumn<QByteArray>("utf8");
+    QTest::addColumn<QString>("res");
+    QTest::addColumn<bool>("valid");
+
+    const struct {
+        const char *name;
+        QByteArray utf8;
+        QString str;
+    } chars[] = {
+        { "2-byte", "\xc3\xa9"_ba, u"\u00e9"_s },
+        { "3-byte", "\xe4\xb8\xad"_ba, u"\u4e2d"_s },
+        { "mixed", "a\xc3\xa9\xe4\xb8\xad"_ba, u"a\u00e9\u4e2d"_s },
+    };
+    for (const auto &c : chars) {
+        for (int count : { 16, 31, 32, 33, 64, 100 }) {
+            QTest::addRow("%s-x%d", c.name, count)
+                    << c.utf8.repeated(count) << c.str.repeated(count) << true;
+        }
+    }
+
+    // a prefix of exactly n bytes of two- and three-byte sequences, so that
+    // what follows starts at every offset within a block
+    const auto prefix = [](int n, QByteArray *utf8, QString *str) {
+        if (n % 2) {
+            *utf8 = n == 1 ? "a"_ba : "\xe4\xb8\xad"_ba;
+            *str = n == 1 ? u"a"_s : u"\u4e2d"_s;
+            n -= utf8->size();
+        }
+        *utf8 += "\xc3\xa9"_ba.repeated(n / 2);
+        *str += u"\u00e9"_s.repeated(n / 2);
+    };
+    const QByteArray suffix = "\xe4\xb8\xad\xc3\xa9"_ba.repeated(16);
+    const QString suffixStr = u"\u4e2d\u00e9"_s.repeated(16);
+
+    const struct {
+        const char *name;
+        QByteArray utf8;
+    } invalid[] = {
+        { "ff", "\xff"_ba },
+        { "continuation", "\x80"_ba },
+        { "overlong", "\xc0\xaf"_ba },
+        { "overlong-3", "\xe0\x80\xaf"_ba },
+        { "surrogate", "\xed\xa0\x80"_ba },
+    };
+    for (int offset = 0; offset < 64; ++offset) {
+        QByteArray utf8;
+        QString str;
+        prefix(offset, &utf8, &str);
+        for (const auto &i : invalid) {
+            QTest::addRow("%s-at-%d", i.name, offset)
+                    << utf8 + i.utf8 + suffix
+                    << str + fromInvalidUtf8Sequence(i.utf8) + suffixStr << false;
+        }
+        // valid, but not handled by the vector code
+        QTest::addRow("4-byte-at-%d", offset)
+                << utf8 + "\xf0\x9f\x98\x80"_ba + suffix
+                << str + u"\U0001f600"_s + suffixStr << true;
+        // truncated at the end of the data
+        QTest::addRow("truncated-at-%d", offset)
+                << utf8 + "\xe4\xb8"_ba << str + fromInvalidUtf8Sequence("\xe4\xb8"_ba) << false;
+    }
+}
+
+void tst_QStringConverter::utf8Blocks()
+{
+    QFETCH(QByteArray, utf8);
+    QFETCH(QString, res);
+    QFETCH(bool, valid);
+
+    QStringDecoder decoder(QStringDecoder::Utf8, QStringDecoder::Flag::Stateless);
+    QCOMPARE(decoder(utf8), res);
+    QCOMPARE(QString::fromUtf8(utf8), res);
+    QCOMPARE(QByteArrayView(utf8).isValidUtf8(), valid);
+    QCOMPARE(QUtf8StringView(utf8).isValidUtf8(), valid);
+    if (valid)
+        QCOMPARE(res.toUtf8(), utf8);
+}
+
 QT_WARNING_PUSH
 QT_WARNING_DISABLE_DEPRECATED
 void tst_QStringConverter::utf8bom_data()
@@ -33,6 +33,8 @@ private slots:
     void filterMode();
     void addCanceledResult();
     void count();
+    void inOrderResults_data();
+    void inOrderResults();
     void pendingResultsDoNotLeak_data();
     void pendingResultsDoNotLeak();
 private:
@@ -515,6 +517,74 @@ void tst_QtConcurrentResultStore::count()
     }
 }
 
+void tst_QtConcurrentResultStore::inOrderResults_data()
+{
+    QTest::addColumn<bool>("filterMode");
+    QTest::addColumn<bool>("explicitIndex");
+
+    QTest::addRow("filter-mode-off") << false << false;
+    QTest::addRow("filter-mode-off, explicit index") << false << true;
+    QTest::addRow("filter-mode-on") << true << false;
+    QTest::addRow("filter-mode-on, explicit index") << true << true;
+}
+
+void tst_QtConcurrentResultStore::inOrderResults()
+{
+    QFETCH(bool, filterMode);
+    QFETCH(bool, explicitIndex);
+
+    QtPrivate::ResultStoreBase store;
+    IntResultsCleaner cleanGuard(store);
+    store.setFilterMode(filterMode);
+
+    constexpr int Count = 10000;
+    store.addResult(-1, &int0);
+    const int *first = store.resultAt(0).pointer<int>();
+    for (int i = 1; i < Count; ++i) {
+        QCOMPARE(store.addResult(explicitIndex ? i : -1, &i), i);
+        QCOMPARE(store.count(), i + 1);
+    }
+    QCOMPARE(store.addResult(Count - 1, &int0), -1); // reject if already present
+
+    // results are appended without moving the ones already stored
+    QCOMPARE(store.resultAt(0).pointer<int>(), first);
+    for (int i = 0; i < Count; ++i)
+        QCOMPARE(store.resultAt(i).value<int>(), i);
+
+    // and are stored in batches
+    int batches = 0;
+    int index = 0;
+    for (ResultIteratorBase it = store.begin(); it != store.end(); it.batchedAdvance()) {
+        QCOMPARE(it.resultIndex(), index);
+        index += it.batchSize();
+        ++batches;
+    }
+    QCOMPARE(index, Count);
+    QVERIFY2(batches < Count / 100, qPrintable(QString::number(batches)));
+
+    index = 0;
+    for (ResultIteratorBase it = store.begin(); it != store.end(); ++it)
+        QCOMPARE(it.value<int>(), index++);
+    QCOMPARE(index, Count);
+
+    // out-of-order results still work after in-order ones
+    QCOMPARE(store.addResult(Count + 1, &int1), Count + 1);
+    QCOMPARE(store.count(), Count);
+    if (filterMode) {
+        QCOMPARE(store.addCanceledResult(Count), Count);
+        QCOMPARE(store.count(), Count + 1);
+        QCOMPARE(store.resultAt(Count).value<int>(), int1);
+    } else {
+        QCOMPARE(store.addResult(Count, &int0), Count);
+        QCOMPARE(store.count(), Count + 2);
+        QCOMPARE(store.resultAt(Count + 1).value<int>(), int1);
+
+        QCOMPARE(store.addResult(-1, &int2), Count + 2);
+        QCOMPARE(store.count(), Count + 3);
+        QCOMPARE(store.resultAt(Count + 2).value<int>(), int2);
+    }
+}
+
 // simplified version of CountedObject from tst_qarraydata.cpp
 struct CountedObject
 {
@@ -583,6 +653,10 @@ void tst_QtConcurrentResultStore::pendingResultsDoNotLeak()
     // array
     auto lvalueListOfObj = QList<CountedObject>({CountedObject(), CountedObject()});
     store.addResults(44, &lvalueListOfObj);
+
+    // appended to a chunk
+    store.moveResult(46, CountedObject());
+    store.moveResult(47, CountedObject());
 }
 
 QTEST_MAIN(tst_QtConcurrentResultStore)
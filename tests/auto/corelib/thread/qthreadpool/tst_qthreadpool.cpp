@@ -70,6 +70,7 @@ private slots:
     void reserveAndStart();
     void reserveAndStart2();
     void releaseAndBlock();
+    void releaseAndBlockOnLocalTask();
     void start();
     void tryStart();
     void tryStartPeakThreadCount();
@@ -859,6 +860,26 @@ void tst_QThreadPool::releaseAndBlock()
     QTRY_COMPARE(threadpool->activeThreadCount(), 0);
 }
 
+void tst_QThreadPool::releaseAndBlockOnLocalTask()
+{
+    QThreadPool threadpool;
+    threadpool.setMaxThreadCount(1);
+
+    // the pool is busy, so the inner task is queued for the outer task's
+    // thread; releasing that thread must let another thread take it over
+    QSemaphore innerDone;
+    bool innerRan = false;
+    threadpool.start([&] {
+        threadpool.start([&] { innerDone.release(); });
+        threadpool.releaseThread();
+        innerRan = innerDone.tryAcquire(1, 10000);
+        threadpool.reserveThread();
+    });
+
+    QVERIFY(threadpool.waitForDone());
+    QVERIFY(innerRan);
+}
+
 static QAtomicInt count;
 class CountingRunnable : public QRunnable
 {
@@ -21,6 +21,10 @@ private slots:
     void intermediary_result_data();
     void intermediary_result();
     void sha1();
+    void chunkedData_data();
+    void chunkedData();
+    void hashBatch_data();
+    void hashBatch();
     void sha3_data();
     void sha3();
     void blake2_data();
@@ -194,6 +198,88 @@ void tst_QCryptographicHash::sha1()
              QByteArray("34AA973CD4C4DAA4F61EEB2BDBAD27316534016F"));
 }
 
+void tst_QCryptographicHash::chunkedData_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<int>("chunkSize");
+    QTest::addColumn<QByteArray>("result");
+
+    // the SHA-1 and SHA-2 implementations buffer partial blocks of 64
+    // bytes, and process the complete ones all at once
+    const struct {
+        QCryptographicHash::Algorithm algorithm;
+        const char *name;
+        QByteArray result;
+    } algorithms[] = {
+        { QCryptographicHash::Sha1, "sha1",
+          QByteArray::fromHex("C9C960A0B925474FAB83942CC27D504FC24AC37B") },
+        { QCryptographicHash::Sha224, "sha224",
+          QByteArray::fromHex("C182669A7F6629DC7FD8A9198F15AF15ADBBAEFFA1842E854F681357") },
+        { QCryptographicHash::Sha256, "sha256",
+          QByteArray::fromHex("4E4C294B331F7A2099A379BEC34B9F9FC03DC46AB465D998F4D683DA53487E6D") },
+    };
+    for (const auto &algorithm : algorithms) {
+        for (int chunkSize : { 1, 7, 63, 64, 65, 130, 1000 }) {
+            QTest::addRow("%s-%d", algorithm.name, chunkSize)
+                    << algorithm.algorithm << chunkSize << algorithm.result;
+        }
+    }
+}
+
+void tst_QCryptographicHash::chunkedData()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(int, chunkSize);
+    QFETCH(QByteArray, result);
+
+    QByteArray data(1000, Qt::Uninitialized);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = char(i % 251);
+
+    QCryptographicHash hash(algorithm);
+    for (qsizetype i = 0; i < data.size(); i += chunkSize)
+        hash.addData(QByteArrayView(data).sliced(i, qMin(chunkSize, data.size() - i)));
+    QCOMPARE(hash.resultView(), result);
+    QCOMPARE(QCryptographicHash::hash(data, algorithm), result);
+}
+
+void tst_QCryptographicHash::hashBatch_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<int>("count");
+
+    for (auto algorithm : { QCryptographicHash::Md5, QCryptographicHash::Sha1,
+                            QCryptographicHash::Sha224, QCryptographicHash::Sha256,
+                            QCryptographicHash::Sha512, QCryptographicHash::Sha3_256 }) {
+        const char *name = QMetaEnum::fromType<QCryptographicHash::Algorithm>().valueToKey(algorithm);
+        for (int count : { 0, 1, 5, 8, 100 })
+            QTest::addRow("%s-%d", name, count) << algorithm << count;
+    }
+}
+
+void tst_QCryptographicHash::hashBatch()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(int, count);
+
+    // messages of all lengths around the block sizes, some of them long
+    // enough to keep being hashed after the others are done
+    QList<QByteArray> messages;
+    for (int i = 0; i < count; ++i) {
+        const int length = i % 10 == 9 ? 1000 * i : i * 3;
+        QByteArray message(length, Qt::Uninitialized);
+        for (int j = 0; j < length; ++j)
+            message[j] = char(i + j * 7);
+        messages.append(message);
+    }
+    const QList<QByteArrayView> views(messages.cbegin(), messages.cend());
+
+    const QByteArrayList results = QCryptographicHash::hashBatch(views, algorithm);
+    QCOMPARE(results.size(), count);
+    for (int i = 0; i < count; ++i)
+        QCOMPARE(results.at(i), QCryptographicHash::hash(messages.at(i), algorithm));
+}
+
 void tst_QCryptographicHash::sha3_data()
 {
     QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
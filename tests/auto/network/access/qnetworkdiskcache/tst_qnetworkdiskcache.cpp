@@ -45,6 +45,8 @@ private slots:
     void updateMetaData();
     void fileMetaData();
     void expire();
+    void index();
+    void expireOverride();
 
     void oldCacheVersionFile_data();
     void oldCacheVersionFile();
@@ -264,8 +266,12 @@ static QStringList countFiles(const QString dir)
     QStringList list;
     QDir::Filters filter(QDir::AllEntries | QDir::NoDotAndDotDot);
     QDirIterator it(dir, filter, QDirIterator::Subdirectories);
-    while (it.hasNext())
-        list.append(it.next());
+    while (it.hasNext()) {
+        const QString fileName = it.next();
+        // the index of the cache is always there
+        if (!fileName.endsWith("/index"))
+            list.append(fileName);
+    }
     return list;
 }
 
@@ -537,6 +543,136 @@ void tst_QNetworkDiskCache::expire()
     }
 }
 
+static QIODevice *prepareEntry(QNetworkDiskCache &cache, const QUrl &url)
+{
+    QNetworkCacheMetaData metaData;
+    metaData.setUrl(url);
+    // entries without headers are rejected when read back; this type is
+    // not compressed, so that all entries have the same size
+    metaData.setRawHeaders({ { "content-type", "application/octet-stream" } });
+    QIODevice *device = cache.prepare(metaData);
+    if (device)
+        device->write(QByteArray(1000, 'x'));
+    return device;
+}
+
+void tst_QNetworkDiskCache::index()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QUrl a("http://localhost:4/index/a");
+    const QUrl b("http://localhost:4/index/b");
+    const QUrl c("http://localhost:4/index/c");
+
+    qint64 size = 0;
+    {
+        SubQNetworkDiskCache cache;
+        cache.setClearCacheOnDestruction(false);
+        cache.setCacheDirectory(dir.path());
+        for (const QUrl &url : { a, b, c }) {
+            QIODevice *device = prepareEntry(cache, url);
+            QVERIFY(device);
+            cache.insert(device);
+        }
+        size = cache.cacheSize();
+        QVERIFY(size > 3000);
+
+        // reading a makes b the least recently used entry
+        std::unique_ptr<QIODevice> device(cache.data(a));
+        QVERIFY(device);
+    }
+
+    {
+        // the index restores the size and use order of the entries
+        SubQNetworkDiskCache cache;
+        cache.setClearCacheOnDestruction(false);
+        cache.setCacheDirectory(dir.path());
+        QCOMPARE(cache.cacheSize(), size);
+        cache.setMaximumCacheSize(size * 5 / 6);
+        QCOMPARE(cache.cacheSize(), size / 3 * 2);
+        size = cache.cacheSize();
+        QVERIFY(cache.metaData(a).isValid());
+        QVERIFY(!cache.metaData(b).isValid());
+        QVERIFY(cache.metaData(c).isValid());
+    }
+
+    const QString indexFile = dir.filePath("data8/index");
+    QVERIFY(QFile::exists(indexFile));
+    {
+        // cut off the last record, which removed b
+        QFile file(indexFile);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(file.size() - 1));
+    }
+    {
+        // the stale entry is dropped when it is looked up
+        SubQNetworkDiskCache cache;
+        cache.setClearCacheOnDestruction(false);
+        cache.setCacheDirectory(dir.path());
+        QVERIFY(cache.metaData(a).isValid());
+        QVERIFY(!cache.metaData(b).isValid());
+        QCOMPARE(cache.cacheSize(), size);
+    }
+
+    // without the index, the cache files are scanned
+    QVERIFY(QFile::remove(indexFile));
+    SubQNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    QCOMPARE(cache.cacheSize(), size);
+    QVERIFY(cache.metaData(a).isValid());
+    QVERIFY(cache.metaData(c).isValid());
+    QVERIFY(QFile::exists(indexFile));
+}
+
+// removes the cache files itself, as a reimplementation that scans the
+// cache directory would, rather than with remove()
+class RemovingDiskCache : public QNetworkDiskCache
+{
+public:
+    bool removeAll = false;
+
+protected:
+    qint64 expire() override
+    {
+        if (!removeAll)
+            return QNetworkDiskCache::expire();
+        QDirIterator it(cacheDirectory(), { "*.d" }, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            QFile::remove(it.next());
+        return 0;
+    }
+};
+
+void tst_QNetworkDiskCache::expireOverride()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QUrl a("http://localhost:4/expire/a");
+    const QUrl b("http://localhost:4/expire/b");
+
+    {
+        RemovingDiskCache cache;
+        cache.setCacheDirectory(dir.path());
+        for (const QUrl &url : { a, b }) {
+            QIODevice *device = prepareEntry(cache, url);
+            QVERIFY(device);
+            cache.insert(device);
+        }
+        QVERIFY(cache.cacheSize() > 2000);
+
+        cache.removeAll = true;
+        cache.clear();
+        QCOMPARE(cache.cacheSize(), 0);
+        QVERIFY(!cache.metaData(a).isValid());
+        QVERIFY(!cache.metaData(b).isValid());
+    }
+
+    // the removal was recorded in the index
+    QNetworkDiskCache cache;
+    cache.setCacheDirectory(dir.path());
+    QCOMPARE(cache.cacheSize(), 0);
+}
+
 void tst_QNetworkDiskCache::oldCacheVersionFile_data()
 {
     QTest::addColumn<int>("pass");
@@ -318,6 +318,7 @@ private Q_SLOTS:
     void ioPutToHttpFromFile();
     void ioPostToHttpFromFile_data();
     void ioPostToHttpFromFile();
+    void ioPostToHttpFromFileAtOffset();
 #if QT_CONFIG(networkproxy)
     void ioPostToHttpFromSocket_data();
     void ioPostToHttpFromSocket();
@@ -452,6 +453,8 @@ private Q_SLOTS:
 
     void amountOfHttp1ConnectionsQtbug25280_data();
     void amountOfHttp1ConnectionsQtbug25280();
+    void http1IdleConnectionTimeout();
+    void http1SharedConnectionPool();
 
     void dontInsertPartialContentIntoTheCache();
 
@@ -4823,6 +4826,35 @@ void tst_QNetworkReply::ioPostToHttpFromFile()
     QCOMPARE(reply->readAll().trimmed(), md5sum(sourceFile.readAll()).toHex());
 }
 
+void tst_QNetworkReply::ioPostToHttpFromFileAtOffset()
+{
+    // large enough to need several writes, whether or not the file is sent
+    // without being read
+    QByteArray data(1024*1024 + 3, Qt::Uninitialized);
+    for (qsizetype i = 0; i < data.size(); ++i)
+        data[i] = char(i % 251);
+
+    QTemporaryFile sourceFile(QDir::currentPath() + "/temp-XXXXXX");
+    QVERIFY(sourceFile.open());
+    QCOMPARE(sourceFile.write(data), data.size());
+    const qint64 offset = 1000;
+    QVERIFY(sourceFile.seek(offset));
+
+    MiniHttpServer server("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+    QNetworkRequest request(QUrl("http://localhost:" + QString::number(server.serverPort())));
+    request.setRawHeader("Content-Type", "application/octet-stream");
+
+    QNetworkReplyPtr reply(manager.post(request, &sourceFile));
+
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+
+    const qsizetype endOfHeader = server.receivedData.indexOf("\r\n\r\n");
+    QVERIFY(endOfHeader != -1);
+    QCOMPARE(server.receivedData.mid(endOfHeader + 4), data.mid(offset));
+    QVERIFY(sourceFile.atEnd());
+}
+
 #if QT_CONFIG(networkproxy)
 void tst_QNetworkReply::ioPostToHttpFromSocket_data()
 {
@@ -8152,15 +8184,18 @@ public:
 void tst_QNetworkReply::amountOfHttp1ConnectionsQtbug25280_data()
 {
     QTest::addColumn<int>("amount");
-    QTest::addRow("default") << 6;
-    QTest::addRow("minimize") << 1;
-    QTest::addRow("increase") << 12;
+    QTest::addColumn<int>("maximum");
+    QTest::addRow("default") << 6 << 6;
+    QTest::addRow("minimize") << 1 << 1;
+    QTest::addRow("increase") << 12 << 12;
+    QTest::addRow("grow") << 2 << 8;
 }
 
 // Also kind of QTBUG-8468
 void tst_QNetworkReply::amountOfHttp1ConnectionsQtbug25280()
 {
     QFETCH(const int, amount);
+    QFETCH(const int, maximum);
     QNetworkAccessManager manager; // function local instance
     Qtbug25280Server server(tst_QNetworkReply::httpEmpty200Response);
     server.doClose = false;
@@ -8171,6 +8206,10 @@ void tst_QNetworkReply::amountOfHttp1ConnectionsQtbug25280()
     std::optional<QHttp1Configuration> http1Configuration;
     if (amount != 6) // don't set if it's the default
         http1Configuration.emplace().setNumberOfConnectionsPerHost(amount);
+    if (maximum != amount) {
+        // all connections are busy while requests wait, so the pool grows to the maximum
+        http1Configuration.value().setMaximumNumberOfConnectionsPerHost(maximum);
+    }
     constexpr int NumRequests = 200; // send a lot more than we have sockets
     int finished = 0;
     std::array<std::unique_ptr<QNetworkReply>, NumRequests> replies;
@@ -8187,7 +8226,71 @@ void tst_QNetworkReply::amountOfHttp1ConnectionsQtbug25280()
         QCOMPARE(reply->error(), QNetworkReply::NoError);
         QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
     }
-    QCOMPARE(server.receivedSockets.size(), amount);
+    QCOMPARE(server.receivedSockets.size(), maximum);
+}
+
+void tst_QNetworkReply::http1IdleConnectionTimeout()
+{
+    QNetworkAccessManager manager; // function local instance
+    MiniHttpServer server(tst_QNetworkReply::httpEmpty200Response);
+    server.doClose = false;
+    QUrl url(QLatin1String("http://127.0.0.1"));
+    url.setPort(server.serverPort());
+
+    QHttp1Configuration http1Configuration;
+    http1Configuration.setIdleConnectionTimeout(std::chrono::seconds(1));
+    QCOMPARE(http1Configuration.idleConnectionTimeout(), std::chrono::seconds(1));
+    QNetworkRequest request(url);
+    request.setHttp1Configuration(http1Configuration);
+
+    QNetworkReplyPtr reply(manager.get(request));
+    QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QVERIFY(server.client);
+    QCOMPARE(server.client->state(), QAbstractSocket::ConnectedState);
+
+    // the kept-alive connection is closed by the client once it was idle for long enough
+    QTRY_COMPARE_WITH_TIMEOUT(server.client->state(), QAbstractSocket::UnconnectedState, 10'000);
+    QCOMPARE(server.totalConnections, 1);
+}
+
+void tst_QNetworkReply::http1SharedConnectionPool()
+{
+    MiniHttpServer server(tst_QNetworkReply::httpEmpty200Response);
+    server.doClose = false;
+    QUrl url(QLatin1String("http://127.0.0.1"));
+    url.setPort(server.serverPort());
+
+    QHttp1Configuration http1Configuration;
+    http1Configuration.setSharedConnectionPoolEnabled(true);
+    QVERIFY(http1Configuration.sharedConnectionPoolEnabled());
+    QNetworkRequest request(url);
+    request.setHttp1Configuration(http1Configuration);
+
+    for (int i = 0; i < 3; ++i) {
+        QNetworkAccessManager manager; // a new manager every time
+        QNetworkReplyPtr reply(manager.get(request));
+        QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        server.clearHeaderParserState();
+    }
+    // all managers used the same connection
+    QCOMPARE(server.totalConnections, 1);
+
+    // but requests with credentials don't get the anonymous connection,
+    // and only share one with requests using the same credentials
+    QUrl userUrl = url;
+    userUrl.setUserInfo(u"user:password"_s);
+    QNetworkRequest userRequest(userUrl);
+    userRequest.setHttp1Configuration(http1Configuration);
+    for (int i = 0; i < 2; ++i) {
+        QNetworkAccessManager manager;
+        QNetworkReplyPtr reply(manager.get(userRequest));
+        QVERIFY2(waitForFinish(reply) == Success, msgWaitForFinished(reply));
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        server.clearHeaderParserState();
+    }
+    QCOMPARE(server.totalConnections, 2);
 }
 
 void tst_QNetworkReply::dontInsertPartialContentIntoTheCache()
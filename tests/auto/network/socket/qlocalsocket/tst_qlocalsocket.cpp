@@ -19,6 +19,10 @@
 #include <qproperty.h>
 #include <QtNetwork/qlocalsocket.h>
 #include <QtNetwork/qlocalserver.h>
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#if QT_CONFIG(localsocket_sharedmemory)
+#include <QtNetwork/private/qlocalsocket_p.h>
+#endif
 
 #ifdef Q_OS_UNIX
 #include <sys/types.h>
@@ -124,6 +128,11 @@ private slots:
 
     void serverBindingsAndProperties();
 
+    void sharedMemoryTransport_data();
+    void sharedMemoryTransport();
+    void sharedMemoryTransportPlainServer();
+    void sharedMemoryTransportPlainClient();
+
 protected slots:
     void socketClosedSlot();
 };
@@ -1817,6 +1826,162 @@ void tst_QLocalSocket::serverBindingsAndProperties()
     QCOMPARE(sockOpts.value(), QLocalServer::OtherAccessOption);
 }
 
+void tst_QLocalSocket::sharedMemoryTransport_data()
+{
+    QTest::addColumn<bool>("clientOption");
+    QTest::addColumn<bool>("serverOption");
+    QTest::addColumn<bool>("sharedMemory");
+
+    QTest::newRow("both") << true << true << true;
+    QTest::newRow("server-only") << false << true << false;
+    QTest::newRow("none") << false << false << false;
+}
+
+#if QT_CONFIG(localsocket_sharedmemory)
+static bool usesSharedMemory(QLocalSocket *socket)
+{
+    const auto d = static_cast<QLocalSocketPrivate *>(QObjectPrivate::get(socket));
+    return d->sharedMemoryState == QLocalSocketPrivate::SharedMemoryState::Active;
+}
+#endif
+
+void tst_QLocalSocket::sharedMemoryTransport()
+{
+    QFETCH(bool, clientOption);
+    QFETCH(bool, serverOption);
+    QFETCH(bool, sharedMemory);
+
+    CrashSafeLocalServer server;
+    if (serverOption)
+        server.setSocketOptions(QLocalServer::SharedMemoryTransportOption);
+    QVERIFY2(server.listen("sharedMemoryTransport"), qUtf8Printable(server.errorString()));
+
+    QLocalSocket client;
+    if (clientOption)
+        client.setSocketOptions(QLocalSocket::SharedMemoryTransportOption);
+    client.connectToServer("sharedMemoryTransport");
+    QVERIFY(server.waitForNewConnection(3000));
+    QLocalSocket *serverSocket = server.nextPendingConnection();
+    QVERIFY(serverSocket);
+    // the handshake needs the server socket to run
+    QTRY_COMPARE(client.state(), QLocalSocket::ConnectedState);
+#if QT_CONFIG(localsocket_sharedmemory)
+    QCOMPARE(usesSharedMemory(&client), sharedMemory);
+#else
+    Q_UNUSED(sharedMemory);
+#endif
+
+    // more than fits into the shared memory at once
+    QByteArray data(10 * 1024 * 1024, Qt::Uninitialized);
+    for (qsizetype i = 0; i < data.size(); ++i)
+        data[i] = char(i % 251);
+
+    QByteArray received;
+    connect(serverSocket, &QLocalSocket::readyRead, this, [&] {
+        received += serverSocket->readAll();
+    });
+    qint64 bytesWritten = 0;
+    connect(&client, &QLocalSocket::bytesWritten, this, [&](qint64 bytes) {
+        bytesWritten += bytes;
+    });
+    QCOMPARE(client.write(data), data.size());
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), data.size(), 10000);
+    QCOMPARE(received, data);
+    QTRY_COMPARE(bytesWritten, data.size());
+    QCOMPARE(client.bytesToWrite(), qint64(0));
+#if QT_CONFIG(localsocket_sharedmemory)
+    QCOMPARE(usesSharedMemory(serverSocket), sharedMemory);
+#endif
+
+    QCOMPARE(serverSocket->write("first line\nsecond"), qint64(17));
+    QTRY_COMPARE(client.bytesAvailable(), qint64(17));
+    QVERIFY(client.canReadLine());
+    QCOMPARE(client.readLine(), QByteArray("first line\n"));
+    QVERIFY(!client.canReadLine());
+    QCOMPARE(client.skip(3), qint64(3));
+    QCOMPARE(client.readAll(), QByteArray("ond"));
+
+    QCOMPARE(serverSocket->write("bye"), qint64(3));
+    serverSocket->disconnectFromServer();
+    // both ends live in this thread: don't block the server's flush
+    QTRY_COMPARE(client.state(), QLocalSocket::UnconnectedState);
+    QCOMPARE(client.readAll(), QByteArray("bye"));
+}
+
+void tst_QLocalSocket::sharedMemoryTransportPlainServer()
+{
+#if !QT_CONFIG(localsocket_sharedmemory)
+    QSKIP("The shared memory transport is not available on this platform");
+#else
+    CrashSafeLocalServer server;
+    QVERIFY2(server.listen("sharedMemoryTransportPlainServer"),
+             qUtf8Printable(server.errorString()));
+
+    QLocalSocket client;
+    client.setSocketOptions(QLocalSocket::SharedMemoryTransportOption);
+    QSignalSpy errorSpy(&client, &QLocalSocket::errorOccurred);
+    client.connectToServer("sharedMemoryTransportPlainServer");
+    QVERIFY(server.waitForNewConnection(3000));
+    QLocalSocket *serverSocket = server.nextPendingConnection();
+    QVERIFY(serverSocket);
+
+    // the server speaks first; its greeting is not a reply to the hello
+    QCOMPARE(serverSocket->write("220 hello\r\n"), qint64(11));
+    QTRY_COMPARE(errorSpy.size(), 1);
+    QCOMPARE(client.error(), QLocalSocket::ConnectionError);
+    QCOMPARE(client.state(), QLocalSocket::UnconnectedState);
+#endif
+}
+
+void tst_QLocalSocket::sharedMemoryTransportPlainClient()
+{
+#if !QT_CONFIG(localsocket_sharedmemory)
+    QSKIP("The shared memory transport is not available on this platform");
+#else
+    CrashSafeLocalServer server;
+    server.setSocketOptions(QLocalServer::SharedMemoryTransportOption);
+    QVERIFY2(server.listen("sharedMemoryTransportPlainClient"),
+             qUtf8Printable(server.errorString()));
+
+    QLocalSocket client;
+    client.connectToServer("sharedMemoryTransportPlainClient");
+    QVERIFY(client.waitForConnected(3000));
+    QVERIFY(server.waitForNewConnection(3000));
+    QLocalSocket *serverSocket = server.nextPendingConnection();
+    QVERIFY(serverSocket);
+
+    // the server speaks first and the client waits for it: the greeting is
+    // held back until the hello timeout expired
+    QElapsedTimer timer;
+    timer.start();
+    QCOMPARE(serverSocket->write("220 hello\r\n"), qint64(11));
+    QTRY_COMPARE_WITH_TIMEOUT(client.bytesAvailable(), qint64(11), 10000);
+    QVERIFY(timer.elapsed() >= QLocalSocketPrivate::HelloTimeout - 100);
+    QCOMPARE(client.readAll(), QByteArray("220 hello\r\n"));
+    QVERIFY(!usesSharedMemory(serverSocket));
+
+    QCOMPARE(client.write("QUIT\r\n"), qint64(6));
+    QTRY_COMPARE(serverSocket->bytesAvailable(), qint64(6));
+    QCOMPARE(serverSocket->readAll(), QByteArray("QUIT\r\n"));
+
+    // the blocking functions also give up waiting for the hello
+    CrashSafeLocalServer blockingServer;
+    blockingServer.setSocketOptions(QLocalServer::SharedMemoryTransportOption);
+    QVERIFY2(blockingServer.listen("sharedMemoryTransportPlainClientBlocking"),
+             qUtf8Printable(blockingServer.errorString()));
+    QLocalSocket blockingClient;
+    blockingClient.connectToServer("sharedMemoryTransportPlainClientBlocking");
+    QVERIFY(blockingClient.waitForConnected(3000));
+    QVERIFY(blockingServer.waitForNewConnection(3000));
+    serverSocket = blockingServer.nextPendingConnection();
+    QVERIFY(serverSocket);
+    QCOMPARE(serverSocket->write("220 hello\r\n"), qint64(11));
+    QVERIFY(serverSocket->waitForBytesWritten(10000));
+    QVERIFY(blockingClient.waitForReadyRead(3000));
+    QCOMPARE(blockingClient.readAll(), QByteArray("220 hello\r\n"));
+#endif
+}
+
 QTEST_MAIN(tst_QLocalSocket)
 #include "tst_qlocalsocket.moc"
 
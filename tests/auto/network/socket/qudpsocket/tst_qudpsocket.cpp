@@ -82,6 +82,7 @@ private slots:
     void outOfProcessConnectedClientServerTest();
     void outOfProcessUnconnectedClientServerTest();
     void zeroLengthDatagram();
+    void batchedDatagrams();
     void multicastTtlOption_data();
     void multicastTtlOption();
     void multicastLoopbackOption_data();
@@ -1235,6 +1236,76 @@ void tst_QUdpSocket::zeroLengthDatagram()
     QCOMPARE(receiver.readDatagram(&buf, 1), qint64(0));
 }
 
+void tst_QUdpSocket::batchedDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 1024 * 1024);
+    QVERIFY(receiver.receiveDatagrams(16).isEmpty());
+
+    // runs of equal sizes, a shorter one ending a run, an empty datagram and
+    // one that needs ancillary data
+    QList<QNetworkDatagram> datagrams;
+    for (int i = 0; i < 150; ++i) {
+        const int size = i == 40 ? 0 : i % 17 == 16 ? 500 : 1000;
+        QNetworkDatagram datagram(QByteArray(size, char('a' + i % 26)), QHostAddress::LocalHost,
+                                  receiver.localPort());
+        if (i == 70)
+            datagram.setHopLimit(8);
+        datagrams.append(datagram);
+    }
+
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost));
+    QSignalSpy bytesWrittenSpy(&sender, &QUdpSocket::bytesWritten);
+    QCOMPARE(sender.writeDatagrams(datagrams), datagrams.size());
+    qint64 bytesWritten = 0;
+    for (const QList<QVariant> &arguments : std::as_const(bytesWrittenSpy))
+        bytesWritten += arguments.at(0).toLongLong();
+    QCOMPARE(bytesWritten, 141 * 1000 + 8 * 500);
+
+    QList<QNetworkDatagram> received;
+    while (received.size() < datagrams.size()) {
+        if (!receiver.hasPendingDatagrams())
+            QVERIFY2(receiver.waitForReadyRead(5000), QtNetworkSettings::msgSocketError(receiver).constData());
+        const QList<QNetworkDatagram> batch = receiver.receiveDatagrams(32, 2048);
+        QVERIFY(batch.size() <= 32);
+        received += batch;
+    }
+    QCOMPARE(received.size(), datagrams.size());
+    for (qsizetype i = 0; i < received.size(); ++i) {
+        QVERIFY(received.at(i).isValid());
+        QCOMPARE(received.at(i).data(), datagrams.at(i).data());
+        QCOMPARE(received.at(i).senderAddress(), QHostAddress(QHostAddress::LocalHost));
+        QCOMPARE(received.at(i).senderPort(), int(sender.localPort()));
+        QCOMPARE(received.at(i).destinationPort(), int(receiver.localPort()));
+    }
+
+    // datagrams larger than maxSize are truncated
+    QCOMPARE(sender.writeDatagrams({ QNetworkDatagram(QByteArray(100, 'x'), QHostAddress::LocalHost,
+                                                      receiver.localPort()) }), 1);
+    QVERIFY(receiver.waitForReadyRead(5000));
+    received = receiver.receiveDatagrams(4, 10);
+    QCOMPARE(received.size(), 1);
+    QCOMPARE(received.first().data(), QByteArray(10, 'x'));
+
+    // a huge count is clamped, a buffer that cannot be allocated is refused
+    QCOMPARE(sender.writeDatagrams({ QNetworkDatagram(QByteArray(100, 'y'), QHostAddress::LocalHost,
+                                                      receiver.localPort()) }), 1);
+    QVERIFY(receiver.waitForReadyRead(5000));
+    QTest::ignoreMessage(QtWarningMsg, "QUdpSocket::receiveDatagrams: cannot allocate 1024 "
+                                       "datagrams of 9223372036854775807 bytes");
+    QVERIFY(receiver.receiveDatagrams(std::numeric_limits<qsizetype>::max(),
+                                      std::numeric_limits<qint64>::max()).isEmpty());
+    received = receiver.receiveDatagrams(std::numeric_limits<qsizetype>::max(), 1000);
+    QCOMPARE(received.size(), 1);
+    QCOMPARE(received.first().data(), QByteArray(100, 'y'));
+}
+
 void tst_QUdpSocket::multicastTtlOption_data()
 {
     QTest::addColumn<QHostAddress>("bindAddress");
@@ -0,0 +1,560 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QRandomGenerator>
+
+#include "qvnccompressor_p.h"
+
+#include <zlib.h>
+
+#include <memory>
+
+Q_DECLARE_METATYPE(QRfbClientFormat)
+
+// A framebuffer in the client's pixel format
+class Framebuffer
+{
+public:
+    Framebuffer(const QSize &size, int bytesPerPixel)
+        : size(size), bpp(bytesPerPixel), pixels(size.width() * size.height() * bpp, '\0')
+    {}
+
+    char *pixel(int x, int y) { return pixels.data() + (y * size.width() + x) * bpp; }
+
+    QSize size;
+    int bpp;
+    QByteArray pixels;
+};
+
+class Reader
+{
+public:
+    explicit Reader(const QByteArray &data) : data(data) {}
+
+    bool atEnd() const { return pos == data.size(); }
+    bool hasError() const { return error; }
+
+    quint8 u8() { return quint8(bytes(1).at(0)); }
+    quint16 u16() { return qFromBigEndian<quint16>(bytes(2).constData()); }
+    quint32 u32() { return qFromBigEndian<quint32>(bytes(4).constData()); }
+
+    // reading past the end sets the error and returns zeros
+    QByteArray bytes(qsizetype size)
+    {
+        if (error || size > data.size() - pos) {
+            error = true;
+            return QByteArray(size, '\0');
+        }
+        pos += size;
+        return data.sliced(pos - size, size);
+    }
+
+private:
+    QByteArray data;
+    qsizetype pos = 0;
+    bool error = false;
+};
+
+// One zlib stream of the client, which persists from one rectangle to
+// the next, as the server's does
+class Inflater
+{
+public:
+    Inflater() { inflateInit(&stream); }
+    ~Inflater() { inflateEnd(&stream); }
+
+    bool inflate(const QByteArray &in, QByteArray *out)
+    {
+        out->clear();
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in.constData()));
+        stream.avail_in = uInt(in.size());
+        char buffer[4096];
+        do {
+            stream.next_out = reinterpret_cast<Bytef *>(buffer);
+            stream.avail_out = sizeof(buffer);
+            const int result = ::inflate(&stream, Z_SYNC_FLUSH);
+            if (result != Z_OK && result != Z_BUF_ERROR)
+                return false;
+            out->append(buffer, sizeof(buffer) - stream.avail_out);
+        } while (stream.avail_in || !stream.avail_out);
+        return true;
+    }
+
+private:
+    z_stream stream = {};
+};
+
+// A client that decodes the rectangles of FramebufferUpdate messages
+class Decoder
+{
+public:
+    Decoder(const QRfbClientFormat &format, Framebuffer *framebuffer)
+        : format(format), framebuffer(framebuffer)
+    {}
+
+    bool decode(const QByteArray &data, int rectCount, qint32 expectedEncoding);
+    qint64 decodedArea() const { return area; }
+
+private:
+    bool decodeZrle(Reader *in, const QRect &rect);
+    bool decodeZrleTile(Reader *in, const QRect &tile);
+    bool decodeTight(Reader *in, const QRect &rect);
+
+    QByteArray readCompactPixel(Reader *in) const;
+    QByteArray readTightPixel(Reader *in) const;
+    static int readRunLength(Reader *in);
+    static int readCompactLength(Reader *in);
+
+    QRfbClientFormat format;
+    Framebuffer *framebuffer;
+    Inflater zrleStream;
+    Inflater tightStreams[4];
+    qint64 area = 0;
+};
+
+bool Decoder::decode(const QByteArray &data, int rectCount, qint32 expectedEncoding)
+{
+    Reader in(data);
+    area = 0;
+    for (int i = 0; i < rectCount; ++i) {
+        const int x = in.u16();
+        const int y = in.u16();
+        const int w = in.u16();
+        const int h = in.u16();
+        const qint32 encoding = in.u32();
+        const QRect rect(x, y, w, h);
+        if (in.hasError() || encoding != expectedEncoding
+            || !QRect(QPoint(), framebuffer->size).contains(rect)) {
+            return false;
+        }
+        const bool ok = encoding == 16 ? decodeZrle(&in, rect) : decodeTight(&in, rect);
+        if (!ok || in.hasError())
+            return false;
+        area += qint64(w) * h;
+    }
+    return in.atEnd();
+}
+
+// The size and position of ZRLE's compact pixels, as RFC 6143 defines them
+QByteArray Decoder::readCompactPixel(Reader *in) const
+{
+    const int bpp = format.bytesPerPixel;
+    QByteArray pixel(bpp, '\0');
+    const quint32 mask = (quint32(format.redMax) << format.redShift)
+                       | (quint32(format.greenMax) << format.greenShift)
+                       | (quint32(format.blueMax) << format.blueShift);
+    if (bpp == 4 && format.trueColor && (!(mask & 0xff000000) || !(mask & 0x000000ff))) {
+        const bool lowBytes = !(mask & 0xff000000);
+        const int offset = lowBytes == !format.bigEndian ? 0 : 1;
+        const QByteArray bytes = in->bytes(3);
+        pixel.replace(offset, 3, bytes);
+    } else {
+        pixel = in->bytes(bpp);
+    }
+    return pixel;
+}
+
+int Decoder::readRunLength(Reader *in)
+{
+    int length = 1;
+    quint8 byte;
+    do {
+        byte = in->u8();
+        length += byte;
+    } while (byte == 255 && !in->hasError());
+    return length;
+}
+
+bool Decoder::decodeZrle(Reader *in, const QRect &rect)
+{
+    const QByteArray compressed = in->bytes(in->u32());
+    QByteArray tiles;
+    if (in->hasError() || !zrleStream.inflate(compressed, &tiles))
+        return false;
+
+    Reader tileReader(tiles);
+    for (int y = 0; y < rect.height(); y += 64) {
+        for (int x = 0; x < rect.width(); x += 64) {
+            const QRect tile(rect.x() + x, rect.y() + y,
+                             qMin(64, rect.width() - x), qMin(64, rect.height() - y));
+            if (!decodeZrleTile(&tileReader, tile))
+                return false;
+        }
+    }
+    return !tileReader.hasError() && tileReader.atEnd();
+}
+
+bool Decoder::decodeZrleTile(Reader *in, const QRect &tile)
+{
+    const int bpp = format.bytesPerPixel;
+    const int subEncoding = in->u8();
+    int index = 0;
+    const int count = tile.width() * tile.height();
+    const auto put = [&](const QByteArray &pixel) {
+        memcpy(framebuffer->pixel(tile.x() + index % tile.width(),
+                                  tile.y() + index / tile.width()), pixel.constData(), bpp);
+        ++index;
+    };
+
+    if (subEncoding == 0) {
+        while (index < count && !in->hasError())
+            put(readCompactPixel(in));
+        return !in->hasError();
+    }
+    if (subEncoding == 1) {
+        const QByteArray pixel = readCompactPixel(in);
+        while (index < count)
+            put(pixel);
+        return !in->hasError();
+    }
+    if (subEncoding == 128) {
+        while (index < count && !in->hasError()) {
+            const QByteArray pixel = readCompactPixel(in);
+            const int length = readRunLength(in);
+            if (length > count - index)
+                return false;
+            for (int i = 0; i < length; ++i)
+                put(pixel);
+        }
+        return !in->hasError();
+    }
+
+    const int paletteSize = subEncoding > 128 ? subEncoding - 128 : subEncoding;
+    if (subEncoding == 129 || (subEncoding > 16 && subEncoding < 130))
+        return false;
+    QList<QByteArray> palette;
+    for (int i = 0; i < paletteSize; ++i)
+        palette.append(readCompactPixel(in));
+
+    if (subEncoding <= 16) {
+        const int bits = paletteSize <= 2 ? 1 : paletteSize <= 4 ? 2 : 4;
+        for (int y = 0; y < tile.height(); ++y) {
+            int shift = 0;
+            quint8 byte = 0;
+            for (int x = 0; x < tile.width(); ++x) {
+                if (!shift) {
+                    byte = in->u8();
+                    shift = 8;
+                }
+                shift -= bits;
+                const int i = (byte >> shift) & ((1 << bits) - 1);
+                if (i >= paletteSize)
+                    return false;
+                put(palette.at(i));
+            }
+        }
+        return !in->hasError();
+    }
+
+    while (index < count && !in->hasError()) {
+        const quint8 byte = in->u8();
+        const int i = byte & 127;
+        const int length = byte & 128 ? readRunLength(in) : 1;
+        if (i >= paletteSize || length > count - index)
+            return false;
+        for (int n = 0; n < length; ++n)
+            put(palette.at(i));
+    }
+    return !in->hasError();
+}
+
+// Tight sends RGB888 pixels as three bytes, and all others as they are
+QByteArray Decoder::readTightPixel(Reader *in) const
+{
+    const bool rgb888 = format.bytesPerPixel == 4 && format.trueColor && format.redMax == 255
+                        && format.greenMax == 255 && format.blueMax == 255;
+    if (!rgb888)
+        return in->bytes(format.bytesPerPixel);
+
+    const QByteArray rgb = in->bytes(3);
+    const quint32 value = (quint32(quint8(rgb[0])) << format.redShift)
+                        | (quint32(quint8(rgb[1])) << format.greenShift)
+                        | (quint32(quint8(rgb[2])) << format.blueShift);
+    QByteArray pixel(4, Qt::Uninitialized);
+    if (format.bigEndian)
+        qToBigEndian(value, pixel.data());
+    else
+        qToLittleEndian(value, pixel.data());
+    return pixel;
+}
+
+int Decoder::readCompactLength(Reader *in)
+{
+    int length = 0;
+    for (int i = 0; i < 3; ++i) {
+        const quint8 byte = in->u8();
+        length |= (i < 2 ? byte & 0x7f : byte) << (7 * i);
+        if (!(byte & 0x80))
+            break;
+    }
+    return length;
+}
+
+bool Decoder::decodeTight(Reader *in, const QRect &rect)
+{
+    const int bpp = format.bytesPerPixel;
+    const quint8 control = in->u8();
+    const auto fill = [&](int x, int y, const QByteArray &pixel) {
+        memcpy(framebuffer->pixel(rect.x() + x, rect.y() + y), pixel.constData(), bpp);
+    };
+
+    if ((control >> 4) == 0x08) {
+        const QByteArray pixel = readTightPixel(in);
+        for (int y = 0; y < rect.height(); ++y) {
+            for (int x = 0; x < rect.width(); ++x)
+                fill(x, y, pixel);
+        }
+        return !in->hasError();
+    }
+    // neither JPEG nor any other compression is expected without a quality level
+    if (control & 0x80)
+        return false;
+
+    for (int i = 0; i < 4; ++i) {
+        if (control & (1 << i))
+            return false; // the server never resets a stream
+    }
+    const int streamId = (control >> 4) & 3;
+    const int filter = control & 0x40 ? in->u8() : 0;
+    if (filter > 1)
+        return false;
+
+    QList<QByteArray> palette;
+    if (filter == 1) {
+        const int paletteSize = in->u8() + 1;
+        for (int i = 0; i < paletteSize; ++i)
+            palette.append(readTightPixel(in));
+    }
+    const int tightPixelSize = format.bytesPerPixel == 4 && format.trueColor
+                               && format.redMax == 255 && format.greenMax == 255
+                               && format.blueMax == 255 ? 3 : bpp;
+    const int rowSize = palette.isEmpty() ? rect.width() * tightPixelSize
+                        : palette.size() == 2 ? (rect.width() + 7) / 8
+                                              : rect.width();
+    const int size = rowSize * rect.height();
+
+    QByteArray bytes;
+    if (size < 12) {
+        bytes = in->bytes(size);
+    } else {
+        const QByteArray compressed = in->bytes(readCompactLength(in));
+        if (in->hasError() || !tightStreams[streamId].inflate(compressed, &bytes))
+            return false;
+    }
+    if (in->hasError() || bytes.size() != size)
+        return false;
+
+    Reader pixels(bytes);
+    for (int y = 0; y < rect.height(); ++y) {
+        for (int x = 0; x < rect.width(); ++x) {
+            if (palette.isEmpty()) {
+                fill(x, y, readTightPixel(&pixels));
+            } else if (palette.size() == 2) {
+                const quint8 byte = quint8(bytes.at(y * rowSize + x / 8));
+                fill(x, y, palette.at((byte >> (7 - x % 8)) & 1));
+            } else {
+                const int i = quint8(bytes.at(y * rowSize + x));
+                if (i >= palette.size())
+                    return false;
+                fill(x, y, palette.at(i));
+            }
+        }
+    }
+    return !pixels.hasError();
+}
+
+class tst_VncEncoders : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+
+private:
+    enum Content {
+        Solid,
+        TwoColors,
+        FewColors,
+        PaletteRuns,
+        ColorRuns,
+        Noise,
+        ContentCount
+    };
+    static QByteArray clientPixel(const QRfbClientFormat &format, QRgb rgb);
+    static QRfbPixelRect makeRect(const QRfbClientFormat &format, const QRect &rect,
+                                  Content content, quint32 seed);
+};
+
+QByteArray tst_VncEncoders::clientPixel(const QRfbClientFormat &format, QRgb rgb)
+{
+    const quint32 value = (quint32(qRed(rgb) * format.redMax / 255) << format.redShift)
+                        | (quint32(qGreen(rgb) * format.greenMax / 255) << format.greenShift)
+                        | (quint32(qBlue(rgb) * format.blueMax / 255) << format.blueShift);
+    const int bpp = format.bytesPerPixel;
+    QByteArray pixel(bpp, Qt::Uninitialized);
+    for (int i = 0; i < bpp; ++i)
+        pixel[i] = char(value >> (8 * (format.bigEndian ? bpp - 1 - i : i)));
+    return pixel;
+}
+
+QRfbPixelRect tst_VncEncoders::makeRect(const QRfbClientFormat &format, const QRect &rect,
+                                        Content content, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    QList<QRgb> colors;
+    for (int i = 0; i < 100; ++i)
+        colors.append(random.generate() | 0xff000000);
+
+    QRfbPixelRect pixelRect;
+    pixelRect.rect = rect;
+    int runLeft = 0;
+    QRgb runColor = 0;
+    for (int y = 0; y < rect.height(); ++y) {
+        for (int x = 0; x < rect.width(); ++x) {
+            QRgb rgb = 0;
+            switch (content) {
+            case Solid:
+                rgb = colors.at(0);
+                break;
+            case TwoColors:
+                rgb = colors.at((x / 3 + y / 5) % 2);
+                break;
+            case FewColors:
+                rgb = colors.at((x + y) / 7 % 5);
+                break;
+            case PaletteRuns:
+            case ColorRuns:
+                if (!runLeft) {
+                    runLeft = random.bounded(1, 300);
+                    runColor = content == PaletteRuns ? colors.at(random.bounded(100))
+                                                      : random.generate();
+                }
+                --runLeft;
+                rgb = runColor;
+                break;
+            case Noise:
+            case ContentCount:
+                rgb = random.generate();
+                break;
+            }
+            pixelRect.pixels.append(clientPixel(format, rgb));
+        }
+    }
+    return pixelRect;
+}
+
+void tst_VncEncoders::roundTrip_data()
+{
+    QTest::addColumn<QRfbClientFormat>("format");
+    QTest::addColumn<bool>("tight");
+
+    QRfbClientFormat rgb32;
+    QRfbClientFormat bgr32BigEndian;
+    bgr32BigEndian.bigEndian = true;
+    bgr32BigEndian.redShift = 0;
+    bgr32BigEndian.blueShift = 16;
+    QRfbClientFormat rgbx32;
+    rgbx32.redShift = 24;
+    rgbx32.greenShift = 16;
+    rgbx32.blueShift = 8;
+    QRfbClientFormat rgb30;
+    rgb30.redMax = rgb30.greenMax = rgb30.blueMax = 1023;
+    rgb30.redShift = 20;
+    rgb30.greenShift = 10;
+    rgb30.blueShift = 0;
+    QRfbClientFormat rgb16;
+    rgb16.bytesPerPixel = 2;
+    rgb16.redMax = rgb16.blueMax = 31;
+    rgb16.greenMax = 63;
+    rgb16.redShift = 11;
+    rgb16.greenShift = 5;
+    QRfbClientFormat rgb16BigEndian = rgb16;
+    rgb16BigEndian.bigEndian = true;
+    QRfbClientFormat bgr8;
+    bgr8.bytesPerPixel = 1;
+    bgr8.redMax = bgr8.greenMax = 7;
+    bgr8.blueMax = 3;
+    bgr8.redShift = 0;
+    bgr8.greenShift = 3;
+    bgr8.blueShift = 6;
+
+    const std::pair<const char *, QRfbClientFormat> formats[] = {
+        { "rgb32", rgb32 },
+        { "bgr32-be", bgr32BigEndian },
+        { "rgbx32", rgbx32 },
+        { "rgb30", rgb30 },
+        { "rgb16", rgb16 },
+        { "rgb16-be", rgb16BigEndian },
+        { "bgr8", bgr8 }
+    };
+    for (const auto &[name, format] : formats) {
+        QTest::addRow("zrle-%s", name) << format << false;
+        QTest::addRow("tight-%s", name) << format << true;
+    }
+}
+
+void tst_VncEncoders::roundTrip()
+{
+    QFETCH(QRfbClientFormat, format);
+    QFETCH(bool, tight);
+
+    // odd sizes, tiles cut at the edges, and rectangles that Tight has to split
+    const QRect rects[] = {
+        QRect(0, 0, 100, 70),
+        QRect(100, 0, 130, 67),
+        QRect(230, 0, 200, 100),
+        QRect(430, 0, 150, 90),
+        QRect(580, 0, 300, 130),
+        QRect(880, 0, 150, 90),
+        QRect(1030, 0, 3, 2),
+        QRect(1040, 0, 1, 1),
+        QRect(1050, 0, 64, 64),
+        QRect(0, 130, 2100, 40),
+        QRect(2100, 0, 30, 200)
+    };
+    const QSize screenSize(2200, 200);
+    Framebuffer expected(screenSize, format.bytesPerPixel);
+    Framebuffer decoded(screenSize, format.bytesPerPixel);
+
+    std::unique_ptr<QRfbCompressor> compressor;
+    if (tight)
+        compressor = std::make_unique<QRfbTightCompressor>();
+    else
+        compressor = std::make_unique<QRfbZrleCompressor>();
+    compressor->setFormat(format);
+    Decoder decoder(format, &decoded);
+
+    // every kind of content in every rectangle, one update after the other,
+    // so that the zlib streams carry over from one update to the next
+    for (int update = 0; update < int(ContentCount); ++update) {
+        QList<QRfbPixelRect> pixelRects;
+        qint64 area = 0;
+        for (int i = 0; i < int(std::size(rects)); ++i) {
+            const QRect &rect = rects[i];
+            const auto content = Content((i + update) % ContentCount);
+            pixelRects.append(makeRect(format, rect, content, update * 100 + i));
+            const QByteArray &pixels = pixelRects.constLast().pixels;
+            const int rowSize = rect.width() * format.bytesPerPixel;
+            for (int y = 0; y < rect.height(); ++y) {
+                memcpy(expected.pixel(rect.x(), rect.y() + y),
+                       pixels.constData() + y * rowSize, rowSize);
+            }
+            area += qint64(rect.width()) * rect.height();
+        }
+
+        QByteArray data;
+        const int rectCount = compressor->encode(pixelRects, &data);
+        QVERIFY(rectCount >= pixelRects.size());
+        QVERIFY2(decoder.decode(data, rectCount, tight ? 7 : 16),
+                 qPrintable(QStringLiteral("update %1").arg(update)));
+        QCOMPARE(decoder.decodedArea(), area);
+        QVERIFY2(decoded.pixels == expected.pixels,
+                 qPrintable(QStringLiteral("update %1").arg(update)));
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_VncEncoders)
+
+#include "tst_vncencoders.moc"
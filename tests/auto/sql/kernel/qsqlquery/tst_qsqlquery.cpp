@@ -145,6 +145,8 @@ private slots:
     void psql_bindWithDoubleColonCastOperator();
     void psql_specialFloatValues_data() { generic_data("QPSQL"); }
     void psql_specialFloatValues();
+    void psql_execBatch_data() { generic_data("QPSQL"); }
+    void psql_execBatch();
     void queryOnInvalidDatabase_data() { generic_data(); }
     void queryOnInvalidDatabase();
     void createQueryOnClosedDatabase_data() { generic_data(); }
@@ -228,6 +230,12 @@ private slots:
     void sqlite_real_data() { generic_data("QSQLITE"); }
     void sqlite_real();
 
+    void sqlite_cachedColumnTypes_data() { generic_data("QSQLITE"); }
+    void sqlite_cachedColumnTypes();
+
+    void sqlite_execBatch_data() { generic_data("QSQLITE"); }
+    void sqlite_execBatch();
+
     void prepared_query_json_row_data() { generic_data(); }
     void prepared_query_json_row();
 
@@ -2888,6 +2896,71 @@ void tst_QSqlQuery::psql_specialFloatValues()
     }
 }
 
+void tst_QSqlQuery::psql_execBatch()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    QSqlQuery q(db);
+    TableScope ts(db, "qtest_psqlbatch", __FILE__);
+    const auto &tableName = ts.tableName();
+
+    QVERIFY_SQL(q, exec(QLatin1String("create table %1 (id int primary key, name varchar(40), "
+                                      "data bytea, flag boolean, num float)").arg(tableName)));
+
+    // more rows than fit into one pipeline window or COPY chunk
+    constexpr int Count = 2500;
+    QVariantList ids, names, blobs, flags, nums;
+    for (int i = 0; i < Count; ++i) {
+        ids << i;
+        names << (i % 10 ? QVariant(u"name\t%1\n\\"_s.arg(i)) : QVariant(QMetaType::fromType<QString>()));
+        blobs << QByteArray(i % 7, char(i));
+        flags << bool(i % 2);
+        nums << (i == 1 ? std::numeric_limits<double>::quiet_NaN() : i / 8.0);
+    }
+    const auto verifyRows = [&](int offset) {
+        QVERIFY_SQL(q, exec(QLatin1String("select id, name, data, flag, num from %1 "
+                                          "where id >= %2 order by id").arg(tableName).arg(offset)));
+        for (int i = 0; i < Count; ++i) {
+            QVERIFY(q.next());
+            QCOMPARE(q.value(0).toInt(), offset + i);
+            QCOMPARE(q.value(1), names.at(i));
+            QCOMPARE(q.value(2).toByteArray(), blobs.at(i).toByteArray());
+            QCOMPARE(q.value(3).toBool(), flags.at(i).toBool());
+            if (i == 1)
+                QVERIFY(qIsNaN(q.value(4).toDouble()));
+            else
+                QCOMPARE(q.value(4).toDouble(), nums.at(i).toDouble());
+        }
+        QVERIFY(!q.next());
+    };
+
+    // ValuesAsRows goes through a pipeline, ValuesAsColumns through COPY
+    for (const auto mode : { QSqlQuery::ValuesAsRows, QSqlQuery::ValuesAsColumns }) {
+        const int offset = mode == QSqlQuery::ValuesAsRows ? 0 : Count;
+        QVariantList shiftedIds;
+        for (const QVariant &id : std::as_const(ids))
+            shiftedIds << id.toInt() + offset;
+        QVERIFY_SQL(q, prepare(QLatin1String("insert into %1 (id, name, data, flag, num) "
+                                             "values (?, ?, ?, ?, ?)").arg(tableName)));
+        q.addBindValue(shiftedIds);
+        q.addBindValue(names);
+        q.addBindValue(blobs);
+        q.addBindValue(flags);
+        q.addBindValue(nums);
+        QVERIFY_SQL(q, execBatch(mode));
+        verifyRows(offset);
+    }
+
+    // a failing row makes the batch fail in both modes
+    for (const auto mode : { QSqlQuery::ValuesAsRows, QSqlQuery::ValuesAsColumns }) {
+        QVERIFY_SQL(q, prepare(QLatin1String("insert into %1 (id) values (?)").arg(tableName)));
+        q.addBindValue(QVariantList{ 3 * Count, 0 });
+        QVERIFY(!q.execBatch(mode));
+        QVERIFY(q.lastError().isValid());
+    }
+}
+
 /* For task 157397: Using QSqlQuery with an invalid QSqlDatabase
    does not set the last error of the query.
    This test function will output some warnings, that's ok.
@@ -4283,6 +4356,147 @@ void tst_QSqlQuery::sqlite_real()
     QCOMPARE(q.value(0).toDouble(), 5.6);
 }
 
+void tst_QSqlQuery::sqlite_cachedColumnTypes()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    TableScope ts(db, "sqlitecachedcolumns", __FILE__);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec(QLatin1String("CREATE TABLE %1 (id INTEGER, name TEXT, data BLOB, "
+                                      "realVal REAL, mixed)").arg(ts.tableName())));
+    constexpr int Count = 300;
+    QVERIFY_SQL(q, prepare(QLatin1String("INSERT INTO %1 (id, name, data, realVal, mixed) "
+                                         "VALUES (?, ?, ?, ?, ?)").arg(ts.tableName())));
+    const auto nameOf = [](int i) { return i % 7 ? QString(u"name%1"_s.arg(i)) : QString(u""_s); };
+    const auto mixedOf = [](int i) -> QVariant {
+        if (i < Count / 2)
+            return i % 5 ? QVariant(qlonglong(i)) : QVariant();
+        return i % 2 ? QVariant(QString::number(i)) : QVariant(i + 0.5);
+    };
+    for (int i = 0; i < Count; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(i % 3 ? QVariant(nameOf(i)) : QVariant(QMetaType::fromType<QString>()));
+        q.addBindValue(QByteArray(i % 11, char('a' + i % 26)));
+        q.addBindValue(i % 4 ? QVariant(i / 4.0) : QVariant(QMetaType::fromType<double>()));
+        q.addBindValue(mixedOf(i));
+        QVERIFY_SQL(q, exec());
+    }
+
+    QVERIFY_SQL(q, exec(QLatin1String("SELECT id, name, data, realVal, mixed FROM %1 ORDER BY id")
+                        .arg(ts.tableName())));
+    const auto checkRow = [&](int i) {
+        QCOMPARE(q.at(), i);
+        QCOMPARE(q.value(0), QVariant(qlonglong(i)));
+        QCOMPARE(q.isNull(1), i % 3 == 0);
+        if (i % 3)
+            QCOMPARE(q.value(1).toString(), nameOf(i));
+        QCOMPARE(q.value(2).toByteArray(), QByteArray(i % 11, char('a' + i % 26)));
+        QCOMPARE(q.isNull(3), i % 4 == 0);
+        if (i % 4)
+            QCOMPARE(q.value(3).toDouble(), i / 4.0);
+        const QVariant mixed = mixedOf(i);
+        QCOMPARE(q.isNull(4), mixed.isNull());
+        if (!mixed.isNull())
+            QCOMPARE(q.value(4), mixed);
+    };
+    for (int i = 0; i < Count; ++i) {
+        QVERIFY(q.next());
+        checkRow(i);
+        if (QTest::currentTestFailed())
+            return;
+    }
+    QVERIFY(!q.next());
+
+    // scroll back over the cached rows
+    for (int i = Count - 1; i >= 0; --i) {
+        QVERIFY(q.previous());
+        checkRow(i);
+        if (QTest::currentTestFailed())
+            return;
+    }
+    QVERIFY(q.seek(Count / 2 + 1));
+    checkRow(Count / 2 + 1);
+    QVERIFY(q.last());
+    checkRow(Count - 1);
+}
+
+void tst_QSqlQuery::sqlite_execBatch()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    TableScope ts(db, "sqlitebatch", __FILE__);
+    const auto &tableName = ts.tableName();
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec(QLatin1String("CREATE TABLE %1 (id INTEGER PRIMARY KEY, name TEXT, "
+                                      "copy TEXT, data BLOB)").arg(tableName)));
+
+    constexpr int Count = 1000;
+    QVariantList ids, names, blobs;
+    for (int i = 0; i < Count; ++i) {
+        ids << i;
+        names << (i % 3 ? QVariant(u"name%1"_s.arg(i)) : QVariant(QMetaType::fromType<QString>()));
+        blobs << QByteArray(i % 5, char(i));
+    }
+    // a named placeholder used twice is a single SQLite parameter
+    QVERIFY_SQL(q, prepare(QLatin1String("INSERT INTO %1 (id, name, copy, data) "
+                                         "VALUES (:id, :name, :name, :data)").arg(tableName)));
+    q.bindValue(":id", ids);
+    q.bindValue(":name", names);
+    q.bindValue(":data", blobs);
+    QVERIFY_SQL(q, execBatch());
+    QCOMPARE(q.numRowsAffected(), 1);
+
+    QVERIFY_SQL(q, exec(QLatin1String("SELECT id, name, copy, data FROM %1 ORDER BY id")
+                        .arg(tableName)));
+    for (int i = 0; i < Count; ++i) {
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), i);
+        QCOMPARE(q.value(1), names.at(i));
+        QCOMPARE(q.value(2), names.at(i));
+        QCOMPARE(q.value(3).toByteArray(), blobs.at(i).toByteArray());
+    }
+    QVERIFY(!q.next());
+
+    // the rows before a failing one are kept, as with one exec() per row
+    QVERIFY_SQL(q, prepare(QLatin1String("INSERT INTO %1 (id) VALUES (?)").arg(tableName)));
+    q.addBindValue(QVariantList{ Count, Count + 1, 0, Count + 2 });
+    QVERIFY(!q.execBatch());
+    QVERIFY(q.lastError().isValid());
+    QVERIFY_SQL(q, exec(QLatin1String("SELECT MAX(id) FROM %1").arg(tableName)));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), Count + 1);
+
+    // ...unless the whole batch is asked to be atomic
+    {
+        const auto tidier = qScopeGuard([]() { QSqlDatabase::removeDatabase("atomicBatch"); });
+        QSqlDatabase atomicDb = QSqlDatabase::cloneDatabase(db, "atomicBatch");
+        atomicDb.setConnectOptions("QSQLITE_ATOMIC_BATCH");
+        QVERIFY(atomicDb.open());
+        QSqlQuery atomicQuery(atomicDb);
+        QVERIFY_SQL(atomicQuery, prepare(QLatin1String("INSERT INTO %1 (id) VALUES (?)")
+                                         .arg(tableName)));
+        atomicQuery.addBindValue(QVariantList{ Count + 10, Count + 11, 0 });
+        QVERIFY(!atomicQuery.execBatch());
+        QVERIFY_SQL(atomicQuery, exec(QLatin1String("SELECT MAX(id) FROM %1").arg(tableName)));
+        QVERIFY(atomicQuery.next());
+        QCOMPARE(atomicQuery.value(0).toInt(), Count + 1);
+    }
+
+    // inside a transaction the batch doesn't commit anything
+    QVERIFY(db.transaction());
+    QVERIFY_SQL(q, prepare(QLatin1String("INSERT INTO %1 (id) VALUES (?)").arg(tableName)));
+    q.addBindValue(QVariantList{ Count + 20, Count + 21 });
+    QVERIFY_SQL(q, execBatch());
+    QVERIFY(db.rollback());
+    QVERIFY_SQL(q, exec(QLatin1String("SELECT MAX(id) FROM %1").arg(tableName)));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), Count + 1);
+}
+
 void tst_QSqlQuery::prepared_query_json_row()
 {
     QFETCH(QString, dbName);
@@ -3,8 +3,11 @@
 
 #include <QTest>
 #include <QVariantMap>
+#include <qjsonarray.h>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonstreamreader.h>
+#include <qjsonstreamwriter.h>
 
 class BenchmarkQtJson: public QObject
 {
@@ -21,6 +24,10 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseStrings_data();
+    void parseStrings();
+    void streamReadJson();
+    void streamWriteJson();
 
     void jsonObjectInsert();
     void variantMapInsert();
@@ -93,6 +100,79 @@ void BenchmarkQtJson::parseJsonToVariant()
     }
 }
 
+void BenchmarkQtJson::parseStrings_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    // an array of objects with string members, the typical payload of a
+    // REST API
+    const auto document = [](QLatin1StringView text, QJsonDocument::JsonFormat format) {
+        QJsonArray array;
+        for (int i = 0; i < 1000; ++i) {
+            QJsonObject object;
+            object.insert("id", i);
+            object.insert("name", "item " + QString::number(i));
+            object.insert("description", text);
+            array.append(object);
+        }
+        return QJsonDocument(array).toJson(format);
+    };
+    const QLatin1StringView ascii("Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+                                  "eiusmod tempor incididunt ut labore et dolore magna aliqua.");
+    const QLatin1StringView escaped("Lorem ipsum \"dolor\" sit amet,\nconsectetur adipiscing elit, "
+                                    "sed do\teiusmod tempor incididunt ut labore et dolore magna.");
+    QTest::newRow("compact") << document(ascii, QJsonDocument::Compact);
+    QTest::newRow("indented") << document(ascii, QJsonDocument::Indented);
+    QTest::newRow("escaped") << document(escaped, QJsonDocument::Compact);
+    QTest::newRow("non-ascii")
+            << QJsonDocument(QJsonArray{ QString(10000, u'\u00e9') + QString(10000, u'x') }).toJson();
+}
+
+void BenchmarkQtJson::parseStrings()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        QVERIFY(doc.isArray());
+    }
+}
+
+void BenchmarkQtJson::streamReadJson()
+{
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+
+    QBENCHMARK {
+        QJsonStreamReader reader(testJson);
+        while (!reader.atEnd())
+            reader.readNext();
+        QVERIFY(!reader.hasError());
+    }
+}
+
+void BenchmarkQtJson::streamWriteJson()
+{
+    QByteArray json;
+    QBENCHMARK {
+        json.clear();
+        QJsonStreamWriter writer(&json);
+        writer.startArray();
+        for (int i = 0; i < 1000; i++) {
+            writer.startObject();
+            writer.append("testkey");
+            writer.append(i);
+            writer.append("value");
+            writer.append(1.5);
+            writer.endObject();
+        }
+        writer.endArray();
+    }
+}
+
 void BenchmarkQtJson::jsonObjectInsert()
 {
     QJsonObject object;
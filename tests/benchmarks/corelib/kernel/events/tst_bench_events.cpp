@@ -71,6 +71,8 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void queuedCallsFromThreads_data();
+    void queuedCallsFromThreads();
 };
 
 void EventsBench::initTestCase()
@@ -145,6 +147,42 @@ void EventsBench::postEvent()
     }
 }
 
+void EventsBench::queuedCallsFromThreads_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("12 threads") << 12;
+}
+
+void EventsBench::queuedCallsFromThreads()
+{
+    QFETCH(int, threadCount);
+    constexpr int CallsPerThread = 10000;
+    QObject receiver;
+
+    QBENCHMARK {
+        int received = 0;
+        const int expected = threadCount * CallsPerThread;
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back(QThread::create([&receiver, &received, expected] {
+                for (int i = 0; i < CallsPerThread; ++i) {
+                    QMetaObject::invokeMethod(&receiver, [&received, expected] {
+                        if (++received == expected)
+                            QTestEventLoop::instance().exitLoop();
+                    }, Qt::QueuedConnection);
+                }
+            }));
+            threads.back()->start();
+        }
+        QTestEventLoop::instance().enterLoop(60);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        for (const auto &thread : threads)
+            thread->wait();
+    }
+}
+
 QTEST_MAIN(EventsBench)
 
 #include "tst_bench_events.moc"
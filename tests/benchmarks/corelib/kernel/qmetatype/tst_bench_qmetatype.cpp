@@ -3,6 +3,10 @@
 
 #include <qtest.h>
 #include <QtCore/qmetatype.h>
+#include <QtCore/qthread.h>
+
+#include <memory>
+#include <vector>
 
 class tst_QMetaType : public QObject
 {
@@ -34,6 +38,9 @@ private slots:
     void isRegisteredCustom();
     void isRegisteredNotRegistered();
 
+    void lookupCustomMultithreaded_data();
+    void lookupCustomMultithreaded();
+
     void constructInPlace_data();
     void constructInPlace();
     void constructInPlaceCopy_data();
@@ -217,6 +224,38 @@ void tst_QMetaType::isRegisteredNotRegistered()
     }
 }
 
+void tst_QMetaType::lookupCustomMultithreaded_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    for (int n : { 1, 2, 4, 8 })
+        QTest::addRow("%d-threads", n) << n;
+}
+
+void tst_QMetaType::lookupCustomMultithreaded()
+{
+    QFETCH(int, threadCount);
+
+    // what QVariant conversions and queued connections do, on many threads
+    const int type = qRegisterMetaType<Foo>("Foo");
+    const auto lookup = [type] {
+        for (int i = 0; i < 100000; ++i) {
+            QMetaType::fromName("Foo");
+            QMetaType(type).sizeOf();
+        }
+    };
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back(QThread::create(lookup));
+            threads.back()->start();
+        }
+        for (const auto &thread : threads)
+            thread->wait();
+    }
+}
+
 void tst_QMetaType::constructInPlace_data()
 {
     QTest::addColumn<int>("typeId");
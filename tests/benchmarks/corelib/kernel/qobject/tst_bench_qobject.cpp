@@ -20,6 +20,8 @@ private slots:
     void signal_slot_benchmark_data();
     void signal_many_receivers();
     void signal_many_receivers_data();
+    void signal_few_receivers();
+    void signal_few_receivers_data();
     void qproperty_benchmark_data();
     void qproperty_benchmark();
     void dynamic_property_benchmark();
@@ -173,6 +175,37 @@ void tst_QObject::signal_many_receivers()
     }
 }
 
+void tst_QObject::signal_few_receivers_data()
+{
+    QTest::addColumn<int>("receiverCount");
+    QTest::addColumn<bool>("functor");
+    QTest::newRow("1 receiver") << 1 << false;
+    QTest::newRow("2 receivers") << 2 << false;
+    QTest::newRow("3 receivers") << 3 << false;
+    QTest::newRow("1 functor") << 1 << true;
+    QTest::newRow("3 functors") << 3 << true;
+}
+
+void tst_QObject::signal_few_receivers()
+{
+    QFETCH(int, receiverCount);
+    QFETCH(bool, functor);
+    Object sender;
+    std::vector<Object> receivers(receiverCount);
+
+    for (Object &receiver : receivers) {
+        if (functor)
+            QObject::connect(&sender, &Object::signal0, &receiver, [&receiver] { receiver.slot0(); });
+        else
+            QObject::connect(&sender, &Object::signal0, &receiver, &Object::slot0);
+    }
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            sender.emitSignal0();
+    }
+}
+
 void tst_QObject::qproperty_benchmark_data()
 {
     QTest::addColumn<QByteArray>("name");
@@ -45,6 +45,9 @@ private slots:
     void queryMatchResultsByGroupIndex();
     void queryMatchResultsByGroupName();
     void iterateThroughGlobalMatchResults();
+
+    void globalMatchEncodedSubject_data();
+    void globalMatchEncodedSubject();
 };
 
 void tst_QRegularExpressionBenchmark::createDefault()
@@ -270,6 +273,59 @@ void tst_QRegularExpressionBenchmark::iterateThroughGlobalMatchResults()
     }
 }
 
+enum SubjectEncoding { ConvertedToUtf16, Utf8, Latin1 };
+
+void tst_QRegularExpressionBenchmark::globalMatchEncodedSubject_data()
+{
+    QTest::addColumn<int>("encoding");
+
+    QTest::newRow("fromUtf8") << int(ConvertedToUtf16);
+    QTest::newRow("utf8") << int(Utf8);
+    QTest::newRow("latin1") << int(Latin1);
+}
+
+/*!
+    \internal This benchmark measures the performance of a global match over
+    8-bit data, e.g. a log file read from disk: either converted to QString
+    first, or matched directly with the QUtf8StringView and QLatin1StringView
+    overloads of globalMatchView().
+*/
+void tst_QRegularExpressionBenchmark::globalMatchEncodedSubject()
+{
+    QFETCH(int, encoding);
+
+    QByteArray log;
+    for (int i = 0; i < 10000; ++i) {
+        log += "2024-01-01 12:00:" + QByteArray::number(i % 60).rightJustified(2, '0')
+                + " [worker-" + QByteArray::number(i % 8) + "] request "
+                + QByteArray::number(i) + " done status=" + (i % 10 ? "200" : "500") + '\n';
+    }
+
+    QRegularExpression re("status=(5\\d\\d)");
+    re.optimize();
+    qsizetype count = 0;
+    QBENCHMARK {
+        count = 0;
+        QRegularExpressionMatchIterator it;
+        switch (encoding) {
+        case ConvertedToUtf16:
+            it = re.globalMatch(QString::fromUtf8(log));
+            break;
+        case Utf8:
+            it = re.globalMatchView(QUtf8StringView(log));
+            break;
+        case Latin1:
+            it = re.globalMatchView(QLatin1StringView(log));
+            break;
+        }
+        while (it.hasNext()) {
+            it.next();
+            ++count;
+        }
+    }
+    QCOMPARE(count, 1000);
+}
+
 QTEST_MAIN(tst_QRegularExpressionBenchmark)
 
 #include "tst_bench_qregularexpression.moc"
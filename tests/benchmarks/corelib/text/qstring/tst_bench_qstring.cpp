@@ -1,5 +1,6 @@
 // Copyright (C) 2016 The Qt Company Ltd.
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+#include <QStringDecoder>
 #include <QStringList>
 #include <QFile>
 #include <QTest>
@@ -43,7 +44,18 @@ private slots:
     void toDouble_data();
     void toDouble();
 
+    // Conversion:
+    void fromUtf8_data() { utf8_data_impl(); }
+    void fromUtf8();
+    void decodeUtf8_data() { utf8_data_impl(); }
+    void decodeUtf8();
+    void isValidUtf8_data() { utf8_data_impl(); }
+    void isValidUtf8();
+    void toUtf8_data() { utf8_data_impl(); }
+    void toUtf8();
+
 private:
+    void utf8_data_impl();
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
     template <typename Integer> void number_impl();
@@ -450,6 +462,82 @@ void tst_QString::toDouble()
     QCOMPARE(actual, expected);
 }
 
+void tst_QString::utf8_data_impl()
+{
+    QTest::addColumn<QByteArray>("utf8");
+
+    // log lines of about 64 kB in different scripts
+    const auto corpus = [](QStringView line) {
+        QString text;
+        while (text.size() < 32 * 1024)
+            text += line;
+        return text.toUtf8();
+    };
+    QTest::newRow("ascii")
+        << corpus(u"2024-03-01T12:00:00 INFO  connection from 10.0.0.1 accepted\n");
+    QTest::newRow("latin1")
+        << corpus(u"2024-03-01T12:00:00 INFO  Überweisung für Müller bestätigt, Gebühr 3,50 €\n");
+    QTest::newRow("cyrillic")
+        << corpus(u"2024-03-01T12:00:00 INFO  соединение с сервером установлено успешно\n");
+    QTest::newRow("greek-only")
+        << corpus(u"Καλημέρα κόσμε, η σύνδεση με τον διακομιστή ολοκληρώθηκε\n");
+    QTest::newRow("cjk")
+        << corpus(u"2024-03-01T12:00:00 INFO 与服务器的连接已成功建立，正在同步数据\n");
+    QTest::newRow("cjk-only")
+        << corpus(u"与服务器的连接已成功建立正在同步数据请稍候再试一次谢谢您的耐心等待\n");
+    QTest::newRow("emoji")
+        << corpus(u"2024-03-01T12:00:00 INFO  deploy finished \U0001F680 all checks \u2705 \U0001F389\n");
+}
+
+void tst_QString::fromUtf8()
+{
+    QFETCH(QByteArray, utf8);
+
+    QString result;
+    QBENCHMARK {
+        result = QString::fromUtf8(utf8);
+    }
+    QCOMPARE(result.toUtf8(), utf8);
+}
+
+void tst_QString::decodeUtf8()
+{
+    QFETCH(QByteArray, utf8);
+
+    // decode in chunks, as when reading a file
+    QString result;
+    QBENCHMARK {
+        QStringDecoder decoder(QStringDecoder::Utf8);
+        result.clear();
+        for (qsizetype i = 0; i < utf8.size(); i += 4093)
+            result += decoder(QByteArrayView(utf8).sliced(i, qMin<qsizetype>(4093, utf8.size() - i)));
+    }
+    QCOMPARE(result.toUtf8(), utf8);
+}
+
+void tst_QString::isValidUtf8()
+{
+    QFETCH(QByteArray, utf8);
+
+    bool valid = false;
+    QBENCHMARK {
+        valid = QByteArrayView(utf8).isValidUtf8();
+    }
+    QVERIFY(valid);
+}
+
+void tst_QString::toUtf8()
+{
+    QFETCH(QByteArray, utf8);
+
+    const QString text = QString::fromUtf8(utf8);
+    QByteArray result;
+    QBENCHMARK {
+        result = text.toUtf8();
+    }
+    QCOMPARE(result, utf8);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "tst_bench_qstring.moc"
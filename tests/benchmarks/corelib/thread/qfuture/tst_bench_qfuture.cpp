@@ -23,6 +23,7 @@ private slots:
     void reportResult();
     void reportResults();
     void reportResultsManualProgress();
+    void streamResults();
 #ifndef QT_NO_EXCEPTIONS
     void reportException();
 #endif
@@ -127,6 +128,24 @@ void tst_QFuture::reportResultsManualProgress()
     }
 }
 
+void tst_QFuture::streamResults()
+{
+    const int resultCount = 100000;
+    QBENCHMARK {
+        QPromise<int> promise;
+        auto future = promise.future();
+        promise.start();
+        for (int i = 0; i < resultCount; ++i)
+            promise.addResult(i);
+        promise.finish();
+
+        qint64 sum = 0;
+        for (int value : future)
+            sum += value;
+        QCOMPARE(sum, qint64(resultCount) * (resultCount - 1) / 2);
+    }
+}
+
 #ifndef QT_NO_EXCEPTIONS
 void tst_QFuture::reportException()
 {
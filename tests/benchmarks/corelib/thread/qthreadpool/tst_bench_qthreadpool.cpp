@@ -15,6 +15,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void fineGrainedTasks_data();
+    void fineGrainedTasks();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -50,6 +52,54 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+void tst_QThreadPool::fineGrainedTasks_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("fromWorkers");
+
+    const int maxThreads = QThread::idealThreadCount();
+    for (int threads = 1; ; threads = qMin(threads * 2, maxThreads)) {
+        QTest::addRow("%d threads, from outside", threads) << threads << false;
+        QTest::addRow("%d threads, from workers", threads) << threads << true;
+        if (threads == maxThreads)
+            break;
+    }
+}
+
+// Runs many tiny tasks, started either all by the benchmark thread or by
+// a handful of tasks running inside the pool (like recursive algorithms do),
+// to show how the pool scales with the number of threads.
+void tst_QThreadPool::fineGrainedTasks()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, fromWorkers);
+
+    constexpr int Spawners = 64;
+    constexpr int TasksPerSpawner = 1000;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    QAtomicInt counter;
+
+    const auto work = [&counter] { counter.fetchAndAddRelaxed(1); };
+    const auto spawn = [&threadPool, &work] {
+        for (int i = 0; i < TasksPerSpawner; ++i)
+            threadPool.start(work);
+    };
+
+    QBENCHMARK {
+        counter.storeRelaxed(0);
+        for (int i = 0; i < Spawners; ++i) {
+            if (fromWorkers)
+                threadPool.start(spawn);
+            else
+                spawn();
+        }
+        QVERIFY(threadPool.waitForDone());
+    }
+    QCOMPARE(counter.loadRelaxed(), Spawners * TasksPerSpawner);
+}
+
 QTEST_MAIN(tst_QThreadPool)
 
 #include "tst_bench_qthreadpool.moc"
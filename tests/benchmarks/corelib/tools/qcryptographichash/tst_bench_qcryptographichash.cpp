@@ -33,6 +33,8 @@ private Q_SLOTS:
     void addData();
     void addDataChunked_data() { hash_data(); }
     void addDataChunked();
+    void hashBatch_data();
+    void hashBatch();
 
     // QMessageAuthenticationCode:
     void hmac_hash_data() { hash_data(); }
@@ -142,6 +144,39 @@ void tst_QCryptographicHash::addDataChunked()
     }
 }
 
+void tst_QCryptographicHash::hashBatch_data()
+{
+    QTest::addColumn<Algorithm>("algo");
+    QTest::addColumn<int>("messageSize");
+
+    // many small messages, as in content-addressed storage
+    static const int messageSizes[] = { 16, 55, 64, 200, 1024 };
+    for (int messageSize : messageSizes) {
+        for_each_algorithm([&] (Algorithm algo, const char *name) {
+            if (algo == Algorithm::NumAlgorithms)
+                return;
+            QTest::addRow("%s-%d", name, messageSize) << algo << messageSize;
+        });
+    }
+}
+
+void tst_QCryptographicHash::hashBatch()
+{
+    QFETCH(const Algorithm, algo);
+    QFETCH(const int, messageSize);
+
+    SKIP_IF_NOT_SUPPORTED(algo);
+
+    QList<QByteArrayView> messages;
+    for (int i = 0; i + messageSize <= MaxBlockSize; i += messageSize)
+        messages.append(QByteArrayView(blockOfData).sliced(i, messageSize));
+
+    QBENCHMARK {
+        [[maybe_unused]]
+        auto r = QCryptographicHash::hashBatch(messages, algo);
+    }
+}
+
 static QByteArray hmacKey() {
     static QByteArray key = [] {
             QByteArray result(277, Qt::Uninitialized);
@@ -29,7 +29,7 @@ class tst_qnetworkdiskcache : public QObject
 {
     Q_OBJECT
 private:
-    void injectFakeData();
+    void injectFakeData(quint32 count = NumFakeCacheObjects);
     void insertOneItem();
     bool isUrlCached(quint32 id);
     void cleanRecursive(QString &path);
@@ -53,6 +53,9 @@ private slots:
 
     void timeExpiration_data();
     void timeExpiration();
+
+    void timeLargeCache_data();
+    void timeLargeCache();
 };
 
 
@@ -299,11 +302,60 @@ void tst_qnetworkdiskcache::timeExpiration()
     cleanRecursive(cacheDir);
 
 }
+void tst_qnetworkdiskcache::timeLargeCache_data()
+{
+    QTest::addColumn<QString>("cacheRootDirectory");
+    QTest::addColumn<int>("entries");
+
+    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QTest::newRow("1000 entries") << cacheLoc << 1000;
+    QTest::newRow("10000 entries") << cacheLoc << 10000;
+    QTest::newRow("100000 entries") << cacheLoc << 100000;
+}
+
+//Times opening a cache with many entries, looking up and evicting some of them
+void tst_qnetworkdiskcache::timeLargeCache()
+{
+    QFETCH(QString, cacheRootDirectory);
+    QFETCH(int, entries);
+
+    cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
+
+    //Housekeeping
+    initCacheObject();
+    cleanRecursive(cacheDir); // slow op.
+    cache->setCacheDirectory(cacheDir);
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    cache->clear();
+
+    injectFakeData(entries); // SLOW
+    const qint64 size = cache->cacheSize();
+    cleanupCacheObject();
+
+    QBENCHMARK_ONCE {
+        initCacheObject();
+        cache->setCacheDirectory(cacheDir);
+        cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+        QCOMPARE(cache->cacheSize(), size);
+
+        for (quint32 i = 0; i < NumReadContent; i++)
+            QVERIFY(!cache->metaData(QUrl(fakeURLbase + "missing/" + QString::number(i))).isValid());
+
+        //evict about half of the entries
+        cache->setMaximumCacheSize(size / 2);
+        QVERIFY(cache->cacheSize() < size / 2);
+    }
+
+    //Cleanup (slow)
+    cleanupCacheObject();
+    cleanRecursive(cacheDir);
+}
+
 // This function simulates a partially or fully occupied disk cache
 // like a normal user of a cache might encounter is real-life browsing.
 // The point of this is to trigger degradation in file-system and media performance
 // that occur due to the quantity and layout of data.
-void tst_qnetworkdiskcache::injectFakeData()
+void tst_qnetworkdiskcache::injectFakeData(quint32 count)
 {
 
     QNetworkCacheMetaData::RawHeaderList headers;
@@ -311,7 +363,7 @@ void tst_qnetworkdiskcache::injectFakeData()
 
 
     //Prep cache dir with fake data using QNetworkDiskCache APIs
-    for (quint32 i = 0; i < NumFakeCacheObjects; i++) {
+    for (quint32 i = 0; i < count; i++) {
 
         //prepare metata for url
         QNetworkCacheMetaData meta;
@@ -7,9 +7,11 @@
 #include <QTest>
 #include <QTestEventLoop>
 #include <QSemaphore>
+#include <QTemporaryFile>
 #include <QTimer>
 #include <QtCore/qrandom.h>
 #include <QtCore/QElapsedTimer>
+#include <QtNetwork/qhttp1configuration.h>
 #include <QtNetwork/qnetworkreply.h>
 #include <QtNetwork/qnetworkrequest.h>
 #include <QtNetwork/qnetworkaccessmanager.h>
@@ -17,6 +19,9 @@
 #include <QtNetwork/qtcpserver.h>
 #include "../../../../auto/network-settings.h"
 
+#include <ctime>
+#include <memory>
+
 #ifdef QT_BUILD_INTERNAL
 #include <QtNetwork/private/qhostinfo_p.h>
 #endif
@@ -315,6 +320,78 @@ protected:
     qint64 toBeGeneratedTotalCount;
 };
 
+// Reads a whole HTTP request, replies once the announced body has arrived.
+class UploadSinkHttpServer : public QThread
+{
+    Q_OBJECT
+    // used to make the constructor only return after the tcp server started listening
+    QSemaphore ready;
+    int port;
+public:
+    qint64 bodyBytes;
+    UploadSinkHttpServer()
+        : port(-1), bodyBytes(0)
+    {
+        start();
+        ready.acquire();
+    }
+
+    inline int serverPort() const { return port; }
+
+protected:
+    void run() override
+    {
+        QTcpServer server;
+        server.listen(QHostAddress::LocalHost);
+        port = server.serverPort();
+        ready.release();
+
+        QVERIFY(server.waitForNewConnection(10*1000));
+        QTcpSocket *client = server.nextPendingConnection();
+
+        qint64 contentLength = 0;
+        forever {
+            if (!client->canReadLine()) {
+                if (!client->waitForReadyRead(10*1000))
+                    return;
+                continue;
+            }
+            const QByteArray line = client->readLine().trimmed();
+            if (line.isEmpty())
+                break; // end of the header
+            if (line.toLower().startsWith("content-length:"))
+                contentLength = line.mid(15).trimmed().toLongLong();
+        }
+
+        QByteArray buffer(64*1024, Qt::Uninitialized);
+        while (bodyBytes < contentLength) {
+            if (!client->bytesAvailable() && !client->waitForReadyRead(10*1000))
+                return;
+            bodyBytes += client->read(buffer.data(), qMin(qint64(buffer.size()),
+                                                          contentLength - bodyBytes));
+        }
+
+        client->write("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+        client->waitForBytesWritten(10*1000);
+    }
+};
+
+// Reads a file without being a QFileDevice, so that uploading it takes the
+// same path as any other random-access QIODevice.
+class FileProxyDevice : public QIODevice
+{
+    QFile *file;
+public:
+    explicit FileProxyDevice(QFile *f) : file(f) { open(ReadOnly | Unbuffered); }
+
+    qint64 size() const override { return file->size(); }
+    bool seek(qint64 pos) override { return QIODevice::seek(pos) && file->seek(pos); }
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override { return file->read(data, maxlen); }
+    qint64 writeData(const char *, qint64) override { return -1; }
+};
+
 class HttpDownloadPerformanceServer : QObject {
     Q_OBJECT;
     qint64 dataSize;
@@ -405,6 +482,44 @@ class HttpDownloadPerformanceClient : QObject {
 
 
 
+// Keeps connections alive and answers each request after a delay, as if it
+// had to do some work for it; throughput then depends on the number of
+// connections the client uses.
+class KeepAliveHttpServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    explicit KeepAliveHttpServer(std::chrono::milliseconds delay) : delay(delay)
+    {
+        listen(QHostAddress::LocalHost);
+    }
+
+    int connectionCount = 0;
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override
+    {
+        QTcpSocket *socket = new QTcpSocket(this);
+        socket->setSocketDescriptor(socketDescriptor);
+        ++connectionCount;
+        auto buffer = std::make_shared<QByteArray>();
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket, buffer] {
+            buffer->append(socket->readAll());
+            qsizetype end;
+            while ((end = buffer->indexOf("\r\n\r\n")) >= 0) {
+                buffer->remove(0, end + 4);
+                QTimer::singleShot(delay, socket, [socket] {
+                    socket->write("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+                });
+            }
+        });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    }
+
+private:
+    std::chrono::milliseconds delay;
+};
+
 class tst_qnetworkreply : public QObject
 {
     Q_OBJECT
@@ -430,6 +545,8 @@ private slots:
     void uploadPerformance();
     void performanceControlRate();
     void httpUploadPerformance();
+    void httpFileUploadPerformance_data();
+    void httpFileUploadPerformance();
     void httpDownloadPerformance_data();
     void httpDownloadPerformance();
     void httpDownloadPerformanceDownloadBuffer_data();
@@ -438,6 +555,8 @@ private slots:
     void httpsUpload();
     void preConnect_data();
     void preConnect();
+    void httpConnectionPool_data();
+    void httpConnectionPool();
 
 private:
     void runHttpsUploadRequest(const QByteArray &data, const QNetworkRequest &request);
@@ -639,6 +758,52 @@ void tst_qnetworkreply::httpUploadPerformance()
               << ((UploadSize/1024.0)/(elapsed/1000.0)) << " kB/sec";
 }
 
+void tst_qnetworkreply::httpFileUploadPerformance_data()
+{
+    QTest::addColumn<bool>("fromFileDevice");
+
+    // a QFile can be sent by the kernel without being read into memory
+    QTest::newRow("file") << true;
+    QTest::newRow("copied") << false;
+}
+
+void tst_qnetworkreply::httpFileUploadPerformance()
+{
+    QFETCH(bool, fromFileDevice);
+    constexpr qint64 UploadSize = 128 * MiB;
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    const QByteArray block(MiB, '@');
+    for (qint64 i = 0; i < UploadSize; i += block.size())
+        QCOMPARE(file.write(block), block.size());
+    QVERIFY(file.flush());
+    QVERIFY(file.seek(0));
+    FileProxyDevice proxy(&file);
+    QIODevice *device = fromFileDevice ? static_cast<QIODevice *>(&file) : &proxy;
+
+    UploadSinkHttpServer server;
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/"));
+    request.setHeader(QNetworkRequest::ContentLengthHeader, UploadSize);
+
+    // the CPU time includes the receiving thread, which does the same work for both rows
+    const std::clock_t cpuStart = std::clock();
+    QElapsedTimer time;
+    time.start();
+    QNetworkReplyPtr reply(manager.put(request, device));
+    connect(reply, SIGNAL(finished()), &QTestEventLoop::instance(), SLOT(exitLoop()));
+    QTestEventLoop::instance().enterLoop(60);
+    const qint64 elapsed = time.elapsed();
+    const qint64 cpu = qint64(std::clock() - cpuStart) * 1000 / CLOCKS_PER_SEC;
+
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QVERIFY(server.wait(10*1000));
+    QCOMPARE(server.bodyBytes, UploadSize);
+
+    qDebug() << "tst_QNetworkReply::httpFileUploadPerformance" << elapsed << "msec, "
+             << ((UploadSize/1024.0)/(elapsed/1000.0)) << "kB/sec," << cpu << "msec CPU";
+}
 
 void tst_qnetworkreply::performanceControlRate()
 {
@@ -932,6 +1097,59 @@ void tst_qnetworkreply::preConnect()
              << (normalElapsed - preConnectElapsed) << "ms";
 }
 
+void tst_qnetworkreply::httpConnectionPool_data()
+{
+    QTest::addColumn<int>("connections");
+    QTest::addColumn<int>("maximumConnections");
+
+    QTest::newRow("fixed, 2 connections") << 2 << 2;
+    QTest::newRow("fixed, 6 connections") << 6 << 6;
+    QTest::newRow("fixed, 16 connections") << 16 << 16;
+    QTest::newRow("adaptive, 2 to 16 connections") << 2 << 16;
+}
+
+void tst_qnetworkreply::httpConnectionPool()
+{
+    QFETCH(int, connections);
+    QFETCH(int, maximumConnections);
+    constexpr int RequestCount = 200;
+
+    KeepAliveHttpServer server(5ms);
+    QHttp1Configuration http1Configuration;
+    http1Configuration.setNumberOfConnectionsPerHost(connections);
+    http1Configuration.setMaximumNumberOfConnectionsPerHost(maximumConnections);
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/"));
+    request.setHttp1Configuration(http1Configuration);
+
+    QNetworkAccessManager manager;
+    qint64 elapsed = 0;
+    int rounds = 0;
+    QBENCHMARK {
+        QElapsedTimer timer;
+        timer.start();
+        int finished = 0;
+        int errors = 0;
+        for (int i = 0; i < RequestCount; ++i) {
+            QNetworkReply *reply = manager.get(request);
+            connect(reply, &QNetworkReply::finished, this, [reply, &finished, &errors] {
+                if (reply->error() != QNetworkReply::NoError)
+                    ++errors;
+                reply->deleteLater();
+                if (++finished == RequestCount)
+                    QTestEventLoop::instance().exitLoop();
+            });
+        }
+        QTestEventLoop::instance().enterLoop(60s);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        QCOMPARE(errors, 0);
+        elapsed += timer.elapsed();
+        ++rounds;
+    }
+    qDebug() << "tst_QNetworkReply::httpConnectionPool" << server.connectionCount
+             << "connections," << (RequestCount * rounds * 1000 / qMax<qint64>(elapsed, 1))
+             << "requests/sec";
+}
+
 QTEST_MAIN(tst_qnetworkreply)
 
 #include "tst_qnetworkreply.moc"
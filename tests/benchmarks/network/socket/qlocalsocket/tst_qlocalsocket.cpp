@@ -32,7 +32,8 @@ class ServerThread : public QThread
 public:
     QSemaphore running;
 
-    explicit ServerThread(int chunkSize)
+    explicit ServerThread(int chunkSize, bool sharedMemory = false)
+        : sharedMemory(sharedMemory)
     {
         buffer.resize(chunkSize);
     }
@@ -40,6 +41,8 @@ public:
     void run() override
     {
         QLocalServer server;
+        if (sharedMemory)
+            server.setSocketOptions(QLocalServer::SharedMemoryTransportOption);
 
         connect(&server, &QLocalServer::newConnection, [this, &server]() {
             auto socket = server.nextPendingConnection();
@@ -62,6 +65,7 @@ public:
 
 protected:
     QByteArray buffer;
+    bool sharedMemory;
 };
 
 class SocketFactory : public QObject
@@ -71,12 +75,14 @@ class SocketFactory : public QObject
 public:
     bool stopped = false;
 
-    explicit SocketFactory(int chunkSize, int connections)
+    explicit SocketFactory(int chunkSize, int connections, bool sharedMemory = false)
     {
         buffer.resize(chunkSize);
         for (int i = 0; i < connections; ++i) {
             QLocalSocket *socket = new QLocalSocket(this);
             Q_CHECK_PTR(socket);
+            if (sharedMemory)
+                socket->setSocketOptions(QLocalSocket::SharedMemoryTransportOption);
 
             connect(this, &SocketFactory::start, [this, socket]() {
                QCOMPARE(socket->write(this->buffer), this->buffer.size());
@@ -163,10 +169,14 @@ void tst_QLocalSocket::dataExchange_data()
 {
     QTest::addColumn<int>("connections");
     QTest::addColumn<int>("chunkSize");
-    for (int connections : {1, 5, 10}) {
-        for (int chunkSize : {100, 1000, 10000, 100000}) {
-            QTest::addRow("connections: %d, chunk size: %d",
-                          connections, chunkSize) << connections << chunkSize;
+    QTest::addColumn<bool>("sharedMemory");
+    for (bool sharedMemory : {false, true}) {
+        for (int connections : {1, 5, 10}) {
+            for (int chunkSize : {100, 1000, 10000, 100000, 1000000}) {
+                QTest::addRow("connections: %d, chunk size: %d, transport: %s",
+                              connections, chunkSize, sharedMemory ? "shared memory" : "socket")
+                        << connections << chunkSize << sharedMemory;
+            }
         }
     }
 }
@@ -175,16 +185,19 @@ void tst_QLocalSocket::dataExchange()
 {
     QFETCH(int, connections);
     QFETCH(int, chunkSize);
+    QFETCH(bool, sharedMemory);
 
     Q_ASSERT(chunkSize > 0 && connections > 0);
     const auto timeToTest = 5000ms;
 
-    ServerThread serverThread(chunkSize);
+    // Where the shared memory transport is not available, both rows
+    // measure the socket.
+    ServerThread serverThread(chunkSize, sharedMemory);
     serverThread.start();
     // Wait for server to start.
     QVERIFY(serverThread.running.tryAcquire(1, 3000));
 
-    SocketFactory factory(chunkSize, connections);
+    SocketFactory factory(chunkSize, connections, sharedMemory);
     QTestEventLoop eventLoop;
     qint64 totalReceived = 0;
     QElapsedTimer timer;
@@ -16,6 +16,8 @@ public:
 private slots:
     void pendingDatagramSize_data();
     void pendingDatagramSize();
+    void sendAndReceive_data();
+    void sendAndReceive();
 };
 
 tst_QUdpSocket::tst_QUdpSocket()
@@ -51,5 +53,52 @@ void tst_QUdpSocket::pendingDatagramSize()
     }
 }
 
+void tst_QUdpSocket::sendAndReceive_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<int>("size");
+    for (int size : {64, 512, 1200}) {
+        QTest::addRow("single/%d", size) << false << size;
+        QTest::addRow("batched/%d", size) << true << size;
+    }
+}
+
+void tst_QUdpSocket::sendAndReceive()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, size);
+    constexpr int Count = 64;
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 1024 * 1024);
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost));
+
+    const QList<QNetworkDatagram> datagrams(Count, QNetworkDatagram(QByteArray(size, 'a'),
+                                                                     QHostAddress::LocalHost,
+                                                                     receiver.localPort()));
+    QBENCHMARK {
+        int received = 0;
+        if (batched) {
+            QCOMPARE(sender.writeDatagrams(datagrams), Count);
+            while (received < Count) {
+                if (!receiver.hasPendingDatagrams())
+                    QVERIFY(receiver.waitForReadyRead(5000));
+                received += receiver.receiveDatagrams(Count, size).size();
+            }
+        } else {
+            for (const QNetworkDatagram &datagram : datagrams)
+                QCOMPARE(sender.writeDatagram(datagram), size);
+            while (received < Count) {
+                if (!receiver.hasPendingDatagrams())
+                    QVERIFY(receiver.waitForReadyRead(5000));
+                if (receiver.receiveDatagram(size).isValid())
+                    ++received;
+            }
+        }
+    }
+}
+
 QTEST_MAIN(tst_QUdpSocket)
 #include "tst_qudpsocket.moc"
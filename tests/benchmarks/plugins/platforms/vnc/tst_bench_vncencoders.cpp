@@ -0,0 +1,210 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QTest>
+#include <QImage>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QRegion>
+
+#include "qvnccompressor_p.h"
+
+#include <functional>
+
+// The dirty rectangles of one screen update, converted as the VNC server
+// would convert them for a client that uses the server's 32 bit format
+using Update = QList<QRfbPixelRect>;
+using Recording = QList<Update>;
+
+enum Encoding {
+    Raw,
+    Zrle,
+    Tight,
+    TightJpeg
+};
+
+class tst_VncEncoders : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void encode_data();
+    void encode();
+
+private:
+    static Update snapshot(const QImage &screen, const QRegion &dirty, bool withImage);
+    static Recording record(const std::function<QRegion (QPainter *, int)> &paintFrame, bool withImage);
+
+    QHash<QString, std::function<QRegion (QPainter *, int)>> scenes;
+};
+
+static const QSize screenSize(1280, 800);
+static const int frameCount = 30;
+
+Update tst_VncEncoders::snapshot(const QImage &screen, const QRegion &dirty, bool withImage)
+{
+    Update update;
+    for (const QRect &rect : dirty & screen.rect()) {
+        QRfbPixelRect pixelRect;
+        pixelRect.rect = rect;
+        const int bstep = rect.width() * 4;
+        pixelRect.pixels.resize(bstep * rect.height());
+        for (int y = 0; y < rect.height(); ++y) {
+            memcpy(pixelRect.pixels.data() + y * bstep,
+                   screen.constScanLine(rect.y() + y) + rect.x() * 4, bstep);
+        }
+        if (withImage)
+            pixelRect.image = screen.copy(rect);
+        update.append(pixelRect);
+    }
+    return update;
+}
+
+// Paints frameCount frames of a scene and records the dirty regions
+Recording tst_VncEncoders::record(const std::function<QRegion (QPainter *, int)> &paintFrame,
+                                  bool withImage)
+{
+    QImage screen(screenSize, QImage::Format_RGB32);
+    screen.fill(Qt::white);
+
+    Recording recording;
+    // the first update is the whole screen, as when a client connects
+    {
+        QPainter painter(&screen);
+        paintFrame(&painter, -1);
+    }
+    recording.append(snapshot(screen, screen.rect(), withImage));
+    for (int frame = 0; frame < frameCount; ++frame) {
+        QPainter painter(&screen);
+        const QRegion dirty = paintFrame(&painter, frame);
+        painter.end();
+        recording.append(snapshot(screen, dirty, withImage));
+    }
+    return recording;
+}
+
+void tst_VncEncoders::initTestCase()
+{
+    // A terminal that scrolls a line of text per frame
+    scenes.insert(QStringLiteral("terminal"), [](QPainter *p, int frame) {
+        const QRect area(40, 40, 800, 600);
+        const int lineHeight = 16;
+        p->fillRect(area, Qt::black);
+        p->setPen(Qt::green);
+        for (int line = 0; line < area.height() / lineHeight; ++line) {
+            p->drawText(area.left() + 4, area.top() + (line + 1) * lineHeight - 4,
+                        QStringLiteral("$ make -j8 && ./tst_bench_vncencoders # line %1").arg(frame + line));
+        }
+        return QRegion(area);
+    });
+
+    // A window with text and flat colors dragged across a gradient
+    scenes.insert(QStringLiteral("window"), [](QPainter *p, int frame) {
+        const QSize windowSize(400, 300);
+        const auto windowRect = [&](int f) { return QRect(QPoint(100 + f * 20, 100 + f * 8), windowSize); };
+        QLinearGradient gradient(0, 0, screenSize.width(), screenSize.height());
+        gradient.setColorAt(0, QColor(30, 60, 120));
+        gradient.setColorAt(1, QColor(200, 120, 40));
+        const QRegion dirty = frame < 0 ? QRegion(QRect(QPoint(), screenSize))
+                                        : QRegion(windowRect(frame - 1)) + windowRect(frame);
+        for (const QRect &rect : dirty)
+            p->fillRect(rect, gradient);
+        const QRect window = windowRect(qMax(frame, 0));
+        p->fillRect(window, QColor(240, 240, 240));
+        p->fillRect(window.adjusted(0, 0, 0, 24 - window.height()), QColor(60, 90, 160));
+        p->setPen(Qt::black);
+        for (int line = 0; line < 15; ++line)
+            p->drawText(window.left() + 10, window.top() + 50 + line * 16, QStringLiteral("Some text in the window"));
+        return dirty;
+    });
+
+    // Photo-like content, as a video playing in a part of the screen
+    scenes.insert(QStringLiteral("video"), [](QPainter *p, int frame) {
+        const QRect area(200, 150, 640, 360);
+        QImage video(area.size(), QImage::Format_RGB32);
+        QRandomGenerator random(frame + 1);
+        for (int y = 0; y < video.height(); ++y) {
+            QRgb *line = reinterpret_cast<QRgb *>(video.scanLine(y));
+            for (int x = 0; x < video.width(); ++x) {
+                const int noise = random.bounded(24);
+                line[x] = qRgb((x + frame * 4) % 200 + noise, (y + frame) % 200 + noise, (x + y) % 200 + noise);
+            }
+        }
+        p->drawImage(area.topLeft(), video);
+        return QRegion(area);
+    });
+
+    // Small updates: a blinking text cursor and a ticking clock
+    scenes.insert(QStringLiteral("idle"), [](QPainter *p, int frame) {
+        const QRect cursor(300, 300, 2, 16);
+        const QRect clock(1180, 4, 90, 20);
+        if (frame < 0) {
+            p->fillRect(QRect(QPoint(), screenSize), QColor(220, 220, 220));
+            return QRegion(QRect(QPoint(), screenSize));
+        }
+        p->fillRect(cursor, frame % 2 ? Qt::black : QColor(220, 220, 220));
+        p->fillRect(clock, QColor(220, 220, 220));
+        p->drawText(clock, Qt::AlignCenter, QStringLiteral("12:%1").arg(frame, 2, 10, QLatin1Char('0')));
+        return QRegion(cursor) + clock;
+    });
+}
+
+void tst_VncEncoders::encode_data()
+{
+    QTest::addColumn<QString>("scene");
+    QTest::addColumn<int>("encoding");
+
+    const QStringList sceneNames = { QStringLiteral("terminal"), QStringLiteral("window"),
+                                     QStringLiteral("video"), QStringLiteral("idle") };
+    for (const QString &scene : sceneNames) {
+        QTest::addRow("%s-raw", qPrintable(scene)) << scene << int(Raw);
+        QTest::addRow("%s-zrle", qPrintable(scene)) << scene << int(Zrle);
+        QTest::addRow("%s-tight", qPrintable(scene)) << scene << int(Tight);
+        QTest::addRow("%s-tight-jpeg", qPrintable(scene)) << scene << int(TightJpeg);
+    }
+}
+
+void tst_VncEncoders::encode()
+{
+    QFETCH(QString, scene);
+    QFETCH(int, encoding);
+
+    const Recording recording = record(scenes.value(scene), encoding == TightJpeg);
+    qint64 rawSize = 0;
+    for (const Update &update : recording) {
+        for (const QRfbPixelRect &rect : update)
+            rawSize += 12 + rect.pixels.size();
+    }
+
+    qint64 encodedSize = 0;
+    QBENCHMARK {
+        // a new compressor per run, as for a new client
+        std::unique_ptr<QRfbCompressor> compressor;
+        if (encoding == Zrle)
+            compressor = std::make_unique<QRfbZrleCompressor>();
+        else if (encoding != Raw)
+            compressor = std::make_unique<QRfbTightCompressor>();
+        if (compressor)
+            compressor->setQualityLevel(encoding == TightJpeg ? 6 : -1);
+
+        encodedSize = 0;
+        QByteArray data;
+        for (const Update &update : recording) {
+            data.clear();
+            if (compressor) {
+                compressor->encode(update, &data);
+            } else {
+                for (const QRfbPixelRect &rect : update)
+                    data.append(12, '\0').append(rect.pixels);
+            }
+            encodedSize += data.size();
+        }
+    }
+    qDebug("%s: %lld bytes, %.1f%% of raw", QTest::currentDataTag(),
+           encodedSize, 100.0 * encodedSize / rawSize);
+}
+
+QTEST_MAIN(tst_VncEncoders)
+
+#include "tst_bench_vncencoders.moc"
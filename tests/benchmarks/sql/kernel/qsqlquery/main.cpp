@@ -24,6 +24,8 @@ private slots:
     void benchmark();
     void benchmarkSelectPrepared_data() { generic_data(); }
     void benchmarkSelectPrepared();
+    void sqliteBulkInsert_data();
+    void sqliteBulkInsert();
 
 private:
     // returns all database connections
@@ -115,4 +117,63 @@ void tst_QSqlQuery::benchmarkSelectPrepared()
     }
 }
 
+void tst_QSqlQuery::sqliteBulkInsert_data()
+{
+    QTest::addColumn<QString>("dbName");
+    QTest::addColumn<bool>("batch");
+    int count = 0;
+    for (const QString &dbName : std::as_const(dbs.dbNames)) {
+        if (!QSqlDatabase::database(dbName).driverName().startsWith("QSQLITE"))
+            continue;
+        QTest::newRow(qPrintable(dbName + ":exec")) << dbName << false;
+        QTest::newRow(qPrintable(dbName + ":execBatch")) << dbName << true;
+        ++count;
+    }
+    if (count == 0)
+        QSKIP("No database drivers of type QSQLITE are available in this Qt configuration");
+}
+
+void tst_QSqlQuery::sqliteBulkInsert()
+{
+    QFETCH(QString, dbName);
+    QFETCH(bool, batch);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    QSqlQuery q(db);
+    TableScope ts(db, "bulkinsert", __FILE__);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + ts.tableName()
+                        + " (id INTEGER NOT NULL, name TEXT, value REAL)"));
+
+    const int NUM_ROWS = 10000;
+    QVariantList ids, names, values;
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        ids << i;
+        names << QString("Value" + QString::number(i));
+        values << i / 3.0;
+    }
+
+    QVERIFY_SQL(q, prepare("INSERT INTO " + ts.tableName() + " (id, name, value) VALUES (?, ?, ?)"));
+    QBENCHMARK {
+        // both run in one transaction, so that only the statement execution
+        // is compared and not the cost of committing every row on its own
+        QVERIFY_SQL(db, transaction());
+        if (batch) {
+            q.addBindValue(ids);
+            q.addBindValue(names);
+            q.addBindValue(values);
+            QVERIFY_SQL(q, execBatch());
+        } else {
+            // what execBatch() amounts to without driver support
+            for (int i = 0; i < NUM_ROWS; ++i) {
+                q.addBindValue(ids.at(i));
+                q.addBindValue(names.at(i));
+                q.addBindValue(values.at(i));
+                QVERIFY_SQL(q, exec());
+            }
+        }
+        QVERIFY_SQL(db, commit());
+    }
+}
+
 #include "main.moc"